@@ -5,8 +5,10 @@
 #include "src/ast.h"
 #include "src/list.h"
 #include "src/map.h"
+#include "src/output.h"
 #include "src/context.h"
 #include "src/smem.h"
+#include "src/symbol.h"
 #include "src/token.h"
 #include "src/types.h"
 #include "src/utils.h"
@@ -23,13 +25,13 @@ bool entry_cmp(const MapEntry** entry, char** key) {
 void entry_to_string(const void** mapEntry) {
     MapEntry* entry = (MapEntry*) *mapEntry;
 
-    printf("key: %s, value: ", (char*) entry->key);
+    output_printf("key: %s, value: ", (char*) entry->key);
     stmt_to_string((Stmt**) &entry->value);
-    printf("\n");
+    output_printf("\n");
 }
 
 void print_map_entry(const MapEntry* entry) {
-    printf("key=%s, value=%s\n",
+    output_printf("key=%s, value=%s\n",
         (char*) entry->key, (char*) entry->value);
 }
 
@@ -43,6 +45,11 @@ void print_map(const Map* map) {
 }
 
 int main(void) {
+    SymbolTable* symbols = symbol_table_new(NULL);
+    TypeTable* types = type_table_new(NULL);
+    symbol_table_set_active(symbols);
+    type_table_set_active(types);
+
     Expr* testMath = NEW_BINARY_EXPR(
         NEW_GROUP_EXPR(
             NEW_BINARY_EXPR(
@@ -284,15 +291,15 @@ int main(void) {
     void* value = context_get(innerScope, "object");
     if (value != NULL) {
         stmt_to_string((Stmt**) &value);
-        printf("\n");
+        output_printf("\n");
     }
 
     if(context_exists(globalContext, "object")) {
-        printf("*** object is defined in globalContext ***\n");
+        output_printf("*** object is defined in globalContext ***\n");
     }
 
     if(context_exists(innerScope, "object")) {
-        printf("*** object is defined in innerScope ***\n");
+        output_printf("*** object is defined in innerScope ***\n");
     }
 
     context_free(&innerScope);
@@ -320,16 +327,16 @@ int main(void) {
     list_insert_last(&testSort, str_dup("b"));
     list_insert_last(&testSort, str_dup("c"));
 
-    printf("Before list_sort:\n");
+    output_printf("Before list_sort:\n");
     list_foreach(word, testSort) {
-        printf("%s\n", (char*) word->value);
+        output_printf("%s\n", (char*) word->value);
     }
 
     list_sort(&testSort, str_cmp);
 
-    printf("After list_sort in order:\n");
+    output_printf("After list_sort in order:\n");
     list_foreach(word, testSort) {
-        printf("%s\n", (char*) word->value);
+        output_printf("%s\n", (char*) word->value);
     }
 
     list_free(&testSort);
@@ -396,5 +403,8 @@ int main(void) {
     Stmt* continueTest = NEW_CONTINUE_STMT();
     STMT_PRINT_AND_FREE(continueTest);
 
+    type_table_free(&types);
+    symbol_table_free(&symbols);
+
     return EXIT_SUCCESS;
 }
@@ -1,66 +1,559 @@
 #include <errno.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/resource.h>
 
+#include "src/arena.h"
 #include "src/ast.h"
+#include "src/buffer.h"
+#include "src/cache.h"
 #include "src/interpreter.h"
 #include "src/list.h"
+#include "src/optimizer.h"
+#include "src/output.h"
+#include "src/reader.h"
+#include "src/smem.h"
+#include "src/symbol.h"
+#include "src/token.h"
 #include "src/type-checker.h"
+#include "src/types.h"
+#include "src/vector.h"
+#include "src/vm.h"
 
-extern FILE* yyin;
+#include "rose.tab.h"
 
-extern int yyparse(void);
+typedef struct yy_buffer_state* YY_BUFFER_STATE;
 
-List* declarations = NULL;
+extern int yylex_init(yyscan_t* scanner);
+extern int yylex_destroy(yyscan_t scanner);
+extern int yylex(YYSTYPE* value, yyscan_t scanner);
+extern void yyset_in(FILE* input, yyscan_t scanner);
 
-int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        printf("Usage: %s file.rose\n", argv[0]);
-        return EXIT_FAILURE;
+extern YY_BUFFER_STATE yy_scan_buffer(char* base, size_t size, yyscan_t scanner);
+extern void yy_delete_buffer(YY_BUFFER_STATE buffer, yyscan_t scanner);
+
+/*
+ * A streamed program is read through the lexer a chunk at a time and each
+ * top-level declaration runs as soon as the parser reduces it. Every one is
+ * built in an arena of its own, handed back for the next once it has run,
+ * unless a closure may point into it: function and struct declarations and
+ * anything holding a function literal keep theirs until the end.
+ */
+typedef struct Stream {
+    EvalStream* program;
+    ParserState* parser;
+    Vector* pending; /* declarations reduced and not run yet */
+    Vector* arenas;  /* the arena of each pending one, NULL when it is kept */
+    Vector* spare;   /* arenas ready to take the next declaration */
+    Vector* kept;
+    size_t functionExpressions;
+} Stream;
+
+static void stream_declaration(Decl* declaration, void* context) {
+    Stream* stream = context;
+
+    Arena* arena = arena_active();
+    arena_set_active(NULL);
+
+    bool keep = declaration->type == FUNC_DECL || declaration->type == STRUCT_DECL
+        || stream->parser->functionExpressions != stream->functionExpressions;
+    stream->functionExpressions = stream->parser->functionExpressions;
+
+    vector_push(&stream->pending, declaration);
+    vector_push(&stream->arenas, keep ? NULL : arena);
+    if (keep) {
+        vector_push(&stream->kept, arena);
+    }
+
+    Arena* next = NULL;
+    if (vector_is_empty(&stream->spare)) {
+        next = arena_new(0);
+    } else {
+        vector_remove_at(&stream->spare, vector_size(&stream->spare) - 1, (void**) &next);
+    }
+
+    /* the text of the declaration was interned or copied by its actions */
+    token_stream_discard();
+
+    arena_set_active(next);
+}
+
+static bool run_pending(Stream* stream) {
+    Arena* parsing = arena_active();
+    arena_set_active(NULL);
+
+    bool ok = true;
+
+    for (size_t i = 0; i < vector_size(&stream->pending) && ok; i++) {
+        ok = eval_stream_next(stream->program, vector_get_at(&stream->pending, i)) == INTERPRETER_SUCCESS;
+
+        Arena* arena = vector_get_at(&stream->arenas, i);
+        if (arena != NULL) {
+            arena_reset(arena);
+            vector_push(&stream->spare, arena);
+        }
     }
 
-    FILE* src = fopen(argv[1], "r");
-    if (src == NULL) {
+    vector_clear(&stream->pending);
+    vector_clear(&stream->arenas);
+
+    arena_set_active(parsing);
+
+    return ok;
+}
+
+static void free_arenas(Vector** arenas) {
+    vector_foreach(arena, *arenas) {
+        arena_free((Arena**) arena);
+    }
+
+    vector_free(arenas);
+}
+
+static int run_stream(const char* path, InterpreterOptions options) {
+    FILE* input = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+    if (input == NULL) {
         fprintf(stderr, "error: %s\n", strerror(errno));
         return EXIT_FAILURE;
     }
 
-    yyin = src;
-    yyparse();
+    ParserState state = {
+        .symbols = symbol_table_new(NULL),
+        .types = type_table_new(NULL),
+        .success = true
+    };
+
+    /* the program keeps interning into them while it runs, not only while it parses */
+    symbol_table_set_active(state.symbols);
+    type_table_set_active(state.types);
 
-    fclose(src);
+    yyscan_t scanner = NULL;
+    yylex_init(&scanner);
+    yyset_in(input, scanner);
+
+    Stream stream = {
+        .program = eval_stream_new(options),
+        .pending = vector_new(NULL),
+        .arenas = vector_new(NULL),
+        .spare = vector_new(NULL),
+        .kept = vector_new(NULL),
+        .functionExpressions = 0
+    };
+
+    state.onDeclaration = stream_declaration;
+    state.context = &stream;
+    stream.parser = &state;
+
+    Arena* arena = arena_new(0);
+    arena_set_active(arena);
+
+    bool ok = true;
+
+    yypstate* parser = yypstate_new();
+
+    int status = YYPUSH_MORE;
+    while (status == YYPUSH_MORE && ok) {
+        YYSTYPE value;
+        int token = yylex(&value, scanner);
+
+        status = yypush_parse(parser, token, &value, scanner, &state);
+        ok = run_pending(&stream);
+    }
 
-    extern bool success;
-    if (!success) {
-        list_free(&declarations);
+    yypstate_delete(parser);
+    yylex_destroy(scanner);
+
+    /* the declaration being parsed when the program stopped */
+    arena = arena_active();
+    arena_set_active(NULL);
+    arena_free(&arena);
+
+    InterpreterStatus programStatus = eval_stream_finish(&stream.program);
+
+    if (!ok || programStatus == INTERPRETER_FAILURE) {
+        output_printf("Interpreter error\n");
+    }
+
+    vector_free(&stream.pending);
+    vector_free(&stream.arenas);
+    free_arenas(&stream.spare);
+    free_arenas(&stream.kept);
+
+    if (input != stdin) {
+        fclose(input);
+    }
+
+    output_free();
+    reader_close_all();
+    type_table_free(&state.types);
+    symbol_table_free(&state.symbols);
+    token_stream_free();
+    smem_release();
+
+    return ok && state.success && programStatus == INTERPRETER_SUCCESS ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static void release(ParserState* state, Arena** arena, Source** source, char** cacheFile) {
+    safe_free((void**) cacheFile);
+
+    output_free();
+    reader_close_all();
+    type_table_free(&state->types);
+    symbol_table_free(&state->symbols);
+    arena_free(arena);
+    token_set_source(NULL);
+    source_free(source);
+    smem_release();
+}
+
+/*
+ * Parses, checks and runs one whole program, everything it used is released
+ * on return. Its tables start out backed by the builtin ones, when given.
+ */
+static int run_file(const char* path, bool useVM, bool useCache, InterpreterOptions options,
+    const SymbolTable* builtinSymbols, const TypeTable* builtinTypes) {
+    /* scanned in place, token spans point into it until release */
+    Source* source = source_open(path);
+    if (source == NULL) {
+        fprintf(stderr, "error: %s: %s\n", path, strerror(errno));
         return EXIT_FAILURE;
     }
 
-    printf("Parsing Successful\n");
+    /* the whole tree lives in one arena and is dropped with it */
+    Arena* arena = arena_new(0);
+    arena_set_active(arena);
+
+    token_set_source(source->text);
+
+    ParserState state = {
+        .symbols = symbol_table_new(builtinSymbols),
+        .types = type_table_new(builtinTypes),
+        .success = true
+    };
+
+    /* the cache, the checker and the engines intern into them too */
+    symbol_table_set_active(state.symbols);
+    type_table_set_active(state.types);
+
+    /* a cache built from this exact source stands in for parsing and checking it */
+    char* cacheFile = useCache ? cache_path(path) : NULL;
+    if (cacheFile != NULL) {
+        state.declarations = cache_load(cacheFile, source->text, source->size);
+        options.checked = state.declarations != NULL;
+    }
+
+    if (!options.checked) {
+        yyscan_t scanner = NULL;
+        yylex_init(&scanner);
+
+        YY_BUFFER_STATE buffer = yy_scan_buffer(source->text, source->size + 2, scanner);
+        yyparse(scanner, &state);
+        yy_delete_buffer(buffer, scanner);
+
+        yylex_destroy(scanner);
+    }
+
+    arena_set_active(NULL);
+
+    List* declarations = state.declarations;
+
+    if (!state.success) {
+        release(&state, &arena, &source, &cacheFile);
+        return EXIT_FAILURE;
+    }
+
+    output_printf("Parsing Successful\n");
+
+    /* checked here rather than by the engine so the cache holds the checked tree */
+    if (cacheFile != NULL && !options.checked && declarations != NULL) {
+        if (check(declarations) == TYPE_CHECKER_FAILURE) {
+            output_printf("Interpreter error\n");
+            release(&state, &arena, &source, &cacheFile);
+            return EXIT_FAILURE;
+        }
+
+        cache_store(cacheFile, source->text, source->size, declarations);
+        options.checked = true;
+    }
 
     // TypeCheckerStatus status = check(declarations);
     // if (status == TYPE_CHECKER_FAILURE) {
-    //     printf("Type checker error\n");
-    //     list_free(&declarations);
+    //     output_printf("Type checker error\n");
+    //     release(&state, &arena, &source);
     //     return EXIT_FAILURE;
     // }
 
-    if (eval(declarations) == INTERPRETER_FAILURE) {
-        printf("Interpreter error\n");
-        list_free(&declarations);
+    InterpreterStatus status = useVM ? vm_eval_with_options(declarations, options) : eval_with_options(declarations, options);
+
+    if (status == INTERPRETER_FAILURE) {
+        output_printf("Interpreter error\n");
+        release(&state, &arena, &source, &cacheFile);
         return EXIT_FAILURE;
     }
 
-    if (declarations != NULL) {
-        // list_foreach(declaration, declarations) {
-        //     decl_to_string((Decl**) &declaration->value);
-        //     printf("\n");
-        // }
+    // if (declarations != NULL) {
+    //     list_foreach(declaration, declarations) {
+    //         decl_to_string((Decl**) &declaration->value);
+    //         output_printf("\n");
+    //     }
+    // }
 
-        list_free(&declarations);
-    }
+    release(&state, &arena, &source, &cacheFile);
 
     return EXIT_SUCCESS;
 }
+
+/* the tree engine recurses as deep as the script does, workers get room for the deep ones */
+#define WORKER_MIN_STACK_SIZE (64 * 1024 * 1024)
+
+typedef struct Job {
+    const char* path;
+    ByteBuffer* output; /* everything the script printed to stdout */
+    int status;
+    bool done;
+} Job;
+
+/*
+ * Scripts run on a fixed set of worker threads, each taking the next one
+ * nobody took yet. Every worker has its own arenas and pools and every
+ * script its own tables, so scripts share nothing but the builtin names and
+ * atomic types interned into the batch's tables before the workers started. Results are printed in the order the scripts
+ * were given, each as soon as it and the ones before it are done.
+ */
+typedef struct Batch {
+    Job* jobs;
+    size_t count;
+    size_t next;
+    bool useVM;
+    bool useCache;
+    InterpreterOptions options;
+    /* read by every worker, written only before they start */
+    SymbolTable* builtinSymbols;
+    TypeTable* builtinTypes;
+    pthread_mutex_t lock;
+    pthread_cond_t finished;
+} Batch;
+
+static void* batch_worker(void* context) {
+    Batch* batch = context;
+
+    for (;;) {
+        pthread_mutex_lock(&batch->lock);
+        size_t index = batch->next < batch->count ? batch->next++ : batch->count;
+        pthread_mutex_unlock(&batch->lock);
+
+        if (index == batch->count)
+            break;
+
+        Job* job = &batch->jobs[index];
+
+        ByteBuffer* output = byte_buffer_new();
+        output_capture(output);
+        int status = run_file(job->path, batch->useVM, batch->useCache, batch->options,
+            batch->builtinSymbols, batch->builtinTypes);
+        output_capture(NULL);
+
+        pthread_mutex_lock(&batch->lock);
+        job->output = output;
+        job->status = status;
+        job->done = true;
+        pthread_cond_signal(&batch->finished);
+        pthread_mutex_unlock(&batch->lock);
+    }
+
+    return NULL;
+}
+
+static int run_batch(char** paths, size_t count, size_t jobs, bool useVM, bool useCache, InterpreterOptions options) {
+    Batch batch = {
+        .jobs = safe_calloc(count, sizeof(Job), NULL),
+        .count = count,
+        .next = 0,
+        .useVM = useVM,
+        .useCache = useCache,
+        .options = options,
+        .builtinSymbols = symbol_table_new(NULL),
+        .builtinTypes = type_table_new(NULL)
+    };
+
+    if (batch.jobs == NULL || batch.builtinSymbols == NULL || batch.builtinTypes == NULL) {
+        safe_free((void**) &batch.jobs);
+        type_table_free(&batch.builtinTypes);
+        symbol_table_free(&batch.builtinSymbols);
+        return EXIT_FAILURE;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        batch.jobs[i].path = paths[i];
+    }
+
+    pthread_mutex_init(&batch.lock, NULL);
+    pthread_cond_init(&batch.finished, NULL);
+
+    symbol_table_set_active(batch.builtinSymbols);
+    type_table_set_active(batch.builtinTypes);
+    eval_intern_builtins();
+    symbol_table_set_active(NULL);
+    type_table_set_active(NULL);
+
+    if (jobs > count) {
+        jobs = count;
+    }
+
+    size_t stackSize = WORKER_MIN_STACK_SIZE;
+
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_STACK, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY && limit.rlim_cur > stackSize) {
+        stackSize = limit.rlim_cur;
+    }
+
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+    pthread_attr_setstacksize(&attributes, stackSize);
+
+    pthread_t* workers = safe_calloc(jobs, sizeof(pthread_t), NULL);
+
+    size_t started = 0;
+    while (workers != NULL && started < jobs && pthread_create(&workers[started], &attributes, batch_worker, &batch) == 0) {
+        started++;
+    }
+
+    pthread_attr_destroy(&attributes);
+
+    if (started == 0) {
+        fprintf(stderr, "error: could not start any worker\n");
+        safe_free((void**) &workers);
+        safe_free((void**) &batch.jobs);
+        type_table_free(&batch.builtinTypes);
+        symbol_table_free(&batch.builtinSymbols);
+        return EXIT_FAILURE;
+    }
+
+    int status = EXIT_SUCCESS;
+
+    for (size_t i = 0; i < count; i++) {
+        Job* job = &batch.jobs[i];
+
+        pthread_mutex_lock(&batch.lock);
+        while (!job->done) {
+            pthread_cond_wait(&batch.finished, &batch.lock);
+        }
+        pthread_mutex_unlock(&batch.lock);
+
+        ByteBuffer* buffer = output_buffer();
+        size_t mark = buffer->size;
+        byte_buffer_append(buffer, job->output->bytes, job->output->size);
+        output_commit(mark);
+        byte_buffer_free(&job->output);
+
+        if (job->status != EXIT_SUCCESS) {
+            output_flush();
+            fprintf(stderr, "error: %s exited with status %d\n", job->path, job->status);
+            status = EXIT_FAILURE;
+        }
+    }
+
+    for (size_t i = 0; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+
+    pthread_cond_destroy(&batch.finished);
+    pthread_mutex_destroy(&batch.lock);
+
+    safe_free((void**) &workers);
+    safe_free((void**) &batch.jobs);
+
+    type_table_free(&batch.builtinTypes);
+    symbol_table_free(&batch.builtinSymbols);
+
+    output_free();
+
+    return status;
+}
+
+int main(int argc, char* argv[]) {
+    bool useVM = false;
+    bool useCache = false;
+    bool useStream = false;
+    size_t jobs = 0;
+    char** paths = safe_calloc(argc, sizeof(char*), NULL);
+    size_t pathCount = 0;
+    InterpreterOptions options = {0};
+    size_t outputCapacity = OUTPUT_DEFAULT_CAPACITY;
+    OutputMode outputMode = OUTPUT_AUTO;
+    bool badOption = false;
+
+    if (paths == NULL)
+        return EXIT_FAILURE;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--engine=vm") == 0) {
+            useVM = true;
+        } else if (strcmp(argv[i], "--engine=tree") == 0) {
+            useVM = false;
+        } else if (strncmp(argv[i], "--gc-threshold=", strlen("--gc-threshold=")) == 0) {
+            options.gcThreshold = strtoull(argv[i] + strlen("--gc-threshold="), NULL, 10);
+        } else if (strcmp(argv[i], "--gc-stats") == 0) {
+            options.gcStats = true;
+        } else if (strncmp(argv[i], "--output-buffer=", strlen("--output-buffer=")) == 0) {
+            outputCapacity = strtoull(argv[i] + strlen("--output-buffer="), NULL, 10);
+        } else if (strcmp(argv[i], "--output=line") == 0) {
+            outputMode = OUTPUT_LINE_BUFFERED;
+        } else if (strcmp(argv[i], "--output=full") == 0) {
+            outputMode = OUTPUT_FULLY_BUFFERED;
+        } else if (strcmp(argv[i], "--cache") == 0) {
+            useCache = true;
+        } else if (strcmp(argv[i], "--stream") == 0) {
+            useStream = true;
+        } else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+            jobs = strtoull(argv[++i], NULL, 10);
+        } else if (strncmp(argv[i], "--jobs=", strlen("--jobs=")) == 0) {
+            jobs = strtoull(argv[i] + strlen("--jobs="), NULL, 10);
+        } else if (strncmp(argv[i], "-O", strlen("-O")) == 0) {
+            const char* level = argv[i] + strlen("-O");
+
+            if (*level == '\0') {
+                options.optimizationLevel = OPTIMIZER_LOCAL;
+            } else if (level[0] >= '0' && level[0] <= '0' + OPTIMIZER_FULL && level[1] == '\0') {
+                options.optimizationLevel = level[0] - '0';
+            } else {
+                fprintf(stderr, "error: unknown optimization level '%s', expected -O0, -O1, -O or -O2\n", argv[i]);
+                badOption = true;
+            }
+        } else {
+            paths[pathCount++] = argv[i];
+        }
+    }
+
+    if (badOption || pathCount == 0 || (pathCount > 1 && jobs == 0)) {
+        output_printf("Usage: %s [--engine=tree|vm] [--gc-threshold=BYTES] [--gc-stats] [--output-buffer=BYTES] [--output=line|full] [--cache] [--stream] [-O[0|1|2]] file.rose\n", argv[0]);
+        output_printf("       %s --jobs N [options] file.rose...\n", argv[0]);
+        safe_free((void**) &paths);
+        return EXIT_FAILURE;
+    }
+
+    output_configure(outputCapacity, outputMode);
+
+    int status = EXIT_FAILURE;
+
+    if (useStream && useVM) {
+        /* the vm compiles the whole program before running it */
+        fprintf(stderr, "error: --stream runs on the tree engine only\n");
+    } else if (useStream && jobs > 0) {
+        fprintf(stderr, "error: --stream runs one program at a time\n");
+    } else if (useStream) {
+        status = run_stream(paths[0], options);
+    } else if (jobs > 0) {
+        status = run_batch(paths, pathCount, jobs, useVM, useCache, options);
+    } else {
+        status = run_file(paths[0], useVM, useCache, options, NULL, NULL);
+    }
+
+    safe_free((void**) &paths);
+    output_free();
+
+    return status;
+}
@@ -1,3 +1,35 @@
+%code requires {
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "src/token.h"
+
+#ifndef YY_TYPEDEF_YY_SCANNER_T
+#define YY_TYPEDEF_YY_SCANNER_T
+typedef void* yyscan_t;
+#endif
+
+struct Decl;
+struct SymbolTable;
+struct TypeTable;
+
+/* what one parse reads and produces, so any number of them can run at once */
+typedef struct ParserState {
+    /* the run's own tables, every name and type the parse makes is interned into them */
+    struct SymbolTable* symbols;
+    struct TypeTable* types;
+    struct List* declarations;
+    bool success;
+    /* set by a streaming driver to take each top-level declaration as it is reduced */
+    void (*onDeclaration)(struct Decl* declaration, void* context);
+    void* context;
+    /* function literals reduced so far, closures made from them point into the tree */
+    size_t functionExpressions;
+} ParserState;
+
+}
+
 %code {
 
 #include <stdbool.h>
@@ -7,16 +39,28 @@
 
 #include "src/ast.h"
 #include "src/smem.h"
+#include "src/symbol.h"
+#include "src/types.h"
+
+extern int yylex(YYSTYPE* value, yyscan_t scanner);
+extern int yyget_lineno(yyscan_t scanner);
 
-bool success = true;
+void yyerror(yyscan_t scanner, ParserState* state, const char* message);
 
-extern int yylineno;
+static List* add_declaration(ParserState* state, List* list, Decl* declaration) {
+    if (state->onDeclaration != NULL) {
+        state->onDeclaration(declaration, state->context);
+        return NULL;
+    }
 
-extern int yylex(void);
+    if (list == NULL) {
+        list = list_new((void(*)(void**)) decl_free);
+    }
 
-void yyerror(const char*);
+    list_insert_last(&list, declaration);
 
-extern List* declarations;
+    return list;
+}
 
 }
 
@@ -91,6 +135,7 @@ extern List* declarations;
     TRUE     "true"
     FALSE    "false"
     STRUCT   "struct"
+    MAP      "map"
 
     TYPE_INT    "int"
     TYPE_FLOAT  "float"
@@ -101,23 +146,26 @@ extern List* declarations;
     ;
 
 %union {
-    char*  str_value;
-    int    int_value;
-    double float_value;
-    char   char_value;
+    char*     str_value;
+    long long int_value;
+    double    float_value;
+    char      char_value;
+    Span      span_t;
 
     struct Token* token_t;
 
     struct Type* type_t;
 
     struct List* list_t;
+    struct Vector* vector_t;
 
     struct Decl* decl_t;
     struct Stmt* stmt_t;
     struct Expr* expr_t;
 }
 
-%token <str_value> ILLEGAL IDENT STRING
+%token <str_value> ILLEGAL
+%token <span_t> IDENT STRING
 %token <int_value> INT
 %token <float_value> FLOAT
 %token <char_value> CHAR
@@ -126,13 +174,14 @@ extern List* declarations;
                 ShiftOperator RelationalOperator EqualityOperator AssignmentOperator
 
 %nterm <type_t> TypeDeclaration StructType AtomicType FunctionType ArrayType
-                ArrayDimension ValidArrayType NamedType FunctionReturnType
+                ArrayDimension ValidArrayType NamedType FunctionReturnType MapType
 
 %nterm <list_t> Declarations ArrayArguments FunctionParameterTypeList StructArguments
-                StructInitializationListExpression CallExpressionArguments
-                StructFieldsDeclaration FunctionParametersDeclaration
-                StructNamedTypesDeclaration ArrayDimensionList MemberAccessList
-                ArrayIndexAccessList
+                StructInitializationListExpression StructFieldsDeclaration
+                FunctionParametersDeclaration StructNamedTypesDeclaration
+                ArrayDimensionList MemberAccessList ArrayIndexAccessList
+
+%nterm <vector_t> BlockDeclarations CallExpressionArguments
 
 %nterm <decl_t> Statement StructDeclaration FunctionDeclaration IdentifierDeclaration
                 ConstDeclaration LetDeclaration Declaration ForInitializer
@@ -142,6 +191,7 @@ extern List* declarations;
 
 %nterm <expr_t> Expression StructArgumentsExpession StructInitializationExpression
                 Literal Identifier GroupExpression ArrayInitializationExpression
+                MapInitializationExpression MapArguments
                 PrimaryExpression CastExpression FunctionExpression PostfixExpression
                 MemberExpression CallExpression ArrayMemberExpression
                 UnaryExpression MultiplicativeExpression AdditiveExpression ShiftExpression
@@ -169,6 +219,19 @@ extern List* declarations;
 
 %define parse.error verbose
 
+/* yyparse for a whole file, yypush_parse for a driver feeding tokens as it reads them */
+%define api.push-pull both
+%define api.pure full
+
+%param {yyscan_t scanner}
+%parse-param {ParserState* state}
+
+/* the lexer and the actions intern through the active tables, which are this parse's */
+%initial-action {
+    symbol_table_set_active(state->symbols);
+    type_table_set_active(state->types);
+}
+
 %start Program
 
 %%
@@ -177,21 +240,18 @@ Program
     : %empty
     | Declarations
         {
-            declarations = $1;
+            state->declarations = $1;
         }
     ;
 
 Declarations
     : Declaration
         {
-            List* list = list_new((void(*)(void**)) decl_free);
-            list_insert_last(&list, $1);
-            $$ = list;
+            $$ = add_declaration(state, NULL, $1);
         }
     | Declarations Declaration
         {
-            list_insert_last(&$1, $2);
-            $$ = $1;
+            $$ = add_declaration(state, $1, $2);
         }
     ;
 
@@ -226,41 +286,37 @@ LetDeclaration
     : "let" IDENT
         {
             Decl* decl = NEW_LET_DECL(
-                NEW_TOKEN(TOKEN_IDENT, $2, yylineno),
+                NEW_TOKEN_AT(TOKEN_IDENT, $2, yyget_lineno(scanner)),
                 NULL,
                 NULL
             );
-            safe_free((void**) &$2);
             $$ = decl;
         }
     | "let" IDENT "=" Expression
         {
             Decl* decl = NEW_LET_DECL(
-                NEW_TOKEN(TOKEN_IDENT, $2, yylineno),
+                NEW_TOKEN_AT(TOKEN_IDENT, $2, yyget_lineno(scanner)),
                 NULL,
                 $4
             );
-            safe_free((void**) &$2);
             $$ = decl;
         }
     | "let" IDENT ":" TypeDeclaration
         {
             Decl* decl = NEW_LET_DECL(
-                NEW_TOKEN(TOKEN_IDENT, $2, yylineno),
+                NEW_TOKEN_AT(TOKEN_IDENT, $2, yyget_lineno(scanner)),
                 $4,
                 NULL
             );
-            safe_free((void**) &$2);
             $$ = decl;
         }
     | "let" IDENT ":" TypeDeclaration "=" Expression
         {
             Decl* decl = NEW_LET_DECL(
-                NEW_TOKEN(TOKEN_IDENT, $2, yylineno),
+                NEW_TOKEN_AT(TOKEN_IDENT, $2, yyget_lineno(scanner)),
                 $4,
                 $6
             );
-            safe_free((void**) &$2);
             $$ = decl;
         }
     ;
@@ -269,21 +325,19 @@ ConstDeclaration
     : "const" IDENT "=" Expression
         {
             Decl* decl = NEW_CONST_DECL(
-                NEW_TOKEN(TOKEN_IDENT, $2, yylineno),
+                NEW_TOKEN_AT(TOKEN_IDENT, $2, yyget_lineno(scanner)),
                 NULL,
                 $4
             );
-            safe_free((void**) &$2);
             $$ = decl;
         }
     | "const" IDENT ":" TypeDeclaration "=" Expression
         {
             Decl* decl = NEW_CONST_DECL(
-                NEW_TOKEN(TOKEN_IDENT, $2, yylineno),
+                NEW_TOKEN_AT(TOKEN_IDENT, $2, yyget_lineno(scanner)),
                 $4,
                 $6
             );
-            safe_free((void**) &$2);
             $$ = decl;
         }
     ;
@@ -292,22 +346,20 @@ FunctionDeclaration
     : "func" IDENT "(" FunctionParametersDeclaration ")" FunctionBody
         {
             Decl* decl = NEW_FUNCTION_DECL_WITH_PARAMS(
-                NEW_TOKEN(TOKEN_IDENT, $2, yylineno),
+                NEW_TOKEN_AT(TOKEN_IDENT, $2, yyget_lineno(scanner)),
                 $4,
                 $6
             );
-            safe_free((void**) &$2);
             $$ = decl;
         }
     | "func" IDENT "(" FunctionParametersDeclaration ")" ":" FunctionReturnType FunctionBody
         {
             Decl* decl = NEW_FUNCTION_DECL_WITH_PARAMS_AND_RETURN(
-                NEW_TOKEN(TOKEN_IDENT, $2, yylineno),
+                NEW_TOKEN_AT(TOKEN_IDENT, $2, yyget_lineno(scanner)),
                 $4,
                 $7,
                 $8
             );
-            safe_free((void**) &$2);
             $$ = decl;
         }
     ;
@@ -323,10 +375,9 @@ StructDeclaration
     : "struct" IDENT "{" StructFieldsDeclaration "}"
         {
             Decl* decl = NEW_STRUCT_DECL_WITH_FIELDS(
-                NEW_TOKEN(TOKEN_IDENT, $2, yylineno),
+                NEW_TOKEN_AT(TOKEN_IDENT, $2, yyget_lineno(scanner)),
                 $4
             );
-            safe_free((void**) &$2);
             $$ = decl;
         }
     ;
@@ -335,10 +386,9 @@ IdentifierDeclaration
     : IDENT ":" TypeDeclaration
         {
             Decl* decl = NEW_FIELD_DECL(
-                NEW_TOKEN(TOKEN_IDENT, $1, yylineno),
+                NEW_TOKEN_AT(TOKEN_IDENT, $1, yyget_lineno(scanner)),
                 $3
             );
-            safe_free((void**) &$1);
             $$ = decl;
         }
     ;
@@ -346,8 +396,7 @@ IdentifierDeclaration
 TypeDeclaration
     : IDENT
         {
-            Type* type = NEW_CUSTOM_TYPE(0, $1);
-            safe_free((void**) &$1);
+            Type* type = NEW_CUSTOM_TYPE(0, span_intern($1));
             $$ = type;
         }
     | AtomicType
@@ -366,6 +415,10 @@ TypeDeclaration
         {
             $$ = $1;
         }
+    | MapType
+        {
+            $$ = $1;
+        }
     ;
 
 AtomicType
@@ -402,11 +455,11 @@ AtomicType
 FunctionType
     : "func" "(" FunctionParameterTypeList ")"
         {
-            $$ = NEW_FUNCTION_TYPE_WITH_PARAMS($3);
+            $$ = type_intern(NEW_FUNCTION_TYPE_WITH_PARAMS($3));
         }
     | "func" "(" FunctionParameterTypeList ")" ":" FunctionReturnType
         {
-            $$ = NEW_FUNCTION_TYPE_WITH_PARAMS_AND_RETURN($3, $6);
+            $$ = type_intern(NEW_FUNCTION_TYPE_WITH_PARAMS_AND_RETURN($3, $6));
         }
     ;
 
@@ -460,7 +513,7 @@ StructType
                 0,
                 $3
             );
-            $$ = type;
+            $$ = type_intern(type);
         }
     ;
 
@@ -485,9 +538,8 @@ StructNamedTypesDeclaration
 NamedType
     : IDENT ":" TypeDeclaration
         {
-            Type* type = NEW_NAMED_TYPE($1, $3);
-            safe_free((void**) &$1);
-            $$ = type;
+            Type* type = NEW_NAMED_TYPE(span_intern($1), $3);
+            $$ = type_intern(type);
         }
     ;
 
@@ -509,15 +561,14 @@ ArrayType
     : ArrayDimensionList ValidArrayType
         {
             Type* type = NEW_ARRAY_TYPE_WITH_DIMENSION($1, $2);
-            $$ = type;
+            $$ = type_intern(type);
         }
     ;
 
 ValidArrayType
     : IDENT
         {
-            Type* type = NEW_CUSTOM_TYPE(0, $1);
-            safe_free((void**) &$1);
+            Type* type = NEW_CUSTOM_TYPE(0, span_intern($1));
             $$ = type;
         }
     | AtomicType
@@ -532,6 +583,10 @@ ValidArrayType
         {
             $$ = $1;
         }
+    | MapType
+        {
+            $$ = $1;
+        }
     ;
 
 ArrayDimensionList
@@ -559,6 +614,14 @@ ArrayDimension
         }
     ;
 
+MapType
+    : "map" "[" TypeDeclaration "]" TypeDeclaration
+        {
+            Type* type = NEW_MAP_TYPE($3, $5);
+            $$ = type_intern(type);
+        }
+    ;
+
 Statement
     : BlockStatement
         {
@@ -595,12 +658,26 @@ Statement
     ;
 
 BlockStatement
-    : "{" Declarations "}"
+    : "{" BlockDeclarations "}"
         {
             $$ = NEW_BLOCK_STMT_WITH_DECLS($2);
         }
     ;
 
+BlockDeclarations
+    : Declaration
+        {
+            Vector* vector = vector_new((void(*)(void**)) decl_free);
+            vector_push(&vector, $1);
+            $$ = vector;
+        }
+    | BlockDeclarations Declaration
+        {
+            vector_push(&$1, $2);
+            $$ = $1;
+        }
+    ;
+
 ReturnStatement
     : "return" Semicolon
         {
@@ -729,47 +806,47 @@ AssignmentExpression
 AssignmentOperator
     : "="
         {
-            $$ = NEW_TOKEN(TOKEN_ASSIGN, "=", yylineno);
+            $$ = NEW_TOKEN(TOKEN_ASSIGN, "=", yyget_lineno(scanner));
         }
     | "+="
         {
-            $$ = NEW_TOKEN(TOKEN_ADD_ASSIGN, "+=", yylineno);
+            $$ = NEW_TOKEN(TOKEN_ADD_ASSIGN, "+=", yyget_lineno(scanner));
         }
     | "-="
         {
-            $$ = NEW_TOKEN(TOKEN_SUB_ASSIGN, "-=", yylineno);
+            $$ = NEW_TOKEN(TOKEN_SUB_ASSIGN, "-=", yyget_lineno(scanner));
         }
     | "*="
         {
-            $$ = NEW_TOKEN(TOKEN_MUL_ASSIGN, "*=", yylineno);
+            $$ = NEW_TOKEN(TOKEN_MUL_ASSIGN, "*=", yyget_lineno(scanner));
         }
     | "/="
         {
-            $$ = NEW_TOKEN(TOKEN_QUO_ASSIGN, "/=", yylineno);
+            $$ = NEW_TOKEN(TOKEN_QUO_ASSIGN, "/=", yyget_lineno(scanner));
         }
     | "%="
         {
-            $$ = NEW_TOKEN(TOKEN_REM_ASSIGN, "%=", yylineno);
+            $$ = NEW_TOKEN(TOKEN_REM_ASSIGN, "%=", yyget_lineno(scanner));
         }
     | "&="
         {
-            $$ = NEW_TOKEN(TOKEN_AND_ASSIGN, "&=", yylineno);
+            $$ = NEW_TOKEN(TOKEN_AND_ASSIGN, "&=", yyget_lineno(scanner));
         }
     | "|="
         {
-            $$ = NEW_TOKEN(TOKEN_OR_ASSIGN, "|=", yylineno);
+            $$ = NEW_TOKEN(TOKEN_OR_ASSIGN, "|=", yyget_lineno(scanner));
         }
     | "^="
         {
-            $$ = NEW_TOKEN(TOKEN_XOR_ASSIGN, "^=", yylineno);
+            $$ = NEW_TOKEN(TOKEN_XOR_ASSIGN, "^=", yyget_lineno(scanner));
         }
     | "<<="
         {
-            $$ = NEW_TOKEN(TOKEN_SHL_ASSIGN, "<<=", yylineno);
+            $$ = NEW_TOKEN(TOKEN_SHL_ASSIGN, "<<=", yyget_lineno(scanner));
         }
     | ">>="
         {
-            $$ = NEW_TOKEN(TOKEN_SHR_ASSIGN, ">>=", yylineno);
+            $$ = NEW_TOKEN(TOKEN_SHR_ASSIGN, ">>=", yyget_lineno(scanner));
         }
     ;
 
@@ -793,7 +870,7 @@ LogicalOrExpression
         {
             $$ = NEW_LOGICAL_EXPR(
                 $1,
-                NEW_TOKEN(TOKEN_LOR, "||", yylineno),
+                NEW_TOKEN(TOKEN_LOR, "||", yyget_lineno(scanner)),
                 $3
             );
         }
@@ -808,7 +885,7 @@ LogicalAndExpression
         {
             $$ = NEW_LOGICAL_EXPR(
                 $1,
-                NEW_TOKEN(TOKEN_LAND, "&&", yylineno),
+                NEW_TOKEN(TOKEN_LAND, "&&", yyget_lineno(scanner)),
                 $3
             );
         }
@@ -823,7 +900,7 @@ OrExpression
         {
             $$ = NEW_BINARY_EXPR(
                 $1,
-                NEW_TOKEN(TOKEN_OR, "|", yylineno),
+                NEW_TOKEN(TOKEN_OR, "|", yyget_lineno(scanner)),
                 $3
             );
         }
@@ -838,7 +915,7 @@ XorExpression
         {
             $$ = NEW_BINARY_EXPR(
                 $1,
-                NEW_TOKEN(TOKEN_XOR, "^", yylineno),
+                NEW_TOKEN(TOKEN_XOR, "^", yyget_lineno(scanner)),
                 $3
             );
         }
@@ -853,7 +930,7 @@ AndExpression
         {
             $$ = NEW_BINARY_EXPR(
                 $1,
-                NEW_TOKEN(TOKEN_AND, "&", yylineno),
+                NEW_TOKEN(TOKEN_AND, "&", yyget_lineno(scanner)),
                 $3
             );
         }
@@ -873,11 +950,11 @@ EqualityExpression
 EqualityOperator
     : "=="
         {
-            $$ = NEW_TOKEN(TOKEN_EQL, "==", yylineno);
+            $$ = NEW_TOKEN(TOKEN_EQL, "==", yyget_lineno(scanner));
         }
     | "!="
         {
-            $$ = NEW_TOKEN(TOKEN_NEQ, "!=", yylineno);
+            $$ = NEW_TOKEN(TOKEN_NEQ, "!=", yyget_lineno(scanner));
         }
     ;
 
@@ -895,19 +972,19 @@ RelationalExpression
 RelationalOperator
     : "<"
         {
-            $$ = NEW_TOKEN(TOKEN_LSS, "<", yylineno);
+            $$ = NEW_TOKEN(TOKEN_LSS, "<", yyget_lineno(scanner));
         }
     | ">"
         {
-            $$ = NEW_TOKEN(TOKEN_GTR, ">", yylineno);
+            $$ = NEW_TOKEN(TOKEN_GTR, ">", yyget_lineno(scanner));
         }
     | "<="
         {
-            $$ = NEW_TOKEN(TOKEN_LEQ, "<=", yylineno);
+            $$ = NEW_TOKEN(TOKEN_LEQ, "<=", yyget_lineno(scanner));
         }
     | ">="
         {
-            $$ = NEW_TOKEN(TOKEN_GEQ, ">=", yylineno);
+            $$ = NEW_TOKEN(TOKEN_GEQ, ">=", yyget_lineno(scanner));
         }
     ;
 
@@ -925,11 +1002,11 @@ ShiftExpression
 ShiftOperator
     : "<<"
         {
-            $$ = NEW_TOKEN(TOKEN_SHL, "<<", yylineno);
+            $$ = NEW_TOKEN(TOKEN_SHL, "<<", yyget_lineno(scanner));
         }
     | ">>"
         {
-            $$ = NEW_TOKEN(TOKEN_SHR, ">>", yylineno);
+            $$ = NEW_TOKEN(TOKEN_SHR, ">>", yyget_lineno(scanner));
         }
     ;
 
@@ -947,11 +1024,11 @@ AdditiveExpression
 AdditiveOperator
     : "+"
         {
-            $$ = NEW_TOKEN(TOKEN_ADD, "+", yylineno);
+            $$ = NEW_TOKEN(TOKEN_ADD, "+", yyget_lineno(scanner));
         }
     | "-"
         {
-            $$ = NEW_TOKEN(TOKEN_SUB, "-", yylineno);
+            $$ = NEW_TOKEN(TOKEN_SUB, "-", yyget_lineno(scanner));
         }
     ;
 
@@ -969,15 +1046,15 @@ MultiplicativeExpression
 MultiplicativeOperator
     : "*"
         {
-            $$ = NEW_TOKEN(TOKEN_MUL, "*", yylineno);
+            $$ = NEW_TOKEN(TOKEN_MUL, "*", yyget_lineno(scanner));
         }
     | "/"
         {
-            $$ = NEW_TOKEN(TOKEN_QUO, "/", yylineno);
+            $$ = NEW_TOKEN(TOKEN_QUO, "/", yyget_lineno(scanner));
         }
     | "%"
         {
-            $$ = NEW_TOKEN(TOKEN_REM, "%", yylineno);
+            $$ = NEW_TOKEN(TOKEN_REM, "%", yyget_lineno(scanner));
         }
     ;
 
@@ -995,19 +1072,19 @@ UnaryExpression
 UnaryOperator
     : "+"
         {
-            $$ = NEW_TOKEN(TOKEN_ADD, "+", yylineno);
+            $$ = NEW_TOKEN(TOKEN_ADD, "+", yyget_lineno(scanner));
         }
     | "-"
         {
-            $$ = NEW_TOKEN(TOKEN_SUB, "-", yylineno);
+            $$ = NEW_TOKEN(TOKEN_SUB, "-", yyget_lineno(scanner));
         }
     | "~"
         {
-            $$ = NEW_TOKEN(TOKEN_TILDE, "~", yylineno);
+            $$ = NEW_TOKEN(TOKEN_TILDE, "~", yyget_lineno(scanner));
         }
     | "!"
         {
-            $$ = NEW_TOKEN(TOKEN_NOT, "!", yylineno);
+            $$ = NEW_TOKEN(TOKEN_NOT, "!", yyget_lineno(scanner));
         }
     ;
 
@@ -1041,11 +1118,11 @@ PostfixExpression
 PostfixOperator
     : "++"
         {
-            $$ = NEW_TOKEN(TOKEN_INC, "++", yylineno);
+            $$ = NEW_TOKEN(TOKEN_INC, "++", yyget_lineno(scanner));
         }
     | "--"
         {
-            $$ = NEW_TOKEN(TOKEN_DEC, "--", yylineno);
+            $$ = NEW_TOKEN(TOKEN_DEC, "--", yyget_lineno(scanner));
         }
     ;
 
@@ -1080,17 +1157,17 @@ CallExpression
 CallExpressionArguments
     : %empty
         {
-            $$ = list_new((void (*)(void**)) expr_free);
+            $$ = vector_new((void (*)(void**)) expr_free);
         }
     | Expression
         {
-            List* list = list_new((void (*)(void**)) expr_free);
-            list_insert_last(&list, $1);
-            $$ = list;
+            Vector* vector = vector_new((void (*)(void**)) expr_free);
+            vector_push(&vector, $1);
+            $$ = vector;
         }
     | CallExpressionArguments "," Expression
         {
-            list_insert_last(&$1, $3);
+            vector_push(&$1, $3);
             $$ = $1;
         }
     ;
@@ -1152,6 +1229,10 @@ PrimaryExpression
         {
             $$ = $1;
         }
+    | MapInitializationExpression
+        {
+            $$ = $1;
+        }
     ;
 
 GroupExpression
@@ -1164,8 +1245,7 @@ GroupExpression
 Identifier
     : IDENT
         {
-            Expr* expr = NEW_IDENT_LITERAL($1);
-            safe_free((void**) &$1);
+            Expr* expr = NEW_IDENT_LITERAL(span_intern($1));
             $$ = expr;
         }
     ;
@@ -1185,9 +1265,8 @@ Literal
         }
     | STRING
         {
-            Expr* expr = NEW_STRING_LITERAL($1);
-            safe_free((void**) &$1);
-            $$ = expr;
+            /* the text between the quotes, copied once straight from the source */
+            $$ = NEW_STRING_LITERAL_WITH_LENGTH(span_text($1) + 1, $1.length - 2);
         }
     | TRUE
         {
@@ -1206,10 +1285,12 @@ Literal
 FunctionExpression
     : "func" "(" FunctionParametersDeclaration ")" FunctionBody
         {
+            state->functionExpressions++;
             $$ = NEW_FUNCTION_EXPR_WITH_PARAMS($3, $5);
         }
     | "func" "(" FunctionParametersDeclaration ")" ":" FunctionReturnType FunctionBody
         {
+            state->functionExpressions++;
             $$ = NEW_FUNCTION_EXPR_WITH_PARAMS_AND_RETURN($3, $6, $7);
         }
     ;
@@ -1218,10 +1299,9 @@ StructInitializationExpression
     : IDENT StructInitializationListExpression
         {
             Expr* expr = NEW_STRUCT_INIT_EXPR_WITH_FIELDS(
-                NEW_TOKEN(TOKEN_STRING, $1, yylineno),
+                NEW_TOKEN_AT(TOKEN_STRING, $1, yyget_lineno(scanner)),
                 $2
             );
-            safe_free((void**) &$1);
             $$ = expr;
         }
     | StructType StructInitializationListExpression
@@ -1259,12 +1339,10 @@ StructArgumentsExpession
     : IDENT ":" Expression
         {
             Expr* expr = NEW_FIELD_EXPR(
-                NEW_TOKEN(TOKEN_STRING, $1, yylineno),
+                NEW_TOKEN_AT(TOKEN_STRING, $1, yyget_lineno(scanner)),
                 $3
             );
 
-            safe_free((void**) &$1);
-
             $$ = expr;
         }
     ;
@@ -1294,9 +1372,35 @@ ArrayArguments
         }
     ;
 
+MapInitializationExpression
+    : MapType "{" MapArguments "}"
+        {
+            ((MapInitExpr*) $3->expr)->type = $1;
+            $$ = $3;
+        }
+    ;
+
+MapArguments
+    : %empty
+        {
+            $$ = NEW_MAP_INIT_EXPR(NULL);
+        }
+    | Expression ":" Expression
+        {
+            Expr* expr = NEW_MAP_INIT_EXPR(NULL);
+            MAP_INIT_EXPR_ADD_ENTRY(expr, $1, $3);
+            $$ = expr;
+        }
+    | MapArguments "," Expression ":" Expression
+        {
+            MAP_INIT_EXPR_ADD_ENTRY($1, $3, $5);
+            $$ = $1;
+        }
+    ;
+
 %%
 
-void yyerror(const char* message) {
-    fprintf(stderr, "[Line: %d]: %s\n", yylineno, message);
-    success = false;
+void yyerror(yyscan_t scanner, ParserState* state, const char* message) {
+    fprintf(stderr, "[Line: %d]: %s\n", yyget_lineno(scanner), message);
+    state->success = false;
 }
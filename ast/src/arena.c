@@ -0,0 +1,165 @@
+#include "arena.h"
+
+#include <string.h>
+
+#include "smem.h"
+#include "utils.h"
+
+
+static _Thread_local Arena* active = NULL;
+
+#define ALIGN_UP(n) (((n) + ARENA_ALIGNMENT - 1) & ~((size_t) ARENA_ALIGNMENT - 1))
+
+#define CHUNK_HEADER_SIZE ALIGN_UP(sizeof(ArenaChunk))
+
+static ArenaChunk* chunk_new(size_t size) {
+    ArenaChunk* chunk = NULL;
+    chunk = safe_malloc(CHUNK_HEADER_SIZE + size, NULL);
+    if (chunk == NULL) {
+        return NULL;
+    }
+
+    *chunk = (ArenaChunk) {
+        .next = NULL,
+        .size = size,
+        .used = 0
+    };
+
+    return chunk;
+}
+
+Arena* arena_new(size_t chunkSize) {
+    Arena* arena = NULL;
+    arena = safe_malloc(sizeof(Arena), NULL);
+    if (arena == NULL) {
+        return NULL;
+    }
+
+    *arena = (Arena) {
+        .chunks = NULL,
+        .chunkSize = chunkSize > 0 ? ALIGN_UP(chunkSize) : ARENA_DEFAULT_CHUNK_SIZE,
+        .bytesAllocated = 0
+    };
+
+    return arena;
+}
+
+void* arena_alloc(Arena* arena, size_t size) {
+    if (arena == NULL || size < 1)
+        return NULL;
+
+    size = ALIGN_UP(size);
+
+    ArenaChunk* chunk = arena->chunks;
+
+    if (chunk == NULL || chunk->size - chunk->used < size) {
+        /* oversized requests get a chunk of their own behind the current one */
+        if (size > arena->chunkSize / 4 && chunk != NULL) {
+            ArenaChunk* large = chunk_new(size);
+            if (large == NULL)
+                return NULL;
+
+            large->next = chunk->next;
+            chunk->next = large;
+            large->used = size;
+            arena->bytesAllocated += size;
+
+            return (char*) large + CHUNK_HEADER_SIZE;
+        }
+
+        chunk = chunk_new(size > arena->chunkSize ? size : arena->chunkSize);
+        if (chunk == NULL)
+            return NULL;
+
+        chunk->next = arena->chunks;
+        arena->chunks = chunk;
+    }
+
+    void* ptr = (char*) chunk + CHUNK_HEADER_SIZE + chunk->used;
+
+    chunk->used += size;
+    arena->bytesAllocated += size;
+
+    return ptr;
+}
+
+char* arena_str_dup(Arena* arena, const char* str) {
+    if (arena == NULL || str == NULL)
+        return NULL;
+
+    size_t len = strlen(str);
+
+    char* copy = arena_alloc(arena, len + 1);
+    if (copy == NULL)
+        return NULL;
+
+    memcpy(copy, str, len + 1);
+
+    return copy;
+}
+
+void arena_free(Arena** arena) {
+    if (arena == NULL || *arena == NULL)
+        return;
+
+    if (active == *arena) {
+        active = NULL;
+    }
+
+    ArenaChunk* chunk = (*arena)->chunks;
+    while (chunk != NULL) {
+        ArenaChunk* next = chunk->next;
+        safe_free((void**) &chunk);
+        chunk = next;
+    }
+
+    safe_free((void**) arena);
+}
+
+void arena_reset(Arena* arena) {
+    if (arena == NULL)
+        return;
+
+    /* one regular chunk is kept so refilling the arena does not go back to malloc */
+    ArenaChunk* kept = NULL;
+
+    ArenaChunk* chunk = arena->chunks;
+    while (chunk != NULL) {
+        ArenaChunk* next = chunk->next;
+
+        if (kept == NULL && chunk->size == arena->chunkSize) {
+            kept = chunk;
+            kept->next = NULL;
+            kept->used = 0;
+        } else {
+            safe_free((void**) &chunk);
+        }
+
+        chunk = next;
+    }
+
+    arena->chunks = kept;
+    arena->bytesAllocated = 0;
+}
+
+void arena_set_active(Arena* arena) {
+    active = arena;
+}
+
+Arena* arena_active(void) {
+    return active;
+}
+
+void* arena_active_alloc(size_t size) {
+    if (active == NULL)
+        return safe_malloc(size, NULL);
+
+    return arena_alloc(active, size);
+}
+
+char* arena_active_str_dup(const char* str) {
+    if (active == NULL)
+        return str_dup(str);
+
+    return arena_str_dup(active, str);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stddef.h>
+
+
+#define ARENA_DEFAULT_CHUNK_SIZE (64 * 1024)
+#define ARENA_ALIGNMENT 16
+
+typedef struct ArenaChunk {
+    struct ArenaChunk* next;
+    size_t size;
+    size_t used;
+} ArenaChunk;
+
+/*
+ * Bump allocator for data that lives and dies together, such as the AST of
+ * one compilation unit. Allocations are never freed one by one: arena_free
+ * drops every chunk at once.
+ *
+ * While an arena is active, the AST, token, literal and list constructors
+ * allocate from it, so a tree built by the parser is laid out in parse order
+ * and must be released with arena_free instead of the *_free walk. Each
+ * thread has its own active arena.
+ */
+typedef struct Arena {
+    ArenaChunk* chunks;
+    size_t chunkSize;
+    size_t bytesAllocated;
+} Arena;
+
+Arena* arena_new(size_t chunkSize);
+void* arena_alloc(Arena* arena, size_t size);
+char* arena_str_dup(Arena* arena, const char* str);
+void arena_free(Arena** arena);
+/* drops everything allocated so far, the arena can be filled again */
+void arena_reset(Arena* arena);
+
+void arena_set_active(Arena* arena);
+Arena* arena_active(void);
+
+void* arena_active_alloc(size_t size);
+char* arena_active_str_dup(const char* str);
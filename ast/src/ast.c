@@ -2,7 +2,9 @@
 
 #include <stdio.h>
 
+#include "arena.h"
 #include "list.h"
+#include "output.h"
 #include "token.h"
 #include "types.h"
 #include "smem.h"
@@ -10,7 +12,7 @@
 
 Decl* decl_new(DeclType type, void* decl, void (*to_string)(void**), void (*destroy)(void**)) {
     Decl* new_decl = NULL;
-    new_decl = safe_malloc(sizeof(Decl), NULL);
+    new_decl = arena_active_alloc(sizeof(Decl));
     if (new_decl == NULL) {
         if (destroy != NULL) {
             destroy(&decl);
@@ -48,7 +50,7 @@ void decl_free(Decl** decl) {
 
 Stmt* stmt_new(StmtType type, void* stmt, void (*to_string)(void**), void (*destroy)(void**)) {
     Stmt* new_stmt = NULL;
-    new_stmt = safe_malloc(sizeof(Expr), NULL);
+    new_stmt = arena_active_alloc(sizeof(Expr));
     if (new_stmt == NULL) {
         if (destroy != NULL) {
             destroy(&stmt);
@@ -86,7 +88,7 @@ void stmt_free(Stmt** stmt) {
 
 Expr* expr_new(ExprType type, void* expr, void (*to_string)(void**), void (*destroy)(void**)) {
     Expr* new_expr = NULL;
-    new_expr = safe_malloc(sizeof(Expr), NULL);
+    new_expr = arena_active_alloc(sizeof(Expr));
     if (new_expr == NULL) {
         if (destroy != NULL) {
             destroy(&expr);
@@ -97,6 +99,7 @@ Expr* expr_new(ExprType type, void* expr, void (*to_string)(void**), void (*dest
     *new_expr = (Expr) {
         .type = type,
         .expr = expr,
+        .resolvedType = NULL,
         .to_string = to_string,
         .destroy = destroy
     };
@@ -124,7 +127,7 @@ void expr_free(Expr** expr) {
 
 LetDecl* let_decl_new(Token* name, Type* type, Expr* expression) {
     LetDecl* decl = NULL;
-    decl = safe_malloc(sizeof(LetDecl), NULL);
+    decl = arena_active_alloc(sizeof(LetDecl));
     if (decl == NULL) {
         token_free(&name);
         type_free(&type);
@@ -135,7 +138,8 @@ LetDecl* let_decl_new(Token* name, Type* type, Expr* expression) {
     *decl = (LetDecl) {
         .name = name,
         .type = type,
-        .expression = expression
+        .expression = expression,
+        .slot = -1
     };
 
     return decl;
@@ -145,16 +149,16 @@ void let_decl_to_string(LetDecl** letDecl) {
     if (letDecl == NULL || *letDecl == NULL)
         return;
 
-    printf("let ");
+    output_printf("let ");
 
     token_to_string(&(*letDecl)->name);
 
     if ((*letDecl)->type != NULL) {
-        printf(": ");
+        output_printf(": ");
         type_to_string(&(*letDecl)->type);
     }
 
-    printf(" = ");
+    output_printf(" = ");
 
     expr_to_string(&(*letDecl)->expression);
 }
@@ -172,7 +176,7 @@ void let_decl_free(LetDecl** letDecl) {
 
 ConstDecl* const_decl_new(Token* name, Type* type, Expr* expression) {
     ConstDecl* decl = NULL;
-    decl = safe_malloc(sizeof(ConstDecl), NULL);
+    decl = arena_active_alloc(sizeof(ConstDecl));
     if (decl == NULL) {
         token_free(&name);
         type_free(&type);
@@ -183,7 +187,8 @@ ConstDecl* const_decl_new(Token* name, Type* type, Expr* expression) {
     *decl = (ConstDecl) {
         .name = name,
         .type = type,
-        .expression = expression
+        .expression = expression,
+        .slot = -1
     };
 
     return decl;
@@ -193,16 +198,16 @@ void const_decl_to_string(ConstDecl** constDecl) {
     if (constDecl == NULL || *constDecl == NULL)
         return;
 
-    printf("const ");
+    output_printf("const ");
 
     token_to_string(&(*constDecl)->name);
 
     if ((*constDecl)->type != NULL) {
-        printf(": ");
+        output_printf(": ");
         type_to_string(&(*constDecl)->type);
     }
 
-    printf(" = ");
+    output_printf(" = ");
 
     expr_to_string(&(*constDecl)->expression);
 }
@@ -220,7 +225,7 @@ void const_decl_free(ConstDecl** constDecl) {
 
 FunctionDecl* function_decl_new(Token* name, List* parameters, Type* returnType, Stmt* body) {
     FunctionDecl* decl = NULL;
-    decl = safe_malloc(sizeof(FunctionDecl), NULL);
+    decl = arena_active_alloc(sizeof(FunctionDecl));
     if (decl == NULL) {
         token_free(&name);
         list_free(&parameters);
@@ -233,7 +238,10 @@ FunctionDecl* function_decl_new(Token* name, List* parameters, Type* returnType,
         .name = name,
         .parameters = parameters,
         .returnType = returnType,
-        .body = body
+        .body = body,
+        .functionType = NULL,
+        .slot = -1,
+        .scope = {0}
     };
 
     return decl;
@@ -250,32 +258,32 @@ void function_decl_to_string(FunctionDecl** functionDecl) {
     if (functionDecl == NULL || *functionDecl == NULL)
         return;
 
-    printf("func ");
+    output_printf("func ");
 
     token_to_string(&(*functionDecl)->name);
 
-    printf("(");
+    output_printf("(");
 
     List* params = (*functionDecl)->parameters;
     if (!list_is_empty(&params)) {
         list_foreach(param, params) {
-            expr_to_string((Expr**) &param->value);
+            decl_to_string((Decl**) &param->value);
 
             if (param->next != NULL) {
-                printf(", ");
+                output_printf(", ");
             }
         }
     }
 
-    printf(")");
+    output_printf(")");
 
     if ((*functionDecl)->returnType != NULL) {
-        printf(": ");
+        output_printf(": ");
 
         type_to_string(&(*functionDecl)->returnType);
     }
 
-    printf(" ");
+    output_printf(" ");
 
     stmt_to_string(&(*functionDecl)->body);
 }
@@ -294,7 +302,7 @@ void function_decl_free(FunctionDecl** functionDecl) {
 
 FieldDecl* field_decl_new(Token* name, Type* type) {
     FieldDecl* decl = NULL;
-    decl = safe_malloc(sizeof(FieldDecl), NULL);
+    decl = arena_active_alloc(sizeof(FieldDecl));
     if (decl == NULL) {
         token_free(&name);
         type_free(&type);
@@ -315,7 +323,7 @@ void field_decl_to_string(FieldDecl** fieldDecl) {
 
     token_to_string(&(*fieldDecl)->name);
 
-    printf(": ");
+    output_printf(": ");
 
     type_to_string(&(*fieldDecl)->type);
 }
@@ -332,7 +340,7 @@ void field_decl_free(FieldDecl** fieldDecl) {
 
 StructDecl* struct_decl_new(Token* name, List* fields) {
     StructDecl* decl = NULL;
-    decl = safe_malloc(sizeof(StructDecl), NULL);
+    decl = arena_active_alloc(sizeof(StructDecl));
     if (decl == NULL) {
         token_free(&name);
         list_free(&fields);
@@ -358,33 +366,33 @@ void struct_decl_to_string(StructDecl** structDecl) {
     if (structDecl == NULL || *structDecl == NULL)
         return;
 
-    printf("struct ");
+    output_printf("struct ");
 
     if ((*structDecl)->name != NULL) {
         token_to_string(&(*structDecl)->name);
-        printf(" ");
+        output_printf(" ");
     }
 
-    printf("{");
+    output_printf("{");
 
     List* fields = (*structDecl)->fields;
     if (!list_is_empty(&fields)) {
-        printf("\n");
+        output_printf("\n");
 
         list_foreach(field, fields) {
-            printf("\t");
+            output_printf("\t");
 
             type_to_string((Type**) &field->value);
 
             if (field->next != NULL) {
-                printf("\n");
+                output_printf("\n");
             }
         }
 
-        printf("\n");
+        output_printf("\n");
     }
 
-    printf("}");
+    output_printf("}");
 }
 
 void struct_decl_free(StructDecl** structDecl) {
@@ -399,7 +407,7 @@ void struct_decl_free(StructDecl** structDecl) {
 
 StmtDecl* stmt_decl_new(Stmt* stmt) {
     StmtDecl* decl = NULL;
-    decl = safe_malloc(sizeof(StmtDecl), NULL);
+    decl = arena_active_alloc(sizeof(StmtDecl));
     if (decl == NULL) {
         stmt_free(&stmt);
         return NULL;
@@ -428,16 +436,17 @@ void stmt_decl_free(StmtDecl** stmtDecl) {
     safe_free((void**) stmtDecl);
 }
 
-BlockStmt* block_stmt_new(List* declarations) {
+BlockStmt* block_stmt_new(Vector* declarations) {
     BlockStmt* stmt = NULL;
-    stmt = safe_malloc(sizeof(BlockStmt), NULL);
+    stmt = arena_active_alloc(sizeof(BlockStmt));
     if (stmt == NULL) {
-        list_free(&declarations);
+        vector_free(&declarations);
         return NULL;
     }
 
     *stmt = (BlockStmt) {
-        .declarations = declarations
+        .declarations = declarations,
+        .scope = {0}
     };
 
     return stmt;
@@ -447,41 +456,41 @@ void block_stmt_add_declaration(BlockStmt** blockStmt, Decl* declaration) {
     if (blockStmt == NULL || *blockStmt == NULL || declaration == NULL)
         return;
 
-    list_insert_last(&(*blockStmt)->declarations, declaration);
+    vector_push(&(*blockStmt)->declarations, declaration);
 }
 
 void block_stmt_to_string(BlockStmt** blockStmt) {
     if (blockStmt == NULL || *blockStmt == NULL)
         return;
 
-    printf("{");
+    output_printf("{");
 
-    List* args = (*blockStmt)->declarations;
-    if (!list_is_empty(&args)) {
-        printf("\n");
+    Vector* args = (*blockStmt)->declarations;
+    if (!vector_is_empty(&args)) {
+        output_printf("\n");
 
-        list_foreach(arg, args) {
-            decl_to_string((Decl**) &arg->value);
+        vector_foreach(arg, args) {
+            decl_to_string((Decl**) arg);
 
-            printf("\n");
+            output_printf("\n");
         }
     }
 
-    printf("}");
+    output_printf("}");
 }
 
 void block_stmt_free(BlockStmt** blockStmt) {
     if (blockStmt == NULL || *blockStmt == NULL)
         return;
 
-    list_free(&(*blockStmt)->declarations);
+    vector_free(&(*blockStmt)->declarations);
 
     safe_free((void**) blockStmt);
 }
 
 ExpressionStmt* expression_stmt_new(Expr* expression) {
     ExpressionStmt* stmt = NULL;
-    stmt = safe_malloc(sizeof(ExpressionStmt), NULL);
+    stmt = arena_active_alloc(sizeof(ExpressionStmt));
     if (stmt == NULL) {
         expr_free(&expression);
         return NULL;
@@ -512,7 +521,7 @@ void expression_stmt_free(ExpressionStmt** expressionStmt) {
 
 ReturnStmt* return_stmt_new(Expr* expression) {
     ReturnStmt* stmt = NULL;
-    stmt = safe_malloc(sizeof(ReturnStmt), NULL);
+    stmt = arena_active_alloc(sizeof(ReturnStmt));
     if (stmt == NULL) {
         expr_free(&expression);
         return NULL;
@@ -529,14 +538,14 @@ void return_stmt_to_string(ReturnStmt** returnStmt) {
     if (returnStmt == NULL || *returnStmt == NULL)
         return;
 
-    printf("return");
+    output_printf("return");
 
     if ((*returnStmt)->expression != NULL) {
-        printf(" ");
+        output_printf(" ");
 
         expr_to_string(&(*returnStmt)->expression);
     } else {
-        printf(";");
+        output_printf(";");
     }
 }
 
@@ -551,7 +560,7 @@ void return_stmt_free(ReturnStmt** returnStmt) {
 
 BreakStmt* break_stmt_new(void) {
     BreakStmt* stmt = NULL;
-    stmt = safe_malloc(sizeof(BreakStmt), NULL);
+    stmt = arena_active_alloc(sizeof(BreakStmt));
     if (stmt == NULL) {
         return NULL;
     }
@@ -563,7 +572,7 @@ void break_stmt_to_string(BreakStmt** breakStmt) {
     if (breakStmt == NULL || *breakStmt == NULL)
         return;
 
-    printf("break");
+    output_printf("break");
 }
 
 void break_stmt_free(BreakStmt** breakStmt) {
@@ -575,7 +584,7 @@ void break_stmt_free(BreakStmt** breakStmt) {
 
 ContinueStmt* continue_stmt_new(void) {
     ContinueStmt* stmt = NULL;
-    stmt = safe_malloc(sizeof(ContinueStmt), NULL);
+    stmt = arena_active_alloc(sizeof(ContinueStmt));
     if (stmt == NULL) {
         return NULL;
     }
@@ -587,7 +596,7 @@ void continue_stmt_to_string(ContinueStmt** continueStmt) {
     if (continueStmt == NULL || *continueStmt == NULL)
         return;
 
-    printf("continue");
+    output_printf("continue");
 }
 
 void continue_stmt_free(ContinueStmt** continueStmt) {
@@ -599,7 +608,7 @@ void continue_stmt_free(ContinueStmt** continueStmt) {
 
 IfStmt* if_stmt_new(Expr* condition, Stmt* thenBranch, Stmt* elseBranch) {
     IfStmt* stmt = NULL;
-    stmt = safe_malloc(sizeof(IfStmt), NULL);
+    stmt = arena_active_alloc(sizeof(IfStmt));
     if (stmt == NULL) {
         expr_free(&condition);
         stmt_free(&thenBranch);
@@ -620,16 +629,16 @@ void if_stmt_to_string(IfStmt** ifStmt) {
     if (ifStmt == NULL || *ifStmt == NULL)
         return;
 
-    printf("if (");
+    output_printf("if (");
 
     expr_to_string(&(*ifStmt)->condition);
 
-    printf(") ");
+    output_printf(") ");
 
     stmt_to_string(&(*ifStmt)->thenBranch);
 
     if ((*ifStmt)->elseBranch != NULL) {
-        printf(" else ");
+        output_printf(" else ");
 
         stmt_to_string(&(*ifStmt)->elseBranch);
     }
@@ -648,7 +657,7 @@ void if_stmt_free(IfStmt** ifStmt) {
 
 WhileStmt* while_stmt_new(Expr* condition, Stmt* body) {
     WhileStmt* stmt = NULL;
-    stmt = safe_malloc(sizeof(WhileStmt), NULL);
+    stmt = arena_active_alloc(sizeof(WhileStmt));
     if (stmt == NULL) {
         expr_free(&condition);
         stmt_free(&body);
@@ -667,11 +676,11 @@ void while_stmt_to_string(WhileStmt** whileStmt) {
     if (whileStmt == NULL || *whileStmt == NULL)
         return;
 
-    printf("while (");
+    output_printf("while (");
 
     expr_to_string(&(*whileStmt)->condition);
 
-    printf(") ");
+    output_printf(") ");
 
     stmt_to_string(&(*whileStmt)->body);
 }
@@ -688,7 +697,7 @@ void while_stmt_free(WhileStmt** whileStmt) {
 
 ForStmt* for_stmt_new(Decl* initialization, Expr* condition, Expr* action, Stmt* body) {
     ForStmt* stmt = NULL;
-    stmt = safe_malloc(sizeof(ForStmt), NULL);
+    stmt = arena_active_alloc(sizeof(ForStmt));
     if (stmt == NULL) {
         decl_free(&initialization);
         expr_free(&condition);
@@ -701,7 +710,8 @@ ForStmt* for_stmt_new(Decl* initialization, Expr* condition, Expr* action, Stmt*
         .initialization = initialization,
         .condition = condition,
         .action = action,
-        .body = body
+        .body = body,
+        .scope = {0}
     };
 
     return stmt;
@@ -711,19 +721,19 @@ void for_stmt_to_string(ForStmt** forStmt) {
     if (forStmt == NULL || *forStmt == NULL)
         return;
 
-    printf("for (");
+    output_printf("for (");
 
     decl_to_string(&(*forStmt)->initialization);
 
-    printf("; ");
+    output_printf("; ");
 
     expr_to_string(&(*forStmt)->condition);
 
-    printf("; ");
+    output_printf("; ");
 
     expr_to_string(&(*forStmt)->action);
 
-    printf(") ");
+    output_printf(") ");
 
     stmt_to_string(&(*forStmt)->body);
 }
@@ -742,7 +752,7 @@ void for_stmt_free(ForStmt** forStmt) {
 
 BinaryExpr* binary_expr_new(Expr* left, Token* op, Expr* right) {
     BinaryExpr* expr = NULL;
-    expr = safe_malloc(sizeof(BinaryExpr), NULL);
+    expr = arena_active_alloc(sizeof(BinaryExpr));
     if (expr == NULL) {
         expr_free(&left);
         token_free(&op);
@@ -753,7 +763,8 @@ BinaryExpr* binary_expr_new(Expr* left, Token* op, Expr* right) {
     *expr = (BinaryExpr) {
         .left = left,
         .op = op,
-        .right = right
+        .right = right,
+        .operands = OPERANDS_ANY
     };
 
     return expr;
@@ -765,11 +776,11 @@ void binary_expr_to_string(BinaryExpr** binaryExpr) {
 
     expr_to_string(&(*binaryExpr)->left);
 
-    printf(" ");
+    output_printf(" ");
 
     token_to_string(&(*binaryExpr)->op);
 
-    printf(" ");
+    output_printf(" ");
 
     expr_to_string(&(*binaryExpr)->right);
 }
@@ -787,7 +798,7 @@ void binary_expr_free(BinaryExpr** binaryExpr) {
 
 GroupExpr* group_expr_new(Expr* expression) {
     GroupExpr* expr = NULL;
-    expr = safe_malloc(sizeof(GroupExpr), NULL);
+    expr = arena_active_alloc(sizeof(GroupExpr));
     if (expr == NULL) {
         expr_free(&expression);
         return NULL;
@@ -804,11 +815,11 @@ void group_expr_to_string(GroupExpr** groupExpr) {
     if (groupExpr == NULL || *groupExpr == NULL)
         return;
 
-    printf("(");
+    output_printf("(");
 
     expr_to_string(&(*groupExpr)->expression);
 
-    printf(")");
+    output_printf(")");
 }
 
 void group_expr_free(GroupExpr** groupExpr) {
@@ -822,7 +833,7 @@ void group_expr_free(GroupExpr** groupExpr) {
 
 AssignExpr* assign_expr_new(Expr* identifier, Token* op, Expr* expression) {
     AssignExpr* expr = NULL;
-    expr = safe_malloc(sizeof(AssignExpr), NULL);
+    expr = arena_active_alloc(sizeof(AssignExpr));
     if (expr == NULL) {
         expr_free(&identifier);
         token_free(&op);
@@ -845,11 +856,11 @@ void assign_expr_to_string(AssignExpr** assignExpr) {
 
     expr_to_string(&(*assignExpr)->identifier);
 
-    printf(" ");
+    output_printf(" ");
 
     token_to_string(&(*assignExpr)->op);
 
-    printf(" ");
+    output_printf(" ");
 
     expr_to_string(&(*assignExpr)->expression);
 }
@@ -865,12 +876,12 @@ void assign_expr_free(AssignExpr** assignExpr) {
     safe_free((void**) assignExpr);
 }
 
-CallExpr* call_expr_new(Expr* callee, List* arguments) {
+CallExpr* call_expr_new(Expr* callee, Vector* arguments) {
     CallExpr* expr = NULL;
-    expr = safe_malloc(sizeof(CallExpr), NULL);
+    expr = arena_active_alloc(sizeof(CallExpr));
     if (expr == NULL) {
         expr_free(&callee);
-        list_free(&arguments);
+        vector_free(&arguments);
         return NULL;
     }
 
@@ -886,7 +897,7 @@ void call_expr_add_argument(CallExpr** callExpr, Expr* argument) {
     if (callExpr == NULL || *callExpr == NULL || argument == NULL)
         return;
 
-    list_insert_last(&(*callExpr)->arguments, argument);
+    vector_push(&(*callExpr)->arguments, argument);
 }
 
 void call_expr_to_string(CallExpr** callExpr) {
@@ -895,17 +906,17 @@ void call_expr_to_string(CallExpr** callExpr) {
 
     expr_to_string(&(*callExpr)->callee);
 
-    printf("(");
-
-    list_foreach(arg, (*callExpr)->arguments) {
-        expr_to_string((Expr**) &arg->value);
+    output_printf("(");
 
-        if (arg->next != NULL) {
-            printf(", ");
+    vector_foreach(arg, (*callExpr)->arguments) {
+        if (arg != (*callExpr)->arguments->items) {
+            output_printf(", ");
         }
+
+        expr_to_string((Expr**) arg);
     }
 
-    printf(")");
+    output_printf(")");
 }
 
 void call_expr_free(CallExpr** callExpr) {
@@ -913,14 +924,14 @@ void call_expr_free(CallExpr** callExpr) {
         return;
 
     expr_free(&(*callExpr)->callee);
-    list_free(&(*callExpr)->arguments);
+    vector_free(&(*callExpr)->arguments);
 
     safe_free((void**) callExpr);
 }
 
 LogicalExpr* logical_expr_new(Expr* left, Token* op, Expr* right) {
     LogicalExpr* expr = NULL;
-    expr = safe_malloc(sizeof(BinaryExpr), NULL);
+    expr = arena_active_alloc(sizeof(BinaryExpr));
     if (expr == NULL) {
         expr_free(&left);
         token_free(&op);
@@ -943,11 +954,11 @@ void logical_expr_to_string(LogicalExpr** logicalExpr) {
 
     expr_to_string(&(*logicalExpr)->left);
 
-    printf(" ");
+    output_printf(" ");
 
     token_to_string(&(*logicalExpr)->op);
 
-    printf(" ");
+    output_printf(" ");
 
     expr_to_string(&(*logicalExpr)->right);
 }
@@ -965,7 +976,7 @@ void logical_expr_free(LogicalExpr** logicalExpr) {
 
 UnaryExpr* unary_expr_new(Token* op, Expr* expression) {
     UnaryExpr* expr = NULL;
-    expr = safe_malloc(sizeof(UnaryExpr), NULL);
+    expr = arena_active_alloc(sizeof(UnaryExpr));
     if (expr == NULL) {
         token_free(&op);
         expr_free(&expression);
@@ -1000,7 +1011,7 @@ void unary_expr_free(UnaryExpr** unaryExpr) {
 
 UpdateExpr* update_expr_new(Expr* expression, Token* op) {
     UpdateExpr* expr = NULL;
-    expr = safe_malloc(sizeof(UpdateExpr), NULL);
+    expr = arena_active_alloc(sizeof(UpdateExpr));
     if (expr == NULL) {
         expr_free(&expression);
         token_free(&op);
@@ -1035,7 +1046,7 @@ void update_expr_free(UpdateExpr** updateExpr) {
 
 FieldInitExpr* field_init_expr_new(Token* name, Expr* value) {
     FieldInitExpr* expr = NULL;
-    expr = safe_malloc(sizeof(FieldInitExpr), NULL);
+    expr = arena_active_alloc(sizeof(FieldInitExpr));
     if (expr == NULL) {
         token_free(&name);
         expr_free(&value);
@@ -1056,7 +1067,7 @@ void field_init_expr_to_string(FieldInitExpr** fieldInit) {
 
     token_to_string(&(*fieldInit)->name);
 
-    printf(": ");
+    output_printf(": ");
 
     expr_to_string(&(*fieldInit)->value);
 }
@@ -1073,7 +1084,7 @@ void field_init_expr_free(FieldInitExpr** fieldInit) {
 
 StructInitExpr* struct_init_expr_new(Token* name, List* fields) {
     StructInitExpr* expr = NULL;
-    expr = safe_malloc(sizeof(StructInitExpr), NULL);
+    expr = arena_active_alloc(sizeof(StructInitExpr));
     if (expr == NULL) {
         token_free(&name);
         list_free(&fields);
@@ -1102,17 +1113,17 @@ void struct_init_expr_to_string(StructInitExpr** structInit) {
     if ((*structInit)->name != NULL)
         token_to_string(&(*structInit)->name);
 
-    printf("{ ");
+    output_printf("{ ");
 
     list_foreach(field, (*structInit)->fields) {
         expr_to_string((Expr**) &field->value);
 
         if (field->next != NULL) {
-            printf(", ");
+            output_printf(", ");
         }
     }
 
-    printf(" }");
+    output_printf(" }");
 }
 
 void struct_init_expr_free(StructInitExpr** structInit) {
@@ -1127,7 +1138,7 @@ void struct_init_expr_free(StructInitExpr** structInit) {
 
 StructInlineExpr* struct_inline_expr_new(Type* type, List* fields) {
     StructInlineExpr* expr = NULL;
-    expr = safe_malloc(sizeof(StructInlineExpr), NULL);
+    expr = arena_active_alloc(sizeof(StructInlineExpr));
     if (expr == NULL) {
         type_free(&type);
         list_free(&fields);
@@ -1156,17 +1167,17 @@ void struct_inline_expr_to_string(StructInlineExpr** structInline) {
     if ((*structInline)->type != NULL)
         type_to_string(&(*structInline)->type);
 
-    printf("{ ");
+    output_printf("{ ");
 
     list_foreach(field, (*structInline)->fields) {
         expr_to_string((Expr**) &field->value);
 
         if (field->next != NULL) {
-            printf(", ");
+            output_printf(", ");
         }
     }
 
-    printf(" }");
+    output_printf(" }");
 }
 
 void struct_inline_expr_free(StructInlineExpr** structInline) {
@@ -1181,7 +1192,7 @@ void struct_inline_expr_free(StructInlineExpr** structInline) {
 
 ArrayInitExpr* array_init_expr_new(Type* type, List* elements) {
     ArrayInitExpr* expr = NULL;
-    expr = safe_malloc(sizeof(ArrayInitExpr), NULL);
+    expr = arena_active_alloc(sizeof(ArrayInitExpr));
     if (expr == NULL) {
         type_free(&type);
         list_free(&elements);
@@ -1209,24 +1220,24 @@ void array_init_expr_to_string(ArrayInitExpr** arrayInit) {
 
     type_to_string(&(*arrayInit)->type);
 
-    printf("{");
+    output_printf("{");
 
     List* elements = (*arrayInit)->elements;
     if (!list_is_empty(&elements)) {
-        printf(" ");
+        output_printf(" ");
 
         list_foreach(element, elements) {
             expr_to_string((Expr**) &element->value);
 
             if (element->next != NULL) {
-                printf(", ");
+                output_printf(", ");
             }
         }
 
-        printf(" ");
+        output_printf(" ");
     }
 
-    printf("}");
+    output_printf("}");
 }
 
 void array_init_expr_free(ArrayInitExpr** arrayInit) {
@@ -1239,9 +1250,78 @@ void array_init_expr_free(ArrayInitExpr** arrayInit) {
     safe_free((void**) arrayInit);
 }
 
+MapInitExpr* map_init_expr_new(Type* type, List* keys, List* values) {
+    MapInitExpr* expr = NULL;
+    expr = arena_active_alloc(sizeof(MapInitExpr));
+    if (expr == NULL) {
+        type_free(&type);
+        list_free(&keys);
+        list_free(&values);
+        return NULL;
+    }
+
+    *expr = (MapInitExpr) {
+        .type = type,
+        .keys = keys,
+        .values = values
+    };
+
+    return expr;
+}
+
+void map_init_expr_add_entry(MapInitExpr** mapInit, Expr* key, Expr* value) {
+    if (mapInit == NULL || *mapInit == NULL || key == NULL || value == NULL)
+        return;
+
+    list_insert_last(&(*mapInit)->keys, key);
+    list_insert_last(&(*mapInit)->values, value);
+}
+
+void map_init_expr_to_string(MapInitExpr** mapInit) {
+    if (mapInit == NULL || *mapInit == NULL)
+        return;
+
+    type_to_string(&(*mapInit)->type);
+
+    output_printf("{");
+
+    List* keys = (*mapInit)->keys;
+    if (!list_is_empty(&keys)) {
+        output_printf(" ");
+
+        ListNode* value = (*mapInit)->values->head;
+        list_foreach(key, keys) {
+            expr_to_string((Expr**) &key->value);
+            output_printf(": ");
+            expr_to_string((Expr**) &value->value);
+
+            if (key->next != NULL) {
+                output_printf(", ");
+            }
+
+            value = value->next;
+        }
+
+        output_printf(" ");
+    }
+
+    output_printf("}");
+}
+
+void map_init_expr_free(MapInitExpr** mapInit) {
+    if (mapInit == NULL || *mapInit == NULL)
+        return;
+
+    type_free(&(*mapInit)->type);
+    list_free(&(*mapInit)->keys);
+    list_free(&(*mapInit)->values);
+
+    safe_free((void**) mapInit);
+}
+
 FunctionExpr* function_expr_new(List* parameters, Type* returnType, Stmt* body) {
     FunctionExpr* expr = NULL;
-    expr = safe_malloc(sizeof(FunctionExpr), NULL);
+    expr = arena_active_alloc(sizeof(FunctionExpr));
     if (expr == NULL) {
         list_free(&parameters);
         type_free(&returnType);
@@ -1252,7 +1332,8 @@ FunctionExpr* function_expr_new(List* parameters, Type* returnType, Stmt* body)
     *expr = (FunctionExpr) {
         .parameters = parameters,
         .returnType = returnType,
-        .body = body
+        .body = body,
+        .scope = {0}
     };
 
     return expr;
@@ -1269,25 +1350,25 @@ void function_expr_to_string(FunctionExpr** functionExpr) {
     if (functionExpr == NULL || *functionExpr == NULL)
         return;
 
-    printf("func(");
+    output_printf("func(");
 
     list_foreach(param, (*functionExpr)->parameters) {
-        expr_to_string((Expr**) &param->value);
+        decl_to_string((Decl**) &param->value);
 
         if (param->next != NULL) {
-            printf(", ");
+            output_printf(", ");
         }
     }
 
-    printf(")");
+    output_printf(")");
 
     if ((*functionExpr)->returnType != NULL) {
-        printf(": ");
+        output_printf(": ");
 
         type_to_string(&(*functionExpr)->returnType);
     }
 
-    printf(" ");
+    output_printf(" ");
 
     stmt_to_string(&(*functionExpr)->body);
 }
@@ -1305,7 +1386,7 @@ void function_expr_free(FunctionExpr** functionExpr) {
 
 ConditionalExpr* conditional_expr_new(Expr* condition, Expr* isTrue, Expr* isFalse) {
     ConditionalExpr* expr = NULL;
-    expr = safe_malloc(sizeof(ConditionalExpr), NULL);
+    expr = arena_active_alloc(sizeof(ConditionalExpr));
     if (expr == NULL) {
         expr_free(&condition);
         expr_free(&isTrue);
@@ -1328,11 +1409,11 @@ void conditional_expr_to_string(ConditionalExpr** conditionalExpr) {
 
     expr_to_string(&(*conditionalExpr)->condition);
 
-    printf(" ? ");
+    output_printf(" ? ");
 
     expr_to_string(&(*conditionalExpr)->isTrue);
 
-    printf(" : ");
+    output_printf(" : ");
 
     expr_to_string(&(*conditionalExpr)->isFalse);
 }
@@ -1350,7 +1431,7 @@ void conditional_expr_free(ConditionalExpr** conditionalExpr) {
 
 MemberExpr* member_expr_new(Expr* object, List* members) {
     MemberExpr* expr = NULL;
-    expr = safe_malloc(sizeof(MemberExpr), NULL);
+    expr = arena_active_alloc(sizeof(MemberExpr));
     if (expr == NULL) {
         expr_free(&object);
         list_free(&members);
@@ -1378,13 +1459,13 @@ void member_expr_to_string(MemberExpr** memberExpr) {
 
     expr_to_string(&(*memberExpr)->object);
 
-    printf(".");
+    output_printf(".");
 
     list_foreach(member, (*memberExpr)->members) {
         expr_to_string((Expr**) &member->value);
 
         if (member->next != NULL) {
-            printf(".");
+            output_printf(".");
         }
     }
 }
@@ -1401,7 +1482,7 @@ void member_expr_free(MemberExpr** memberExpr) {
 
 ArrayMemberExpr* array_member_expr_new(Expr* object, List* levelOfAccess) {
     ArrayMemberExpr* expr = NULL;
-    expr = safe_malloc(sizeof(ArrayMemberExpr), NULL);
+    expr = arena_active_alloc(sizeof(ArrayMemberExpr));
     if (expr == NULL) {
         expr_free(&object);
         list_free(&levelOfAccess);
@@ -1430,9 +1511,9 @@ void array_member_expr_to_string(ArrayMemberExpr** arrayMemberExpr) {
     expr_to_string(&(*arrayMemberExpr)->object);
 
     list_foreach(level, (*arrayMemberExpr)->levelOfAccess) {
-        printf("[");
+        output_printf("[");
         expr_to_string((Expr**) &level->value);
-        printf("]");
+        output_printf("]");
     }
 }
 
@@ -1448,7 +1529,7 @@ void array_member_expr_free(ArrayMemberExpr** arrayMemberExpr) {
 
 CastExpr* cast_expr_new(Expr* target, Type* type) {
     CastExpr* expr = NULL;
-    expr = safe_malloc(sizeof(CastExpr), NULL);
+    expr = arena_active_alloc(sizeof(CastExpr));
     if (expr == NULL) {
         expr_free(&target);
         type_free(&type);
@@ -1469,11 +1550,11 @@ void cast_expr_to_string(CastExpr** castExpr) {
 
     expr_to_string(&(*castExpr)->target);
 
-    printf(".(");
+    output_printf(".(");
 
     type_to_string(&(*castExpr)->type);
 
-    printf(")");
+    output_printf(")");
 }
 
 void cast_expr_free(CastExpr** castExpr) {
@@ -1488,7 +1569,7 @@ void cast_expr_free(CastExpr** castExpr) {
 
 LiteralExpr* literal_expr_new(LiteralType type, void* value, void (*to_string)(void**), void (*destroy)(void**)) {
     LiteralExpr* expr = NULL;
-    expr = safe_malloc(sizeof(LiteralExpr), NULL);
+    expr = arena_active_alloc(sizeof(LiteralExpr));
     if (expr == NULL) {
         if (destroy != NULL) {
             destroy(&value);
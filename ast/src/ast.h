@@ -1,9 +1,14 @@
 #pragma once
 
+#include <stdbool.h>
+#include <stddef.h>
+
 #include "list.h"
 #include "literal-type.h"
+#include "output.h"
 #include "token.h"
 #include "types.h"
+#include "vector.h"
 
 
 typedef enum DeclType {
@@ -38,6 +43,7 @@ typedef enum ExprType {
     STRUCT_INIT_EXPR,
     STRUCT_INLINE_EXPR,
     ARRAY_INIT_EXPR,
+    MAP_INIT_EXPR,
     FUNC_EXPR,
     CONDITIONAL_EXPR,
     MEMBER_EXPR,
@@ -76,6 +82,7 @@ void stmt_free(Stmt** stmt);
 typedef struct Expr {
     ExprType type;
     void* expr;
+    Type* resolvedType; /* set by the type checker, canonical */
     void (*to_string)(void**);
     void (*destroy)(void**);
 } Expr;
@@ -86,10 +93,18 @@ void expr_to_string(Expr** expr);
 void expr_free(Expr** expr);
 
 
+/* frame the interpreter opens for a scope, filled in by the resolver */
+typedef struct ScopeLayout {
+    size_t size;       /* slots to reserve, 0 when the scope declares nothing and is elided */
+    bool isCapturable; /* a nested function may capture it, so it has to live on the heap */
+} ScopeLayout;
+
+
 typedef struct LetDecl {
     Token* name;
     Type* type;
     Expr* expression;
+    int slot; /* set by the resolver */
 } LetDecl;
 
 LetDecl* let_decl_new(Token* name, Type* type, Expr* expression);
@@ -101,6 +116,7 @@ typedef struct ConstDecl {
     Token* name;
     Type* type;
     Expr* expression;
+    int slot; /* set by the resolver */
 } ConstDecl;
 
 ConstDecl* const_decl_new(Token* name, Type* type, Expr* expression);
@@ -123,6 +139,9 @@ typedef struct FunctionDecl {
     List* parameters; /* List of (FieldDecl*) */
     Type* returnType;
     Stmt* body;
+    Type* functionType; /* set by the type checker, canonical */
+    int slot; /* set by the resolver */
+    ScopeLayout scope;
 } FunctionDecl;
 
 FunctionDecl* function_decl_new(Token* name, List* parameters, Type* returnType, Stmt* body);
@@ -152,10 +171,11 @@ void stmt_decl_free(StmtDecl** stmtDecl);
 
 
 typedef struct BlockStmt {
-    List* declarations; /* List of (Decl*) */
+    Vector* declarations; /* Vector of (Decl*) */
+    ScopeLayout scope;
 } BlockStmt;
 
-BlockStmt* block_stmt_new(List* statements);
+BlockStmt* block_stmt_new(Vector* statements);
 void block_stmt_add_declaration(BlockStmt** blockStmt, Decl* declaration);
 void block_stmt_to_string(BlockStmt** blockStmt);
 void block_stmt_free(BlockStmt** blockStmt);
@@ -223,6 +243,7 @@ typedef struct ForStmt {
     Expr* condition;
     Expr* action;
     Stmt* body;
+    ScopeLayout scope;
 } ForStmt;
 
 ForStmt* for_stmt_new(Decl* initialization, Expr* condition, Expr* action, Stmt* body);
@@ -230,10 +251,19 @@ void for_stmt_to_string(ForStmt** forStmt);
 void for_stmt_free(ForStmt** forStmt);
 
 
+/* what the type checker proved about both sides of a binary expression */
+typedef enum OperandTypes {
+    OPERANDS_ANY,    /* only known at runtime */
+    OPERANDS_INT,    /* int and int */
+    OPERANDS_FLOAT,  /* float and float, or float and int */
+    OPERANDS_CONCAT  /* char or string on both sides of + */
+} OperandTypes;
+
 typedef struct BinaryExpr {
     Expr* left;
     Token* op;
     Expr* right;
+    OperandTypes operands;
 } BinaryExpr;
 
 BinaryExpr* binary_expr_new(Expr* left, Token* op, Expr* right);
@@ -263,10 +293,10 @@ void assign_expr_free(AssignExpr** assignExpr);
 
 typedef struct CallExpr {
     Expr* callee;
-    List* arguments; /* List of (Expr*) */
+    Vector* arguments; /* Vector of (Expr*) */
 } CallExpr;
 
-CallExpr* call_expr_new(Expr* callee, List* arguments);
+CallExpr* call_expr_new(Expr* callee, Vector* arguments);
 void call_expr_add_argument(CallExpr** callExpr, Expr* argument);
 void call_expr_to_string(CallExpr** callExpr);
 void call_expr_free(CallExpr** callExpr);
@@ -346,10 +376,23 @@ void array_init_expr_to_string(ArrayInitExpr** arrayInit);
 void array_init_expr_free(ArrayInitExpr** arrayInit);
 
 
+typedef struct MapInitExpr {
+    Type* type;
+    List* keys;
+    List* values; /* values[i] belongs to keys[i] */
+} MapInitExpr;
+
+MapInitExpr* map_init_expr_new(Type* type, List* keys, List* values);
+void map_init_expr_add_entry(MapInitExpr** mapInit, Expr* key, Expr* value);
+void map_init_expr_to_string(MapInitExpr** mapInit);
+void map_init_expr_free(MapInitExpr** mapInit);
+
+
 typedef struct FunctionExpr {
     List* parameters; /* List of (FieldDecl*) */
     Type* returnType;
     Stmt* body;
+    ScopeLayout scope;
 } FunctionExpr;
 
 FunctionExpr* function_expr_new(List* parameters, Type* returnType, Stmt* body);
@@ -511,12 +554,12 @@ void literal_expr_free(LiteralExpr** literalExpr);
 
 #define DECL_PRINT_AND_FREE(decl)                                              \
     decl_to_string((&(decl)));                                                 \
-    printf("\n");                                                              \
+    output_printf("\n");                                                       \
     decl_free((&(decl)))
 
 #define NEW_BLOCK_STMT()                                                       \
     stmt_new(BLOCK_STMT,                                                       \
-        block_stmt_new((list_new((void (*)(void **)) decl_free))),             \
+        block_stmt_new((vector_new((void (*)(void **)) decl_free))),           \
         (void (*)(void **))block_stmt_to_string,                               \
         (void (*)(void **))block_stmt_free)
 
@@ -575,7 +618,7 @@ void literal_expr_free(LiteralExpr** literalExpr);
 
 #define STMT_PRINT_AND_FREE(stmt)                                              \
     stmt_to_string((&(stmt)));                                                 \
-    printf("\n");                                                              \
+    output_printf("\n");                                                       \
     stmt_free((&(stmt)))
 
 #define NEW_BINARY_EXPR(left, op, right)                                       \
@@ -595,7 +638,7 @@ void literal_expr_free(LiteralExpr** literalExpr);
 
 #define NEW_CALL_EXPR(callee)                                                  \
     expr_new(CALL_EXPR,                                                        \
-        call_expr_new((callee), (list_new((void (*)(void **)) expr_free))),    \
+        call_expr_new((callee), (vector_new((void (*)(void **)) expr_free))),  \
         (void (*)(void **))call_expr_to_string,                                \
         (void (*)(void **))call_expr_free)
 
@@ -702,6 +745,18 @@ void literal_expr_free(LiteralExpr** literalExpr);
         (void (*)(void **))array_init_expr_to_string,                          \
         (void (*)(void **))array_init_expr_free)
 
+#define NEW_MAP_INIT_EXPR(map_type)                                            \
+    expr_new(MAP_INIT_EXPR,                                                    \
+        map_init_expr_new((map_type),                                          \
+            (list_new((void (*)(void **)) expr_free)),                         \
+            (list_new((void (*)(void **)) expr_free))),                        \
+        (void (*)(void **))map_init_expr_to_string,                            \
+        (void (*)(void **))map_init_expr_free)
+
+#define MAP_INIT_EXPR_ADD_ENTRY(map_init_expr, key_expr, value_expr)           \
+    map_init_expr_add_entry(                                                   \
+        (MapInitExpr**) (&(map_init_expr)->expr), (key_expr), (value_expr))
+
 #define ARRAY_INIT_EXPR_ADD_ELEMENT(array_init_expr, element_expr)             \
     array_init_expr_add_element(                                               \
         (ArrayInitExpr**) (&(array_init_expr)->expr), (element_expr))
@@ -827,7 +882,7 @@ void literal_expr_free(LiteralExpr** literalExpr);
 
 #define EXPR_PRINT_AND_FREE(expr)                                              \
     expr_to_string((&(expr)));                                                 \
-    printf("\n");                                                              \
+    output_printf("\n");                                                       \
     expr_free((&(expr)))
 
 #define NEW_IDENT(value)                                                       \
@@ -865,6 +920,13 @@ void literal_expr_free(LiteralExpr** literalExpr);
 
 #define NEW_STRING_LITERAL(value) NEW_LITERAL_EXPR(NEW_STRING((value)))
 
+#define NEW_STRING_WITH_LENGTH(value, length)                                  \
+    literal_expr_new(STRING_LITERAL, string_literal_new_with_length((value), (length)), \
+                (void (*)(void **))string_literal_to_string,                   \
+                (void (*)(void **))string_literal_free)
+
+#define NEW_STRING_LITERAL_WITH_LENGTH(value, length) NEW_LITERAL_EXPR(NEW_STRING_WITH_LENGTH((value), (length)))
+
 #define NEW_BOOL(value)                                                        \
     literal_expr_new(BOOL_LITERAL, bool_literal_new((value)),                  \
                 (void (*)(void **))bool_literal_to_string,                     \
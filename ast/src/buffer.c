@@ -1,9 +1,11 @@
 #include "buffer.h"
 
+#include <math.h>
 #include <stdarg.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -16,7 +18,7 @@ ByteBuffer* byte_buffer_new(void) {
 
 ByteBuffer* byte_buffer_new_with_capacity(size_t capacity) {
     ByteBuffer* buffer = NULL;
-    buffer = safe_malloc(capacity, NULL);
+    buffer = safe_malloc(sizeof(ByteBuffer), NULL);
     if (buffer == NULL) {
         return NULL;
     }
@@ -106,45 +108,56 @@ size_t byte_buffer_append(ByteBuffer* byteBuffer, const char* content, size_t co
         }
     }
 
-    strncat(byteBuffer->bytes, content, contentSize);
+    /* bytes stays NUL terminated at size, so there is nothing to search for */
+    memcpy(byteBuffer->bytes + byteBuffer->size, content, contentSize);
 
     byteBuffer->size += contentSize;
+    byteBuffer->bytes[byteBuffer->size] = '\0';
 
     return contentSize;
 }
 
 size_t byte_buffer_appendf(ByteBuffer* byteBuffer, const char* format, ...) {
-    if (byteBuffer == NULL || format == NULL)
-        return 0;
-
     va_list args;
     va_start(args, format);
+    size_t contentSize = byte_buffer_vappendf(byteBuffer, format, args);
+    va_end(args);
+
+    return contentSize;
+}
+
+size_t byte_buffer_vappendf(ByteBuffer* byteBuffer, const char* format, va_list args) {
+    if (byteBuffer == NULL || format == NULL)
+        return 0;
 
     va_list args_copy;
     va_copy(args_copy, args);
-    int contentSize = vsnprintf(NULL, 0, format, args_copy);
-    va_end(args_copy);
 
-    if (contentSize < 0) {
-        va_end(args);
-        return 0;
-    }
+    /* formats straight into the free space and only grows when it did not fit */
+    size_t available = byteBuffer->capacity - byteBuffer->size;
+    int contentSize = vsnprintf(byteBuffer->bytes + byteBuffer->size, available, format, args);
 
-    char* content = safe_malloc(contentSize + 1, NULL);
-    if (content == NULL) {
-        va_end(args);
-        return 0;
+    if (contentSize >= 0 && (size_t) contentSize >= available) {
+        if (byte_buffer_increase_storage_capacity(byteBuffer, contentSize + 1)) {
+            vsnprintf(byteBuffer->bytes + byteBuffer->size, contentSize + 1, format, args_copy);
+        } else {
+            contentSize = -1;
+        }
     }
 
-    vsprintf(content, format, args);
+    va_end(args_copy);
 
-    va_end(args);
+    if (byteBuffer->bytes == NULL)
+        return 0;
 
-    size_t bytesUsed = byte_buffer_append(byteBuffer, content, contentSize);
+    if (contentSize < 0) {
+        byteBuffer->bytes[byteBuffer->size] = '\0';
+        return 0;
+    }
 
-    safe_free((void**) &content);
+    byteBuffer->size += contentSize;
 
-    return bytesUsed;
+    return contentSize;
 }
 
 size_t byte_buffer_nappendf(ByteBuffer* byteBuffer, size_t maxSize, const char* format, ...) {
@@ -177,6 +190,147 @@ size_t byte_buffer_nappendf(ByteBuffer* byteBuffer, size_t maxSize, const char*
     return bytesUsed;
 }
 
+static const char digitPairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/* writes the digits of value backwards from end, two at a time, and returns where they start */
+static char* format_digits(char* end, uint64_t value) {
+    while (value >= 100) {
+        const char* pair = &digitPairs[(value % 100) * 2];
+        value /= 100;
+
+        *--end = pair[1];
+        *--end = pair[0];
+    }
+
+    if (value >= 10) {
+        const char* pair = &digitPairs[value * 2];
+
+        *--end = pair[1];
+        *--end = pair[0];
+    } else {
+        *--end = (char) ('0' + value);
+    }
+
+    return end;
+}
+
+size_t byte_buffer_append_int(ByteBuffer* byteBuffer, int64_t value) {
+    char text[24];
+    char* end = text + sizeof(text);
+
+    uint64_t magnitude = value < 0 ? 0 - (uint64_t) value : (uint64_t) value;
+
+    char* start = format_digits(end, magnitude);
+    if (value < 0) {
+        *--start = '-';
+    }
+
+    return byte_buffer_append(byteBuffer, start, end - start);
+}
+
+#define FIXED_DECIMALS 6
+#define FIXED_SCALE 1000000
+
+/*
+ * value * 10^6 rounded to nearest, ties to even, which is what "%f" prints.
+ * A double is mantissa * 2^exponent, so the product is exact in 128 bits
+ * and the rounding only looks at the bits shifted out. Infinities, NaN and
+ * magnitudes from 2^63 up are left to printf.
+ */
+static bool fixed_point(double value, uint64_t* integral, uint64_t* fraction) {
+#ifdef __SIZEOF_INT128__
+    uint64_t bits = 0;
+    memcpy(&bits, &value, sizeof(bits));
+
+    int exponent = (int) ((bits >> 52) & 0x7ff);
+    uint64_t mantissa = bits & ((UINT64_C(1) << 52) - 1);
+
+    if (exponent == 0x7ff)
+        return false;
+
+    if (exponent == 0) {
+        exponent = 1;
+    } else {
+        mantissa |= UINT64_C(1) << 52;
+    }
+
+    exponent -= 1075;
+
+    if (exponent >= 0) {
+        if (exponent > 10)
+            return false;
+
+        *integral = mantissa << exponent;
+        *fraction = 0;
+        return true;
+    }
+
+    unsigned __int128 scaled = (unsigned __int128) mantissa * FIXED_SCALE;
+    unsigned __int128 rounded = 0;
+    int shift = -exponent;
+
+    /* scaled is below 2^73, so shifting 127 bits or more leaves less than half a unit */
+    if (shift < 127) {
+        rounded = scaled >> shift;
+
+        unsigned __int128 remainder = scaled - (rounded << shift);
+        unsigned __int128 half = (unsigned __int128) 1 << (shift - 1);
+
+        if (remainder > half || (remainder == half && (rounded & 1) != 0)) {
+            rounded += 1;
+        }
+    }
+
+    *integral = (uint64_t) (rounded / FIXED_SCALE);
+    *fraction = (uint64_t) (rounded % FIXED_SCALE);
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+size_t byte_buffer_append_double(ByteBuffer* byteBuffer, double value) {
+    uint64_t integral = 0;
+    uint64_t fraction = 0;
+
+    if (!fixed_point(value, &integral, &fraction))
+        return byte_buffer_appendf(byteBuffer, "%f", value);
+
+    char text[32];
+    char* end = text + sizeof(text);
+    char* start = end;
+
+    for (size_t i = 0; i < FIXED_DECIMALS / 2; i++) {
+        const char* pair = &digitPairs[(fraction % 100) * 2];
+        fraction /= 100;
+
+        *--start = pair[1];
+        *--start = pair[0];
+    }
+
+    *--start = '.';
+
+    start = format_digits(start, integral);
+
+    /* like printf, a negative value that rounds to zero keeps its sign */
+    if (signbit(value)) {
+        *--start = '-';
+    }
+
+    return byte_buffer_append(byteBuffer, start, end - start);
+}
+
 char* byte_buffer_to_string(ByteBuffer* byteBuffer) {
     if (byteBuffer == NULL)
         return "";
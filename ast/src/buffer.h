@@ -1,6 +1,8 @@
 #pragma once
 
+#include <stdarg.h>
 #include <stddef.h>
+#include <stdint.h>
 
 
 #define DEFAULT_BB_CAPACITY 256
@@ -22,6 +24,11 @@ void byte_buffer_clear(ByteBuffer* byteBuffer);
 
 size_t byte_buffer_append(ByteBuffer* byteBuffer, const char* content, size_t contentSize);
 size_t byte_buffer_appendf(ByteBuffer* byteBuffer, const char* format, ...);
+size_t byte_buffer_vappendf(ByteBuffer* byteBuffer, const char* format, va_list args);
 size_t byte_buffer_nappendf(ByteBuffer* byteBuffer, size_t maxSize, const char* format, ...);
 
+/* same text as "%" PRId64 and "%f", without going through printf */
+size_t byte_buffer_append_int(ByteBuffer* byteBuffer, int64_t value);
+size_t byte_buffer_append_double(ByteBuffer* byteBuffer, double value);
+
 char* byte_buffer_to_string(ByteBuffer* byteBuffer);
@@ -0,0 +1,1194 @@
+#include "cache.h"
+
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* mman.h's mask of mapping kinds, unused here, would shadow TypeID's MAP_TYPE */
+#undef MAP_TYPE
+
+#include "ast.h"
+#include "buffer.h"
+#include "map.h"
+#include "smem.h"
+#include "symbol.h"
+#include "token.h"
+#include "types.h"
+#include "vector.h"
+
+
+static const char CACHE_MAGIC[8] = {'R', 'O', 'S', 'E', 'C', '\0', '\0', '\0'};
+
+/* magic, version, flags, source size and hash, payload size and hash */
+#define CACHE_HEADER_SIZE 48
+
+char* cache_path(const char* sourcePath) {
+    if (sourcePath == NULL)
+        return NULL;
+
+    size_t length = strlen(sourcePath);
+
+    /* file.rose becomes file.rosec */
+    if (length >= strlen(".rose") && strcmp(sourcePath + length - strlen(".rose"), ".rose") == 0) {
+        length -= strlen(".rose");
+    }
+
+    char* path = safe_malloc(length + strlen(CACHE_EXTENSION) + 1, NULL);
+    if (path == NULL) {
+        return NULL;
+    }
+
+    memcpy(path, sourcePath, length);
+    strcpy(path + length, CACHE_EXTENSION);
+
+    return path;
+}
+
+static uint64_t mix(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+/* eight bytes per step, sources run to megabytes and are hashed on every run */
+uint64_t cache_hash(const void* data, size_t size) {
+    const unsigned char* bytes = data;
+    uint64_t hash = 0x9e3779b97f4a7c15ULL ^ size;
+
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, bytes + i, 8);
+        hash = (hash ^ mix(word)) * 0xc4ceb9fe1a85ec53ULL;
+    }
+
+    uint64_t tail = 0;
+    for (size_t shift = 0; i < size; i++, shift += 8) {
+        tail |= (uint64_t) bytes[i] << shift;
+    }
+
+    return mix(hash ^ mix(tail));
+}
+
+
+typedef struct CacheWriter {
+    ByteBuffer* names;
+    ByteBuffer* types;
+    ByteBuffer* nodes;
+    Map* nameIndex; /* Map of (char*, index + 1) by interned name */
+    Map* typeIndex; /* Map of (Type*, index + 1) by pointer */
+    size_t nameCount;
+    size_t typeCount;
+} CacheWriter;
+
+static void put_varint(ByteBuffer* out, uint64_t value) {
+    char bytes[10];
+    size_t length = 0;
+
+    while (value >= 0x80) {
+        bytes[length++] = (char) (value | 0x80);
+        value >>= 7;
+    }
+    bytes[length++] = (char) value;
+
+    byte_buffer_append(out, bytes, length);
+}
+
+static void put_int(ByteBuffer* out, int64_t value) {
+    put_varint(out, ((uint64_t) value << 1) ^ (uint64_t) (value >> 63));
+}
+
+static void put_fixed64(char* at, uint64_t value) {
+    for (size_t i = 0; i < 8; i++) {
+        at[i] = (char) (value >> (8 * i));
+    }
+}
+
+static void put_double(ByteBuffer* out, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    char bytes[8];
+    put_fixed64(bytes, bits);
+    byte_buffer_append(out, bytes, sizeof(bytes));
+}
+
+/* the name's index in the table, plus one so 0 can stand for NULL */
+static void put_name(CacheWriter* writer, ByteBuffer* out, const char* name) {
+    if (name == NULL) {
+        put_varint(out, 0);
+        return;
+    }
+
+    uintptr_t ref = (uintptr_t) map_get(writer->nameIndex, (void*) name);
+    if (ref == 0) {
+        ref = ++writer->nameCount;
+        map_put(writer->nameIndex, (void*) name, (void*) ref);
+
+        /* kept terminated so the loader can intern it where it lies */
+        size_t length = symbol_of(name)->length;
+        put_varint(writer->names, length);
+        byte_buffer_append(writer->names, name, length + 1);
+    }
+
+    put_varint(out, ref);
+}
+
+static size_t pointer_hash(const void* pointer) {
+    return (size_t) mix((uintptr_t) pointer);
+}
+
+static bool same_pointer(const MapEntry** entry, void** key) {
+    return (*entry)->key == *key;
+}
+
+static uintptr_t type_ref(CacheWriter* writer, Type* type);
+
+static void put_type(CacheWriter* writer, ByteBuffer* out, Type* type) {
+    put_varint(out, type_ref(writer, type));
+}
+
+static void put_type_list(CacheWriter* writer, ByteBuffer* out, List* types) {
+    put_varint(out, list_size(&types));
+    list_foreach(type, types) {
+        put_type(writer, out, type->value);
+    }
+}
+
+static void register_type_list(CacheWriter* writer, List* types) {
+    list_foreach(type, types) {
+        type_ref(writer, type->value);
+    }
+}
+
+/*
+ * Types are written children first, so the loader always finds the types
+ * an entry refers to already built. A type shared by pointer is written
+ * once and stays shared, canonical types are interned again on load.
+ */
+static uintptr_t type_ref(CacheWriter* writer, Type* type) {
+    if (type == NULL)
+        return 0;
+
+    uintptr_t ref = (uintptr_t) map_get(writer->typeIndex, type);
+    if (ref != 0)
+        return ref;
+
+    switch (type->typeId) {
+    case NAMED_TYPE:
+        type_ref(writer, ((NamedType*) type->type)->type);
+        break;
+    case STRUCT_TYPE:
+        register_type_list(writer, ((StructType*) type->type)->fields);
+        break;
+    case ARRAY_TYPE:
+        register_type_list(writer, ((ArrayType*) type->type)->dimensions);
+        type_ref(writer, ((ArrayType*) type->type)->type);
+        break;
+    case MAP_TYPE:
+        type_ref(writer, ((MapType*) type->type)->key);
+        type_ref(writer, ((MapType*) type->type)->value);
+        break;
+    case FUNC_TYPE:
+        register_type_list(writer, ((FunctionType*) type->type)->parameterTypes);
+        type_ref(writer, ((FunctionType*) type->type)->returnType);
+        break;
+    default:
+        break;
+    }
+
+    ByteBuffer* out = writer->types;
+
+    put_varint(out, type->typeId);
+    put_varint(out, type->interned);
+
+    switch (type->typeId) {
+    case CUSTOM_TYPE: {
+        AtomicType* custom = type->type;
+        put_varint(out, custom->size);
+        put_name(writer, out, custom->name);
+        break;
+    }
+    case NAMED_TYPE: {
+        NamedType* named = type->type;
+        put_name(writer, out, named->name);
+        put_type(writer, out, named->type);
+        break;
+    }
+    case STRUCT_TYPE: {
+        StructType* structType = type->type;
+        put_varint(out, structType->size);
+        put_name(writer, out, structType->name);
+        put_type_list(writer, out, structType->fields);
+        break;
+    }
+    case ARRAY_DIMENSION_TYPE:
+        put_varint(out, ((ArrayDimension*) type->type)->size);
+        break;
+    case ARRAY_TYPE:
+        put_type_list(writer, out, ((ArrayType*) type->type)->dimensions);
+        put_type(writer, out, ((ArrayType*) type->type)->type);
+        break;
+    case MAP_TYPE:
+        put_type(writer, out, ((MapType*) type->type)->key);
+        put_type(writer, out, ((MapType*) type->type)->value);
+        break;
+    case FUNC_TYPE:
+        put_type_list(writer, out, ((FunctionType*) type->type)->parameterTypes);
+        put_type(writer, out, ((FunctionType*) type->type)->returnType);
+        break;
+    default:
+        /* int, float, char, string, bool, void and nil are rebuilt by id */
+        break;
+    }
+
+    ref = ++writer->typeCount;
+    map_put(writer->typeIndex, type, (void*) ref);
+
+    return ref;
+}
+
+/* node kinds are written plus one, 0 stands for a missing node */
+static void put_token(CacheWriter* writer, Token* token) {
+    if (token == NULL) {
+        put_varint(writer->nodes, 0);
+        return;
+    }
+
+    put_varint(writer->nodes, (uint64_t) (token->type + 2));
+    put_name(writer, writer->nodes, token->literal);
+    put_varint(writer->nodes, token->line);
+}
+
+static void put_decl(CacheWriter* writer, Decl* declaration);
+static void put_stmt(CacheWriter* writer, Stmt* statement);
+static void put_expr(CacheWriter* writer, Expr* expression);
+
+static void put_decl_list(CacheWriter* writer, List* declarations) {
+    put_varint(writer->nodes, list_size(&declarations));
+    list_foreach(declaration, declarations) {
+        put_decl(writer, declaration->value);
+    }
+}
+
+static void put_expr_list(CacheWriter* writer, List* expressions) {
+    put_varint(writer->nodes, list_size(&expressions));
+    list_foreach(expression, expressions) {
+        put_expr(writer, expression->value);
+    }
+}
+
+static void put_decl(CacheWriter* writer, Decl* declaration) {
+    ByteBuffer* out = writer->nodes;
+
+    if (declaration == NULL) {
+        put_varint(out, 0);
+        return;
+    }
+
+    put_varint(out, declaration->type + 1);
+
+    switch (declaration->type) {
+    case LET_DECL: {
+        LetDecl* letDecl = declaration->decl;
+        put_token(writer, letDecl->name);
+        put_type(writer, out, letDecl->type);
+        put_expr(writer, letDecl->expression);
+        break;
+    }
+    case CONST_DECL: {
+        ConstDecl* constDecl = declaration->decl;
+        put_token(writer, constDecl->name);
+        put_type(writer, out, constDecl->type);
+        put_expr(writer, constDecl->expression);
+        break;
+    }
+    case FIELD_DECL: {
+        FieldDecl* fieldDecl = declaration->decl;
+        put_token(writer, fieldDecl->name);
+        put_type(writer, out, fieldDecl->type);
+        break;
+    }
+    case FUNC_DECL: {
+        FunctionDecl* functionDecl = declaration->decl;
+        put_token(writer, functionDecl->name);
+        put_decl_list(writer, functionDecl->parameters);
+        put_type(writer, out, functionDecl->returnType);
+        put_stmt(writer, functionDecl->body);
+        put_type(writer, out, functionDecl->functionType);
+        break;
+    }
+    case STRUCT_DECL: {
+        StructDecl* structDecl = declaration->decl;
+        put_token(writer, structDecl->name);
+        put_type_list(writer, out, structDecl->fields);
+        break;
+    }
+    case STMT_DECL:
+        put_stmt(writer, ((StmtDecl*) declaration->decl)->stmt);
+        break;
+    }
+}
+
+static void put_stmt(CacheWriter* writer, Stmt* statement) {
+    ByteBuffer* out = writer->nodes;
+
+    if (statement == NULL) {
+        put_varint(out, 0);
+        return;
+    }
+
+    put_varint(out, statement->type + 1);
+
+    switch (statement->type) {
+    case BLOCK_STMT: {
+        Vector* declarations = ((BlockStmt*) statement->stmt)->declarations;
+        put_varint(out, vector_size(&declarations));
+        vector_foreach(declaration, declarations) {
+            put_decl(writer, *declaration);
+        }
+        break;
+    }
+    case EXPRESSION_STMT:
+        put_expr(writer, ((ExpressionStmt*) statement->stmt)->expression);
+        break;
+    case RETURN_STMT:
+        put_expr(writer, ((ReturnStmt*) statement->stmt)->expression);
+        break;
+    case BREAK_STMT:
+    case CONTINUE_STMT:
+        break;
+    case IF_STMT: {
+        IfStmt* ifStmt = statement->stmt;
+        put_expr(writer, ifStmt->condition);
+        put_stmt(writer, ifStmt->thenBranch);
+        put_stmt(writer, ifStmt->elseBranch);
+        break;
+    }
+    case WHILE_STMT: {
+        WhileStmt* whileStmt = statement->stmt;
+        put_expr(writer, whileStmt->condition);
+        put_stmt(writer, whileStmt->body);
+        break;
+    }
+    case FOR_STMT: {
+        ForStmt* forStmt = statement->stmt;
+        put_decl(writer, forStmt->initialization);
+        put_expr(writer, forStmt->condition);
+        put_expr(writer, forStmt->action);
+        put_stmt(writer, forStmt->body);
+        break;
+    }
+    }
+}
+
+static void put_literal(CacheWriter* writer, LiteralExpr* literal) {
+    ByteBuffer* out = writer->nodes;
+
+    put_varint(out, literal->type);
+
+    switch (literal->type) {
+    case IDENT_LITERAL:
+        put_name(writer, out, ((IdentLiteral*) literal->value)->value);
+        break;
+    case INT_LITERAL:
+        put_int(out, ((IntLiteral*) literal->value)->value);
+        break;
+    case FLOAT_LITERAL:
+        put_double(out, ((FloatLiteral*) literal->value)->value);
+        break;
+    case CHAR_LITERAL:
+        put_varint(out, (unsigned char) ((CharLiteral*) literal->value)->value);
+        break;
+    case STRING_LITERAL: {
+        const char* value = ((StringLiteral*) literal->value)->value;
+        size_t length = strlen(value);
+        put_varint(out, length);
+        byte_buffer_append(out, value, length + 1);
+        break;
+    }
+    case BOOL_LITERAL:
+        put_varint(out, ((BoolLiteral*) literal->value)->value);
+        break;
+    case VOID_LITERAL:
+    case NIL_LITERAL:
+        break;
+    }
+}
+
+static void put_expr(CacheWriter* writer, Expr* expression) {
+    ByteBuffer* out = writer->nodes;
+
+    if (expression == NULL) {
+        put_varint(out, 0);
+        return;
+    }
+
+    put_varint(out, expression->type + 1);
+    put_type(writer, out, expression->resolvedType);
+
+    switch (expression->type) {
+    case BINARY_EXPR: {
+        BinaryExpr* binaryExpr = expression->expr;
+        put_expr(writer, binaryExpr->left);
+        put_token(writer, binaryExpr->op);
+        put_expr(writer, binaryExpr->right);
+        put_varint(out, binaryExpr->operands);
+        break;
+    }
+    case GROUP_EXPR:
+        put_expr(writer, ((GroupExpr*) expression->expr)->expression);
+        break;
+    case ASSIGN_EXPR: {
+        AssignExpr* assignExpr = expression->expr;
+        put_expr(writer, assignExpr->identifier);
+        put_token(writer, assignExpr->op);
+        put_expr(writer, assignExpr->expression);
+        break;
+    }
+    case CALL_EXPR: {
+        CallExpr* callExpr = expression->expr;
+        put_expr(writer, callExpr->callee);
+        put_varint(out, vector_size(&callExpr->arguments));
+        vector_foreach(argument, callExpr->arguments) {
+            put_expr(writer, *argument);
+        }
+        break;
+    }
+    case LOGICAL_EXPR: {
+        LogicalExpr* logicalExpr = expression->expr;
+        put_expr(writer, logicalExpr->left);
+        put_token(writer, logicalExpr->op);
+        put_expr(writer, logicalExpr->right);
+        break;
+    }
+    case UNARY_EXPR: {
+        UnaryExpr* unaryExpr = expression->expr;
+        put_token(writer, unaryExpr->op);
+        put_expr(writer, unaryExpr->expression);
+        break;
+    }
+    case UPDATE_EXPR: {
+        UpdateExpr* updateExpr = expression->expr;
+        put_expr(writer, updateExpr->expression);
+        put_token(writer, updateExpr->op);
+        break;
+    }
+    case FIELD_INIT_EXPR: {
+        FieldInitExpr* fieldInit = expression->expr;
+        put_token(writer, fieldInit->name);
+        put_expr(writer, fieldInit->value);
+        break;
+    }
+    case STRUCT_INIT_EXPR: {
+        StructInitExpr* structInit = expression->expr;
+        put_token(writer, structInit->name);
+        put_expr_list(writer, structInit->fields);
+        break;
+    }
+    case STRUCT_INLINE_EXPR: {
+        StructInlineExpr* structInline = expression->expr;
+        put_type(writer, out, structInline->type);
+        put_expr_list(writer, structInline->fields);
+        break;
+    }
+    case ARRAY_INIT_EXPR: {
+        ArrayInitExpr* arrayInit = expression->expr;
+        put_type(writer, out, arrayInit->type);
+        put_expr_list(writer, arrayInit->elements);
+        break;
+    }
+    case MAP_INIT_EXPR: {
+        MapInitExpr* mapInit = expression->expr;
+        put_type(writer, out, mapInit->type);
+        put_expr_list(writer, mapInit->keys);
+        put_expr_list(writer, mapInit->values);
+        break;
+    }
+    case FUNC_EXPR: {
+        FunctionExpr* functionExpr = expression->expr;
+        put_decl_list(writer, functionExpr->parameters);
+        put_type(writer, out, functionExpr->returnType);
+        put_stmt(writer, functionExpr->body);
+        break;
+    }
+    case CONDITIONAL_EXPR: {
+        ConditionalExpr* conditional = expression->expr;
+        put_expr(writer, conditional->condition);
+        put_expr(writer, conditional->isTrue);
+        put_expr(writer, conditional->isFalse);
+        break;
+    }
+    case MEMBER_EXPR: {
+        MemberExpr* memberExpr = expression->expr;
+        put_expr(writer, memberExpr->object);
+        put_expr_list(writer, memberExpr->members);
+        break;
+    }
+    case ARRAY_MEMBER_EXPR: {
+        ArrayMemberExpr* arrayMember = expression->expr;
+        put_expr(writer, arrayMember->object);
+        put_expr_list(writer, arrayMember->levelOfAccess);
+        break;
+    }
+    case CAST_EXPR: {
+        CastExpr* castExpr = expression->expr;
+        put_expr(writer, castExpr->target);
+        put_type(writer, out, castExpr->type);
+        break;
+    }
+    case LITERAL_EXPR:
+        put_literal(writer, expression->expr);
+        break;
+    }
+}
+
+static bool write_file(const char* path, const char* header, ByteBuffer* payload) {
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return false;
+
+    struct { const char* bytes; size_t size; } parts[] = {
+        {header, CACHE_HEADER_SIZE},
+        {payload->bytes, payload->size}
+    };
+
+    bool written = true;
+    for (size_t i = 0; i < 2 && written; i++) {
+        size_t offset = 0;
+        while (offset < parts[i].size) {
+            ssize_t count = write(fd, parts[i].bytes + offset, parts[i].size - offset);
+            if (count <= 0) {
+                written = false;
+                break;
+            }
+            offset += (size_t) count;
+        }
+    }
+
+    return close(fd) == 0 && written;
+}
+
+bool cache_store(const char* path, const char* source, size_t size, List* declarations) {
+    if (path == NULL || source == NULL || declarations == NULL)
+        return false;
+
+    CacheWriter writer = {
+        .names = byte_buffer_new(),
+        .types = byte_buffer_new(),
+        .nodes = byte_buffer_new_with_capacity(size + DEFAULT_BB_CAPACITY),
+        .nameIndex = symbol_map_new(256, NULL),
+        .typeIndex = MAP_NEW_WITH_HASH(64, pointer_hash, same_pointer, NULL, NULL)
+    };
+
+    put_decl_list(&writer, declarations);
+
+    ByteBuffer* payload = byte_buffer_new_with_capacity(writer.names->size + writer.types->size + writer.nodes->size + 32);
+    put_varint(payload, writer.nameCount);
+    byte_buffer_append(payload, writer.names->bytes, writer.names->size);
+    put_varint(payload, writer.typeCount);
+    byte_buffer_append(payload, writer.types->bytes, writer.types->size);
+    byte_buffer_append(payload, writer.nodes->bytes, writer.nodes->size);
+
+    byte_buffer_free(&writer.names);
+    byte_buffer_free(&writer.types);
+    byte_buffer_free(&writer.nodes);
+    map_free(&writer.nameIndex);
+    map_free(&writer.typeIndex);
+
+    char header[CACHE_HEADER_SIZE] = {0};
+    memcpy(header, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    put_fixed64(header + 8, CACHE_VERSION);
+    put_fixed64(header + 16, size);
+    put_fixed64(header + 24, cache_hash(source, size));
+    put_fixed64(header + 32, payload->size);
+    put_fixed64(header + 40, cache_hash(payload->bytes, payload->size));
+
+    /* written aside and renamed over, runs and threads sharing the script never see half a file */
+    static atomic_uint stores = 0;
+
+    ByteBuffer* temporary = byte_buffer_new();
+    byte_buffer_appendf(temporary, "%s.%ld.%u.tmp", path, (long) getpid(), atomic_fetch_add(&stores, 1));
+    char* temporaryPath = byte_buffer_to_string(temporary);
+    byte_buffer_free(&temporary);
+
+    bool stored = write_file(temporaryPath, header, payload) && rename(temporaryPath, path) == 0;
+    if (!stored) {
+        unlink(temporaryPath);
+    }
+
+    safe_free((void**) &temporaryPath);
+    byte_buffer_free(&payload);
+
+    return stored;
+}
+
+
+typedef struct CacheReader {
+    const unsigned char* at;
+    const unsigned char* end;
+    bool failed;
+    char** names;
+    size_t nameCount;
+    Type** types;
+    size_t typeCount;
+} CacheReader;
+
+static uint64_t get_varint(CacheReader* reader) {
+    uint64_t value = 0;
+
+    for (unsigned shift = 0; shift < 64 && reader->at < reader->end; shift += 7) {
+        unsigned char byte = *reader->at++;
+        value |= (uint64_t) (byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+            return value;
+    }
+
+    reader->failed = true;
+    return 0;
+}
+
+static int64_t get_int(CacheReader* reader) {
+    uint64_t value = get_varint(reader);
+    return (int64_t) (value >> 1) ^ -(int64_t) (value & 1);
+}
+
+static uint64_t get_fixed64(const unsigned char* at) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < 8; i++) {
+        value |= (uint64_t) at[i] << (8 * i);
+    }
+
+    return value;
+}
+
+static double get_double(CacheReader* reader) {
+    if (reader->end - reader->at < 8) {
+        reader->failed = true;
+        return 0;
+    }
+
+    uint64_t bits = get_fixed64(reader->at);
+    reader->at += 8;
+
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+
+    return value;
+}
+
+/* a count of items that each take at least a byte, so a damaged one cannot run away */
+static size_t get_count(CacheReader* reader) {
+    uint64_t count = get_varint(reader);
+    if (count > (uint64_t) (reader->end - reader->at)) {
+        reader->failed = true;
+        return 0;
+    }
+
+    return (size_t) count;
+}
+
+/* length bytes followed by their NUL, left in place */
+static const char* get_bytes(CacheReader* reader, size_t* length) {
+    *length = get_count(reader);
+    if (reader->failed || reader->end - reader->at < (ptrdiff_t) (*length + 1) || reader->at[*length] != '\0') {
+        reader->failed = true;
+        return NULL;
+    }
+
+    const char* bytes = (const char*) reader->at;
+    reader->at += *length + 1;
+
+    return bytes;
+}
+
+static char* get_name(CacheReader* reader) {
+    uint64_t ref = get_varint(reader);
+    if (ref > reader->nameCount) {
+        reader->failed = true;
+        return NULL;
+    }
+
+    return ref == 0 ? NULL : reader->names[ref - 1];
+}
+
+static Type* get_type(CacheReader* reader) {
+    uint64_t ref = get_varint(reader);
+    if (ref > reader->typeCount) {
+        reader->failed = true;
+        return NULL;
+    }
+
+    return ref == 0 ? NULL : reader->types[ref - 1];
+}
+
+static List* get_type_list(CacheReader* reader) {
+    size_t count = get_count(reader);
+
+    List* types = list_new((void (*)(void **)) type_free);
+    for (size_t i = 0; i < count && !reader->failed; i++) {
+        list_insert_last(&types, get_type(reader));
+    }
+
+    return types;
+}
+
+static Type* read_type(CacheReader* reader) {
+    TypeID typeId = (TypeID) get_varint(reader);
+    bool interned = get_varint(reader) != 0;
+
+    if (typeId > _atomic_start && typeId < _atomic_end)
+        return type_atomic(typeId);
+
+    Type* type = NULL;
+
+    switch (typeId) {
+    case CUSTOM_TYPE: {
+        size_t size = get_varint(reader);
+        type = type_new(CUSTOM_TYPE, atomic_type_new(size, get_name(reader)));
+        break;
+    }
+    case NAMED_TYPE: {
+        char* name = get_name(reader);
+        type = NEW_NAMED_TYPE(name, get_type(reader));
+        break;
+    }
+    case STRUCT_TYPE: {
+        size_t size = get_varint(reader);
+        char* name = get_name(reader);
+        type = type_new(STRUCT_TYPE, struct_type_new(size, name, get_type_list(reader)));
+        break;
+    }
+    case ARRAY_DIMENSION_TYPE:
+        type = type_new(ARRAY_DIMENSION_TYPE, array_dimension_new(get_varint(reader)));
+        break;
+    case ARRAY_TYPE: {
+        List* dimensions = get_type_list(reader);
+        type = NEW_ARRAY_TYPE_WITH_DIMENSION(dimensions, get_type(reader));
+        break;
+    }
+    case MAP_TYPE: {
+        Type* key = get_type(reader);
+        type = NEW_MAP_TYPE(key, get_type(reader));
+        break;
+    }
+    case FUNC_TYPE: {
+        List* parameters = get_type_list(reader);
+        type = NEW_FUNCTION_TYPE_WITH_PARAMS_AND_RETURN(parameters, get_type(reader));
+        break;
+    }
+    default:
+        reader->failed = true;
+        return NULL;
+    }
+
+    if (type == NULL) {
+        reader->failed = true;
+        return NULL;
+    }
+
+    return interned ? type_intern(type) : type;
+}
+
+static Token* get_token(CacheReader* reader) {
+    uint64_t kind = get_varint(reader);
+    if (kind == 0)
+        return NULL;
+
+    char* literal = get_name(reader);
+    size_t line = get_varint(reader);
+
+    /* the name comes interned from the table, the token only has to point at it */
+    Token* token = NEW_TOKEN((TokenType) ((int64_t) kind - 2), NULL, line);
+    if (token != NULL) {
+        token->literal = literal;
+    }
+
+    return token;
+}
+
+static Decl* get_decl(CacheReader* reader);
+static Stmt* get_stmt(CacheReader* reader);
+static Expr* get_expr(CacheReader* reader);
+
+static List* get_decl_list(CacheReader* reader) {
+    size_t count = get_count(reader);
+
+    List* declarations = list_new((void (*)(void **)) decl_free);
+    for (size_t i = 0; i < count && !reader->failed; i++) {
+        list_insert_last(&declarations, get_decl(reader));
+    }
+
+    return declarations;
+}
+
+static List* get_expr_list(CacheReader* reader) {
+    size_t count = get_count(reader);
+
+    List* expressions = list_new((void (*)(void **)) expr_free);
+    for (size_t i = 0; i < count && !reader->failed; i++) {
+        list_insert_last(&expressions, get_expr(reader));
+    }
+
+    return expressions;
+}
+
+static Vector* get_vector(CacheReader* reader, void* (*get_item)(CacheReader*), void (*destroy)(void**)) {
+    size_t count = get_count(reader);
+
+    Vector* items = vector_new(destroy);
+    vector_reserve(&items, count);
+    for (size_t i = 0; i < count && !reader->failed; i++) {
+        vector_push(&items, get_item(reader));
+    }
+
+    return items;
+}
+
+static Decl* get_decl(CacheReader* reader) {
+    uint64_t kind = get_varint(reader);
+    if (kind == 0 || reader->failed)
+        return NULL;
+
+    switch ((DeclType) (kind - 1)) {
+    case LET_DECL: {
+        Token* name = get_token(reader);
+        Type* type = get_type(reader);
+        return NEW_LET_DECL(name, type, get_expr(reader));
+    }
+    case CONST_DECL: {
+        Token* name = get_token(reader);
+        Type* type = get_type(reader);
+        return NEW_CONST_DECL(name, type, get_expr(reader));
+    }
+    case FIELD_DECL: {
+        Token* name = get_token(reader);
+        return NEW_FIELD_DECL(name, get_type(reader));
+    }
+    case FUNC_DECL: {
+        Token* name = get_token(reader);
+        List* parameters = get_decl_list(reader);
+        Type* returnType = get_type(reader);
+        Stmt* body = get_stmt(reader);
+
+        Decl* declaration = NEW_FUNCTION_DECL_WITH_PARAMS_AND_RETURN(name, parameters, returnType, body);
+        Type* functionType = get_type(reader);
+        if (declaration != NULL) {
+            ((FunctionDecl*) declaration->decl)->functionType = functionType;
+        }
+
+        return declaration;
+    }
+    case STRUCT_DECL: {
+        Token* name = get_token(reader);
+        return NEW_STRUCT_DECL_WITH_FIELDS(name, get_type_list(reader));
+    }
+    case STMT_DECL:
+        return NEW_STMT_DECL(get_stmt(reader));
+    }
+
+    reader->failed = true;
+    return NULL;
+}
+
+static Stmt* get_stmt(CacheReader* reader) {
+    uint64_t kind = get_varint(reader);
+    if (kind == 0 || reader->failed)
+        return NULL;
+
+    switch ((StmtType) (kind - 1)) {
+    case BLOCK_STMT: {
+        Vector* declarations = get_vector(reader,
+            (void* (*)(CacheReader*)) get_decl, (void (*)(void **)) decl_free);
+        return NEW_BLOCK_STMT_WITH_DECLS(declarations);
+    }
+    case EXPRESSION_STMT:
+        return NEW_EXPR_STMT(get_expr(reader));
+    case RETURN_STMT:
+        return NEW_RETURN_STMT(get_expr(reader));
+    case BREAK_STMT:
+        return NEW_BREAK_STMT();
+    case CONTINUE_STMT:
+        return NEW_CONTINUE_STMT();
+    case IF_STMT: {
+        Expr* condition = get_expr(reader);
+        Stmt* thenBranch = get_stmt(reader);
+        return NEW_IF_STMT(condition, thenBranch, get_stmt(reader));
+    }
+    case WHILE_STMT: {
+        Expr* condition = get_expr(reader);
+        return NEW_WHILE_STMT(condition, get_stmt(reader));
+    }
+    case FOR_STMT: {
+        Decl* initialization = get_decl(reader);
+        Expr* condition = get_expr(reader);
+        Expr* action = get_expr(reader);
+        return NEW_FOR_STMT(initialization, condition, action, get_stmt(reader));
+    }
+    }
+
+    reader->failed = true;
+    return NULL;
+}
+
+static LiteralExpr* get_literal(CacheReader* reader) {
+    switch ((LiteralType) get_varint(reader)) {
+    case IDENT_LITERAL: {
+        char* name = get_name(reader);
+
+        LiteralExpr* literal = NEW_IDENT(NULL);
+        if (literal != NULL) {
+            ((IdentLiteral*) literal->value)->value = name;
+        }
+
+        return literal;
+    }
+    case INT_LITERAL:
+        return NEW_INT(get_int(reader));
+    case FLOAT_LITERAL:
+        return NEW_FLOAT(get_double(reader));
+    case CHAR_LITERAL:
+        return NEW_CHAR((char) get_varint(reader));
+    case STRING_LITERAL: {
+        size_t length = 0;
+        const char* value = get_bytes(reader, &length);
+        return value != NULL ? NEW_STRING_WITH_LENGTH(value, length) : NULL;
+    }
+    case BOOL_LITERAL:
+        return NEW_BOOL(get_varint(reader) != 0);
+    case VOID_LITERAL:
+        return NEW_VOID();
+    case NIL_LITERAL:
+        return NEW_NIL();
+    }
+
+    reader->failed = true;
+    return NULL;
+}
+
+static Expr* get_expr(CacheReader* reader) {
+    uint64_t kind = get_varint(reader);
+    if (kind == 0 || reader->failed)
+        return NULL;
+
+    Type* resolvedType = get_type(reader);
+    Expr* expression = NULL;
+
+    switch ((ExprType) (kind - 1)) {
+    case BINARY_EXPR: {
+        Expr* left = get_expr(reader);
+        Token* op = get_token(reader);
+        Expr* right = get_expr(reader);
+
+        expression = NEW_BINARY_EXPR(left, op, right);
+        OperandTypes operands = (OperandTypes) get_varint(reader);
+        if (expression != NULL) {
+            ((BinaryExpr*) expression->expr)->operands = operands;
+        }
+        break;
+    }
+    case GROUP_EXPR:
+        expression = NEW_GROUP_EXPR(get_expr(reader));
+        break;
+    case ASSIGN_EXPR: {
+        Expr* identifier = get_expr(reader);
+        Token* op = get_token(reader);
+        expression = NEW_ASSIGN_EXPR(identifier, op, get_expr(reader));
+        break;
+    }
+    case CALL_EXPR: {
+        Expr* callee = get_expr(reader);
+        Vector* arguments = get_vector(reader,
+            (void* (*)(CacheReader*)) get_expr, (void (*)(void **)) expr_free);
+        expression = NEW_CALL_EXPR_WITH_ARGS(callee, arguments);
+        break;
+    }
+    case LOGICAL_EXPR: {
+        Expr* left = get_expr(reader);
+        Token* op = get_token(reader);
+        expression = NEW_LOGICAL_EXPR(left, op, get_expr(reader));
+        break;
+    }
+    case UNARY_EXPR: {
+        Token* op = get_token(reader);
+        expression = NEW_UNARY_EXPR(op, get_expr(reader));
+        break;
+    }
+    case UPDATE_EXPR: {
+        Expr* operand = get_expr(reader);
+        expression = NEW_UPDATE_EXPR(operand, get_token(reader));
+        break;
+    }
+    case FIELD_INIT_EXPR: {
+        Token* name = get_token(reader);
+        expression = NEW_FIELD_EXPR(name, get_expr(reader));
+        break;
+    }
+    case STRUCT_INIT_EXPR: {
+        Token* name = get_token(reader);
+        expression = NEW_STRUCT_INIT_EXPR_WITH_FIELDS(name, get_expr_list(reader));
+        break;
+    }
+    case STRUCT_INLINE_EXPR: {
+        Type* type = get_type(reader);
+        expression = NEW_STRUCT_INLINE_EXPR_WITH_FIELDS(type, get_expr_list(reader));
+        break;
+    }
+    case ARRAY_INIT_EXPR: {
+        Type* type = get_type(reader);
+        expression = NEW_ARRAY_INIT_EXPR_WITH_ELEMENTS(type, get_expr_list(reader));
+        break;
+    }
+    case MAP_INIT_EXPR: {
+        Type* type = get_type(reader);
+        List* keys = get_expr_list(reader);
+        expression = expr_new(MAP_INIT_EXPR, map_init_expr_new(type, keys, get_expr_list(reader)),
+            (void (*)(void **)) map_init_expr_to_string,
+            (void (*)(void **)) map_init_expr_free);
+        break;
+    }
+    case FUNC_EXPR: {
+        List* parameters = get_decl_list(reader);
+        Type* returnType = get_type(reader);
+        expression = NEW_FUNCTION_EXPR_WITH_PARAMS_AND_RETURN(parameters, returnType, get_stmt(reader));
+        break;
+    }
+    case CONDITIONAL_EXPR: {
+        Expr* condition = get_expr(reader);
+        Expr* isTrue = get_expr(reader);
+        expression = NEW_CONDITIONAL_EXPR(condition, isTrue, get_expr(reader));
+        break;
+    }
+    case MEMBER_EXPR: {
+        Expr* object = get_expr(reader);
+        expression = NEW_MEMBER_EXPR_WITH_MEMBER_LIST(object, get_expr_list(reader));
+        break;
+    }
+    case ARRAY_MEMBER_EXPR: {
+        Expr* object = get_expr(reader);
+        expression = NEW_ARRAY_MEMBER_EXPR_WITH_ACCESS_LEVEL_LIST(object, get_expr_list(reader));
+        break;
+    }
+    case CAST_EXPR: {
+        Expr* target = get_expr(reader);
+        expression = NEW_CAST_EXPR(target, get_type(reader));
+        break;
+    }
+    case LITERAL_EXPR:
+        expression = NEW_LITERAL_EXPR(get_literal(reader));
+        break;
+    default:
+        reader->failed = true;
+        return NULL;
+    }
+
+    if (expression == NULL) {
+        reader->failed = true;
+        return NULL;
+    }
+
+    expression->resolvedType = resolvedType;
+
+    return expression;
+}
+
+static bool read_tables(CacheReader* reader) {
+    reader->nameCount = get_count(reader);
+    reader->names = safe_malloc((reader->nameCount + 1) * sizeof(char*), NULL);
+    if (reader->names == NULL)
+        return false;
+
+    for (size_t i = 0; i < reader->nameCount && !reader->failed; i++) {
+        size_t length = 0;
+        const char* name = get_bytes(reader, &length);
+        reader->names[i] = name != NULL ? symbol_intern(name) : NULL;
+    }
+
+    reader->typeCount = get_count(reader);
+    reader->types = safe_malloc((reader->typeCount + 1) * sizeof(Type*), NULL);
+    if (reader->types == NULL)
+        return false;
+
+    /* an entry only refers to the ones before it, so the count grows as they are read */
+    size_t count = reader->typeCount;
+    reader->typeCount = 0;
+    while (reader->typeCount < count && !reader->failed) {
+        Type* type = read_type(reader);
+        reader->types[reader->typeCount++] = type;
+    }
+
+    return !reader->failed;
+}
+
+static List* load_mapped(const unsigned char* data, size_t dataSize, const char* source, size_t size) {
+    if (dataSize < CACHE_HEADER_SIZE || memcmp(data, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0)
+        return NULL;
+
+    uint64_t payloadSize = get_fixed64(data + 32);
+
+    if (get_fixed64(data + 8) != CACHE_VERSION
+        || get_fixed64(data + 16) != size
+        || payloadSize != dataSize - CACHE_HEADER_SIZE
+        || get_fixed64(data + 40) != cache_hash(data + CACHE_HEADER_SIZE, payloadSize)
+        || get_fixed64(data + 24) != cache_hash(source, size))
+        return NULL;
+
+    CacheReader reader = {
+        .at = data + CACHE_HEADER_SIZE,
+        .end = data + dataSize
+    };
+
+    List* declarations = NULL;
+
+    if (read_tables(&reader)) {
+        declarations = get_decl_list(&reader);
+    }
+
+    if (reader.failed || reader.at != reader.end) {
+        /* whatever was built lives in the arena and goes with it */
+        declarations = NULL;
+    }
+
+    safe_free((void**) &reader.names);
+    safe_free((void**) &reader.types);
+
+    return declarations;
+}
+
+List* cache_load(const char* path, const char* source, size_t size) {
+    if (path == NULL || source == NULL)
+        return NULL;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size < CACHE_HEADER_SIZE) {
+        close(fd);
+        return NULL;
+    }
+
+    void* data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (data == MAP_FAILED)
+        return NULL;
+
+    madvise(data, info.st_size, MADV_SEQUENTIAL);
+
+    List* declarations = load_mapped(data, info.st_size, source, size);
+
+    munmap(data, info.st_size);
+
+    return declarations;
+}
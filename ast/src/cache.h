@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "list.h"
+
+
+#define CACHE_VERSION 1
+#define CACHE_EXTENSION ".rosec"
+
+/*
+ * Checked trees saved next to their source so a later run can skip the
+ * lexer, the parser and the type checker. The file holds no pointers: a
+ * header with the hash and size of the source it was built from, then a
+ * table of names, a table of the types the tree refers to and the nodes in
+ * prefix order, referring to names and types by index. Integers are little
+ * endian varints, so the file reads the same on any host.
+ *
+ * A cache is written once the tree is checked and before the optimizer or
+ * the resolver touch it, so it is valid for every engine and -O level.
+ */
+
+/* file.rose caches to file.rosec, any other name gets .rosec appended */
+char* cache_path(const char* sourcePath);
+
+uint64_t cache_hash(const void* data, size_t size);
+
+/* replaces the cache at path atomically, false when it could not be written */
+bool cache_store(const char* path, const char* source, size_t size, List* declarations);
+
+/*
+ * The tree cached at path for exactly this source, built in the active
+ * arena. NULL when there is no cache, it was built from another source or
+ * another version, or it is damaged; the caller parses instead.
+ */
+List* cache_load(const char* path, const char* source, size_t size);
@@ -0,0 +1,1106 @@
+#include "compiler.h"
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ast.h"
+#include "list.h"
+#include "literal-type.h"
+#include "map.h"
+#include "object.h"
+#include "smem.h"
+#include "token.h"
+#include "types.h"
+#include "utils.h"
+
+
+void chunk_init(Chunk* chunk) {
+    if (chunk == NULL)
+        return;
+
+    *chunk = (Chunk) {
+        .code = NULL,
+        .count = 0,
+        .capacity = 0,
+        .constants = NULL,
+        .constantCount = 0,
+        .constantCapacity = 0,
+        .types = vector_new((void (*)(void**)) type_free),
+        .handlers = NULL,
+        .handlerCount = 0,
+        .handlerCapacity = 0
+    };
+}
+
+void chunk_write(Chunk* chunk, uint8_t byte) {
+    if (chunk == NULL)
+        return;
+
+    if (chunk->count + 1 > chunk->capacity) {
+        size_t capacity = chunk->capacity < 8 ? 8 : chunk->capacity * 2;
+        chunk->code = chunk->code == NULL
+            ? safe_malloc(capacity * sizeof(uint8_t), NULL)
+            : safe_realloc((void**) &chunk->code, capacity * sizeof(uint8_t), NULL);
+        chunk->capacity = capacity;
+    }
+
+    chunk->code[chunk->count++] = byte;
+}
+
+size_t chunk_add_constant(Chunk* chunk, Value value) {
+    if (chunk->constantCount + 1 > chunk->constantCapacity) {
+        size_t capacity = chunk->constantCapacity < 8 ? 8 : chunk->constantCapacity * 2;
+        chunk->constants = chunk->constants == NULL
+            ? safe_malloc(capacity * sizeof(Value), NULL)
+            : safe_realloc((void**) &chunk->constants, capacity * sizeof(Value), NULL);
+        chunk->constantCapacity = capacity;
+    }
+
+    chunk->constants[chunk->constantCount] = value;
+
+    return chunk->constantCount++;
+}
+
+size_t chunk_add_type(Chunk* chunk, Type* type) {
+    vector_push(&chunk->types, type);
+
+    return vector_size(&chunk->types) - 1;
+}
+
+void chunk_add_handler(Chunk* chunk, Handler handler) {
+    if (chunk->handlerCount + 1 > chunk->handlerCapacity) {
+        size_t capacity = chunk->handlerCapacity < 8 ? 8 : chunk->handlerCapacity * 2;
+        chunk->handlers = chunk->handlers == NULL
+            ? safe_malloc(capacity * sizeof(Handler), NULL)
+            : safe_realloc((void**) &chunk->handlers, capacity * sizeof(Handler), NULL);
+        chunk->handlerCapacity = capacity;
+    }
+
+    chunk->handlers[chunk->handlerCount++] = handler;
+}
+
+Type* chunk_get_type(Chunk* chunk, size_t index) {
+    return vector_get_at(&chunk->types, index);
+}
+
+void chunk_free(Chunk* chunk) {
+    if (chunk == NULL)
+        return;
+
+    for (size_t i = 0; i < chunk->constantCount; i++) {
+        Value constant = chunk->constants[i];
+
+        if (IS_FUNCTION(constant)) {
+            FunctionProto* function = AS_FUNCTION(constant);
+            function_proto_free(&function);
+        } else if (IS_OBJECT(constant)) {
+            Object* object = AS_OBJECT(constant);
+            object_free(&object);
+        } else if (IS_BIG_INT(constant)) {
+            Object* box = AS_BIG_INT(constant);
+            object_free(&box);
+        }
+    }
+
+    safe_free((void**) &chunk->code);
+    safe_free((void**) &chunk->constants);
+    safe_free((void**) &chunk->handlers);
+    vector_free(&chunk->types);
+
+    chunk->count = chunk->capacity = 0;
+    chunk->constantCount = chunk->constantCapacity = 0;
+    chunk->handlerCount = chunk->handlerCapacity = 0;
+}
+
+FunctionProto* function_proto_new(const char* name) {
+    FunctionProto* function = NULL;
+    function = safe_malloc(sizeof(FunctionProto), NULL);
+    if (function == NULL) {
+        return NULL;
+    }
+
+    *function = (FunctionProto) {
+        .name = str_dup(name),
+        .arity = 0,
+        .upvalueCount = 0
+    };
+
+    chunk_init(&function->chunk);
+
+    return function;
+}
+
+void function_proto_free(FunctionProto** function) {
+    if (function == NULL || *function == NULL)
+        return;
+
+    chunk_free(&(*function)->chunk);
+    safe_free((void**) &(*function)->name);
+
+    safe_free((void**) function);
+}
+
+
+typedef struct Local {
+    char* name;
+    int depth;
+    bool isCaptured;
+} Local;
+
+typedef struct UpvalueRef {
+    uint8_t index;
+    bool isLocal;
+} UpvalueRef;
+
+typedef struct Loop {
+    struct Loop* enclosing;
+    size_t start;
+    int scopeDepth;
+    List* breakJumps;    /* List of (size_t*) */
+    List* continueJumps; /* List of (size_t*), patched when the loop has no fixed start */
+    bool hasStart;
+} Loop;
+
+typedef struct Compiler {
+    struct Compiler* enclosing;
+    FunctionProto* function;
+    Local locals[UINT8_COUNT];
+    size_t localCount;
+    UpvalueRef upvalues[UINT8_COUNT];
+    int scopeDepth;
+    Loop* loop;
+} Compiler;
+
+static _Thread_local Compiler* current = NULL;
+
+static _Thread_local Map* globals = NULL;
+static _Thread_local List* globalNames = NULL;
+
+static _Thread_local bool hadError = false;
+
+static void compile_decl(Decl* declaration);
+static void compile_stmt(Stmt* statement);
+static void compile_expr(Expr* expression);
+
+static bool entry_cmp(const MapEntry** entry, char** key) {
+    return strcmp((*entry)->key, *key) == 0;
+}
+
+/* only the first error is reported, the ones after it tend to follow from it */
+static void compile_error(const char* fmt, ...) {
+    if (hadError)
+        return;
+
+    va_list args;
+    va_start(args, fmt);
+
+    fprintf(stderr, "compile error: ");
+    vfprintf(stderr, fmt, args);
+    fprintf(stderr, "\n");
+
+    va_end(args);
+
+    hadError = true;
+}
+
+static Chunk* current_chunk(void) {
+    return &current->function->chunk;
+}
+
+static void emit_byte(uint8_t byte) {
+    chunk_write(current_chunk(), byte);
+}
+
+static void emit_bytes(uint8_t first, uint8_t second) {
+    emit_byte(first);
+    emit_byte(second);
+}
+
+static void emit_short(uint16_t value) {
+    emit_byte((value >> 8) & 0xff);
+    emit_byte(value & 0xff);
+}
+
+static void emit_op_short(OpCode op, size_t operand) {
+    if (operand > UINT16_MAX) {
+        compile_error("too many constants in one chunk");
+        return;
+    }
+
+    emit_byte(op);
+    emit_short((uint16_t) operand);
+}
+
+static void emit_constant(Value value) {
+    emit_op_short(OP_CONSTANT, chunk_add_constant(current_chunk(), value));
+}
+
+static size_t emit_jump(OpCode op) {
+    emit_byte(op);
+    emit_short(0xffff);
+
+    return current_chunk()->count - 2;
+}
+
+static void patch_jump(size_t offset) {
+    size_t jump = current_chunk()->count - offset - 2;
+
+    if (jump > UINT16_MAX) {
+        compile_error("too much code to jump over");
+        return;
+    }
+
+    current_chunk()->code[offset] = (jump >> 8) & 0xff;
+    current_chunk()->code[offset + 1] = jump & 0xff;
+}
+
+static void emit_loop(size_t start) {
+    emit_byte(OP_LOOP);
+
+    size_t offset = current_chunk()->count - start + 2;
+    if (offset > UINT16_MAX) {
+        compile_error("loop body too large");
+        return;
+    }
+
+    emit_short((uint16_t) offset);
+}
+
+/* an error in the code emitted since start resumes at target with the current locals */
+static void add_handler(size_t start, size_t target) {
+    chunk_add_handler(current_chunk(), (Handler) {
+        .start = start,
+        .end = current_chunk()->count,
+        .target = target,
+        .depth = current->localCount
+    });
+}
+
+static void compiler_init(Compiler* compiler, const char* name) {
+    compiler->enclosing = current;
+    compiler->function = function_proto_new(name);
+    compiler->localCount = 0;
+    compiler->scopeDepth = 0;
+    compiler->loop = NULL;
+
+    current = compiler;
+
+    /* slot zero holds the running closure */
+    Local* local = &current->locals[current->localCount++];
+    local->name = "";
+    local->depth = 0;
+    local->isCaptured = false;
+}
+
+static FunctionProto* compiler_end(void) {
+    emit_byte(OP_NIL);
+    emit_byte(OP_RETURN);
+
+    FunctionProto* function = current->function;
+
+    current = current->enclosing;
+
+    return function;
+}
+
+static size_t resolve_global(const char* name) {
+    size_t* index = map_get(globals, (void*) name);
+    if (index != NULL) {
+        return *index;
+    }
+
+    index = safe_malloc(sizeof(size_t), NULL);
+    *index = list_size(&globalNames);
+
+    list_insert_last(&globalNames, str_dup(name));
+    map_put(globals, str_dup(name), index);
+
+    return *index;
+}
+
+static int resolve_local(Compiler* compiler, const char* name) {
+    for (int i = (int) compiler->localCount - 1; i >= 0; i--) {
+        Local* local = &compiler->locals[i];
+
+        if (local->depth != -1 && strcmp(local->name, name) == 0) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+static int add_upvalue(Compiler* compiler, uint8_t index, bool isLocal) {
+    size_t upvalueCount = compiler->function->upvalueCount;
+
+    for (size_t i = 0; i < upvalueCount; i++) {
+        UpvalueRef* upvalue = &compiler->upvalues[i];
+
+        if (upvalue->index == index && upvalue->isLocal == isLocal) {
+            return (int) i;
+        }
+    }
+
+    if (upvalueCount == UINT8_COUNT) {
+        compile_error("too many closure variables in function");
+        return 0;
+    }
+
+    compiler->upvalues[upvalueCount].isLocal = isLocal;
+    compiler->upvalues[upvalueCount].index = index;
+
+    return (int) compiler->function->upvalueCount++;
+}
+
+static int resolve_upvalue(Compiler* compiler, const char* name) {
+    if (compiler->enclosing == NULL)
+        return -1;
+
+    int local = resolve_local(compiler->enclosing, name);
+    if (local != -1) {
+        compiler->enclosing->locals[local].isCaptured = true;
+        return add_upvalue(compiler, (uint8_t) local, true);
+    }
+
+    int upvalue = resolve_upvalue(compiler->enclosing, name);
+    if (upvalue != -1) {
+        return add_upvalue(compiler, (uint8_t) upvalue, false);
+    }
+
+    return -1;
+}
+
+static void add_local(char* name) {
+    if (current->localCount == UINT8_COUNT) {
+        compile_error("too many local variables in function");
+        return;
+    }
+
+    Local* local = &current->locals[current->localCount++];
+    local->name = name;
+    local->depth = -1;
+    local->isCaptured = false;
+}
+
+static void mark_initialized(void) {
+    current->locals[current->localCount - 1].depth = current->scopeDepth;
+}
+
+/* binds the value on top of the stack to `name` in the current scope */
+static void define_variable(char* name) {
+    if (current->scopeDepth > 0) {
+        add_local(name);
+        mark_initialized();
+        return;
+    }
+
+    emit_op_short(OP_DEFINE_GLOBAL, resolve_global(name));
+}
+
+static void begin_scope(void) {
+    current->scopeDepth++;
+}
+
+static void discard_locals(int depth) {
+    for (int i = (int) current->localCount - 1; i >= 0 && current->locals[i].depth > depth; i--) {
+        emit_byte(current->locals[i].isCaptured ? OP_CLOSE_UPVALUE : OP_POP);
+    }
+}
+
+static void end_scope(void) {
+    discard_locals(current->scopeDepth - 1);
+
+    current->scopeDepth--;
+
+    while (current->localCount > 0 && current->locals[current->localCount - 1].depth > current->scopeDepth) {
+        current->localCount--;
+    }
+}
+
+static void emit_get_variable(char* name) {
+    int arg = resolve_local(current, name);
+    if (arg != -1) {
+        emit_bytes(OP_GET_LOCAL, (uint8_t) arg);
+        return;
+    }
+
+    arg = resolve_upvalue(current, name);
+    if (arg != -1) {
+        emit_bytes(OP_GET_UPVALUE, (uint8_t) arg);
+        return;
+    }
+
+    emit_op_short(OP_GET_GLOBAL, resolve_global(name));
+}
+
+static void emit_set_variable(char* name) {
+    int arg = resolve_local(current, name);
+    if (arg != -1) {
+        emit_bytes(OP_SET_LOCAL, (uint8_t) arg);
+        return;
+    }
+
+    arg = resolve_upvalue(current, name);
+    if (arg != -1) {
+        emit_bytes(OP_SET_UPVALUE, (uint8_t) arg);
+        return;
+    }
+
+    emit_op_short(OP_SET_GLOBAL, resolve_global(name));
+}
+
+static char* ident_name(Expr* expression) {
+    if (expression == NULL || expression->type != LITERAL_EXPR)
+        return NULL;
+
+    LiteralExpr* literalExpr = expression->expr;
+    if (literalExpr->type != IDENT_LITERAL)
+        return NULL;
+
+    return ((IdentLiteral*) literalExpr->value)->value;
+}
+
+static OpCode binary_op_code(TokenType type) {
+    switch (type) {
+    case TOKEN_ADD: case TOKEN_ADD_ASSIGN: return OP_ADD;
+    case TOKEN_SUB: case TOKEN_SUB_ASSIGN: return OP_SUB;
+    case TOKEN_MUL: case TOKEN_MUL_ASSIGN: return OP_MUL;
+    case TOKEN_QUO: case TOKEN_QUO_ASSIGN: return OP_QUO;
+    case TOKEN_REM: case TOKEN_REM_ASSIGN: return OP_REM;
+    case TOKEN_AND: case TOKEN_AND_ASSIGN: return OP_AND;
+    case TOKEN_OR:  case TOKEN_OR_ASSIGN:  return OP_OR;
+    case TOKEN_XOR: case TOKEN_XOR_ASSIGN: return OP_XOR;
+    case TOKEN_SHL: case TOKEN_SHL_ASSIGN: return OP_SHL;
+    case TOKEN_SHR: case TOKEN_SHR_ASSIGN: return OP_SHR;
+    case TOKEN_EQL: return OP_EQL;
+    case TOKEN_NEQ: return OP_NEQ;
+    case TOKEN_LSS: return OP_LSS;
+    case TOKEN_GTR: return OP_GTR;
+    case TOKEN_LEQ: return OP_LEQ;
+    case TOKEN_GEQ: return OP_GEQ;
+    default:
+        compile_error("unsupported binary operator");
+        return OP_NIL;
+    }
+}
+
+static void compile_function(const char* name, List* parameters, Stmt* body) {
+    Compiler compiler;
+    compiler_init(&compiler, name);
+
+    begin_scope();
+
+    list_foreach(parameter, parameters) {
+        FieldDecl* fieldDecl = ((Decl*) parameter->value)->decl;
+
+        current->function->arity++;
+        add_local(fieldDecl->name->literal);
+        mark_initialized();
+    }
+
+    compile_stmt(body);
+
+    FunctionProto* function = compiler_end();
+
+    emit_op_short(OP_CLOSURE, chunk_add_constant(current_chunk(), FUNCTION_VALUE(function)));
+
+    for (size_t i = 0; i < function->upvalueCount; i++) {
+        emit_byte(compiler.upvalues[i].isLocal ? 1 : 0);
+        emit_byte(compiler.upvalues[i].index);
+    }
+}
+
+static void loop_begin(Loop* loop, bool hasStart) {
+    *loop = (Loop) {
+        .enclosing = current->loop,
+        .start = current_chunk()->count,
+        .scopeDepth = current->scopeDepth,
+        .breakJumps = list_new(safe_free),
+        .continueJumps = list_new(safe_free),
+        .hasStart = hasStart
+    };
+
+    current->loop = loop;
+}
+
+static void loop_patch(List* jumps) {
+    list_foreach(jump, jumps) {
+        patch_jump(*(size_t*) jump->value);
+    }
+}
+
+static void loop_add_jump(List* jumps, size_t offset) {
+    size_t* jump = safe_malloc(sizeof(size_t), NULL);
+    *jump = offset;
+
+    list_insert_last(&jumps, jump);
+}
+
+static void loop_end(Loop* loop) {
+    loop_patch(loop->breakJumps);
+
+    list_free(&loop->breakJumps);
+    list_free(&loop->continueJumps);
+
+    current->loop = loop->enclosing;
+}
+
+static void compile_decl(Decl* declaration) {
+    if (declaration == NULL)
+        return;
+
+    switch (declaration->type) {
+    case LET_DECL: {
+        LetDecl* letDecl = declaration->decl;
+
+        if (letDecl->expression != NULL) {
+            compile_expr(letDecl->expression);
+        } else {
+            emit_byte(OP_NIL);
+        }
+
+        define_variable(letDecl->name->literal);
+        break;
+    }
+    case CONST_DECL: {
+        ConstDecl* constDecl = declaration->decl;
+
+        if (constDecl->expression != NULL) {
+            compile_expr(constDecl->expression);
+        } else {
+            emit_byte(OP_NIL);
+        }
+
+        define_variable(constDecl->name->literal);
+        break;
+    }
+    case FUNC_DECL: {
+        FunctionDecl* functionDecl = declaration->decl;
+        char* functionName = functionDecl->name->literal;
+
+        if (current->scopeDepth > 0) {
+            /* visible inside its own body for recursion */
+            add_local(functionName);
+            mark_initialized();
+            compile_function(functionName, functionDecl->parameters, functionDecl->body);
+            break;
+        }
+
+        compile_function(functionName, functionDecl->parameters, functionDecl->body);
+        emit_op_short(OP_DEFINE_GLOBAL, resolve_global(functionName));
+        break;
+    }
+    case STMT_DECL: {
+        StmtDecl* stmtDecl = declaration->decl;
+
+        compile_stmt(stmtDecl->stmt);
+        break;
+    }
+    case FIELD_DECL:
+    case STRUCT_DECL:
+    default:
+        break;
+    }
+}
+
+static void compile_stmt(Stmt* statement) {
+    if (statement == NULL)
+        return;
+
+    switch (statement->type) {
+    case BLOCK_STMT: {
+        BlockStmt* blockStmt = statement->stmt;
+
+        begin_scope();
+
+        vector_foreach(declaration, blockStmt->declarations) {
+            compile_decl(*declaration);
+        }
+
+        end_scope();
+        break;
+    }
+    case EXPRESSION_STMT: {
+        ExpressionStmt* exprStmt = statement->stmt;
+
+        compile_expr(exprStmt->expression);
+        emit_byte(OP_POP);
+        break;
+    }
+    case RETURN_STMT: {
+        ReturnStmt* returnStmt = statement->stmt;
+
+        if (returnStmt->expression != NULL) {
+            compile_expr(returnStmt->expression);
+        } else {
+            emit_byte(OP_NIL);
+        }
+
+        emit_byte(OP_RETURN);
+        break;
+    }
+    case BREAK_STMT: {
+        if (current->loop == NULL) {
+            compile_error("break outside of a loop");
+            break;
+        }
+
+        discard_locals(current->loop->scopeDepth);
+        loop_add_jump(current->loop->breakJumps, emit_jump(OP_JUMP));
+        break;
+    }
+    case CONTINUE_STMT: {
+        if (current->loop == NULL) {
+            compile_error("continue outside of a loop");
+            break;
+        }
+
+        discard_locals(current->loop->scopeDepth);
+
+        if (current->loop->hasStart) {
+            emit_loop(current->loop->start);
+        } else {
+            loop_add_jump(current->loop->continueJumps, emit_jump(OP_JUMP));
+        }
+        break;
+    }
+    case IF_STMT: {
+        IfStmt* ifStmt = statement->stmt;
+
+        compile_expr(ifStmt->condition);
+
+        size_t thenJump = emit_jump(OP_JUMP_IF_FALSE);
+
+        compile_stmt(ifStmt->thenBranch);
+
+        if (ifStmt->elseBranch == NULL) {
+            patch_jump(thenJump);
+            break;
+        }
+
+        size_t elseJump = emit_jump(OP_JUMP);
+
+        patch_jump(thenJump);
+        compile_stmt(ifStmt->elseBranch);
+        patch_jump(elseJump);
+        break;
+    }
+    case WHILE_STMT: {
+        WhileStmt* whileStmt = statement->stmt;
+
+        Loop loop;
+        loop_begin(&loop, true);
+
+        compile_expr(whileStmt->condition);
+        size_t exitJump = emit_jump(OP_JUMP_IF_FALSE);
+
+        size_t bodyStart = current_chunk()->count;
+        compile_stmt(whileStmt->body);
+        add_handler(bodyStart, loop.start);
+        emit_loop(loop.start);
+
+        patch_jump(exitJump);
+        loop_end(&loop);
+        break;
+    }
+    case FOR_STMT: {
+        ForStmt* forStmt = statement->stmt;
+
+        begin_scope();
+
+        compile_decl(forStmt->initialization);
+
+        Loop loop;
+        loop_begin(&loop, forStmt->action == NULL);
+
+        size_t exitJump = 0;
+        bool hasCondition = forStmt->condition != NULL;
+
+        if (hasCondition) {
+            compile_expr(forStmt->condition);
+            exitJump = emit_jump(OP_JUMP_IF_FALSE);
+        }
+
+        compile_stmt(forStmt->body);
+
+        loop_patch(loop.continueJumps);
+
+        if (forStmt->action != NULL) {
+            compile_expr(forStmt->action);
+            emit_byte(OP_POP);
+        }
+
+        emit_loop(loop.start);
+
+        if (hasCondition) {
+            patch_jump(exitJump);
+        }
+
+        loop_end(&loop);
+        end_scope();
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+/* pushes the array and all of its indices, OP_INDEX then resolves them in one step */
+static uint8_t compile_array_operands(ArrayMemberExpr* arrayMember) {
+    size_t count = list_size(&arrayMember->levelOfAccess);
+
+    if (count > ARRAY_MAX_RANK) {
+        compile_error("too many array indices");
+        count = ARRAY_MAX_RANK;
+    }
+
+    compile_expr(arrayMember->object);
+
+    list_foreach(index, arrayMember->levelOfAccess) {
+        compile_expr(index->value);
+    }
+
+    return (uint8_t) count;
+}
+
+static void compile_assign_expr(AssignExpr* assignExpr) {
+    TokenType op = assignExpr->op->type;
+    Expr* target = assignExpr->identifier;
+
+    if (target != NULL && target->type == ARRAY_MEMBER_EXPR) {
+        uint8_t count = compile_array_operands(target->expr);
+
+        if (op == TOKEN_ASSIGN) {
+            compile_expr(assignExpr->expression);
+        } else {
+            emit_bytes(OP_DUPN, count + 1);
+            emit_bytes(OP_INDEX, count);
+            compile_expr(assignExpr->expression);
+            emit_byte(binary_op_code(op));
+        }
+
+        emit_bytes(OP_SET_INDEX, count);
+        return;
+    }
+
+    char* name = ident_name(target);
+    if (name == NULL) {
+        compile_error("invalid assignment target");
+        return;
+    }
+
+    if (op != TOKEN_ASSIGN) {
+        emit_get_variable(name);
+        compile_expr(assignExpr->expression);
+        emit_byte(binary_op_code(op));
+    } else {
+        compile_expr(assignExpr->expression);
+    }
+
+    emit_set_variable(name);
+}
+
+static void compile_update_expr(UpdateExpr* updateExpr) {
+    bool isIncrement = updateExpr->op->type == TOKEN_INC;
+    Expr* target = updateExpr->expression;
+
+    if (target != NULL && target->type == ARRAY_MEMBER_EXPR) {
+        uint8_t count = compile_array_operands(target->expr);
+
+        emit_bytes(isIncrement ? OP_INC_INDEX : OP_DEC_INDEX, count);
+        return;
+    }
+
+    char* name = ident_name(target);
+
+    if (name == NULL) {
+        compile_error("invalid update target");
+        return;
+    }
+
+    int slot = resolve_local(current, name);
+    if (slot != -1) {
+        emit_bytes(isIncrement ? OP_INC_LOCAL : OP_DEC_LOCAL, (uint8_t) slot);
+        return;
+    }
+
+    emit_get_variable(name);
+    emit_byte(OP_DUP);
+    emit_byte(isIncrement ? OP_INC : OP_DEC);
+    emit_set_variable(name);
+    emit_byte(OP_POP);
+}
+
+static void compile_literal_expr(LiteralExpr* literalExpr) {
+    switch (literalExpr->type) {
+    case IDENT_LITERAL:
+        emit_get_variable(((IdentLiteral*) literalExpr->value)->value);
+        break;
+    case INT_LITERAL:
+        emit_constant(INT_VALUE(((IntLiteral*) literalExpr->value)->value));
+        break;
+    case FLOAT_LITERAL:
+        emit_constant(FLOAT_VALUE(((FloatLiteral*) literalExpr->value)->value));
+        break;
+    case CHAR_LITERAL:
+        emit_constant(CHAR_VALUE(((CharLiteral*) literalExpr->value)->value));
+        break;
+    case STRING_LITERAL:
+        emit_constant(OBJECT_VALUE(NEW_STRING_OBJECT(((StringLiteral*) literalExpr->value)->value)));
+        break;
+    case BOOL_LITERAL:
+        emit_byte(((BoolLiteral*) literalExpr->value)->value ? OP_TRUE : OP_FALSE);
+        break;
+    case VOID_LITERAL:
+    case NIL_LITERAL:
+        emit_byte(OP_NIL);
+        break;
+    default:
+        compile_error("cannot determine value of expression");
+        break;
+    }
+}
+
+static void compile_expr(Expr* expression) {
+    if (expression == NULL) {
+        emit_byte(OP_NIL);
+        return;
+    }
+
+    switch (expression->type) {
+    case BINARY_EXPR: {
+        BinaryExpr* binaryExpr = expression->expr;
+
+        compile_expr(binaryExpr->left);
+        compile_expr(binaryExpr->right);
+        emit_byte(binary_op_code(binaryExpr->op->type));
+        break;
+    }
+    case GROUP_EXPR: {
+        GroupExpr* groupExpr = expression->expr;
+
+        compile_expr(groupExpr->expression);
+        break;
+    }
+    case ASSIGN_EXPR: {
+        compile_assign_expr(expression->expr);
+        break;
+    }
+    case CALL_EXPR: {
+        CallExpr* callExpr = expression->expr;
+
+        compile_expr(callExpr->callee);
+
+        size_t argc = vector_size(&callExpr->arguments);
+        if (argc > UINT8_MAX) {
+            compile_error("too many arguments in call");
+            break;
+        }
+
+        vector_foreach(argument, callExpr->arguments) {
+            compile_expr(*argument);
+        }
+
+        emit_bytes(OP_CALL, (uint8_t) argc);
+        break;
+    }
+    case LOGICAL_EXPR: {
+        LogicalExpr* logicalExpr = expression->expr;
+        OpCode shortCircuit = logicalExpr->op->type == TOKEN_LAND ? OP_JUMP_IF_FALSE : OP_JUMP_IF_TRUE;
+
+        compile_expr(logicalExpr->left);
+        size_t leftJump = emit_jump(shortCircuit);
+
+        compile_expr(logicalExpr->right);
+        size_t rightJump = emit_jump(shortCircuit);
+
+        emit_byte(shortCircuit == OP_JUMP_IF_FALSE ? OP_TRUE : OP_FALSE);
+        size_t endJump = emit_jump(OP_JUMP);
+
+        patch_jump(leftJump);
+        patch_jump(rightJump);
+        emit_byte(shortCircuit == OP_JUMP_IF_FALSE ? OP_FALSE : OP_TRUE);
+
+        patch_jump(endJump);
+        break;
+    }
+    case UNARY_EXPR: {
+        UnaryExpr* unaryExpr = expression->expr;
+
+        compile_expr(unaryExpr->expression);
+
+        switch (unaryExpr->op->type) {
+        case TOKEN_ADD:   emit_byte(OP_PLUS);  break;
+        case TOKEN_SUB:   emit_byte(OP_NEG);   break;
+        case TOKEN_NOT:   emit_byte(OP_NOT);   break;
+        case TOKEN_TILDE: emit_byte(OP_TILDE); break;
+        default:
+            compile_error("invalid operation: %s", unaryExpr->op->literal);
+            break;
+        }
+        break;
+    }
+    case UPDATE_EXPR: {
+        compile_update_expr(expression->expr);
+        break;
+    }
+    case ARRAY_INIT_EXPR: {
+        ArrayInitExpr* arrayInitExpr = expression->expr;
+
+        size_t count = list_size(&arrayInitExpr->elements);
+        if (count > UINT16_MAX) {
+            compile_error("too many elements in array literal");
+            break;
+        }
+
+        list_foreach(element, arrayInitExpr->elements) {
+            compile_expr(element->value);
+        }
+
+        Type* arrayType = type_copy((const Type**) &arrayInitExpr->type);
+
+        emit_op_short(OP_ARRAY, chunk_add_type(current_chunk(), arrayType));
+        emit_short((uint16_t) count);
+        break;
+    }
+    case MAP_INIT_EXPR: {
+        MapInitExpr* mapInitExpr = expression->expr;
+
+        size_t count = list_size(&mapInitExpr->keys);
+        if (count > UINT16_MAX) {
+            compile_error("too many entries in map literal");
+            break;
+        }
+
+        ListNode* value = mapInitExpr->values->head;
+        list_foreach(key, mapInitExpr->keys) {
+            compile_expr(key->value);
+            compile_expr(value->value);
+            value = value->next;
+        }
+
+        Type* mapType = type_copy((const Type**) &mapInitExpr->type);
+
+        emit_op_short(OP_MAP, chunk_add_type(current_chunk(), mapType));
+        emit_short((uint16_t) count);
+        break;
+    }
+    case FUNC_EXPR: {
+        FunctionExpr* functionExpr = expression->expr;
+
+        compile_function("anonymous", functionExpr->parameters, functionExpr->body);
+        break;
+    }
+    case CONDITIONAL_EXPR: {
+        ConditionalExpr* conditionalExpr = expression->expr;
+
+        compile_expr(conditionalExpr->condition);
+        size_t falseJump = emit_jump(OP_JUMP_IF_FALSE);
+
+        compile_expr(conditionalExpr->isTrue);
+        size_t endJump = emit_jump(OP_JUMP);
+
+        patch_jump(falseJump);
+        compile_expr(conditionalExpr->isFalse);
+
+        patch_jump(endJump);
+        break;
+    }
+    case ARRAY_MEMBER_EXPR: {
+        emit_bytes(OP_INDEX, compile_array_operands(expression->expr));
+        break;
+    }
+    case CAST_EXPR: {
+        CastExpr* castExpr = expression->expr;
+
+        compile_expr(castExpr->target);
+        emit_bytes(OP_CAST, (uint8_t) castExpr->type->typeId);
+        break;
+    }
+    case LITERAL_EXPR: {
+        compile_literal_expr(expression->expr);
+        break;
+    }
+    case FIELD_INIT_EXPR:
+    case STRUCT_INIT_EXPR:
+    case STRUCT_INLINE_EXPR:
+    case MEMBER_EXPR: {
+        /* structs have no runtime value yet, the tree engine reads all of these as nil too */
+        emit_byte(OP_NIL);
+        break;
+    }
+    default:
+        compile_error("expression not supported by the vm");
+        break;
+    }
+}
+
+Program* compile(List* declarations) {
+    if (declarations == NULL)
+        return NULL;
+
+    hadError = false;
+
+    globals = MAP_NEW(64, entry_cmp, safe_free, safe_free);
+    globalNames = list_new(NULL);
+
+    Compiler compiler;
+    compiler_init(&compiler, "script");
+
+    list_foreach(declaration, declarations) {
+        size_t start = current_chunk()->count;
+        compile_decl(declaration->value);
+        add_handler(start, current_chunk()->count);
+    }
+
+    FunctionProto* script = compiler_end();
+
+    Program* program = NULL;
+
+    if (!hadError) {
+        program = safe_malloc(sizeof(Program), NULL);
+    }
+
+    if (program != NULL) {
+        *program = (Program) {
+            .script = script,
+            .globalNames = safe_calloc(list_size(&globalNames) + 1, sizeof(char*), NULL),
+            .globalCount = list_size(&globalNames)
+        };
+
+        size_t index = 0;
+        list_foreach(name, globalNames) {
+            program->globalNames[index++] = name->value;
+        }
+    } else {
+        function_proto_free(&script);
+
+        list_foreach(name, globalNames) {
+            safe_free((void**) &name->value);
+        }
+    }
+
+    list_free(&globalNames);
+    map_free(&globals);
+
+    return program;
+}
+
+void program_free(Program** program) {
+    if (program == NULL || *program == NULL)
+        return;
+
+    for (size_t i = 0; i < (*program)->globalCount; i++) {
+        safe_free((void**) &(*program)->globalNames[i]);
+    }
+
+    safe_free((void**) &(*program)->globalNames);
+    function_proto_free(&(*program)->script);
+
+    safe_free((void**) program);
+}
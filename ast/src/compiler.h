@@ -0,0 +1,132 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "list.h"
+#include "object.h"
+#include "types.h"
+#include "value.h"
+#include "vector.h"
+
+
+#define UINT8_COUNT (UINT8_MAX + 1)
+
+typedef enum OpCode {
+    OP_CONSTANT,        /* u16 constant */
+    OP_NIL,
+    OP_TRUE,
+    OP_FALSE,
+    OP_POP,
+    OP_DUP,
+    OP_DUPN,            /* u8 count */
+
+    OP_DEFINE_GLOBAL,   /* u16 global */
+    OP_GET_GLOBAL,      /* u16 global */
+    OP_SET_GLOBAL,      /* u16 global */
+    OP_GET_LOCAL,       /* u8 slot */
+    OP_SET_LOCAL,       /* u8 slot */
+    OP_GET_UPVALUE,     /* u8 upvalue */
+    OP_SET_UPVALUE,     /* u8 upvalue */
+    OP_CLOSE_UPVALUE,
+
+    OP_INC,
+    OP_DEC,
+    OP_INC_LOCAL,       /* u8 slot, pushes the old value */
+    OP_DEC_LOCAL,       /* u8 slot, pushes the old value */
+
+    OP_ADD,
+    OP_SUB,
+    OP_MUL,
+    OP_QUO,
+    OP_REM,
+    OP_AND,
+    OP_OR,
+    OP_XOR,
+    OP_SHL,
+    OP_SHR,
+
+    OP_EQL,
+    OP_NEQ,
+    OP_LSS,
+    OP_GTR,
+    OP_LEQ,
+    OP_GEQ,
+
+    OP_PLUS,
+    OP_NEG,
+    OP_NOT,
+    OP_TILDE,
+
+    OP_JUMP,            /* u16 forward offset */
+    OP_JUMP_IF_FALSE,   /* u16 forward offset, pops the condition */
+    OP_JUMP_IF_TRUE,    /* u16 forward offset, pops the condition */
+    OP_LOOP,            /* u16 backward offset */
+
+    OP_CALL,            /* u8 argc */
+    OP_CLOSURE,         /* u16 constant, then (u8 isLocal, u8 index) per upvalue */
+    OP_RETURN,
+
+    OP_ARRAY,           /* u16 type, u16 count */
+    OP_MAP,             /* u16 type, u16 count, each entry pushed as key then value */
+    OP_INDEX,           /* u8 count, every index is applied at once, a map takes its one key */
+    OP_SET_INDEX,       /* u8 count */
+    OP_INC_INDEX,       /* u8 count, pushes the old element */
+    OP_DEC_INDEX,       /* u8 count, pushes the old element */
+
+    OP_CAST             /* u8 TypeID */
+} OpCode;
+
+/*
+ * A runtime error raised inside [start, end) resumes at target with only
+ * the frame's first depth slots kept, the way the tree engine logs an
+ * error and carries on with the next top-level declaration or the next
+ * iteration of a while loop. Inner ranges are added first.
+ */
+typedef struct Handler {
+    size_t start;
+    size_t end;
+    size_t target;
+    size_t depth;
+} Handler;
+
+typedef struct Chunk {
+    uint8_t* code;
+    size_t count;
+    size_t capacity;
+    Value* constants;
+    size_t constantCount;
+    size_t constantCapacity;
+    Vector* types; /* Vector of (Type*) referenced by OP_ARRAY and OP_MAP */
+    Handler* handlers;
+    size_t handlerCount;
+    size_t handlerCapacity;
+} Chunk;
+
+void chunk_init(Chunk* chunk);
+void chunk_write(Chunk* chunk, uint8_t byte);
+size_t chunk_add_constant(Chunk* chunk, Value value);
+size_t chunk_add_type(Chunk* chunk, Type* type);
+void chunk_add_handler(Chunk* chunk, Handler handler);
+Type* chunk_get_type(Chunk* chunk, size_t index);
+void chunk_free(Chunk* chunk);
+
+typedef struct FunctionProto {
+    char* name;
+    size_t arity;
+    size_t upvalueCount;
+    Chunk chunk;
+} FunctionProto;
+
+FunctionProto* function_proto_new(const char* name);
+void function_proto_free(FunctionProto** function);
+
+typedef struct Program {
+    FunctionProto* script;
+    char** globalNames;
+    size_t globalCount;
+} Program;
+
+Program* compile(List* declarations);
+void program_free(Program** program);
@@ -6,7 +6,7 @@
 
 Context* context_new(Map* environment) {
     Context* new_ctx = NULL;
-    new_ctx = safe_calloc(1, sizeof(Context), NULL);
+    new_ctx = smem_alloc(sizeof(Context));
     if (new_ctx == NULL) {
         map_free(&environment);
         return NULL;
@@ -14,7 +14,14 @@ Context* context_new(Map* environment) {
 
     *new_ctx = (Context) {
         .environment = environment,
-        .enclosing = NULL
+        .enclosing = NULL,
+        .slots = NULL,
+        .size = 0,
+        .capacity = 0,
+        .isCaptured = false,
+        .isStacked = false,
+        .mark = 0,
+        .next = NULL
     };
 
     return new_ctx;
@@ -22,7 +29,7 @@ Context* context_new(Map* environment) {
 
 Context* context_enclosed_new(Context* enclosing, Map* environment) {
     Context* new_ctx = NULL;
-    new_ctx = safe_calloc(1, sizeof(Context), NULL);
+    new_ctx = smem_alloc(sizeof(Context));
     if (new_ctx == NULL) {
         context_free(&enclosing);
         map_free(&environment);
@@ -31,7 +38,14 @@ Context* context_enclosed_new(Context* enclosing, Map* environment) {
 
     *new_ctx = (Context) {
         .enclosing = enclosing,
-        .environment = environment
+        .environment = environment,
+        .slots = NULL,
+        .size = 0,
+        .capacity = 0,
+        .isCaptured = false,
+        .isStacked = false,
+        .mark = 0,
+        .next = NULL
     };
 
     return new_ctx;
@@ -42,12 +56,13 @@ void context_free(Context** ctx) {
         return;
 
     map_free(&(*ctx)->environment);
+    safe_free((void**) &(*ctx)->slots);
 
-    safe_free((void**) ctx);
+    smem_free((void**) ctx, sizeof(Context));
 }
 
 void context_define(Context* ctx, void* name, void* value) {
-    if (ctx == NULL || name == NULL)
+    if (ctx == NULL || ctx->environment == NULL || name == NULL)
         return;
 
     map_put(ctx->environment, name, value);
@@ -57,7 +72,7 @@ void* context_get(Context* ctx, void* name) {
     if (ctx == NULL || name == NULL)
         return NULL;
 
-    void* value = map_get(ctx->environment, name);
+    void* value = ctx->environment != NULL ? map_get(ctx->environment, name) : NULL;
     if (value != NULL) {
         return value;
     }
@@ -73,7 +88,7 @@ void context_assign(Context* ctx, void* name, void* value) {
     if (ctx == NULL || name == NULL)
         return;
 
-    const void* current_value = map_get(ctx->environment, name);
+    const void* current_value = ctx->environment != NULL ? map_get(ctx->environment, name) : NULL;
     if (current_value != NULL) {
         map_put(ctx->environment, name, value);
         return;
@@ -86,8 +101,151 @@ void context_assign(Context* ctx, void* name, void* value) {
 }
 
 bool context_exists(Context* ctx, void* name) {
-    if (ctx == NULL || name == NULL)
+    if (ctx == NULL || ctx->environment == NULL || name == NULL)
         return false;
 
     return map_get(ctx->environment, name) != NULL;
 }
+
+void context_define_at(Context* ctx, size_t slot, Value value) {
+    if (ctx == NULL)
+        return;
+
+    if (slot >= ctx->capacity) {
+        /* stacked frames are sized by the resolver and cannot grow */
+        if (ctx->isStacked)
+            return;
+
+        size_t capacity = ctx->capacity < 4 ? 4 : ctx->capacity;
+        while (capacity <= slot) {
+            capacity *= 2;
+        }
+
+        Value* slots = safe_malloc(capacity * sizeof(Value), NULL);
+        if (slots == NULL)
+            return;
+
+        for (size_t i = 0; i < capacity; i++) {
+            slots[i] = i < ctx->size ? ctx->slots[i] : UNDEFINED_VALUE();
+        }
+
+        safe_free((void**) &ctx->slots);
+
+        ctx->slots = slots;
+        ctx->capacity = capacity;
+    }
+
+    ctx->slots[slot] = value;
+
+    if (slot >= ctx->size) {
+        ctx->size = slot + 1;
+    }
+}
+
+Value context_get_at(Context* ctx, size_t depth, size_t slot) {
+    for (; ctx != NULL && depth > 0; depth--) {
+        ctx = ctx->enclosing;
+    }
+
+    if (ctx == NULL || slot >= ctx->size)
+        return UNDEFINED_VALUE();
+
+    return ctx->slots[slot];
+}
+
+void context_assign_at(Context* ctx, size_t depth, size_t slot, Value value) {
+    for (; ctx != NULL && depth > 0; depth--) {
+        ctx = ctx->enclosing;
+    }
+
+    if (ctx == NULL || slot >= ctx->size)
+        return;
+
+    ctx->slots[slot] = value;
+}
+
+ContextStack* context_stack_new(size_t frameCapacity, size_t slotCapacity) {
+    ContextStack* stack = NULL;
+    stack = safe_malloc(sizeof(ContextStack), NULL);
+    if (stack == NULL) {
+        return NULL;
+    }
+
+    *stack = (ContextStack) {
+        .frames = safe_malloc(frameCapacity * sizeof(Context), NULL),
+        .frameCount = 0,
+        .frameCapacity = frameCapacity,
+        .slots = safe_malloc(slotCapacity * sizeof(Value), NULL),
+        .slotCount = 0,
+        .slotCapacity = slotCapacity
+    };
+
+    if (stack->frames == NULL || stack->slots == NULL) {
+        context_stack_free(&stack);
+        return NULL;
+    }
+
+    return stack;
+}
+
+void context_stack_free(ContextStack** stack) {
+    if (stack == NULL || *stack == NULL)
+        return;
+
+    safe_free((void**) &(*stack)->frames);
+    safe_free((void**) &(*stack)->slots);
+
+    safe_free((void**) stack);
+}
+
+Context* context_stack_push(ContextStack* stack, Context* enclosing, size_t size, bool isCapturable) {
+    if (stack == NULL || isCapturable
+        || stack->frameCount == stack->frameCapacity
+        || stack->slotCapacity - stack->slotCount < size) {
+        Context* ctx = context_new(NULL);
+        if (ctx != NULL) {
+            ctx->enclosing = enclosing;
+        }
+
+        return ctx;
+    }
+
+    Context* ctx = &stack->frames[stack->frameCount++];
+    Value* slots = &stack->slots[stack->slotCount];
+
+    stack->slotCount += size;
+
+    for (size_t i = 0; i < size; i++) {
+        slots[i] = UNDEFINED_VALUE();
+    }
+
+    *ctx = (Context) {
+        .environment = NULL,
+        .enclosing = enclosing,
+        .slots = slots,
+        .size = size,
+        .capacity = size,
+        .isCaptured = false,
+        .isStacked = true,
+        .mark = 0,
+        .next = NULL
+    };
+
+    return ctx;
+}
+
+/* drops ctx and every frame pushed after it, heap fallbacks are freed unless a closure kept them */
+void context_stack_pop(ContextStack* stack, Context* ctx) {
+    if (ctx == NULL)
+        return;
+
+    if (!ctx->isStacked) {
+        if (!ctx->isCaptured) {
+            context_free(&ctx);
+        }
+        return;
+    }
+
+    stack->frameCount = (size_t) (ctx - stack->frames);
+    stack->slotCount = (size_t) (ctx->slots - stack->slots);
+}
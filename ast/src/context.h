@@ -1,13 +1,22 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stddef.h>
 
 #include "map.h"
+#include "value.h"
 
 
 typedef struct Context {
     Map* environment;
     struct Context* enclosing;
+    Value* slots; /* values addressed by the resolver's (depth, slot) pairs */
+    size_t size;
+    size_t capacity;
+    bool isCaptured; /* owned by the garbage collector once a closure references it */
+    bool isStacked;  /* lives in a ContextStack and borrows its slots from it */
+    unsigned int mark;
+    struct Context* next;
 } Context;
 
 Context* context_new(Map* environment);
@@ -18,3 +27,32 @@ void context_define(Context* ctx, void* name, void* value);
 void* context_get(Context* ctx, void* name);
 void context_assign(Context* ctx, void* name, void* value);
 bool context_exists(Context* ctx, void* name);
+
+void context_define_at(Context* ctx, size_t slot, Value value);
+Value context_get_at(Context* ctx, size_t depth, size_t slot);
+void context_assign_at(Context* ctx, size_t depth, size_t slot, Value value);
+
+
+#define CONTEXT_STACK_FRAMES 4096
+#define CONTEXT_STACK_SLOTS  (64 * 1024)
+
+/*
+ * Contiguous frames for the scopes and calls no closure can capture. Both
+ * arrays are allocated once, pushing a frame only bumps the two counters and
+ * popping must happen in reverse order. Scopes a closure may capture, and
+ * any push made once either array is exhausted, get a heap context instead.
+ */
+typedef struct ContextStack {
+    Context* frames;
+    size_t frameCount;
+    size_t frameCapacity;
+    Value* slots;
+    size_t slotCount;
+    size_t slotCapacity;
+} ContextStack;
+
+ContextStack* context_stack_new(size_t frameCapacity, size_t slotCapacity);
+void context_stack_free(ContextStack** stack);
+
+Context* context_stack_push(ContextStack* stack, Context* enclosing, size_t size, bool isCapturable);
+void context_stack_pop(ContextStack* stack, Context* ctx);
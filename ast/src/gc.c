@@ -0,0 +1,408 @@
+#include "gc.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "buffer.h"
+#include "context.h"
+#include "interpreter.h"
+#include "map.h"
+#include "object.h"
+#include "smem.h"
+#include "value.h"
+
+
+static _Thread_local GC* active = NULL;
+
+static bool grow(void** items, size_t* capacity, size_t count, size_t elementSize) {
+    if (count < *capacity)
+        return true;
+
+    size_t newCapacity = *capacity < 8 ? 8 : *capacity * 2;
+
+    void* newItems = safe_malloc(newCapacity * elementSize, NULL);
+    if (newItems == NULL)
+        return false;
+
+    if (*items != NULL) {
+        memcpy(newItems, *items, count * elementSize);
+        safe_free(items);
+    }
+
+    *items = newItems;
+    *capacity = newCapacity;
+
+    return true;
+}
+
+static size_t object_size(Object* object) {
+    size_t size = sizeof(Object);
+
+    switch (object->type) {
+    case OBJ_STRING: {
+        StringObject* stringObject = object->object;
+        size += sizeof(StringObject);
+        if (stringObject != NULL && stringObject->value != NULL)
+            size += strlen(stringObject->value) + 1;
+        break;
+    }
+    case OBJ_ARRAY: {
+        ArrayObject* arrayObject = object->object;
+        size += sizeof(ArrayObject);
+        if (arrayObject != NULL)
+            size += array_object_get_size(arrayObject);
+        break;
+    }
+    case OBJ_MAP: {
+        MapObject* mapObject = object->object;
+        size += sizeof(MapObject);
+        if (mapObject != NULL)
+            size += map_object_get_size(mapObject);
+        break;
+    }
+    case OBJ_FUNCTION:
+        size += sizeof(FunctionObject);
+        break;
+    case OBJ_CALLABLE:
+        size += sizeof(Callable);
+        break;
+    default:
+        size += 2 * sizeof(void*);
+        break;
+    }
+
+    return size;
+}
+
+GC* gc_new(size_t threshold) {
+    GC* gc = NULL;
+    gc = safe_malloc(sizeof(GC), NULL);
+    if (gc == NULL) {
+        return NULL;
+    }
+
+    if (threshold == 0) {
+        threshold = GC_DEFAULT_THRESHOLD;
+    }
+
+    *gc = (GC) {
+        .objects = NULL,
+        .contexts = NULL,
+        .bytesAllocated = 0,
+        .threshold = threshold,
+        .minThreshold = threshold,
+        .epoch = 1,
+        .roots = NULL,
+        .rootCount = 0,
+        .rootCapacity = 0,
+        .frames = NULL,
+        .frameCount = 0,
+        .frameCapacity = 0,
+        .gray = NULL,
+        .grayCount = 0,
+        .grayCapacity = 0,
+        .markForeign = NULL,
+        .traceForeign = NULL,
+        .foreign = NULL,
+        .stats = {0}
+    };
+
+    return gc;
+}
+
+void gc_free(GC** gc) {
+    if (gc == NULL || *gc == NULL)
+        return;
+
+    if (active == *gc) {
+        active = NULL;
+    }
+
+    Object* object = (*gc)->objects;
+    while (object != NULL) {
+        Object* next = object->next;
+        object_free(&object);
+        object = next;
+    }
+
+    Context* ctx = (*gc)->contexts;
+    while (ctx != NULL) {
+        Context* next = ctx->next;
+        context_free(&ctx);
+        ctx = next;
+    }
+
+    safe_free((void**) &(*gc)->roots);
+    safe_free((void**) &(*gc)->frames);
+    safe_free((void**) &(*gc)->gray);
+
+    safe_free((void**) gc);
+}
+
+void gc_set_active(GC* gc) {
+    active = gc;
+}
+
+void gc_track(Object* object) {
+    if (active == NULL || object == NULL)
+        return;
+
+    object->size = object_size(object);
+    object->next = active->objects;
+    active->objects = object;
+
+    active->bytesAllocated += object->size;
+    active->stats.objectsAllocated++;
+
+    if (active->bytesAllocated > active->stats.peakBytes) {
+        active->stats.peakBytes = active->bytesAllocated;
+    }
+}
+
+/* re-accounts a tracked object whose payload grew in place, like an array after push */
+void gc_resize(Object* object) {
+    if (active == NULL || object == NULL || object->size == 0)
+        return;
+
+    size_t size = object_size(object);
+
+    active->bytesAllocated = active->bytesAllocated - object->size + size;
+    object->size = size;
+
+    if (active->bytesAllocated > active->stats.peakBytes) {
+        active->stats.peakBytes = active->bytesAllocated;
+    }
+}
+
+/* hands the context chain over to the heap, closures keep it alive from now on */
+void gc_capture(GC* gc, Context* ctx) {
+    for (; ctx != NULL && !ctx->isCaptured; ctx = ctx->enclosing) {
+        ctx->isCaptured = true;
+
+        if (gc != NULL) {
+            ctx->next = gc->contexts;
+            gc->contexts = ctx;
+        }
+    }
+}
+
+void gc_push_root(GC* gc, Value value) {
+    if (gc == NULL)
+        return;
+
+    if (!grow((void**) &gc->roots, &gc->rootCapacity, gc->rootCount, sizeof(Value)))
+        return;
+
+    gc->roots[gc->rootCount++] = value;
+}
+
+void gc_pop_roots(GC* gc, size_t count) {
+    if (gc == NULL)
+        return;
+
+    gc->rootCount = count > gc->rootCount ? 0 : gc->rootCount - count;
+}
+
+void gc_push_frame(GC* gc, Context* ctx) {
+    if (gc == NULL)
+        return;
+
+    if (!grow((void**) &gc->frames, &gc->frameCapacity, gc->frameCount, sizeof(Context*)))
+        return;
+
+    gc->frames[gc->frameCount++] = ctx;
+}
+
+void gc_pop_frame(GC* gc) {
+    if (gc == NULL || gc->frameCount == 0)
+        return;
+
+    gc->frameCount--;
+}
+
+static void mark_object(GC* gc, Object* object) {
+    if (object == NULL || object->mark == gc->epoch)
+        return;
+
+    object->mark = gc->epoch;
+
+    if (!grow((void**) &gc->gray, &gc->grayCapacity, gc->grayCount, sizeof(Object*)))
+        return;
+
+    gc->gray[gc->grayCount++] = object;
+}
+
+static void mark_value(GC* gc, Value value) {
+    if (IS_OBJECT(value)) {
+        mark_object(gc, AS_OBJECT(value));
+    } else if (IS_BIG_INT(value)) {
+        mark_object(gc, AS_BIG_INT(value));
+    } else if (gc->markForeign != NULL) {
+        gc->markForeign(gc, value);
+    }
+}
+
+void gc_mark_value(GC* gc, Value value) {
+    if (gc != NULL) {
+        mark_value(gc, value);
+    }
+}
+
+static void mark_context(GC* gc, Context* ctx) {
+    for (; ctx != NULL && ctx->mark != gc->epoch; ctx = ctx->enclosing) {
+        ctx->mark = gc->epoch;
+
+        for (size_t i = 0; i < ctx->size; i++) {
+            mark_value(gc, ctx->slots[i]);
+        }
+    }
+}
+
+static void trace_object(GC* gc, Object* object) {
+    if (object->object == NULL)
+        return;
+
+    switch (object->type) {
+    case OBJ_ARRAY: {
+        ArrayObject* arrayObject = object->object;
+
+        if (arrayObject->storage != ARRAY_VALUES)
+            break;
+
+        for (size_t i = 0; i < arrayObject->length; i++) {
+            mark_value(gc, arrayObject->values[i]);
+        }
+        break;
+    }
+    case OBJ_MAP: {
+        MapObject* mapObject = object->object;
+        MapIterator iterator = { .map = mapObject->entries, .index = 0 };
+
+        while (map_iterator_has_next(&iterator)) {
+            MapEntry* entry = map_iterator_next(&iterator);
+
+            mark_value(gc, *(Value*) entry->key);
+            mark_value(gc, *(Value*) entry->value);
+        }
+        break;
+    }
+    case OBJ_FUNCTION: {
+        FunctionObject* functionObject = object->object;
+
+        mark_context(gc, functionObject->env);
+        break;
+    }
+    case OBJ_CALLABLE: {
+        Callable* callable = object->object;
+
+        mark_object(gc, callable->functionObject);
+        break;
+    }
+    case OBJ_RETURN: {
+        ReturnObject* returnObject = object->object;
+
+        mark_object(gc, returnObject->value);
+        break;
+    }
+    case OBJ_IDENT: {
+        IdentObject* identObject = object->object;
+
+        mark_object(gc, identObject->value);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+static void sweep(GC* gc) {
+    Object** object = &gc->objects;
+
+    while (*object != NULL) {
+        Object* current = *object;
+
+        if (current->mark == gc->epoch) {
+            object = &current->next;
+            continue;
+        }
+
+        *object = current->next;
+
+        gc->bytesAllocated -= current->size;
+        gc->stats.bytesFreed += current->size;
+        gc->stats.objectsFreed++;
+
+        object_free(&current);
+    }
+
+    Context** ctx = &gc->contexts;
+
+    while (*ctx != NULL) {
+        Context* current = *ctx;
+
+        if (current->mark == gc->epoch) {
+            ctx = &current->next;
+            continue;
+        }
+
+        *ctx = current->next;
+
+        gc->stats.contextsFreed++;
+
+        context_free(&current);
+    }
+}
+
+void gc_collect(GC* gc, Interpreter* interpreter) {
+    if (gc == NULL)
+        return;
+
+    gc->epoch++;
+    gc->grayCount = 0;
+
+    if (interpreter != NULL) {
+        mark_context(gc, interpreter->env);
+        mark_value(gc, interpreter->returnValue);
+    }
+
+    for (size_t i = 0; i < gc->frameCount; i++) {
+        mark_context(gc, gc->frames[i]);
+    }
+
+    for (size_t i = 0; i < gc->rootCount; i++) {
+        mark_value(gc, gc->roots[i]);
+    }
+
+    do {
+        while (gc->grayCount > 0) {
+            trace_object(gc, gc->gray[--gc->grayCount]);
+        }
+    } while (gc->traceForeign != NULL && gc->traceForeign(gc));
+
+    sweep(gc);
+
+    gc->stats.collections++;
+
+    size_t threshold = gc->bytesAllocated * GC_GROWTH_FACTOR;
+    gc->threshold = threshold > gc->minThreshold ? threshold : gc->minThreshold;
+}
+
+void gc_safepoint(GC* gc, Interpreter* interpreter) {
+    if (gc != NULL && gc->bytesAllocated >= gc->threshold) {
+        gc_collect(gc, interpreter);
+    }
+}
+
+void gc_stats_to_string(ByteBuffer* byteBuffer, GC* gc) {
+    if (byteBuffer == NULL || gc == NULL)
+        return;
+
+    GCStats* stats = &gc->stats;
+
+    byte_buffer_appendf(byteBuffer,
+        "gc: %zu collections, %zu objects allocated, %zu freed (%zu bytes), "
+        "%zu contexts freed, peak %zu bytes, live %zu bytes, next collection at %zu bytes",
+        stats->collections, stats->objectsAllocated, stats->objectsFreed, stats->bytesFreed,
+        stats->contextsFreed, stats->peakBytes, gc->bytesAllocated, gc->threshold);
+}
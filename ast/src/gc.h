@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "buffer.h"
+#include "context.h"
+#include "object.h"
+#include "value.h"
+
+
+#define GC_DEFAULT_THRESHOLD (1024 * 1024)
+#define GC_GROWTH_FACTOR 2
+
+typedef struct GCStats {
+    size_t collections;
+    size_t objectsAllocated;
+    size_t objectsFreed;
+    size_t bytesFreed;
+    size_t contextsFreed;
+    size_t peakBytes;
+} GCStats;
+
+/*
+ * Mark-and-sweep heap for the tree-walking interpreter. While a heap is
+ * active every Object built by object_new is linked into it, and captured
+ * contexts are adopted through gc_capture. Collections only run at the
+ * statement boundaries where the interpreter calls gc_safepoint, so the
+ * only C locals that need rooting are values held across a nested call.
+ * The active heap is per thread, like the active arena.
+ */
+typedef struct GC {
+    Object* objects;
+    Context* contexts;
+    size_t bytesAllocated;
+    size_t threshold;    /* collect once bytesAllocated reaches it */
+    size_t minThreshold;
+    unsigned int epoch;
+    Value* roots;        /* interpreter temporaries */
+    size_t rootCount;
+    size_t rootCapacity;
+    Context** frames;    /* caller environments of the running functions */
+    size_t frameCount;
+    size_t frameCapacity;
+    Object** gray;
+    size_t grayCount;
+    size_t grayCapacity;
+    /* values that are not Objects, like the VM's closures, are marked by their owner */
+    void (*markForeign)(struct GC* gc, Value value);
+    bool (*traceForeign)(struct GC* gc); /* false once nothing foreign is left to trace */
+    void* foreign;
+    GCStats stats;
+} GC;
+
+GC* gc_new(size_t threshold);
+void gc_free(GC** gc);
+
+void gc_set_active(GC* gc);
+void gc_track(Object* object);
+void gc_resize(Object* object);
+
+void gc_capture(GC* gc, Context* ctx);
+
+void gc_push_root(GC* gc, Value value);
+void gc_pop_roots(GC* gc, size_t count);
+void gc_push_frame(GC* gc, Context* ctx);
+void gc_pop_frame(GC* gc);
+
+void gc_mark_value(GC* gc, Value value);
+
+void gc_collect(GC* gc, struct Interpreter* interpreter);
+void gc_safepoint(GC* gc, struct Interpreter* interpreter);
+
+void gc_stats_to_string(ByteBuffer* byteBuffer, GC* gc);
@@ -1,7 +1,6 @@
 #include "interpreter.h"
 
 #include <ctype.h>
-#include <math.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdio.h>
@@ -11,29 +10,28 @@
 #include "ast.h"
 #include "buffer.h"
 #include "context.h"
+#include "gc.h"
 #include "list.h"
 #include "literal-type.h"
 #include "map.h"
+#include "numeric.h"
 #include "object.h"
+#include "optimizer.h"
+#include "output.h"
+#include "resolver.h"
 #include "smem.h"
+#include "symbol.h"
 #include "token.h"
 #include "type-checker.h"
 #include "types.h"
+#include "value.h"
 
 
-static TypeChecker* types = NULL;
-
-static const Context* globalEnv = NULL;
-
-static const Object* TRUE_OBJECT     = NULL;
-static const Object* FALSE_OBJECT    = NULL;
-static const Object* NIL_OBJECT      = NULL;
-static const Object* BREAK_OBJECT    = NULL;
-static const Object* CONTINUE_OBJECT = NULL;
-
-static Object* eval_binary_expr(Interpreter* interpreter, Type* type, Object* left, Token* operation, Object* right);
-static Object* eval_assign_expr(Interpreter* interpreter, Token* op, char* ident, Object* value);
-static Object* eval_literal_expr(Interpreter* interpreter, LiteralExpr* literalExpr);
+static Value eval_binary_expr(Interpreter* interpreter, Value left, Token* operation, Value right);
+static Value eval_typed_binary_expr(Interpreter* interpreter, BinaryExpr* binaryExpr, Value left, Value right);
+static Value eval_compound_op(Interpreter* interpreter, TokenType op, Value target, Value value);
+static Value eval_assign_expr(Interpreter* interpreter, Token* op, IdentLiteral* ident, Value value);
+static Value eval_literal_expr(Interpreter* interpreter, LiteralExpr* literalExpr);
 
 
 static bool isInteger(const char* str) {
@@ -58,18 +56,54 @@ static bool isBool(const char* str) {
     return isTrue || isFalse;
 }
 
-static bool is_error(Interpreter* interpreter, Object* object);
-static void log_error(Error* error);
+static bool is_error(Interpreter* interpreter, Value value);
+static void log_error(Value error);
+
+static bool is_signal(Value value, ObjectType type);
+static Value error_value(ErrorType type, const char* message);
 
-static Object* eval_to_bool_obj(bool input);
-static bool is_thruthy(Object* object);
+#define CORE_BUILTIN_COUNT 21
 
-static Object* eval_binary_op(ObjectType returnType, Token* op, double left, double right);
+/* the numeric module's names follow these unless the program declares them */
+static char* const coreBuiltins[CORE_BUILTIN_COUNT] = {
+    "print", "println", "input", "len", "push", "pop", "reserve",
+    "matmul", "transpose", "matadd", "matsub", "hadamard",
+    "delete", "has", "keys", "values", "flush",
+    "read_all", "read_lines", "has_line", "next_line"
+};
 
-static Type* get_operation_type(Token* operation, Object* left, Object* right);
+void eval_intern_builtins(void) {
+    for (size_t i = 0; i < CORE_BUILTIN_COUNT; i++) {
+        symbol_intern(coreBuiltins[i]);
+    }
+
+    for (size_t i = 0; i < NUMERIC_BUILTIN_COUNT; i++) {
+        symbol_intern(numericBuiltins[i].name);
+    }
 
-static bool entry_cmp(const MapEntry** entry, char** key) {
-    return strcmp((*entry)->key, *key) == 0;
+    for (TypeID typeId = _atomic_start + 1; typeId < _atomic_end; typeId++) {
+        type_atomic(typeId);
+    }
+}
+
+static bool is_declared(List* declarations, const char* name) {
+    list_foreach(declaration, declarations) {
+        Decl* decl = declaration->value;
+        Token* declared = NULL;
+
+        if (decl->type == LET_DECL) {
+            declared = ((LetDecl*) decl->decl)->name;
+        } else if (decl->type == CONST_DECL) {
+            declared = ((ConstDecl*) decl->decl)->name;
+        } else if (decl->type == FUNC_DECL) {
+            declared = ((FunctionDecl*) decl->decl)->name;
+        }
+
+        if (declared != NULL && strcmp(declared->literal, name) == 0)
+            return true;
+    }
+
+    return false;
 }
 
 static Interpreter* interpreter_init(void) {
@@ -81,6 +115,12 @@ static Interpreter* interpreter_init(void) {
 
     *interpreter = (Interpreter) {
         .env = NULL,
+        .stack = context_stack_new(CONTEXT_STACK_FRAMES, CONTEXT_STACK_SLOTS),
+        .returnValue = NIL_VALUE(),
+        .gc = NULL,
+        .returnSignal = NULL,
+        .breakSignal = NULL,
+        .continueSignal = NULL,
         .exitCode = INTERPRETER_SUCCESS
     };
 
@@ -91,43 +131,137 @@ static void interpreter_free(Interpreter** interpreter) {
     if (interpreter == NULL || *interpreter == NULL)
         return;
 
-    context_free(&(*interpreter)->env);
+    /* once captured the global scope belongs to the collector */
+    if ((*interpreter)->env != NULL && !(*interpreter)->env->isCaptured) {
+        context_free(&(*interpreter)->env);
+    }
+
+    context_stack_free(&(*interpreter)->stack);
 
     safe_free((void**) interpreter);
 }
 
+static Interpreter* interpreter_start(InterpreterOptions options, const NumericBuiltin** numeric, size_t builtinCount) {
+    Interpreter* interpreter = interpreter_init();
+
+    /* made before the heap is active, so they are never collected */
+    interpreter->returnSignal   = NEW_RETURN_OBJECT(NULL);
+    interpreter->breakSignal    = NEW_BREAK_OBJECT();
+    interpreter->continueSignal = NEW_CONTINUE_OBJECT();
+
+    GC* gc = gc_new(options.gcThreshold);
+    gc_set_active(gc);
+
+    Context* globalEnv = context_new(NULL);
+
+    /* same order as the resolver's builtin names, it gave them the first slots */
+    context_define_at(globalEnv, 0, OBJECT_VALUE(NEW_PRINT_FUNC()));
+    context_define_at(globalEnv, 1, OBJECT_VALUE(NEW_PRINTLN_FUNC()));
+    context_define_at(globalEnv, 2, OBJECT_VALUE(NEW_INPUT_FUNC()));
+    context_define_at(globalEnv, 3, OBJECT_VALUE(NEW_LEN_FUNC()));
+    context_define_at(globalEnv, 4, OBJECT_VALUE(NEW_PUSH_FUNC()));
+    context_define_at(globalEnv, 5, OBJECT_VALUE(NEW_POP_FUNC()));
+    context_define_at(globalEnv, 6, OBJECT_VALUE(NEW_RESERVE_FUNC()));
+    context_define_at(globalEnv, 7, OBJECT_VALUE(NEW_MATMUL_FUNC()));
+    context_define_at(globalEnv, 8, OBJECT_VALUE(NEW_TRANSPOSE_FUNC()));
+    context_define_at(globalEnv, 9, OBJECT_VALUE(NEW_MATADD_FUNC()));
+    context_define_at(globalEnv, 10, OBJECT_VALUE(NEW_MATSUB_FUNC()));
+    context_define_at(globalEnv, 11, OBJECT_VALUE(NEW_HADAMARD_FUNC()));
+    context_define_at(globalEnv, 12, OBJECT_VALUE(NEW_NATIVE_FUNC(delete_function_run)));
+    context_define_at(globalEnv, 13, OBJECT_VALUE(NEW_NATIVE_FUNC(has_function_run)));
+    context_define_at(globalEnv, 14, OBJECT_VALUE(NEW_NATIVE_FUNC(keys_function_run)));
+    context_define_at(globalEnv, 15, OBJECT_VALUE(NEW_NATIVE_FUNC(values_function_run)));
+    context_define_at(globalEnv, 16, OBJECT_VALUE(NEW_NATIVE_FUNC(flush_function_run)));
+    context_define_at(globalEnv, 17, OBJECT_VALUE(NEW_NATIVE_FUNC(read_all_function_run)));
+    context_define_at(globalEnv, 18, OBJECT_VALUE(NEW_NATIVE_FUNC(read_lines_function_run)));
+    context_define_at(globalEnv, 19, OBJECT_VALUE(NEW_NATIVE_FUNC(has_line_function_run)));
+    context_define_at(globalEnv, 20, OBJECT_VALUE(NEW_NATIVE_FUNC(next_line_function_run)));
+
+    for (size_t slot = CORE_BUILTIN_COUNT; slot < builtinCount; slot++) {
+        context_define_at(globalEnv, slot, OBJECT_VALUE(NEW_NATIVE_FUNC(numeric[slot - CORE_BUILTIN_COUNT]->function)));
+    }
+
+    interpreter->env = globalEnv;
+    interpreter->gc = gc;
+
+    return interpreter;
+}
+
+static InterpreterStatus interpreter_finish(Interpreter** interpreter, InterpreterOptions options) {
+    GC* gc = (*interpreter)->gc;
+
+    output_flush();
+
+    if (options.gcStats) {
+        ByteBuffer* bb = byte_buffer_new();
+        gc_stats_to_string(bb, gc);
+        char* stats = byte_buffer_to_string(bb);
+        byte_buffer_free(&bb);
+
+        fprintf(stderr, "%s\n", stats);
+
+        safe_free((void**) &stats);
+    }
+
+    gc_set_active(NULL);
+
+    object_free(&(*interpreter)->returnSignal);
+    object_free(&(*interpreter)->breakSignal);
+    object_free(&(*interpreter)->continueSignal);
+
+    InterpreterStatus status = (*interpreter)->exitCode;
+
+    interpreter_free(interpreter);
+
+    gc_free(&gc);
+
+    return status;
+}
+
 InterpreterStatus eval(List* declarations) {
+    return eval_with_options(declarations, (InterpreterOptions) {0});
+}
+
+InterpreterStatus eval_with_options(List* declarations, InterpreterOptions options) {
     if (declarations == NULL)
         return INTERPRETER_SUCCESS;
 
-    if (init_and_check(&types, declarations) == TYPE_CHECKER_FAILURE) {
-        type_checker_destroy(&types);
+    /* the resolved types stay on the tree */
+    if (!options.checked && check(declarations) == TYPE_CHECKER_FAILURE) {
         return INTERPRETER_FAILURE;
     }
 
-    globalEnv = context_new(MAP_NEW(32, entry_cmp, NULL, NULL));
+    optimize(declarations, options.optimizationLevel);
 
-    context_define((Context*) globalEnv, "print", NEW_PRINT_FUNC());
-    context_define((Context*) globalEnv, "println", NEW_PRINTLN_FUNC());
-    context_define((Context*) globalEnv, "input", NEW_INPUT_FUNC());
-    context_define((Context*) globalEnv, "len", NEW_LEN_FUNC());
+    /* a program's own top-level sum or max wins over the numeric module */
+    char* builtins[CORE_BUILTIN_COUNT + NUMERIC_BUILTIN_COUNT];
+    memcpy(builtins, coreBuiltins, sizeof(coreBuiltins));
 
-    TRUE_OBJECT     = NEW_BOOLEAN_OBJECT(true);
-    FALSE_OBJECT    = NEW_BOOLEAN_OBJECT(false);
-    NIL_OBJECT      = NEW_NIL_OBJECT();
-    BREAK_OBJECT    = NEW_BREAK_OBJECT();
-    CONTINUE_OBJECT = NEW_CONTINUE_OBJECT();
+    const NumericBuiltin* numeric[NUMERIC_BUILTIN_COUNT];
+    size_t builtinCount = CORE_BUILTIN_COUNT;
 
-    Interpreter* interpreter = interpreter_init();
-    interpreter->env = (Context*) globalEnv;
+    for (size_t i = 0; i < NUMERIC_BUILTIN_COUNT; i++) {
+        if (!is_declared(declarations, numericBuiltins[i].name)) {
+            numeric[builtinCount - CORE_BUILTIN_COUNT] = &numericBuiltins[i];
+            builtins[builtinCount++] = numericBuiltins[i].name;
+        }
+    }
+
+    if (resolve(declarations, builtins, builtinCount) == RESOLVER_FAILURE) {
+        return INTERPRETER_FAILURE;
+    }
+
+    Interpreter* interpreter = interpreter_start(options, numeric, builtinCount);
 
     // ByteBuffer* bb = byte_buffer_new();
     // char* str_out = NULL;
 
     list_foreach(declaration, declarations) {
-        Object* res = eval_decl(interpreter, declaration->value);
-        if (res != NULL && is_error(interpreter, res)) {
-            log_error(res->object);
+        gc_safepoint(interpreter->gc, interpreter);
+
+        Value res = eval_decl(interpreter, declaration->value);
+        if (is_error(interpreter, res)) {
+            log_error(res);
             continue;
         }
 
@@ -148,114 +282,188 @@ InterpreterStatus eval(List* declarations) {
 
     // byte_buffer_free(&bb);
 
-    object_free((Object**) &TRUE_OBJECT);
-    object_free((Object**) &FALSE_OBJECT);
-    object_free((Object**) &NIL_OBJECT);
-    object_free((Object**) &BREAK_OBJECT);
-    object_free((Object**) &CONTINUE_OBJECT);
+    return interpreter_finish(&interpreter, options);
+}
 
-    InterpreterStatus status = interpreter->exitCode;
+EvalStream* eval_stream_new(InterpreterOptions options) {
+    EvalStream* stream = NULL;
+    stream = safe_malloc(sizeof(EvalStream), NULL);
+    if (stream == NULL) {
+        return NULL;
+    }
 
-    interpreter_free(&interpreter);
+    /* whether the program takes one of the numeric names is only known once
+       it does, so they are all registered and given up then */
+    char* builtins[CORE_BUILTIN_COUNT + NUMERIC_BUILTIN_COUNT];
+    memcpy(builtins, coreBuiltins, sizeof(coreBuiltins));
 
-    // type_checker_destroy(&types);
+    const NumericBuiltin* numeric[NUMERIC_BUILTIN_COUNT];
+    for (size_t i = 0; i < NUMERIC_BUILTIN_COUNT; i++) {
+        numeric[i] = &numericBuiltins[i];
+        builtins[CORE_BUILTIN_COUNT + i] = numericBuiltins[i].name;
+    }
+
+    *stream = (EvalStream) {
+        .typeChecker = type_checker_new(),
+        .resolver = resolver_new(builtins, CORE_BUILTIN_COUNT + NUMERIC_BUILTIN_COUNT),
+        .interpreter = interpreter_start(options, numeric, CORE_BUILTIN_COUNT + NUMERIC_BUILTIN_COUNT),
+        .options = options,
+        .numericTaken = 0
+    };
+
+    return stream;
+}
+
+static int declared_slot(Decl* declaration) {
+    switch (declaration->type) {
+    case LET_DECL:
+        return ((LetDecl*) declaration->decl)->slot;
+    case CONST_DECL:
+        return ((ConstDecl*) declaration->decl)->slot;
+    case FUNC_DECL:
+        return ((FunctionDecl*) declaration->decl)->slot;
+    default:
+        return -1;
+    }
+}
+
+InterpreterStatus eval_stream_next(EvalStream* stream, Decl* declaration) {
+    if (stream == NULL || declaration == NULL)
+        return INTERPRETER_SUCCESS;
+
+    if (check_next(stream->typeChecker, declaration) == TYPE_CHECKER_FAILURE) {
+        return INTERPRETER_FAILURE;
+    }
+
+    if (resolve_next(stream->resolver, declaration) == RESOLVER_FAILURE) {
+        return INTERPRETER_FAILURE;
+    }
+
+    /* the first top-level sum or max replaces the numeric module's from here on */
+    int slot = declared_slot(declaration);
+    if (slot >= CORE_BUILTIN_COUNT && slot < CORE_BUILTIN_COUNT + NUMERIC_BUILTIN_COUNT) {
+        unsigned bit = 1u << (slot - CORE_BUILTIN_COUNT);
+
+        if ((stream->numericTaken & bit) == 0) {
+            stream->numericTaken |= bit;
+            context_define_at(stream->interpreter->env, (size_t) slot, UNDEFINED_VALUE());
+        }
+    }
+
+    Interpreter* interpreter = stream->interpreter;
+
+    gc_safepoint(interpreter->gc, interpreter);
+
+    Value res = eval_decl(interpreter, declaration);
+    if (is_error(interpreter, res)) {
+        log_error(res);
+    }
+
+    return INTERPRETER_SUCCESS;
+}
+
+InterpreterStatus eval_stream_finish(EvalStream** stream) {
+    if (stream == NULL || *stream == NULL)
+        return INTERPRETER_SUCCESS;
+
+    InterpreterStatus status = interpreter_finish(&(*stream)->interpreter, (*stream)->options);
+
+    resolver_free(&(*stream)->resolver);
+    type_checker_destroy(&(*stream)->typeChecker);
+
+    safe_free((void**) stream);
 
     return status;
 }
 
-static Context* extend_function_env(FunctionObject* functionObject, List* arguments) {
-    Context* functionEnv = context_enclosed_new(
-        functionObject->env,
-        MAP_NEW(32, entry_cmp, NULL, NULL)
-    );
-
-    size_t paramIndex = 0;
-    list_foreach(parameter, functionObject->parameters) {
-        FieldDecl* parameterDecl = ((Decl*) parameter->value)->decl;
-        char* parameterName = parameterDecl->name->literal;
-
-        context_define(
-            functionEnv,
-            parameterName,
-            list_get_at(&arguments, paramIndex)
-        );
+static void enter_scope(Interpreter* interpreter, ScopeLayout scope) {
+    if (scope.size == 0)
+        return;
+
+    interpreter->env = context_stack_push(interpreter->stack, interpreter->env, scope.size, scope.isCapturable);
+}
+
+/* restores the enclosing scope and releases the current one unless a closure still references it */
+static void leave_scope(Interpreter* interpreter, Context* previous) {
+    Context* scope = interpreter->env;
 
-        paramIndex++;
+    interpreter->env = previous;
+
+    if (scope != NULL && scope != previous) {
+        context_stack_pop(interpreter->stack, scope);
     }
+}
+
+static Value already_defined_error(const char* name) {
+    ByteBuffer* bb = byte_buffer_new();
+
+    byte_buffer_appendf(bb, "%s: already defined", name);
+    char* error_message = byte_buffer_to_string(bb);
+    byte_buffer_free(&bb);
 
-    return functionEnv;
+    Value error = error_value(RUNTIME_ERROR, error_message);
+    safe_free((void**) &error_message);
+
+    return error;
 }
 
-Object* eval_decl(Interpreter* interpreter, Decl* declaration) {
+Value eval_decl(Interpreter* interpreter, Decl* declaration) {
     if (interpreter == NULL || declaration == NULL)
-        return NULL;
+        return NIL_VALUE();
 
     switch (declaration->type) {
     case LET_DECL: {
         LetDecl* letDecl = declaration->decl;
-        char* varName = letDecl->name->literal;
 
-        if (context_exists(interpreter->env, varName)) {
-            ByteBuffer* bb = byte_buffer_new();
-
-            byte_buffer_appendf(bb, "%s: already defined", varName);
-            char* error_message = byte_buffer_to_string(bb);
-            byte_buffer_free(&bb);
+        if (!IS_UNDEFINED(context_get_at(interpreter->env, 0, letDecl->slot))) {
+            return already_defined_error(letDecl->name->literal);
+        }
 
-            Object* error = NEW_ERROR_OBJECT(RUNTIME_ERROR, error_message);
-            safe_free((void**) &error_message);
+        Value identValue = eval_expr(interpreter, letDecl->expression);
 
-            return error;
-        }
+        context_define_at(interpreter->env, letDecl->slot, identValue);
 
-        Type* identType = letDecl->type;
-        Object* identValue = eval_expr(interpreter, letDecl->expression);
+        return identValue;
+    }
+    case CONST_DECL: {
+        ConstDecl* constDecl = declaration->decl;
 
-        // Object* newIdentObject = NEW_IDENT_OBJECT(identType, varName, identValue);
+        if (!IS_UNDEFINED(context_get_at(interpreter->env, 0, constDecl->slot))) {
+            return already_defined_error(constDecl->name->literal);
+        }
 
-        context_define(interpreter->env, varName, identValue);
+        Value identValue = eval_expr(interpreter, constDecl->expression);
 
-        Object* ok = context_get(interpreter->env, varName);
+        context_define_at(interpreter->env, constDecl->slot, identValue);
 
         return identValue;
     }
-    case CONST_DECL: {
-        return NULL;
-    }
     case FIELD_DECL: {
-        return NULL;
+        return NIL_VALUE();
     }
     case FUNC_DECL: {
         FunctionDecl* functionDecl = declaration->decl;
-        char* functionName = functionDecl->name->literal;
-
-        if (context_exists(interpreter->env, functionName)) {
-            ByteBuffer* bb = byte_buffer_new();
-
-            byte_buffer_appendf(bb, "%s: already defined", functionName);
-            char* error_message = byte_buffer_to_string(bb);
-            byte_buffer_free(&bb);
 
-            Object* error = NEW_ERROR_OBJECT(RUNTIME_ERROR, error_message);
-            safe_free((void**) &error_message);
-
-            return error;
+        if (!IS_UNDEFINED(context_get_at(interpreter->env, 0, functionDecl->slot))) {
+            return already_defined_error(functionDecl->name->literal);
         }
 
-        Type* functionType = get_decl_type(types, declaration);
+        Type* functionType = functionDecl->functionType;
         Context* functionEnv = interpreter->env;
         List* functionParameters = functionDecl->parameters;
         Stmt* functionBody = functionDecl->body;
+        ScopeLayout functionFrame = functionDecl->scope;
 
-        Object* functionObject = NEW_FUNCTION_OBJECT(functionType, functionEnv, functionParameters, functionBody);
+        Object* functionObject = NEW_FUNCTION_OBJECT(functionType, functionEnv, functionParameters, functionBody, functionFrame);
         Object* callableFunction = NEW_CALLABLE_OBJECT(functionObject);
 
-        context_define(interpreter->env, functionName, callableFunction);
+        gc_capture(interpreter->gc, functionEnv);
+        context_define_at(interpreter->env, functionDecl->slot, OBJECT_VALUE(callableFunction));
 
-        return functionObject;
+        return OBJECT_VALUE(functionObject);
     }
     case STRUCT_DECL: {
-        return NULL;
+        return NIL_VALUE();
     }
     case STMT_DECL: {
         StmtDecl* stmtDecl = declaration->decl;
@@ -263,102 +471,93 @@ Object* eval_decl(Interpreter* interpreter, Decl* declaration) {
         return eval_stmt(interpreter, stmtDecl->stmt);
     }
     default:
-        return NULL;
+        return NIL_VALUE();
     }
 }
 
-Object* eval_stmt(Interpreter* interpreter, Stmt* statement) {
+Value eval_stmt(Interpreter* interpreter, Stmt* statement) {
     if (interpreter == NULL || statement == NULL)
-        return NULL;
+        return NIL_VALUE();
 
     switch (statement->type) {
     case BLOCK_STMT: {
+        BlockStmt* blockStmt = statement->stmt;
+
         Context* previous = interpreter->env;
 
-        interpreter->env = context_enclosed_new(
-            previous,
-            MAP_NEW(32, entry_cmp, NULL, NULL)
-        );
+        enter_scope(interpreter, blockStmt->scope);
 
-        BlockStmt* blockStmt = statement->stmt;
-        Object* result = NULL;
+        Value result = NIL_VALUE();
 
         bool isContinue = false;
 
-        list_foreach(declaration, blockStmt->declarations) {
+        vector_foreach(declaration, blockStmt->declarations) {
+            gc_safepoint(interpreter->gc, interpreter);
+
             if (!isContinue) {
-                result = eval_decl(interpreter, declaration->value);
+                result = eval_decl(interpreter, *declaration);
             } else {
                 isContinue = false;
             }
 
-            if (result != NULL && result->type == OBJ_RETURN) {
-                return result;
+            if (is_signal(result, OBJ_RETURN)) {
+                break;
             }
 
-            if (result != NULL && result->type == OBJ_BREAK) {
-                return result;
+            if (is_signal(result, OBJ_BREAK)) {
+                break;
             }
 
-            if (result != NULL && result->type == OBJ_ERROR) {
-                return result;
+            if (is_signal(result, OBJ_ERROR)) {
+                break;
             }
 
-            isContinue = result != NULL && result->type == OBJ_CONTINUE;
+            isContinue = is_signal(result, OBJ_CONTINUE);
         }
 
-        context_free(&interpreter->env);
-
-        interpreter->env = previous;
+        leave_scope(interpreter, previous);
 
         return result;
     }
     case RETURN_STMT: {
         ReturnStmt* returnStmt = statement->stmt;
 
-        Object* result = eval_expr(interpreter, returnStmt->expression);
+        Value result = eval_expr(interpreter, returnStmt->expression);
 
         if (is_error(interpreter, result)) {
-            log_error(result->object);
+            log_error(result);
             return result;
         }
 
-        return NEW_RETURN_OBJECT(result);
+        interpreter->returnValue = result;
+
+        return OBJECT_VALUE(interpreter->returnSignal);
     }
     case BREAK_STMT: {
-        return BREAK_OBJECT;
+        return OBJECT_VALUE(interpreter->breakSignal);
     }
     case CONTINUE_STMT: {
-        return CONTINUE_OBJECT;
+        return OBJECT_VALUE(interpreter->continueSignal);
     }
     case IF_STMT: {
         IfStmt* ifStmt = statement->stmt;
 
-        Object* condition = eval_expr(interpreter, ifStmt->condition);
+        Value condition = eval_expr(interpreter, ifStmt->condition);
         if (is_error(interpreter, condition)) {
-            log_error(condition->object);
+            log_error(condition);
             return condition;
         }
 
-        Context* previous = interpreter->env;
+        Value result = NIL_VALUE();
 
-        interpreter->env = context_enclosed_new(
-            previous,
-            MAP_NEW(32, entry_cmp, NULL, NULL)
-        );
-
-        Object* result = NULL;
-
-        if (is_thruthy(condition)) {
+        if (value_is_truthy(condition)) {
             result = eval_stmt(interpreter, ifStmt->thenBranch);
         } else if (ifStmt->elseBranch) {
             result = eval_stmt(interpreter, ifStmt->elseBranch);
         }
 
-        interpreter->env = previous;
-
         if (is_error(interpreter, result)) {
-            log_error(result->object);
+            log_error(result);
             return result;
         }
 
@@ -367,68 +566,76 @@ Object* eval_stmt(Interpreter* interpreter, Stmt* statement) {
     case WHILE_STMT: {
         WhileStmt* whileStmt = statement->stmt;
 
-        Object* result = NULL;
+        Value result = NIL_VALUE();
+
+        while (value_is_truthy(eval_expr(interpreter, whileStmt->condition))) {
+            gc_safepoint(interpreter->gc, interpreter);
 
-        while (is_thruthy(eval_expr(interpreter, whileStmt->condition))) {
             result = eval_stmt(interpreter, whileStmt->body);
 
-            if (result != NULL && result->type == OBJ_RETURN) {
+            if (is_signal(result, OBJ_RETURN)) {
                 return result;
             }
 
-            if (result != NULL && result->type == OBJ_BREAK) {
+            if (is_signal(result, OBJ_BREAK)) {
                 return result;
             }
         }
 
-        return NIL_OBJECT;
+        return NIL_VALUE();
     }
     case FOR_STMT: {
         ForStmt* forStmt = statement->stmt;
 
         Context* previous = interpreter->env;
 
-        interpreter->env = context_enclosed_new(
-            previous,
-            MAP_NEW(32, entry_cmp, NULL, NULL)
-        );
+        enter_scope(interpreter, forStmt->scope);
 
-        Object* init = eval_decl(interpreter, forStmt->initialization);
+        Value init = eval_decl(interpreter, forStmt->initialization);
         if (is_error(interpreter, init)) {
-            log_error(init->object);
+            log_error(init);
+            leave_scope(interpreter, previous);
             return init;
         }
 
-        Object* result = NULL;
+        Value result = NIL_VALUE();
+
+        while(value_is_truthy(eval_expr(interpreter, forStmt->condition))) {
+            gc_safepoint(interpreter->gc, interpreter);
 
-        while(is_thruthy(eval_expr(interpreter, forStmt->condition))) {
             result = eval_stmt(interpreter, forStmt->body);
             if (is_error(interpreter, result)) {
-                log_error(result->object);
+                log_error(result);
+                leave_scope(interpreter, previous);
                 return result;
             }
 
-            if (result != NULL && result->type == OBJ_RETURN) {
+            if (is_signal(result, OBJ_RETURN)) {
                 break;
             }
 
-            if (result != NULL && result->type == OBJ_BREAK) {
+            if (is_signal(result, OBJ_BREAK)) {
                 break;
             }
 
             if (forStmt->action) {
                 result = eval_expr(interpreter, forStmt->action);
                 if (is_error(interpreter, result)) {
-                    log_error(result->object);
-                    interpreter->env = previous;
+                    log_error(result);
+                    leave_scope(interpreter, previous);
                     return result;
                 }
             }
         }
 
-        interpreter->env = previous;
+        leave_scope(interpreter, previous);
 
-        return result;
+        /* plain values may not survive the safepoints of later iterations */
+        if (is_signal(result, OBJ_RETURN) || is_signal(result, OBJ_BREAK)) {
+            return result;
+        }
+
+        return NIL_VALUE();
     }
     case EXPRESSION_STMT: {
         ExpressionStmt* exprStmt = statement->stmt;
@@ -436,46 +643,154 @@ Object* eval_stmt(Interpreter* interpreter, Stmt* statement) {
         return eval_expr(interpreter, exprStmt->expression);
     }
     default:
-        return NULL;
+        return NIL_VALUE();
+    }
+}
+
+/* where an indexed read or write lands */
+typedef struct Element {
+    IndexTarget target;
+    bool missing; /* a map key not present yet, read as the zero value */
+} Element;
+
+/* evaluates the object and every level first, so a dense array is read with one offset calculation */
+static Value eval_element(Interpreter* interpreter, ArrayMemberExpr* arrayMember, Element* element) {
+    size_t count = list_size(&arrayMember->levelOfAccess);
+    if (count > ARRAY_MAX_RANK) {
+        return error_value(RUNTIME_ERROR, "invalid array access");
+    }
+
+    Value current = eval_expr(interpreter, arrayMember->object);
+    if (is_error(interpreter, current)) {
+        return current;
+    }
+
+    gc_push_root(interpreter->gc, current);
+
+    Value levels[ARRAY_MAX_RANK];
+    size_t index = 0;
+
+    list_foreach(level, arrayMember->levelOfAccess) {
+        Value levelValue = eval_expr(interpreter, level->value);
+        if (is_error(interpreter, levelValue)) {
+            gc_pop_roots(interpreter->gc, index + 1);
+            return levelValue;
+        }
+
+        gc_push_root(interpreter->gc, levelValue);
+        levels[index++] = levelValue;
+    }
+
+    Value resolved = index_target_resolve(&element->target, current, levels, count);
+
+    gc_pop_roots(interpreter->gc, count + 1);
+
+    element->missing = false;
+
+    if (!IS_NIL(resolved))
+        return resolved;
+
+    IndexTarget* target = &element->target;
+
+    if (target->container->type == OBJ_ARRAY)
+        return array_object_get_index(target->container->object, target->indices, target->count);
+
+    Value value = NIL_VALUE();
+    if (map_object_get(target->container->object, target->key, &value))
+        return value;
+
+    element->missing = true;
+
+    return map_object_zero(target->container->object);
+}
+
+static Value store_element(Element* element, Value value) {
+    IndexTarget* target = &element->target;
+
+    if (target->container->type == OBJ_ARRAY)
+        return array_object_set_index(target->container->object, target->indices, target->count, value);
+
+    if (!map_object_set(target->container->object, target->key, value))
+        return error_value(RUNTIME_ERROR, "invalid map access");
+
+    gc_resize(target->container);
+
+    return value;
+}
+
+static bool same_kind(Value left, Value right) {
+    if (IS_OBJECT(left) && IS_OBJECT(right)) {
+        Type* leftType = object_get_type(AS_OBJECT(left));
+        Type* rightType = object_get_type(AS_OBJECT(right));
+
+        return type_equals(&leftType, &rightType);
+    }
+
+    return value_type(left) == value_type(right);
+}
+
+static Value eval_call_expr(Interpreter* interpreter, CallExpr* callExpr) {
+    Value callable = eval_expr(interpreter, callExpr->callee);
+    if (is_error(interpreter, callable)) {
+        log_error(callable);
+        return callable;
+    }
+
+    if (!IS_OBJECT(callable)) {
+        return error_value(RUNTIME_ERROR, "callable_run: cannot execute callable function");
+    }
+
+    size_t argc = vector_size(&callExpr->arguments);
+    Value arguments[argc > 0 ? argc : 1];
+    size_t index = 0;
+
+    /* the callee and the evaluated arguments stay rooted until the call returns */
+    gc_push_root(interpreter->gc, callable);
+
+    vector_foreach(argument, callExpr->arguments) {
+        Value value = eval_expr(interpreter, *argument);
+        if (is_error(interpreter, value)) {
+            gc_pop_roots(interpreter->gc, index + 1);
+            log_error(value);
+            return value;
+        }
+
+        gc_push_root(interpreter->gc, value);
+        arguments[index++] = value;
     }
+
+    Value result = callable_run(interpreter, AS_OBJECT(callable), arguments, argc);
+
+    gc_pop_roots(interpreter->gc, argc + 1);
+
+    return result;
 }
 
-Object* eval_expr(Interpreter* interpreter, Expr* expression) {
+Value eval_expr(Interpreter* interpreter, Expr* expression) {
     if (interpreter == NULL || expression == NULL)
-        return NULL;
+        return NIL_VALUE();
 
     switch (expression->type) {
     case BINARY_EXPR: {
         BinaryExpr* binaryExpr = expression->expr;
 
-        Object* left = eval_expr(interpreter, binaryExpr->left);
+        Value left = eval_expr(interpreter, binaryExpr->left);
         if (is_error(interpreter, left)) {
-            log_error(left->object);
+            log_error(left);
             return left;
         }
 
-        Object* right = eval_expr(interpreter, binaryExpr->right);
+        gc_push_root(interpreter->gc, left);
+        Value right = eval_expr(interpreter, binaryExpr->right);
+        gc_pop_roots(interpreter->gc, 1);
         if (is_error(interpreter, right)) {
-            log_error(right->object);
+            log_error(right);
             return right;
         }
 
-        // Context* out = types->env;
-        // types->env = interpreter->env;
-
-        // Type* resultType = get_expr_type(types, expression);
-
-        // if (resultType == NULL) {
-            Type* resultType = resultType = get_operation_type(binaryExpr->op, left, right);
-        // }
-
-        // types->env = out;
-
-        Token* operation = binaryExpr->op;
-
-        Object* result = eval_binary_expr(interpreter, resultType, left, operation, right);
+        Value result = eval_typed_binary_expr(interpreter, binaryExpr, left, right);
         if (is_error(interpreter, result)) {
-            log_error(result->object);
+            log_error(result);
             return result;
         }
 
@@ -484,9 +799,9 @@ Object* eval_expr(Interpreter* interpreter, Expr* expression) {
     case GROUP_EXPR: {
         GroupExpr* groupExpr = expression->expr;
 
-        Object* result = eval_expr(interpreter, groupExpr->expression);
+        Value result = eval_expr(interpreter, groupExpr->expression);
         if (is_error(interpreter, result)) {
-            log_error(result->object);
+            log_error(result);
             return result;
         }
 
@@ -498,132 +813,101 @@ Object* eval_expr(Interpreter* interpreter, Expr* expression) {
         if (assignExpr != NULL && assignExpr->identifier != NULL && assignExpr->identifier->type == ARRAY_MEMBER_EXPR) {
             ArrayMemberExpr* arrayMember = assignExpr->identifier->expr;
 
-            Object* array = eval_expr(interpreter, arrayMember->object);
-            if (is_error(interpreter, array)) {
-                log_error(array->object);
-                return array;
-            }
-
-            Object* ident = array;
-
-            list_foreach(level, arrayMember->levelOfAccess) {
-                Object* index = eval_expr(interpreter, level->value);
-
-                if (ident != NULL && ident->type == OBJ_ARRAY) {
-                    ident = array_object_get_object_at(ident->object, ((IntegerObject*) index->object)->value);
-                }
-            }
+            Element element;
 
+            Value ident = eval_element(interpreter, arrayMember, &element);
             if (is_error(interpreter, ident)) {
-                log_error(ident->object);
+                log_error(ident);
                 return ident;
             }
 
-            Object* value = eval_expr(interpreter, assignExpr->expression);
+            gc_push_root(interpreter->gc, OBJECT_VALUE(element.target.container));
+            gc_push_root(interpreter->gc, element.target.key);
+            gc_push_root(interpreter->gc, ident);
+            Value value = eval_expr(interpreter, assignExpr->expression);
+            gc_pop_roots(interpreter->gc, 3);
             if (is_error(interpreter, value)) {
-                log_error(value->object);
+                log_error(value);
                 return value;
             }
 
-            Type* identType = object_get_type(ident);
-            Type* valueType = object_get_type(value);
-            if (!type_equals(&identType, &valueType)) {
-                type_to_string(&identType);
-                printf("\n");
-                type_to_string(&valueType);
-                printf("\n");
-                return NEW_ERROR_OBJECT(RUNTIME_ERROR, "invalid assign: type mismatch");
+            /* the zero value standing in for a missing map key says nothing about the value's type */
+            if (!element.missing && !same_kind(ident, value)) {
+                return error_value(RUNTIME_ERROR, "invalid assign: type mismatch");
             }
 
-            // TODO: implement remaining operators
-            ident->object = value->object;
+            if (assignExpr->op->type != TOKEN_ASSIGN) {
+                value = eval_compound_op(interpreter, assignExpr->op->type, ident, value);
+                if (is_error(interpreter, value)) {
+                    log_error(value);
+                    return value;
+                }
+            }
 
-            return ident;
+            Value assigned = store_element(&element, value);
+            if (is_error(interpreter, assigned)) {
+                log_error(assigned);
+                return assigned;
+            }
+
+            return value;
         }
 
-        Object* ident = eval_expr(interpreter, assignExpr->identifier);
+        Value ident = eval_expr(interpreter, assignExpr->identifier);
         if (is_error(interpreter, ident)) {
-            log_error(ident->object);
+            log_error(ident);
             return ident;
         }
 
-        Object* value = eval_expr(interpreter, assignExpr->expression);
+        Value value = eval_expr(interpreter, assignExpr->expression);
         if (is_error(interpreter, value)) {
-            log_error(value->object);
+            log_error(value);
             return value;
         }
 
-        char* identName = ((IdentLiteral*) ((Expr*) assignExpr->identifier->expr)->expr)->value;
+        IdentLiteral* identLiteral = ((LiteralExpr*) assignExpr->identifier->expr)->value;
 
-        Object* result = eval_assign_expr(
+        Value result = eval_assign_expr(
             interpreter,
             assignExpr->op,
-            identName,
+            identLiteral,
             value
         );
         if (is_error(interpreter, result)) {
-            log_error(result->object);
+            log_error(result);
             return result;
         }
 
         return result;
     }
     case CALL_EXPR: {
-        CallExpr* callExpr = expression->expr;
-
-        Object* callable = eval_expr(interpreter, callExpr->callee);
-        if (is_error(interpreter, callable)) {
-            log_error(callable->object);
-            return callable;
-        }
-
-        List* arguments = list_new(NULL);
-
-        list_foreach(argument, callExpr->arguments) {
-            Object* value = eval_expr(interpreter, argument->value);
-            if (is_error(interpreter, value)) {
-                log_error(value->object);
-                list_free(&arguments);
-                return value;
-            }
-
-            list_insert_last(&arguments, value);
-        }
-
-        Object* result = callable_run(interpreter, callable, arguments);
-
-        list_free(&arguments);
-
-        return result;
+        return eval_call_expr(interpreter, expression->expr);
     }
     case LOGICAL_EXPR: {
         LogicalExpr* logicalExpr = expression->expr;
 
-        Object* left = eval_expr(interpreter, logicalExpr->left);
+        Value left = eval_expr(interpreter, logicalExpr->left);
         if (is_error(interpreter, left)) {
-            log_error(left->object);
+            log_error(left);
             return left;
         }
 
-        Object* right = eval_expr(interpreter, logicalExpr->right);
+        gc_push_root(interpreter->gc, left);
+        Value right = eval_expr(interpreter, logicalExpr->right);
+        gc_pop_roots(interpreter->gc, 1);
         if (is_error(interpreter, right)) {
-            log_error(right->object);
+            log_error(right);
             return right;
         }
 
-        Object* result = NULL;
+        Value result = NIL_VALUE();
 
         if (logicalExpr->op->type == TOKEN_LAND) {
-            result = eval_to_bool_obj(is_thruthy(left) && is_thruthy(right));
+            result = BOOL_VALUE(value_is_truthy(left) && value_is_truthy(right));
         }
 
         if (logicalExpr->op->type == TOKEN_LOR) {
-            result = eval_to_bool_obj(is_thruthy(left) || is_thruthy(right));
-        }
-
-        if (is_error(interpreter, result)) {
-            log_error(result->object);
-            return result;
+            result = BOOL_VALUE(value_is_truthy(left) || value_is_truthy(right));
         }
 
         return result;
@@ -631,55 +915,47 @@ Object* eval_expr(Interpreter* interpreter, Expr* expression) {
     case UNARY_EXPR: {
         UnaryExpr* unaryExpr = expression->expr;
 
-        Object* right = eval_expr(interpreter, unaryExpr->expression);
+        Value right = eval_expr(interpreter, unaryExpr->expression);
         if (is_error(interpreter, right)) {
-            log_error(right->object);
+            log_error(right);
             return right;
         }
 
         TokenType operationType = unaryExpr->op->type;
 
         if (operationType == TOKEN_ADD) {
-            if (right->type == OBJ_INTEGER) {
-                IntegerObject* intObj = (IntegerObject*)right->object;
-                return NEW_INTEGER_OBJECT(intObj->value);
-            }
-            if (right->type == OBJ_FLOAT) {
-                FloatObject* floatObj = (FloatObject*)right->object;
-                return NEW_FLOAT_OBJECT(floatObj->value);
+            if (IS_INT(right) || IS_FLOAT(right)) {
+                return right;
             }
         }
 
         if (operationType == TOKEN_SUB) {
-            if (right->type == OBJ_INTEGER) {
-                IntegerObject* intObj = (IntegerObject*)right->object;
-                return NEW_INTEGER_OBJECT(-intObj->value);
+            if (IS_INT(right)) {
+                return INT_VALUE(0u - (uint64_t) AS_INT(right));
             }
-            if (right->type == OBJ_FLOAT) {
-                FloatObject* floatObj = (FloatObject*)right->object;
-                return NEW_FLOAT_OBJECT(-floatObj->value);
+            if (IS_FLOAT(right)) {
+                return FLOAT_VALUE(-AS_FLOAT(right));
             }
         }
 
         if (operationType == TOKEN_TILDE) {
-            if (right->type == OBJ_INTEGER) {
-                IntegerObject* intObj = (IntegerObject*)right->object;
-                return NEW_INTEGER_OBJECT(~intObj->value);
+            if (IS_INT(right)) {
+                return INT_VALUE(~AS_INT(right));
             }
         }
 
         if (operationType == TOKEN_NOT) {
-            return eval_to_bool_obj(!is_thruthy(right));
+            return BOOL_VALUE(!value_is_truthy(right));
         }
 
         ByteBuffer* bb = byte_buffer_new();
         byte_buffer_append(bb, "invalid operation: ", strlen("invalid operation: "));
         byte_buffer_appendf(bb, "%s ", unaryExpr->op->literal);
-        object_to_string(bb, &right);
+        value_to_string(bb, right);
         char* error_message = byte_buffer_to_string(bb);
         byte_buffer_free(&bb);
 
-        Object* error = NEW_ERROR_OBJECT(RUNTIME_ERROR, error_message);
+        Value error = error_value(RUNTIME_ERROR, error_message);
 
         safe_free((void**) &error_message);
 
@@ -687,141 +963,178 @@ Object* eval_expr(Interpreter* interpreter, Expr* expression) {
     }
     case UPDATE_EXPR: {
         UpdateExpr* updateExpr = expression->expr;
+        Expr* target = updateExpr->expression;
+
+        Element element = { .target.container = NULL };
 
-        Object* identValue = eval_expr(interpreter, updateExpr->expression);
+        Value identValue = target->type == ARRAY_MEMBER_EXPR
+            ? eval_element(interpreter, target->expr, &element)
+            : eval_expr(interpreter, target);
         if (is_error(interpreter, identValue)) {
-            log_error(identValue->object);
+            log_error(identValue);
             return identValue;
         }
 
-        char* identName = ((IdentLiteral*) ((Expr*) updateExpr->expression->expr)->expr)->value;
         TokenType operationType = updateExpr->op->type;
+        int64_t delta = operationType == TOKEN_INC ? 1 : -1;
 
-        if (operationType == TOKEN_INC) {
-            if (identValue->type == OBJ_INTEGER) {
-                IntegerObject* intObj = identValue->object;
-                return NEW_INTEGER_OBJECT(intObj->value++);
-            }
-            if (identValue->type == OBJ_FLOAT) {
-                FloatObject* floatObj = identValue->object;
-                return NEW_FLOAT_OBJECT(floatObj->value++);
+        Value updated = UNDEFINED_VALUE();
+
+        if (operationType == TOKEN_INC || operationType == TOKEN_DEC) {
+            if (IS_INT(identValue)) {
+                updated = INT_VALUE((uint64_t) AS_INT(identValue) + (uint64_t) delta);
+            } else if (IS_FLOAT(identValue)) {
+                updated = FLOAT_VALUE(AS_FLOAT(identValue) + delta);
             }
         }
 
-        if (operationType == TOKEN_DEC) {
-            if (identValue->type == OBJ_INTEGER) {
-                IntegerObject* intObj = identValue->object;
-                return NEW_INTEGER_OBJECT(intObj->value--);
-            }
-            if (identValue->type == OBJ_FLOAT) {
-                FloatObject* floatObj = identValue->object;
-                return NEW_FLOAT_OBJECT(floatObj->value--);
-            }
+        if (!IS_UNDEFINED(updated) && target->type == LITERAL_EXPR) {
+            IdentLiteral* identLiteral = ((LiteralExpr*) target->expr)->value;
+
+            context_assign_at(interpreter->env, identLiteral->depth, identLiteral->slot, updated);
+
+            return identValue;
+        }
+
+        if (!IS_UNDEFINED(updated) && element.target.container != NULL) {
+            store_element(&element, updated);
+
+            return identValue;
         }
 
         ByteBuffer* bb = byte_buffer_new();
         byte_buffer_append(bb, "invalid operation: ", strlen("invalid operation: "));
-        object_to_string(bb, &identValue);
+        value_to_string(bb, identValue);
         byte_buffer_appendf(bb, "%s", updateExpr->op->literal);
         char* error_message = byte_buffer_to_string(bb);
         byte_buffer_free(&bb);
 
-        Object* error = NEW_ERROR_OBJECT(RUNTIME_ERROR, error_message);
+        Value error = error_value(RUNTIME_ERROR, error_message);
 
         safe_free((void**) &error_message);
 
         return error;
     }
     case FIELD_INIT_EXPR: {
-        return NULL;
+        return NIL_VALUE();
     }
     case STRUCT_INIT_EXPR: {
-        return NULL;
+        return NIL_VALUE();
     }
     case STRUCT_INLINE_EXPR: {
-        return NULL;
+        return NIL_VALUE();
     }
     case ARRAY_INIT_EXPR: {
         ArrayInitExpr* arrayInitExpr = expression->expr;
 
-        List* objects = list_new(NULL);
-        Object* result = NULL;
+        size_t length = list_size(&arrayInitExpr->elements);
+        Value* values = safe_malloc((length > 0 ? length : 1) * sizeof(Value), NULL);
+        size_t index = 0;
+
         list_foreach(element, arrayInitExpr->elements) {
-            result = eval_expr(interpreter, element->value);
+            Value result = eval_expr(interpreter, element->value);
             if (is_error(interpreter, result)) {
-                log_error(result->object);
+                gc_pop_roots(interpreter->gc, index);
+                log_error(result);
+                safe_free((void**) &values);
                 return result;
             }
 
-            list_insert_last(&objects, result);
+            gc_push_root(interpreter->gc, result);
+            values[index++] = result;
+        }
+
+        gc_pop_roots(interpreter->gc, length);
+
+        Type* arrayType = type_copy((const Type**) &arrayInitExpr->type);
+
+        return OBJECT_VALUE(NEW_ARRAY_OBJECT(arrayType, values, length));
+    }
+    case MAP_INIT_EXPR: {
+        MapInitExpr* mapInitExpr = expression->expr;
+
+        size_t count = list_size(&mapInitExpr->keys);
+        Value* entries = safe_malloc((count > 0 ? 2 * count : 1) * sizeof(Value), NULL);
+        size_t index = 0;
+
+        ListNode* value = mapInitExpr->values->head;
+        list_foreach(key, mapInitExpr->keys) {
+            Expr* entry[] = { key->value, value->value };
+            value = value->next;
+
+            for (size_t i = 0; i < 2; i++) {
+                Value result = eval_expr(interpreter, entry[i]);
+                if (is_error(interpreter, result)) {
+                    gc_pop_roots(interpreter->gc, index);
+                    log_error(result);
+                    safe_free((void**) &entries);
+                    return result;
+                }
+
+                gc_push_root(interpreter->gc, result);
+                entries[index++] = result;
+            }
+        }
+
+        Object* map = NEW_MAP_OBJECT(type_copy((const Type**) &mapInitExpr->type), count);
+
+        /* in source order, so a repeated key keeps its last value */
+        for (size_t i = 0; i < index; i += 2) {
+            map_object_set(map->object, entries[i], entries[i + 1]);
         }
 
-        return NEW_ARRAY_OBJECT(arrayInitExpr->type, objects);
+        gc_pop_roots(interpreter->gc, index);
+        safe_free((void**) &entries);
+        gc_resize(map);
+
+        return OBJECT_VALUE(map);
     }
     case FUNC_EXPR: {
         FunctionExpr* functionExpr = expression->expr;
 
-        Type* functionType = get_expr_type(types, expression);
+        Type* functionType = expression->resolvedType;
         Context* functionEnv = interpreter->env;
         List* functionParameters = functionExpr->parameters;
         Stmt* functionBody = functionExpr->body;
+        ScopeLayout functionFrame = functionExpr->scope;
 
-        Object* functionObject = NEW_FUNCTION_OBJECT(functionType, functionEnv, functionParameters, functionBody);
+        Object* functionObject = NEW_FUNCTION_OBJECT(functionType, functionEnv, functionParameters, functionBody, functionFrame);
         Object* callableFunction = NEW_CALLABLE_OBJECT(functionObject);
 
-        return callableFunction;
+        gc_capture(interpreter->gc, functionEnv);
+
+        return OBJECT_VALUE(callableFunction);
     }
     case CONDITIONAL_EXPR: {
         ConditionalExpr* conditionalExpr = expression->expr;
 
-        Object* result = NULL;
+        Value result = NIL_VALUE();
 
-        if (is_thruthy(eval_expr(interpreter, conditionalExpr->condition))) {
+        if (value_is_truthy(eval_expr(interpreter, conditionalExpr->condition))) {
             result = eval_expr(interpreter, conditionalExpr->isTrue);
         } else if (conditionalExpr->isFalse) {
             result = eval_expr(interpreter, conditionalExpr->isFalse);
         }
 
         if (is_error(interpreter, result)) {
-            log_error(result->object);
+            log_error(result);
             return result;
         }
 
         return result;
     }
     case MEMBER_EXPR: {
-        return NULL;
+        return NIL_VALUE();
     }
     case ARRAY_MEMBER_EXPR: {
         ArrayMemberExpr* arrayMemberExpr = expression->expr;
 
-        Object* array = eval_expr(interpreter, arrayMemberExpr->object);
-        if (is_error(interpreter, array)) {
-            log_error(array->object);
-            return array;
-        }
-
-        if (array_object_get_dimensions(array->object) < list_size(&arrayMemberExpr->levelOfAccess)) {
-            return NEW_ERROR_OBJECT(RUNTIME_ERROR, "invalid array access");
-        }
-
-        Object* result = array;
-        Object* index = NULL;
+        Element element;
 
-        list_foreach(level, arrayMemberExpr->levelOfAccess) {
-            index = eval_expr(interpreter, level->value);
-
-            if (is_error(interpreter, index)) {
-                log_error(index->object);
-                return index;
-            }
-
-            result = array_object_get_object_at(result->object, ((IntegerObject*) index->object)->value);
-
-            if (is_error(interpreter, result)) {
-                log_error(result->object);
-                return index;
-            }
+        Value result = eval_element(interpreter, arrayMemberExpr, &element);
+        if (is_error(interpreter, result)) {
+            log_error(result);
+            return result;
         }
 
         return result;
@@ -829,111 +1142,106 @@ Object* eval_expr(Interpreter* interpreter, Expr* expression) {
     case CAST_EXPR: {
         CastExpr* castExpr = expression->expr;
 
-        Object* targetValue = eval_expr(interpreter, castExpr->target);
+        Value targetValue = eval_expr(interpreter, castExpr->target);
         if (is_error(interpreter, targetValue)) {
-            log_error(targetValue->object);
+            log_error(targetValue);
             return targetValue;
         }
 
-        Type* targetType = object_get_type(targetValue);
-
-        Object* result = NULL;
+        TypeID castType = castExpr->type->typeId;
 
-        if (targetValue != NULL && targetType != NULL && targetType->typeId == STRING_TYPE) {
-            StringObject* strObj = targetValue->object;
+        if (IS_OBJECT(targetValue) && AS_OBJECT(targetValue)->type == OBJ_STRING) {
+            StringObject* strObj = AS_OBJECT(targetValue)->object;
 
-            if (castExpr->type->typeId == STRING_TYPE) {
-                return NEW_STRING_OBJECT(strObj->value);
+            if (castType == STRING_TYPE) {
+                return targetValue;
             }
 
-            if (castExpr->type->typeId == INT_TYPE && isInteger(strObj->value)) {
-                return NEW_INTEGER_OBJECT(atoi(strObj->value));
+            if (castType == INT_TYPE && isInteger(strObj->value)) {
+                return INT_VALUE(strtoll(strObj->value, NULL, 10));
             }
 
-            if (castExpr->type->typeId == FLOAT_TYPE && isInteger(strObj->value) || isFloat(strObj->value)) {
-                return NEW_FLOAT_OBJECT(atof(strObj->value));
+            if (castType == FLOAT_TYPE && (isInteger(strObj->value) || isFloat(strObj->value))) {
+                return FLOAT_VALUE(atof(strObj->value));
             }
 
-            if (castExpr->type->typeId == CHAR_TYPE && isChar(strObj->value)) {
-                return NEW_CHARACTER_OBJECT(strObj->value[0]);
+            if (castType == CHAR_TYPE && isChar(strObj->value)) {
+                return CHAR_VALUE(strObj->value[0]);
             }
 
-            if (castExpr->type->typeId == BOOL_TYPE && isBool(strObj->value)) {
-                return NEW_BOOLEAN_OBJECT(strcmp(strObj->value, "true") == 0);
+            if (castType == BOOL_TYPE && isBool(strObj->value)) {
+                return BOOL_VALUE(strcmp(strObj->value, "true") == 0);
             }
         }
 
-        if (targetValue != NULL && targetType != NULL && targetType->typeId == INT_TYPE) {
-            IntegerObject* intObj = targetValue->object;
-
-            if (castExpr->type->typeId == INT_TYPE) {
-                return NEW_INTEGER_OBJECT(intObj->value);
+        if (IS_INT(targetValue)) {
+            if (castType == INT_TYPE) {
+                return targetValue;
             }
 
-            if (castExpr->type->typeId == FLOAT_TYPE) {
-                return NEW_FLOAT_OBJECT(intObj->value);
+            if (castType == FLOAT_TYPE) {
+                return FLOAT_VALUE(AS_INT(targetValue));
             }
         }
 
-        if (targetValue != NULL && targetType != NULL && targetType->typeId == FLOAT_TYPE) {
-            FloatObject* floatObj = targetValue->object;
-
-            if (castExpr->type->typeId == FLOAT_TYPE) {
-                return NEW_INTEGER_OBJECT(floatObj->value);
+        if (IS_FLOAT(targetValue)) {
+            if (castType == FLOAT_TYPE) {
+                return targetValue;
             }
 
-            if (castExpr->type->typeId == INT_TYPE) {
-                return NEW_INTEGER_OBJECT((int)floatObj->value);
+            if (castType == INT_TYPE) {
+                return INT_VALUE((int64_t) AS_FLOAT(targetValue));
             }
         }
 
-        if (targetValue != NULL && targetType != NULL && targetType->typeId == CHAR_TYPE) {
-            CharacterObject* charObj = targetValue->object;
-
-            if (castExpr->type->typeId == INT_TYPE) {
-                return NEW_INTEGER_OBJECT(charObj->value);
+        if (IS_CHAR(targetValue)) {
+            if (castType == INT_TYPE) {
+                return INT_VALUE(AS_CHAR(targetValue));
             }
 
-            if (castExpr->type->typeId == CHAR_TYPE) {
-                return NEW_CHARACTER_OBJECT(charObj->value);
+            if (castType == CHAR_TYPE) {
+                return targetValue;
             }
 
-            if (castExpr->type->typeId == STRING_TYPE) {
-                return NEW_STRING_OBJECT(&charObj->value);
+            if (castType == STRING_TYPE) {
+                char str[2] = { AS_CHAR(targetValue), '\0' };
+                return OBJECT_VALUE(NEW_STRING_OBJECT(str));
             }
         }
 
-        return NEW_ERROR_OBJECT(RUNTIME_ERROR, "invalid cast");
+        return error_value(RUNTIME_ERROR, "invalid cast");
     }
     case LITERAL_EXPR: {
         LiteralExpr* literalExpr = expression->expr;
 
-        Object* value = eval_literal_expr(interpreter, literalExpr);
+        Value value = eval_literal_expr(interpreter, literalExpr);
 
         if (is_error(interpreter, value)) {
-            log_error(value->object);
+            log_error(value);
             return value;
         }
 
         return value;
     }
     default:
-        return NEW_ERROR_OBJECT(RUNTIME_ERROR, "cannot eval expression");
+        return error_value(RUNTIME_ERROR, "cannot eval expression");
     }
 }
 
-static Object* eval_literal_expr(Interpreter* interpreter, LiteralExpr* literalExpr) {
+static Value eval_literal_expr(Interpreter* interpreter, LiteralExpr* literalExpr) {
     if (interpreter == NULL || literalExpr == NULL) {
-        return NEW_ERROR_OBJECT(RUNTIME_ERROR, "cannot determine value of expression");
+        return error_value(RUNTIME_ERROR, "cannot determine value of expression");
     }
 
     switch (literalExpr->type) {
     case IDENT_LITERAL: {
         IdentLiteral* identLiteral = (IdentLiteral*) literalExpr->value;
 
-        void* found_obj = NULL;
-        found_obj = context_get(interpreter->env, identLiteral->value);
-        if (found_obj == NULL) {
+        Value found = UNDEFINED_VALUE();
+        if (identLiteral->slot >= 0) {
+            found = context_get_at(interpreter->env, identLiteral->depth, identLiteral->slot);
+        }
+        if (IS_UNDEFINED(found)) {
             ByteBuffer* bb = byte_buffer_new();
 
             byte_buffer_appendf(bb, "undefined: %s", identLiteral->value);
@@ -942,57 +1250,62 @@ static Object* eval_literal_expr(Interpreter* interpreter, LiteralExpr* literalE
 
             byte_buffer_free(&bb);
 
-            Object* error = NEW_ERROR_OBJECT(RUNTIME_ERROR, error_message);
+            Value error = error_value(RUNTIME_ERROR, error_message);
 
             safe_free((void**) &error_message);
 
             return error;
         }
 
-        return found_obj;
+        return found;
     }
     case INT_LITERAL: {
         IntLiteral* intLiteral = literalExpr->value;
 
-        return NEW_INTEGER_OBJECT(intLiteral->value);
+        return INT_VALUE(intLiteral->value);
     }
     case FLOAT_LITERAL: {
         FloatLiteral* floatLiteral = literalExpr->value;
 
-        return NEW_FLOAT_OBJECT(floatLiteral->value);
+        return FLOAT_VALUE(floatLiteral->value);
     }
     case CHAR_LITERAL: {
         CharLiteral* charLiteral = literalExpr->value;
 
-        return NEW_CHARACTER_OBJECT(charLiteral->value);
+        return CHAR_VALUE(charLiteral->value);
     }
     case STRING_LITERAL: {
         StringLiteral* stringLiteral = literalExpr->value;
 
-        return NEW_STRING_OBJECT(stringLiteral->value);
+        return OBJECT_VALUE(NEW_STRING_OBJECT(stringLiteral->value));
     }
     case BOOL_LITERAL: {
         BoolLiteral* boolLiteral = literalExpr->value;
 
-        return (Object*) (boolLiteral->value ? TRUE_OBJECT : FALSE_OBJECT);
+        return BOOL_VALUE(boolLiteral->value);
     }
     case NIL_LITERAL: {
-        return (Object*) NIL_OBJECT;
+        return NIL_VALUE();
     }
     default:
-        printf("Error: \n\t");
+        output_printf("Error: \n\t");
         literal_expr_to_string(&literalExpr);
-        printf("\n");
+        output_printf("\n");
 
-        return NEW_ERROR_OBJECT(RUNTIME_ERROR, "cannot determine value of expression");
+        return error_value(RUNTIME_ERROR, "cannot determine value of expression");
     }
 }
 
-static bool is_error(Interpreter* interpreter, Object* object) {
-    if (object == NULL)
-        return false;
+static bool is_signal(Value value, ObjectType type) {
+    return IS_OBJECT(value) && AS_OBJECT(value)->type == type;
+}
+
+static Value error_value(ErrorType type, const char* message) {
+    return OBJECT_VALUE(NEW_ERROR_OBJECT(type, (char*) message));
+}
 
-    if (object->type == OBJ_ERROR) {
+static bool is_error(Interpreter* interpreter, Value value) {
+    if (is_signal(value, OBJ_ERROR)) {
         interpreter->exitCode = INTERPRETER_FAILURE;
         return true;
     }
@@ -1000,10 +1313,15 @@ static bool is_error(Interpreter* interpreter, Object* object) {
     return false;
 }
 
-static void log_error(Error* error) {
-    if (error == NULL)
+static void log_error(Value value) {
+    if (!is_signal(value, OBJ_ERROR))
         return;
 
+    Error* error = AS_OBJECT(value)->object;
+
+    /* the error follows whatever the program printed so far */
+    output_flush();
+
     ByteBuffer* bb = byte_buffer_new();
 
     error_to_string(bb, &error);
@@ -1017,413 +1335,169 @@ static void log_error(Error* error) {
     safe_free((void**) &error_message);
 }
 
-static Object* eval_to_bool_obj(bool input) {
-    if (input) {
-        return (Object*) TRUE_OBJECT;
-    }
-
-    return (Object*) FALSE_OBJECT;
+static bool is_text(Value value) {
+    return IS_CHAR(value) || is_signal(value, OBJ_STRING);
 }
 
-static bool is_thruthy(Object* object) {
-    if (object == NULL)
-        return false;
+static Value eval_value_op(TokenType op, Value left, Value right) {
+    Value result = UNDEFINED_VALUE();
 
-    if (object->type == OBJ_NIL) {
-        return false;
+    switch (value_binary_op(op, left, right, &result)) {
+    case VALUE_OP_OK:
+        return result;
+    case VALUE_OP_DIVISION_BY_ZERO:
+        return error_value(DIVISION_BY_ZERO_ERROR, "division by zero");
+    default:
+        return error_value(RUNTIME_ERROR, "invalid operation");
     }
+}
 
-    if (object->type == OBJ_BOOLEAN) {
-        return ((BooleanObject*) object->object)->value;
-    }
+static Value eval_concat(Value left, Value right) {
+    ByteBuffer* bb = byte_buffer_new();
+    value_to_string(bb, left);
+    value_to_string(bb, right);
+    char* str = byte_buffer_to_string(bb);
+    byte_buffer_free(&bb);
 
-    if (object->type == OBJ_INTEGER) {
-        return ((IntegerObject*) object->object)->value == 0 ? false : true;
-    }
+    Object* result = NEW_STRING_OBJECT(str);
 
-    if (object->type == OBJ_FLOAT) {
-        return ((FloatObject*) object->object)->value == 0.0 ? false : true;
-    }
+    safe_free((void**) &str);
 
-    return true;
+    return OBJECT_VALUE(result);
 }
 
-static Object* eval_binary_expr(Interpreter* interpreter, Type* type, Object* left, Token* operation, Object* right) {
-    if (interpreter == NULL || type == NULL || left == NULL || operation == NULL || right == NULL) {
-        return NEW_ERROR_OBJECT(RUNTIME_ERROR, "eval_binary_expr: invalid operation");
-    }
-
-    if (type->typeId == INT_TYPE || type->typeId == FLOAT_TYPE || type->typeId == BOOL_TYPE) {
-        if ((left->type == OBJ_STRING || left->type == OBJ_CHARACTER)
-            && (right->type == OBJ_STRING || right->type == OBJ_CHARACTER)) {
+/* the type checker picked the evaluator, the tag tests only guard what it could not prove */
+static Value eval_typed_binary_expr(Interpreter* interpreter, BinaryExpr* binaryExpr, Value left, Value right) {
+    TokenType op = binaryExpr->op->type;
 
-            if (operation->type == TOKEN_EQL) {
-                return NEW_BOOLEAN_OBJECT(object_equals(left, right));
-            }
+    switch (binaryExpr->operands) {
+    case OPERANDS_INT:
+        if (IS_INT(left) && IS_INT(right))
+            return eval_value_op(op, left, right);
+        break;
+    case OPERANDS_FLOAT:
+        if (IS_NUMBER(left) && IS_NUMBER(right))
+            return eval_value_op(op, left, right);
+        break;
+    case OPERANDS_CONCAT:
+        if (is_text(left) && is_text(right))
+            return eval_concat(left, right);
+        break;
+    default:
+        break;
+    }
 
-            if (operation->type == TOKEN_NEQ) {
-                return NEW_BOOLEAN_OBJECT(!object_equals(left, right));
-            }
+    return eval_binary_expr(interpreter, left, binaryExpr->op, right);
+}
 
-            return NEW_ERROR_OBJECT(RUNTIME_ERROR, "eval_binary_expr: invalid operation");
-        }
+/* operands the type checker could not pin down, the evaluator is picked from the values */
+static Value eval_binary_expr(Interpreter* interpreter, Value left, Token* operation, Value right) {
+    if (interpreter == NULL || operation == NULL) {
+        return error_value(RUNTIME_ERROR, "eval_binary_expr: invalid operation");
+    }
 
-        double left_value = 0;
-        double right_value = 0;
-        ObjectType returnType = OBJ_BOOLEAN;
+    TokenType op = operation->type;
 
-        if (left->type == right->type) {
-            returnType = left->type;
-        } else {
-            returnType = OBJ_FLOAT;
+    switch (op) {
+    case TOKEN_ADD:
+        if (is_text(left) || is_text(right))
+            return eval_concat(left, right);
+        /* fall through */
+    case TOKEN_SUB:
+    case TOKEN_MUL:
+    case TOKEN_QUO:
+    case TOKEN_REM:
+    case TOKEN_AND:
+    case TOKEN_OR:
+    case TOKEN_XOR:
+    case TOKEN_SHL:
+    case TOKEN_SHR:
+    case TOKEN_EQL:
+    case TOKEN_NEQ:
+    case TOKEN_LSS:
+    case TOKEN_GTR:
+    case TOKEN_LEQ:
+    case TOKEN_GEQ: {
+        /* any two values compare equal or not, as on the vm */
+        if (op == TOKEN_EQL || op == TOKEN_NEQ) {
+            return eval_value_op(op, left, right);
         }
 
-        if (left->type == OBJ_INTEGER) {
-            left_value = ((IntegerObject*)left->object)->value;
-        } else if (left->type == OBJ_FLOAT) {
-            left_value = ((FloatObject*)left->object)->value;
-        } else {
-            return NEW_ERROR_OBJECT(RUNTIME_ERROR, "eval_binary_expr: invalid left operand type");
+        if (is_text(left) && is_text(right)) {
+            return error_value(RUNTIME_ERROR, "eval_binary_expr: invalid operation");
         }
 
-        if (right->type == OBJ_INTEGER) {
-            right_value = ((IntegerObject*)right->object)->value;
-        } else if (right->type == OBJ_FLOAT) {
-            right_value = ((FloatObject*)right->object)->value;
-        } else {
-            return NEW_ERROR_OBJECT(RUNTIME_ERROR, "eval_binary_expr: invalid right operand type");
+        if (!IS_NUMBER(left)) {
+            return error_value(RUNTIME_ERROR, "eval_binary_expr: invalid left operand type");
         }
 
-        Object* result = eval_binary_op(returnType, operation, left_value, right_value);
-        if (is_error(interpreter, result)) {
-            log_error(result->object);
-            return result;
+        if (!IS_NUMBER(right)) {
+            return error_value(RUNTIME_ERROR, "eval_binary_expr: invalid right operand type");
         }
 
-        return result;
+        return eval_value_op(op, left, right);
     }
-
-    if (type->typeId == STRING_TYPE) {
-        ByteBuffer* bb = byte_buffer_new();
-        object_to_string(bb, &left);
-        object_to_string(bb, &right);
-        char* str = byte_buffer_to_string(bb);
-        byte_buffer_free(&bb);
-
-        Object* result = NEW_STRING_OBJECT(str);
-
-        safe_free((void**) &str);
-
-        return result;
+    default:
+        break;
     }
 
     ByteBuffer* bb = byte_buffer_new();
     byte_buffer_append(bb, "invalid operation: ", strlen("invalid operation: "));
-    object_to_string(bb, &left);
+    value_to_string(bb, left);
     byte_buffer_appendf(bb, " %s ", operation->literal);
-    object_to_string(bb, &right);
+    value_to_string(bb, right);
     char* error_message = byte_buffer_to_string(bb);
     byte_buffer_free(&bb);
 
-    Object* error = NEW_ERROR_OBJECT(RUNTIME_ERROR, error_message);
+    Value error = error_value(RUNTIME_ERROR, error_message);
 
     safe_free((void**) &error_message);
 
     return error;
 }
 
-static Object* eval_assign_expr(Interpreter* interpreter, Token* op, char* ident, Object* value) {
-    if (op == NULL)
-        return NEW_ERROR_OBJECT(RUNTIME_ERROR, "invalid operation");
-
-    Object* identValue = context_get(interpreter->env, ident);
-    if (is_error(interpreter, identValue)) {
-        log_error(identValue->object);
-        return identValue;
-    }
-
-    if (op->type == TOKEN_ASSIGN) {
-        context_assign(interpreter->env, ident, value);
-        return context_get(interpreter->env, ident);
-    }
-
-    double left_value = 0;
-    double right_value = 0;
-    ObjectType returnType = OBJ_FLOAT;
-
-    // lazy solution
-
-    if (identValue != NULL && identValue->type == OBJ_STRING) {
-        if (op->type != TOKEN_ADD_ASSIGN) {
-            return NEW_ERROR_OBJECT(RUNTIME_ERROR, "invalid operation");
-        }
-
-        if (identValue->type == value->type) {
-            returnType = identValue->type;
-        } else if (value->type == OBJ_CHARACTER) {
-            returnType = OBJ_STRING;
-        } else {
-            return NEW_ERROR_OBJECT(RUNTIME_ERROR, "invalid operation");
-        }
-    }
-
-    if (identValue != NULL && identValue->type == OBJ_CHARACTER) {
-        if (op->type != TOKEN_ADD_ASSIGN) {
-            return NEW_ERROR_OBJECT(RUNTIME_ERROR, "invalid operation");
-        }
-
-        if (identValue->type == value->type) {
-            returnType = identValue->type;
-        } else if (value->type == OBJ_STRING) {
-            returnType = OBJ_STRING;
-        } else {
-            return NEW_ERROR_OBJECT(RUNTIME_ERROR, "invalid operation");
-        }
-    }
-
-    if (identValue != NULL && identValue->type == OBJ_INTEGER) {
-        left_value = ((IntegerObject*)identValue->object)->value;
-
-        if (identValue->type == value->type) {
-            right_value = ((IntegerObject*) value->object)->value;
-            returnType = identValue->type;
-        } else if (value->type == OBJ_FLOAT) {
-            right_value = ((FloatObject*) value->object)->value;
-            returnType = OBJ_FLOAT;
-        } else {
-            return NEW_ERROR_OBJECT(RUNTIME_ERROR, "invalid operation");
-        }
-    }
-
-    if (identValue != NULL && identValue->type == OBJ_FLOAT) {
-        left_value = ((FloatObject*)identValue->object)->value;
+/* the operation behind +=, -= and the other compound assignments */
+static Value eval_compound_op(Interpreter* interpreter, TokenType op, Value target, Value value) {
+    (void) interpreter;
 
-        if (identValue->type == value->type) {
-            right_value = ((FloatObject*) value->object)->value;
-            returnType = identValue->type;
-        } else if (value->type == OBJ_INTEGER) {
-            right_value = ((IntegerObject*) value->object)->value;
-            returnType = OBJ_FLOAT;
-        } else {
-            return NEW_ERROR_OBJECT(RUNTIME_ERROR, "invalid operation");
-        }
-    }
+    Value result = UNDEFINED_VALUE();
 
-    Object* result = NULL;
-
-    if (returnType == OBJ_INTEGER || returnType == OBJ_FLOAT) {
-        switch (op->type) {
-        case TOKEN_ADD_ASSIGN: {
-            if (returnType == OBJ_FLOAT)
-                result = NEW_FLOAT_OBJECT(left_value + right_value);
-            else if (returnType == OBJ_INTEGER)
-                result = NEW_INTEGER_OBJECT((int)(left_value + right_value));
-            break;
-        }
-        case TOKEN_SUB_ASSIGN: {
-            if (returnType == OBJ_FLOAT)
-                result = NEW_FLOAT_OBJECT(left_value - right_value);
-            else if (returnType == OBJ_INTEGER)
-                result = NEW_INTEGER_OBJECT((int)(left_value - right_value));
-            break;
-        }
-        case TOKEN_MUL_ASSIGN: {
-            if (returnType == OBJ_FLOAT)
-                result = NEW_FLOAT_OBJECT(left_value * right_value);
-            else if (returnType == OBJ_INTEGER)
-                result = NEW_INTEGER_OBJECT((int)(left_value * right_value));
-            break;
+    if (is_text(target)) {
+        if (op == TOKEN_ADD_ASSIGN && is_text(value)) {
+            result = eval_concat(target, value);
         }
-        case TOKEN_QUO_ASSIGN: {
-            if (right_value == 0)
-                return NEW_ERROR_OBJECT(DIVISION_BY_ZERO_ERROR, "division by zero");
-            if (returnType == OBJ_FLOAT)
-                result = NEW_FLOAT_OBJECT(left_value / right_value);
-            else if (returnType == OBJ_INTEGER)
-                result = NEW_INTEGER_OBJECT((int)(left_value / right_value));
-            break;
-        }
-        case TOKEN_REM_ASSIGN: {
-            if (right_value == 0)
-                return NEW_ERROR_OBJECT(DIVISION_BY_ZERO_ERROR, "division by zero");
-            if (returnType == OBJ_FLOAT)
-                result = NEW_FLOAT_OBJECT(fmod(left_value, right_value));
-            else if (returnType == OBJ_INTEGER)
-                result = NEW_INTEGER_OBJECT((int)fmod(left_value, right_value));
-            break;
-        }
-        case TOKEN_AND_ASSIGN: {
-            if (returnType == OBJ_INTEGER)
-                result = NEW_INTEGER_OBJECT((int)left_value & (int)right_value);
-            break;
-        }
-        case TOKEN_OR_ASSIGN: {
-            if (returnType == OBJ_INTEGER)
-                result = NEW_INTEGER_OBJECT((int)left_value | (int)right_value);
-            break;
-        }
-        case TOKEN_XOR_ASSIGN: {
-            if (returnType == OBJ_INTEGER)
-                result = NEW_INTEGER_OBJECT((int)left_value ^ (int)right_value);
-            break;
-        }
-        case TOKEN_SHL_ASSIGN: {
-            if (returnType == OBJ_INTEGER)
-                result = NEW_INTEGER_OBJECT((int)left_value << (int)right_value);
-            break;
-        }
-        case TOKEN_SHR_ASSIGN: {
-            if (returnType == OBJ_INTEGER)
-                result = NEW_INTEGER_OBJECT((int)left_value >> (int)right_value);
-            break;
-        }
-        }
-    } else {
-        ByteBuffer* bb = byte_buffer_new();
-        object_to_string(bb, &identValue);
-        object_to_string(bb, &value);
-        char* str = byte_buffer_to_string(bb);
-        byte_buffer_free(&bb);
-
-        result = NEW_STRING_OBJECT(str);
-
-        safe_free((void**) &str);
+    } else if (IS_NUMBER(target) && IS_NUMBER(value)) {
+        result = eval_value_op(op, target, value);
     }
 
-    if (result != NULL) {
-        context_assign(interpreter->env, ident, result);
-        return context_get(interpreter->env, ident);
+    if (IS_UNDEFINED(result)) {
+        return error_value(RUNTIME_ERROR, "invalid operation");
     }
 
-    return NEW_ERROR_OBJECT(RUNTIME_ERROR, "invalid operation");
+    return result;
 }
 
-static Object* eval_binary_op(ObjectType returnType, Token* op, double left, double right) {
-    if (op == NULL)
-        return NEW_ERROR_OBJECT(RUNTIME_ERROR, "invalid operation");
-
-    switch (op->type) {
-    case TOKEN_ADD:
-        if (returnType == OBJ_FLOAT)
-            return NEW_FLOAT_OBJECT(left + right);
-        else if (returnType == OBJ_INTEGER)
-            return NEW_INTEGER_OBJECT((int)(left + right));
-        break;
-    case TOKEN_SUB:
-        if (returnType == OBJ_FLOAT)
-            return NEW_FLOAT_OBJECT(left - right);
-        else if (returnType == OBJ_INTEGER)
-            return NEW_INTEGER_OBJECT((int)(left - right));
-        break;
-    case TOKEN_MUL:
-        if (returnType == OBJ_FLOAT)
-            return NEW_FLOAT_OBJECT(left * right);
-        else if (returnType == OBJ_INTEGER)
-            return NEW_INTEGER_OBJECT((int)(left * right));
-        break;
-    case TOKEN_QUO:
-        if (right == 0)
-            return NEW_ERROR_OBJECT(DIVISION_BY_ZERO_ERROR, "division by zero");
-        if (returnType == OBJ_FLOAT)
-            return NEW_FLOAT_OBJECT(left / right);
-        else if (returnType == OBJ_INTEGER)
-            return NEW_INTEGER_OBJECT((int)(left / right));
-        break;
-    case TOKEN_REM:
-        if (right == 0)
-            return NEW_ERROR_OBJECT(DIVISION_BY_ZERO_ERROR, "division by zero");
-        if (returnType == OBJ_FLOAT)
-            return NEW_FLOAT_OBJECT(fmod(left, right));
-        else if (returnType == OBJ_INTEGER)
-            return NEW_INTEGER_OBJECT((int)fmod(left, right));
-        break;
-    case TOKEN_AND:
-        if (returnType == OBJ_INTEGER)
-            return NEW_INTEGER_OBJECT((int)left & (int)right);
-        break;
-    case TOKEN_OR:
-        if (returnType == OBJ_INTEGER)
-            return NEW_INTEGER_OBJECT((int)left | (int)right);
-        break;
-    case TOKEN_XOR:
-        if (returnType == OBJ_INTEGER)
-            return NEW_INTEGER_OBJECT((int)left ^ (int)right);
-        break;
-    case TOKEN_SHL:
-        if (returnType == OBJ_INTEGER)
-            return NEW_INTEGER_OBJECT((int)left << (int)right);
-        break;
-    case TOKEN_SHR:
-        if (returnType == OBJ_INTEGER)
-            return NEW_INTEGER_OBJECT((int)left >> (int)right);
-        break;
-    case TOKEN_EQL:
-        return eval_to_bool_obj(left == right);
-    case TOKEN_LSS:
-        return eval_to_bool_obj(left < right);
-    case TOKEN_GTR:
-        return eval_to_bool_obj(left > right);
-    case TOKEN_NEQ:
-        return eval_to_bool_obj(left != right);
-    case TOKEN_LEQ:
-        return eval_to_bool_obj(left <= right);
-    case TOKEN_GEQ:
-        return eval_to_bool_obj(left >= right);
-    }
-
-    return NEW_ERROR_OBJECT(RUNTIME_ERROR, "invalid operation");
-}
+static Value eval_assign_expr(Interpreter* interpreter, Token* op, IdentLiteral* ident, Value value) {
+    if (op == NULL || ident->slot < 0)
+        return error_value(RUNTIME_ERROR, "invalid operation");
 
-static Type* get_operation_type(Token* operation, Object* left, Object* right) {
-    if (operation == NULL || left == NULL || right == NULL) {
-        return NEW_NIL_TYPE();
+    Value identValue = context_get_at(interpreter->env, ident->depth, ident->slot);
+    if (is_error(interpreter, identValue)) {
+        log_error(identValue);
+        return identValue;
     }
 
-    switch (operation->type) {
-    case TOKEN_ADD: {
-        if (left->type == OBJ_CHARACTER || right->type == OBJ_CHARACTER) {
-            return NEW_STRING_TYPE();
-        }
-
-        if (left->type == OBJ_STRING || right->type == OBJ_STRING) {
-            return NEW_STRING_TYPE();
-        }
-
-        if (left->type == OBJ_FLOAT || right->type == OBJ_FLOAT) {
-            return NEW_FLOAT_TYPE();
-        }
-
-        return NEW_INT_TYPE();
+    if (op->type == TOKEN_ASSIGN) {
+        context_assign_at(interpreter->env, ident->depth, ident->slot, value);
+        return value;
     }
 
-    case TOKEN_SUB:
-    case TOKEN_MUL:
-    case TOKEN_QUO:
-    case TOKEN_REM:
-    case TOKEN_AND:
-    case TOKEN_OR:
-    case TOKEN_XOR:
-    case TOKEN_SHL:
-    case TOKEN_SHR: {
-        if (left->type == OBJ_FLOAT || right->type == OBJ_FLOAT) {
-            return NEW_FLOAT_TYPE();
-        }
-
-        return NEW_INT_TYPE();
+    Value result = eval_compound_op(interpreter, op->type, identValue, value);
+    if (is_error(interpreter, result)) {
+        return result;
     }
 
-    case TOKEN_LOR:
-    case TOKEN_LAND:
-    case TOKEN_EQL:
-    case TOKEN_LSS:
-    case TOKEN_GTR:
-    case TOKEN_NOT:
-    case TOKEN_NEQ:
-    case TOKEN_LEQ:
-    case TOKEN_GEQ: {
-        return NEW_BOOL_TYPE();
-    }
-    }
+    context_assign_at(interpreter->env, ident->depth, ident->slot, result);
 
-    return NEW_NIL_TYPE();
+    return result;
 }
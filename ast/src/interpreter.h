@@ -3,6 +3,9 @@
 #include "ast.h"
 #include "object.h"
 #include "context.h"
+#include "resolver.h"
+#include "type-checker.h"
+#include "value.h"
 
 
 typedef enum InterpreterStatus {
@@ -10,13 +13,54 @@ typedef enum InterpreterStatus {
     INTERPRETER_FAILURE
 } InterpreterStatus;
 
+typedef struct InterpreterOptions {
+    size_t gcThreshold;    /* bytes allocated before the first collection, 0 for the default */
+    bool gcStats;          /* print collection statistics to stderr when the program ends */
+    int optimizationLevel; /* OPTIMIZER_NONE, OPTIMIZER_LOCAL or OPTIMIZER_FULL */
+    bool checked;          /* the tree was already type checked, by the driver or before it was cached */
+} InterpreterOptions;
+
+/* everything one running program owns, so several can run at once on their own threads */
 typedef struct Interpreter {
     Context* env;
+    ContextStack* stack; /* frames for the scopes and calls no closure can capture */
+    Value returnValue;
+    struct GC* gc;
     InterpreterStatus exitCode;
+    struct Object* returnSignal; /* what return, break and continue statements evaluate to */
+    struct Object* breakSignal;
+    struct Object* continueSignal;
 } Interpreter;
 
 InterpreterStatus eval(List* declarations);
+InterpreterStatus eval_with_options(List* declarations, InterpreterOptions options);
+
+/*
+ * Interns the builtin names and the atomic types into the active tables, for
+ * a driver building the builtin tables that back the ones of many programs.
+ */
+void eval_intern_builtins(void);
+
+/*
+ * A program run one top-level declaration at a time, for a driver that
+ * hands each one over as soon as it is parsed. A declaration is checked and
+ * resolved against the ones before it and then evaluated, the global scope
+ * living on in between. The optimizer needs the whole program, so it does
+ * not run. eval_stream_next fails on a type or resolution error, after
+ * which the program should stop; runtime errors are logged as usual.
+ */
+typedef struct EvalStream {
+    Interpreter* interpreter;
+    TypeChecker* typeChecker;
+    Resolver* resolver;
+    InterpreterOptions options;
+    unsigned numericTaken; /* numeric builtins the program has declared its own of, by bit */
+} EvalStream;
+
+EvalStream* eval_stream_new(InterpreterOptions options);
+InterpreterStatus eval_stream_next(EvalStream* stream, Decl* declaration);
+InterpreterStatus eval_stream_finish(EvalStream** stream);
 
-struct Object* eval_decl(struct Interpreter* interpreter, Decl* declaration);
-struct Object* eval_stmt(struct Interpreter* interpreter, Stmt* statement);
-struct Object* eval_expr(struct Interpreter* interpreter, Expr* expression);
\ No newline at end of file
+Value eval_decl(struct Interpreter* interpreter, Decl* declaration);
+Value eval_stmt(struct Interpreter* interpreter, Stmt* statement);
+Value eval_expr(struct Interpreter* interpreter, Expr* expression);
\ No newline at end of file
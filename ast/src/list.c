@@ -4,12 +4,13 @@
 #include <stddef.h>
 #include <string.h>
 
+#include "arena.h"
 #include "smem.h"
 
 
 ListNode* list_node_new(void* value, ListNode* prev, ListNode* next) {
     ListNode* new_node = NULL;
-    new_node = safe_malloc(sizeof(ListNode), NULL);
+    new_node = smem_alloc(sizeof(ListNode));
     if (new_node == NULL) {
         return NULL;
     }
@@ -30,18 +31,52 @@ void list_node_free(ListNode** node, void (*destroy)(void**)) {
     if (destroy != NULL)
         destroy(&(*node)->value);
 
-    safe_free((void**) node);
+    smem_free((void**) node, sizeof(ListNode));
+}
+
+/* nodes of a list built inside an arena belong to that arena */
+static ListNode* node_new(List* list, void* value, ListNode* prev, ListNode* next) {
+    if (list->arena == NULL)
+        return list_node_new(value, prev, next);
+
+    ListNode* new_node = arena_alloc(list->arena, sizeof(ListNode));
+    if (new_node == NULL) {
+        return NULL;
+    }
+
+    *new_node = (ListNode) {
+        .value = value,
+        .prev = prev,
+        .next = next
+    };
+
+    return new_node;
+}
+
+static void node_free(List* list, ListNode** node, void (*destroy)(void**)) {
+    if (list->arena == NULL) {
+        list_node_free(node, destroy);
+        return;
+    }
+
+    if (destroy != NULL)
+        destroy(&(*node)->value);
+
+    *node = NULL;
 }
 
 List* list_new(void (*destroy)(void**)) {
+    Arena* arena = arena_active();
+
     List* new_list = NULL;
-    new_list = safe_calloc(1, sizeof(List), NULL);
+    new_list = arena != NULL ? arena_alloc(arena, sizeof(List)) : smem_alloc(sizeof(List));
     if (new_list == NULL) {
         return NULL;
     }
 
     *new_list = (List) {
-        .destroy = destroy
+        .destroy = destroy,
+        .arena = arena
     };
 
     return new_list;
@@ -55,7 +90,12 @@ void list_free(List** list) {
         list_remove_first(list, NULL);
     }
 
-    safe_free((void**) list);
+    if ((*list)->arena != NULL) {
+        *list = NULL;
+        return;
+    }
+
+    smem_free((void**) list, sizeof(List));
 }
 
 size_t list_size(List** list) {
@@ -98,7 +138,7 @@ void list_insert_first(List** list, void* object) {
     if (!list_is_initialized(list))
         return;
 
-    ListNode* new_node = list_node_new(object, NULL, (*list)->head);
+    ListNode* new_node = node_new(*list, object, NULL, (*list)->head);
     if (new_node == NULL)
         return;
 
@@ -117,7 +157,7 @@ void list_insert_last(List** list, void* object) {
     if (!list_is_initialized(list))
         return;
 
-    ListNode* new_node = list_node_new(object, (*list)->tail, NULL);
+    ListNode* new_node = node_new(*list, object, (*list)->tail, NULL);
     if (new_node == NULL)
         return;
 
@@ -149,7 +189,7 @@ void list_insert_at(List** list, size_t index, void* object) {
     ListNode* current = get_node(list, index);
     ListNode* previous = current->prev;
 
-    ListNode* new_node = list_node_new(object, previous, current);
+    ListNode* new_node = node_new(*list, object, previous, current);
     if (new_node == NULL)
         return;
 
@@ -180,9 +220,9 @@ void list_remove_first(List** list, void** return_buffer) {
 
     if (return_buffer != NULL && *return_buffer == NULL) {
         *return_buffer = head->value;
-        list_node_free(&head, NULL);
+        node_free(*list, &head, NULL);
     } else {
-        list_node_free(&head, (*list)->destroy);
+        node_free(*list, &head, (*list)->destroy);
     }
 }
 
@@ -204,9 +244,9 @@ void list_remove_last(List** list, void** return_buffer) {
 
     if (return_buffer != NULL && *return_buffer == NULL) {
         *return_buffer = tail->value;
-        list_node_free(&tail, NULL);
+        node_free(*list, &tail, NULL);
     } else {
-        list_node_free(&tail, (*list)->destroy);
+        node_free(*list, &tail, (*list)->destroy);
     }
 }
 
@@ -238,9 +278,9 @@ void list_remove_at(List** list, size_t index, void** return_buffer) {
 
     if (return_buffer != NULL && *return_buffer == NULL) {
         *return_buffer = current->value;
-        list_node_free(&current, NULL);
+        node_free(*list, &current, NULL);
     } else {
-        list_node_free(&current, (*list)->destroy);
+        node_free(*list, &current, (*list)->destroy);
     }
 }
 
@@ -393,7 +433,7 @@ bool list_find_and_remove(List** list, bool (*cb)(const void**, void**), void**
             if (next != NULL)
                 next->prev = prev;
 
-            list_node_free(&node, (*list)->destroy);
+            node_free(*list, &node, (*list)->destroy);
             
             decrease_list_size(list);
             
@@ -14,11 +14,14 @@ ListNode* list_node_new(void* value, ListNode* prev, ListNode* next);
 void list_node_free(ListNode** node, void (*destroy)(void**));
 
 
+struct Arena;
+
 typedef struct List {
     size_t size;
     ListNode* head;
     ListNode* tail;
     void (*destroy)(void**);
+    struct Arena* arena; /* set when the list was created inside an arena */
 } List;
 
 List* list_new(void (*destroy)(void**));
@@ -1,19 +1,26 @@
 #include "literal-type.h"
 
+#include <inttypes.h>
 #include <stdio.h>
+#include <string.h>
 
+#include "arena.h"
+#include "output.h"
 #include "smem.h"
+#include "symbol.h"
 #include "utils.h"
 
 
 IdentLiteral* ident_literal_new(const char* ident) {
     IdentLiteral* type = NULL;
-    type = safe_malloc(sizeof(IdentLiteral), NULL);
+    type = arena_active_alloc(sizeof(IdentLiteral));
     if (type == NULL) {
         return NULL;
     }
 
-    type->value = str_dup(ident);
+    type->value = symbol_intern(ident);
+    type->depth = -1;
+    type->slot = -1;
 
     return type;
 }
@@ -22,21 +29,19 @@ void ident_literal_to_string(IdentLiteral** identType) {
     if (identType == NULL || *identType == NULL)
         return;
 
-    printf("&[%s]", (*identType)->value);
+    output_printf("&[%s]", (*identType)->value);
 }
 
 void ident_literal_free(IdentLiteral** identType) {
     if (identType == NULL || *identType == NULL)
         return;
 
-    safe_free((void**) &(*identType)->value);
-
     safe_free((void**) identType);
 }
 
-IntLiteral* int_literal_new(int value) {
+IntLiteral* int_literal_new(int64_t value) {
     IntLiteral* type = NULL;
-    type = safe_malloc(sizeof(IntLiteral), NULL);
+    type = arena_active_alloc(sizeof(IntLiteral));
     if (type == NULL) {
         return NULL;
     }
@@ -50,7 +55,7 @@ void int_literal_to_string(IntLiteral** intLiteral) {
     if (intLiteral == NULL || *intLiteral == NULL)
         return;
 
-    printf("%d", (*intLiteral)->value);
+    output_printf("%" PRId64, (*intLiteral)->value);
 }
 
 void int_literal_free(IntLiteral** intLiteral) {
@@ -62,7 +67,7 @@ void int_literal_free(IntLiteral** intLiteral) {
 
 FloatLiteral* float_literal_new(double value) {
     FloatLiteral* type = NULL;
-    type = safe_malloc(sizeof(FloatLiteral), NULL);
+    type = arena_active_alloc(sizeof(FloatLiteral));
     if (type == NULL) {
         return NULL;
     }
@@ -76,7 +81,7 @@ void float_literal_to_string(FloatLiteral** floatLiteral) {
     if (floatLiteral == NULL || *floatLiteral == NULL)
         return;
 
-    printf("%f", (*floatLiteral)->value);
+    output_printf("%f", (*floatLiteral)->value);
 }
 
 void float_literal_free(FloatLiteral** floatLiteral) {
@@ -88,7 +93,7 @@ void float_literal_free(FloatLiteral** floatLiteral) {
 
 CharLiteral* char_literal_new(char value) {
     CharLiteral* type = NULL;
-    type = safe_malloc(sizeof(CharLiteral), NULL);
+    type = arena_active_alloc(sizeof(CharLiteral));
     if (type == NULL) {
         return NULL;
     }
@@ -102,7 +107,7 @@ void char_literal_to_string(CharLiteral** charLiteral) {
     if (charLiteral == NULL || *charLiteral == NULL)
         return;
 
-    printf("'%c'", (*charLiteral)->value);
+    output_printf("'%c'", (*charLiteral)->value);
 }
 
 void char_literal_free(CharLiteral** charLiteral) {
@@ -114,22 +119,40 @@ void char_literal_free(CharLiteral** charLiteral) {
 
 StringLiteral* string_literal_new(const char* value) {
     StringLiteral* type = NULL;
-    type = safe_malloc(sizeof(StringLiteral), NULL);
+    type = arena_active_alloc(sizeof(StringLiteral));
     if (type == NULL) {
         return NULL;
     }
 
-    type->value = str_dup(value);
+    type->value = arena_active_str_dup(value);
     remove_quotes(&type->value);
 
     return type;
 }
 
+StringLiteral* string_literal_new_with_length(const char* value, size_t length) {
+    StringLiteral* type = NULL;
+    type = arena_active_alloc(sizeof(StringLiteral));
+    if (type == NULL) {
+        return NULL;
+    }
+
+    type->value = arena_active_alloc(length + 1);
+    if (type->value == NULL) {
+        return NULL;
+    }
+
+    memcpy(type->value, value, length);
+    type->value[length] = '\0';
+
+    return type;
+}
+
 void string_literal_to_string(StringLiteral** stringLiteral) {
     if (stringLiteral == NULL || *stringLiteral == NULL)
         return;
 
-    printf("\"%s\"", (*stringLiteral)->value);
+    output_printf("\"%s\"", (*stringLiteral)->value);
 }
 
 void string_literal_free(StringLiteral** stringLiteral) {
@@ -143,7 +166,7 @@ void string_literal_free(StringLiteral** stringLiteral) {
 
 BoolLiteral* bool_literal_new(bool value) {
     BoolLiteral* type = NULL;
-    type = safe_malloc(sizeof(BoolLiteral), NULL);
+    type = arena_active_alloc(sizeof(BoolLiteral));
     if (type == NULL) {
         return NULL;
     }
@@ -157,7 +180,7 @@ void bool_literal_to_string(BoolLiteral** boolLiteral) {
     if (boolLiteral == NULL || *boolLiteral == NULL)
         return;
 
-    printf("%s", (*boolLiteral)->value ? "true" : "false");
+    output_printf("%s", (*boolLiteral)->value ? "true" : "false");
 }
 
 void bool_literal_free(BoolLiteral** boolLiteral) {
@@ -169,7 +192,7 @@ void bool_literal_free(BoolLiteral** boolLiteral) {
 
 VoidLiteral* void_literal_new(void) {
     VoidLiteral* type = NULL;
-    type = safe_malloc(sizeof(VoidLiteral), NULL);
+    type = arena_active_alloc(sizeof(VoidLiteral));
     if (type == NULL) {
         return NULL;
     }
@@ -181,7 +204,7 @@ void void_literal_to_string(VoidLiteral** voidLiteral) {
     if (voidLiteral == NULL || *voidLiteral == NULL)
         return;
 
-    printf("void");
+    output_printf("void");
 }
 
 void void_literal_free(VoidLiteral** voidLiteral) {
@@ -193,7 +216,7 @@ void void_literal_free(VoidLiteral** voidLiteral) {
 
 NilLiteral* nil_literal_new(void) {
     NilLiteral* type = NULL;
-    type = safe_malloc(sizeof(NilLiteral), NULL);
+    type = arena_active_alloc(sizeof(NilLiteral));
     if (type == NULL) {
         return NULL;
     }
@@ -205,7 +228,7 @@ void nil_literal_to_string(NilLiteral** nilLiteral) {
     if (nilLiteral == NULL || *nilLiteral == NULL)
         return;
 
-    printf("nil");
+    output_printf("nil");
 }
 
 void nil_literal_free(NilLiteral** nilLiteral) {
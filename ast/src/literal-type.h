@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -21,6 +22,8 @@ typedef enum LiteralType {
 
 typedef struct IdentLiteral {
     char* value;
+    int depth; /* scopes to walk up, set by the resolver (-1 if unresolved) */
+    int slot;  /* index inside that scope, set by the resolver (-1 if unresolved) */
 } IdentLiteral;
 
 IdentLiteral* ident_literal_new(const char*);
@@ -29,10 +32,10 @@ void ident_literal_free(IdentLiteral**);
 
 
 typedef struct IntLiteral {
-    int value;
+    int64_t value;
 } IntLiteral;
 
-IntLiteral* int_literal_new(int);
+IntLiteral* int_literal_new(int64_t);
 void int_literal_to_string(IntLiteral**);
 void int_literal_free(IntLiteral**);
 
@@ -60,6 +63,8 @@ typedef struct StringLiteral {
 } StringLiteral;
 
 StringLiteral* string_literal_new(const char*);
+/* copies length bytes, the lexer passes the text between the quotes */
+StringLiteral* string_literal_new_with_length(const char*, size_t);
 void string_literal_to_string(StringLiteral**);
 void string_literal_free(StringLiteral**);
 
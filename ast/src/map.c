@@ -2,16 +2,17 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <string.h>
 
-#include "list.h"
 #include "smem.h"
+#include "symbol.h"
 #include "utils.h"
 
 
 MapEntry* map_entry_new(void* key, void* value,
     void (*destroy_key)(void**), void (*destroy_value)(void**)) {
     MapEntry* entry = NULL;
-    entry = safe_malloc(sizeof(MapEntry), NULL);
+    entry = smem_alloc(sizeof(MapEntry));
     if (entry == NULL) {
         if (destroy_key != NULL)
             destroy_key(&key);
@@ -40,128 +41,275 @@ void map_entry_free(MapEntry** mapEntry) {
     if ((*mapEntry)->destroy_value != NULL)
         (*mapEntry)->destroy_value(&(*mapEntry)->value);
 
-    safe_free((void**) mapEntry);
+    smem_free((void**) mapEntry, sizeof(MapEntry));
 }
 
-Map* map_new(size_t number_of_buckets, bool (*cmp)(const void**, void**),
-    void (*destroy_key)(void**), void (*destroy_value)(void**)) {
-    if (cmp == NULL) {
-        return NULL;
-    }
+#define MAP_MIN_TABLE (MAP_INLINE_CAPACITY * 2)
 
+static size_t string_hash(const void* key) {
+    return hash_string(key);
+}
+
+static Map* map_alloc(size_t capacity, size_t (*hash)(const void*),
+    bool (*cmp)(const void**, void**),
+    void (*destroy_key)(void**), void (*destroy_value)(void**)) {
     Map* map = NULL;
     map = safe_malloc(sizeof(Map), NULL);
     if (map == NULL) {
         return NULL;
     }
 
-    List** buckets = NULL;
-    buckets = safe_calloc(number_of_buckets, sizeof(List*), NULL);
-    if (buckets == NULL) {
-        safe_free((void**) &map);
-        return NULL;
-    }
-
-    for (size_t i = 0; i < number_of_buckets; i++) {
-        buckets[i] = list_new((void (*)(void**)) map_entry_free);
+    size_t table_capacity = MAP_MIN_TABLE;
+    while (table_capacity < capacity) {
+        table_capacity *= 2;
     }
 
     *map = (Map) {
         .total_entries = 0,
-        .number_of_buckets = number_of_buckets,
-        .buckets = buckets,
+        .capacity = MAP_INLINE_CAPACITY,
+        .table_capacity = table_capacity,
+        .slots = NULL,
+        .hash = hash,
         .cmp = cmp,
         .destroy_key = destroy_key,
         .destroy_value = destroy_value
     };
 
+    map->slots = map->inline_slots;
+
     return map;
 }
 
+Map* map_new(size_t capacity, bool (*cmp)(const void**, void**),
+    void (*destroy_key)(void**), void (*destroy_value)(void**)) {
+    if (cmp == NULL) {
+        return NULL;
+    }
+
+    return map_alloc(capacity, string_hash, cmp, destroy_key, destroy_value);
+}
+
+Map* map_new_with_hash(size_t capacity, size_t (*hash)(const void*),
+    bool (*cmp)(const void**, void**),
+    void (*destroy_key)(void**), void (*destroy_value)(void**)) {
+    if (hash == NULL || cmp == NULL) {
+        return NULL;
+    }
+
+    return map_alloc(capacity, hash, cmp, destroy_key, destroy_value);
+}
+
+Map* symbol_map_new(size_t capacity, void (*destroy_value)(void**)) {
+    return map_alloc(capacity, (size_t (*)(const void*)) symbol_hash, NULL, NULL, destroy_value);
+}
+
+static bool is_inline(const Map* map) {
+    return map->slots == map->inline_slots;
+}
+
+static void release_slot(Map* map, MapSlot* slot) {
+    if (map->destroy_key != NULL)
+        map->destroy_key(&slot->entry.key);
+
+    if (map->destroy_value != NULL)
+        map->destroy_value(&slot->entry.value);
+
+    slot->hash = 0;
+}
+
 void map_free(Map** map) {
     if (map == NULL || *map == NULL)
         return;
 
-    for (size_t i = 0; i < (*map)->number_of_buckets; i++) {
-        list_free(&((*map)->buckets[i]));
+    map_clear(*map);
+
+    if (!is_inline(*map)) {
+        safe_free((void**) &(*map)->slots);
     }
 
-    safe_free((void**) &(*map)->buckets);
     safe_free((void**) map);
 }
 
-size_t get_index(const char* key, size_t number_of_buckets) {
-    return hash_string(key) % number_of_buckets;
+static size_t hash_key(const Map* map, void* key) {
+    size_t hash = map->hash(key);
+    return hash != 0 ? hash : 1;
 }
 
-inline static void increment_map_total_entries(Map* map) {
-    map->total_entries += 1;
+static bool matches(Map* map, MapSlot* slot, size_t hash, void* key) {
+    if (slot->hash != hash)
+        return false;
+
+    if (map->cmp == NULL)
+        return slot->entry.key == key;
+
+    MapEntry* entry = &slot->entry;
+    return map->cmp((const void**) &entry, &key);
 }
 
-inline static void decrement_map_total_entries(Map* map) {
-    map->total_entries -= 1;
+/* how far a slot sits from where its hash wants it */
+static size_t probe_distance(const Map* map, size_t index, size_t hash) {
+    return (index - hash) & (map->capacity - 1);
 }
 
-void map_put(Map* map, void* key, void* value) {
-    size_t index = get_index(key, map->number_of_buckets);
-
-    ListNode* object = NULL;
-    int object_index = list_find_first(
-        &(map->buckets[index]), map->cmp,
-        &key,
-        (void**) &object
-    );
-
-    if (object == NULL) {
-        list_insert_last(&(map->buckets[index]),
-            map_entry_new(
-                key, value,
-                map->destroy_key, map->destroy_value
-            )
-        );
-        increment_map_total_entries(map);
+static MapSlot* find_slot(Map* map, void* key, size_t hash) {
+    if (is_inline(map)) {
+        for (size_t i = 0; i < map->total_entries; i++) {
+            if (matches(map, &map->slots[i], hash, key))
+                return &map->slots[i];
+        }
+        return NULL;
+    }
+
+    size_t mask = map->capacity - 1;
+
+    for (size_t index = hash & mask, distance = 0;; index = (index + 1) & mask, distance++) {
+        MapSlot* slot = &map->slots[index];
+
+        /* a richer resident means the key would have displaced it */
+        if (slot->hash == 0 || probe_distance(map, index, slot->hash) < distance)
+            return NULL;
+
+        if (matches(map, slot, hash, key))
+            return slot;
+    }
+}
+
+/* places a key known to be absent, the table must have a free slot */
+static void table_insert(Map* map, MapSlot incoming) {
+    size_t mask = map->capacity - 1;
+    size_t distance = 0;
+
+    for (size_t index = incoming.hash & mask;; index = (index + 1) & mask, distance++) {
+        MapSlot* slot = &map->slots[index];
+
+        if (slot->hash == 0) {
+            *slot = incoming;
+            return;
+        }
+
+        size_t resident = probe_distance(map, index, slot->hash);
+        if (resident < distance) {
+            MapSlot displaced = *slot;
+            *slot = incoming;
+            incoming = displaced;
+            distance = resident;
+        }
+    }
+}
+
+static bool resize(Map* map, size_t capacity) {
+    MapSlot* slots = safe_calloc(capacity, sizeof(MapSlot), NULL);
+    if (slots == NULL)
+        return false;
+
+    MapSlot* previous = map->slots;
+    size_t previous_capacity = map->capacity;
+
+    map->slots = slots;
+    map->capacity = capacity;
+
+    for (size_t i = 0; i < previous_capacity; i++) {
+        if (previous[i].hash != 0) {
+            table_insert(map, previous[i]);
+        }
+    }
+
+    if (previous == map->inline_slots) {
+        memset(map->inline_slots, 0, sizeof(map->inline_slots));
     } else {
-        list_replace_at(&(map->buckets[index]), object_index,
-            map_entry_new(
-                key, value,
-                map->destroy_key, map->destroy_value
-            )
-        );
+        safe_free((void**) &previous);
     }
+
+    return true;
 }
 
-void* map_get(Map* map, void* key) {
-    size_t index = get_index(key, map->number_of_buckets);
+void map_put(Map* map, void* key, void* value) {
+    size_t hash = hash_key(map, key);
 
-    MapEntry* entry = NULL;
-    int object_index = list_find_first(
-        &(map->buckets[index]), map->cmp,
-        &key,
-        (void**) &entry
-    );
+    MapSlot* slot = find_slot(map, key, hash);
+    if (slot != NULL) {
+        if (map->destroy_key != NULL && slot->entry.key != key)
+            map->destroy_key(&slot->entry.key);
+
+        if (map->destroy_value != NULL && slot->entry.value != value)
+            map->destroy_value(&slot->entry.value);
+
+        slot->entry.key = key;
+        slot->entry.value = value;
+        return;
+    }
+
+    MapSlot incoming = {
+        .entry = {
+            .key = key,
+            .value = value,
+            .destroy_key = map->destroy_key,
+            .destroy_value = map->destroy_value
+        },
+        .hash = hash
+    };
 
-    if (object_index != -1) {
-        return entry->value;
+    if (is_inline(map) && map->total_entries < MAP_INLINE_CAPACITY) {
+        map->slots[map->total_entries++] = incoming;
+        return;
+    }
+
+    size_t capacity = is_inline(map) ? map->table_capacity : map->capacity;
+    if (is_inline(map) || (map->total_entries + 1) * 4 > map->capacity * 3) {
+        if (!is_inline(map)) {
+            capacity *= 2;
+        }
+
+        if (!resize(map, capacity)) {
+            release_slot(map, &incoming);
+            return;
+        }
     }
 
-    return NULL;
+    table_insert(map, incoming);
+    map->total_entries += 1;
+}
+
+void* map_get(Map* map, void* key) {
+    MapSlot* slot = find_slot(map, key, hash_key(map, key));
+    return slot != NULL ? slot->entry.value : NULL;
 }
 
 void map_remove(Map* map, void* key) {
-    size_t index = get_index(key, map->number_of_buckets);
+    MapSlot* slot = find_slot(map, key, hash_key(map, key));
+    if (slot == NULL)
+        return;
+
+    release_slot(map, slot);
+    map->total_entries -= 1;
+
+    if (is_inline(map)) {
+        MapSlot* last = &map->slots[map->total_entries];
+        if (slot != last) {
+            *slot = *last;
+            last->hash = 0;
+        }
+        return;
+    }
+
+    /* pull the rest of the run one step closer to home, no tombstones */
+    size_t mask = map->capacity - 1;
+    size_t index = (size_t) (slot - map->slots);
+
+    for (size_t next = (index + 1) & mask;; index = next, next = (next + 1) & mask) {
+        MapSlot* following = &map->slots[next];
 
-    bool ok = list_find_and_remove(&(map->buckets[index]), map->cmp, &key);
-    if (ok) {
-        decrement_map_total_entries(map);
+        if (following->hash == 0 || probe_distance(map, next, following->hash) == 0) {
+            map->slots[index].hash = 0;
+            return;
+        }
+
+        map->slots[index] = *following;
     }
 }
 
 bool map_contains(Map* map, void* key) {
-    size_t index = get_index(key, map->number_of_buckets);
-
-    void* entry = NULL;
-    list_find_first(&(map->buckets[index]), map->cmp, &key, &entry);
-    return entry != NULL;
+    return find_slot(map, key, hash_key(map, key)) != NULL;
 }
 
 size_t map_size(Map* map) {
@@ -172,8 +320,10 @@ void map_clear(Map* map) {
     if (map_size(map) == 0)
         return;
 
-    for (size_t i = 0; i < map->number_of_buckets; i++) {
-        list_clear(&map->buckets[i]);
+    for (size_t i = 0; i < map->capacity; i++) {
+        if (map->slots[i].hash != 0) {
+            release_slot(map, &map->slots[i]);
+        }
     }
 
     map->total_entries = 0;
@@ -183,8 +333,11 @@ void map_iterate(Map* map, void (*cb)(const void**)) {
     if (map_size(map) == 0)
         return;
 
-    for (size_t i = 0; i < map->number_of_buckets; i++) {
-        list_for_each(&map->buckets[i], cb);
+    for (size_t i = 0; i < map->capacity; i++) {
+        if (map->slots[i].hash != 0) {
+            const MapEntry* entry = &map->slots[i].entry;
+            cb((const void**) &entry);
+        }
     }
 }
 
@@ -201,8 +354,7 @@ MapIterator* map_iterator_new(const Map* map) {
 
     *iterator = (MapIterator) {
         .map = map,
-        .bucket_index = 0,
-        .current_node = NULL
+        .index = 0
     };
 
     return iterator;
@@ -216,22 +368,13 @@ void map_iterator_free(MapIterator** iterator) {
 }
 
 bool map_iterator_has_next(MapIterator* iterator) {
-    while (iterator->bucket_index < iterator->map->number_of_buckets) {
-        List* bucket = iterator->map->buckets[iterator->bucket_index];
-
-        if (iterator->current_node == NULL && !list_is_empty(&bucket)) {
-            return true;
-        }
+    const Map* map = iterator->map;
 
-        if (iterator->current_node != NULL && iterator->current_node->next != NULL) {
-            return true;
-        }
-
-        iterator->bucket_index += 1;
-        iterator->current_node = NULL;
+    while (iterator->index < map->capacity && map->slots[iterator->index].hash == 0) {
+        iterator->index += 1;
     }
 
-    return false;
+    return iterator->index < map->capacity;
 }
 
 MapEntry* map_iterator_next(MapIterator* iterator) {
@@ -239,13 +382,5 @@ MapEntry* map_iterator_next(MapIterator* iterator) {
         return NULL;
     }
 
-    List* bucket = iterator->map->buckets[iterator->bucket_index];
-
-    if (iterator->current_node == NULL) {
-        iterator->current_node = bucket->head;
-    } else {
-        iterator->current_node = iterator->current_node->next;
-    }
-
-    return (MapEntry*) iterator->current_node->value;
+    return &iterator->map->slots[iterator->index++].entry;
 }
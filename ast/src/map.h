@@ -17,21 +17,49 @@ MapEntry* map_entry_new(void* key, void* value,
     void (*destroy_key)(void**), void (*destroy_value)(void**));
 void map_entry_free(MapEntry** mapEntry);
 
+#define MAP_INLINE_CAPACITY 8
+
+/*
+ * Slots of the open-addressing table. The hash is stored so lookups skip
+ * most key comparisons and growing never rehashes a key; zero marks an
+ * empty slot.
+ */
+typedef struct MapSlot {
+    MapEntry entry;
+    size_t hash;
+} MapSlot;
+
+/*
+ * Up to MAP_INLINE_CAPACITY entries live unordered in inline_slots and are
+ * scanned linearly. Past that the map spills into a power-of-two Robin Hood
+ * table that doubles once it is three quarters full and closes gaps on
+ * removal by shifting the following run back.
+ */
 typedef struct Map {
     size_t total_entries;
-    size_t number_of_buckets;
-    List** buckets;
-    bool (*cmp)(const void**, void**);
+    size_t capacity;         /* slots behind the slots pointer */
+    size_t table_capacity;   /* size of the first table, from map_new's hint */
+    MapSlot* slots;          /* inline_slots until the map spills */
+    MapSlot inline_slots[MAP_INLINE_CAPACITY];
+    size_t (*hash)(const void*);
+    bool (*cmp)(const void**, void**); /* NULL matches keys by pointer */
     void (*destroy_key)(void**);
     void (*destroy_value)(void**);
 } Map;
 
-Map* map_new(size_t number_of_buckets, bool (*cmp)(const void**, void**),
+Map* map_new(size_t capacity, bool (*cmp)(const void**, void**),
     void (*destroy_key)(void**), void (*destroy_value)(void**));
 void map_free(Map** map);
 
-size_t get_index(const char* key, size_t number_of_buckets);
+/* a map over keys that are not strings, hash may return any value */
+Map* map_new_with_hash(size_t capacity, size_t (*hash)(const void*),
+    bool (*cmp)(const void**, void**),
+    void (*destroy_key)(void**), void (*destroy_value)(void**));
 
+/* a map keyed by symbol_intern names, hashing and comparing without touching the characters */
+Map* symbol_map_new(size_t capacity, void (*destroy_value)(void**));
+
+/* putting an existing key updates its slot, releasing the replaced key and value */
 void map_put(Map* map, void* key, void* value);
 void* map_get(Map* map, void* key);
 void map_remove(Map* map, void* key);
@@ -41,17 +69,27 @@ void map_clear(Map* map);
 void map_iterate(Map* map, void (*cb)(const void**));
 
 
-#define MAP_NEW(number_of_buckets, cmp_fn, free_key_fn, free_value_fn)         \
-    map_new((number_of_buckets),                                               \
+#define MAP_NEW(capacity, cmp_fn, free_key_fn, free_value_fn)                  \
+    map_new((capacity),                                                        \
         ((bool (*)(const void**, void**)) cmp_fn),                             \
         ((void (*)(void**)) free_key_fn),                                      \
         ((void (*)(void**)) free_value_fn))
 
+#define MAP_NEW_WITH_HASH(capacity, hash_fn, cmp_fn, free_key_fn, free_value_fn) \
+    map_new_with_hash((capacity),                                              \
+        ((size_t (*)(const void*)) hash_fn),                                   \
+        ((bool (*)(const void**, void**)) cmp_fn),                             \
+        ((void (*)(void**)) free_key_fn),                                      \
+        ((void (*)(void**)) free_value_fn))
+
+#define SYMBOL_MAP_NEW(capacity, free_value_fn)                                \
+    symbol_map_new((capacity), ((void (*)(void**)) free_value_fn))
+
 
+/* walks slot order, the map must not change while it is in use */
 typedef struct MapIterator {
     const Map* map;
-    size_t bucket_index;
-    ListNode* current_node;
+    size_t index;
 } MapIterator;
 
 MapIterator* map_iterator_new(const Map* map);
@@ -0,0 +1,105 @@
+#include "matrix.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+
+#define MATRIX_MULTIPLY(type, a, b, c, n, k, m)                                \
+    for (size_t ii = 0; ii < (n); ii += MATRIX_BLOCK) {                        \
+        size_t iEnd = MIN(ii + MATRIX_BLOCK, (n));                             \
+        for (size_t kk = 0; kk < (k); kk += MATRIX_BLOCK) {                    \
+            size_t kEnd = MIN(kk + MATRIX_BLOCK, (k));                         \
+            for (size_t jj = 0; jj < (m); jj += MATRIX_BLOCK) {                \
+                size_t jEnd = MIN(jj + MATRIX_BLOCK, (m));                     \
+                for (size_t i = ii; i < iEnd; i++) {                           \
+                    type* row = (c) + i * (m);                                 \
+                    for (size_t p = kk; p < kEnd; p++) {                       \
+                        type scale = (a)[i * (k) + p];                         \
+                        const type* column = (b) + p * (m);                    \
+                        for (size_t j = jj; j < jEnd; j++) {                   \
+                            row[j] += scale * column[j];                       \
+                        }                                                      \
+                    }                                                          \
+                }                                                              \
+            }                                                                  \
+        }                                                                      \
+    }
+
+void matrix_multiply_int(const int64_t* a, const int64_t* b, int64_t* c, size_t n, size_t k, size_t m) {
+    /* unsigned so overflow wraps instead of being undefined */
+    const uint64_t* left = (const uint64_t*) a;
+    const uint64_t* right = (const uint64_t*) b;
+    uint64_t* result = (uint64_t*) c;
+
+    MATRIX_MULTIPLY(uint64_t, left, right, result, n, k, m)
+}
+
+void matrix_multiply_float(const double* a, const double* b, double* c, size_t n, size_t k, size_t m) {
+    MATRIX_MULTIPLY(double, a, b, c, n, k, m)
+}
+
+void matrix_transpose(const void* source, void* target, size_t rows, size_t cols, size_t elementSize) {
+    const char* from = source;
+    char* to = target;
+
+    for (size_t ii = 0; ii < rows; ii += MATRIX_BLOCK) {
+        size_t iEnd = MIN(ii + MATRIX_BLOCK, rows);
+
+        for (size_t jj = 0; jj < cols; jj += MATRIX_BLOCK) {
+            size_t jEnd = MIN(jj + MATRIX_BLOCK, cols);
+
+            for (size_t i = ii; i < iEnd; i++) {
+                for (size_t j = jj; j < jEnd; j++) {
+                    memcpy(to + (j * rows + i) * elementSize, from + (i * cols + j) * elementSize, elementSize);
+                }
+            }
+        }
+    }
+}
+
+void matrix_elementwise_int(MatrixOperation operation, const int64_t* a, const int64_t* b, int64_t* c, size_t size) {
+    const uint64_t* left = (const uint64_t*) a;
+    const uint64_t* right = (const uint64_t*) b;
+    uint64_t* result = (uint64_t*) c;
+
+    switch (operation) {
+    case MATRIX_ADD:
+        for (size_t i = 0; i < size; i++) {
+            result[i] = left[i] + right[i];
+        }
+        break;
+    case MATRIX_SUB:
+        for (size_t i = 0; i < size; i++) {
+            result[i] = left[i] - right[i];
+        }
+        break;
+    case MATRIX_MUL:
+        for (size_t i = 0; i < size; i++) {
+            result[i] = left[i] * right[i];
+        }
+        break;
+    }
+}
+
+void matrix_elementwise_float(MatrixOperation operation, const double* a, const double* b, double* c, size_t size) {
+    switch (operation) {
+    case MATRIX_ADD:
+        for (size_t i = 0; i < size; i++) {
+            c[i] = a[i] + b[i];
+        }
+        break;
+    case MATRIX_SUB:
+        for (size_t i = 0; i < size; i++) {
+            c[i] = a[i] - b[i];
+        }
+        break;
+    case MATRIX_MUL:
+        for (size_t i = 0; i < size; i++) {
+            c[i] = a[i] * b[i];
+        }
+        break;
+    }
+}
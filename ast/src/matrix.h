@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+#define MATRIX_BLOCK 64
+
+typedef enum MatrixOperation {
+    MATRIX_ADD,
+    MATRIX_SUB,
+    MATRIX_MUL
+} MatrixOperation;
+
+/*
+ * Kernels over row-major buffers. The products walk MATRIX_BLOCK tiles in
+ * i-k-j order, so a tile of b and the row of c it feeds stay in cache while
+ * a is streamed, and accumulate into a zeroed c. The transpose swaps whole
+ * tiles so neither side strides through memory a full row at a time.
+ * Integer arithmetic wraps like the interpreter's.
+ */
+void matrix_multiply_int(const int64_t* a, const int64_t* b, int64_t* c, size_t n, size_t k, size_t m);
+void matrix_multiply_float(const double* a, const double* b, double* c, size_t n, size_t k, size_t m);
+void matrix_transpose(const void* source, void* target, size_t rows, size_t cols, size_t elementSize);
+
+void matrix_elementwise_int(MatrixOperation operation, const int64_t* a, const int64_t* b, int64_t* c, size_t size);
+void matrix_elementwise_float(MatrixOperation operation, const double* a, const double* b, double* c, size_t size);
@@ -0,0 +1,203 @@
+#include "numeric.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "buffer.h"
+#include "object.h"
+#include "simd.h"
+#include "smem.h"
+#include "types.h"
+#include "value.h"
+
+
+const NumericBuiltin numericBuiltins[NUMERIC_BUILTIN_COUNT] = {
+    {"sum",     sum_function_run},
+    {"min",     min_function_run},
+    {"max",     max_function_run},
+    {"dot",     dot_function_run},
+    {"axpy",    axpy_function_run},
+    {"map_add", map_add_function_run},
+    {"map_mul", map_mul_function_run},
+    {"fill",    fill_function_run}
+};
+
+static Value error_value(const char* name, const char* reason) {
+    ByteBuffer* bb = byte_buffer_new();
+    byte_buffer_appendf(bb, "%s_function_run: %s", name, reason);
+    char* message = byte_buffer_to_string(bb);
+    byte_buffer_free(&bb);
+
+    Object* error = NEW_ERROR_OBJECT(RUNTIME_ERROR, message);
+    safe_free((void**) &message);
+
+    return OBJECT_VALUE(error);
+}
+
+static ArrayObject* numeric_argument(Value value) {
+    if (!IS_OBJECT(value) || AS_OBJECT(value)->type != OBJ_ARRAY)
+        return NULL;
+
+    ArrayObject* array = AS_OBJECT(value)->object;
+    if (array->storage != ARRAY_INTS && array->storage != ARRAY_FLOATS)
+        return NULL;
+
+    return array;
+}
+
+/* a scalar of the array's element type */
+static bool scalar_matches(ArrayObject* array, Value value) {
+    return array->storage == ARRAY_INTS ? IS_INT(value) : IS_FLOAT(value);
+}
+
+static bool same_shape(ArrayObject* left, ArrayObject* right) {
+    return left->storage == right->storage && left->rank == right->rank && left->length == right->length;
+}
+
+static Value reduce_run(const char* name, int64_t (*reduce_int)(const int64_t*, size_t),
+    double (*reduce_float)(const double*, size_t), bool allowEmpty, Value* arguments, size_t argc)
+{
+    ArrayObject* array = arguments != NULL && argc == 1 ? numeric_argument(arguments[0]) : NULL;
+
+    if (array == NULL)
+        return error_value(name, "invalid argument");
+
+    if (array->length == 0 && !allowEmpty)
+        return error_value(name, "empty array");
+
+    if (array->storage == ARRAY_INTS)
+        return INT_VALUE(reduce_int(array->ints, array->length));
+
+    return FLOAT_VALUE(reduce_float(array->floats, array->length));
+}
+
+Value sum_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    (void) interpreter;
+    (void) functionObject;
+
+    const SimdKernels* kernels = simd_kernels();
+    return reduce_run("sum", kernels->sum_int, kernels->sum_float, true, arguments, argc);
+}
+
+Value min_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    (void) interpreter;
+    (void) functionObject;
+
+    const SimdKernels* kernels = simd_kernels();
+    return reduce_run("min", kernels->min_int, kernels->min_float, false, arguments, argc);
+}
+
+Value max_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    (void) interpreter;
+    (void) functionObject;
+
+    const SimdKernels* kernels = simd_kernels();
+    return reduce_run("max", kernels->max_int, kernels->max_float, false, arguments, argc);
+}
+
+Value dot_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    (void) interpreter;
+    (void) functionObject;
+
+    bool valid = arguments != NULL && argc == 2;
+
+    ArrayObject* left = valid ? numeric_argument(arguments[0]) : NULL;
+    ArrayObject* right = valid ? numeric_argument(arguments[1]) : NULL;
+
+    if (left == NULL || right == NULL || !same_shape(left, right))
+        return error_value("dot", "invalid argument");
+
+    const SimdKernels* kernels = simd_kernels();
+
+    if (left->storage == ARRAY_INTS)
+        return INT_VALUE(kernels->dot_int(left->ints, right->ints, left->length));
+
+    return FLOAT_VALUE(kernels->dot_float(left->floats, right->floats, left->length));
+}
+
+Value axpy_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    (void) interpreter;
+    (void) functionObject;
+
+    bool valid = arguments != NULL && argc == 3;
+
+    ArrayObject* x = valid ? numeric_argument(arguments[1]) : NULL;
+    ArrayObject* y = valid ? numeric_argument(arguments[2]) : NULL;
+
+    if (x == NULL || y == NULL || !same_shape(x, y) || !scalar_matches(x, arguments[0]))
+        return error_value("axpy", "invalid argument");
+
+    const SimdKernels* kernels = simd_kernels();
+
+    if (x->storage == ARRAY_INTS) {
+        kernels->axpy_int(AS_INT(arguments[0]), x->ints, y->ints, x->length);
+    } else {
+        kernels->axpy_float(AS_FLOAT(arguments[0]), x->floats, y->floats, x->length);
+    }
+
+    return NIL_VALUE();
+}
+
+static Value map_run(const char* name, bool multiply, Value* arguments, size_t argc) {
+    bool valid = arguments != NULL && argc == 2;
+
+    ArrayObject* source = valid ? numeric_argument(arguments[0]) : NULL;
+
+    if (source == NULL || !scalar_matches(source, arguments[1]))
+        return error_value(name, "invalid argument");
+
+    Object* result = NEW_ARRAY_OBJECT(type_copy((const Type**) &source->type), NULL, 0);
+    ArrayObject* array = result->object;
+
+    if (array->rank == 1 && source->length > 0) {
+        array_object_reserve(array, source->length);
+        array->length = source->length;
+    }
+
+    const SimdKernels* kernels = simd_kernels();
+
+    if (source->storage == ARRAY_INTS) {
+        (multiply ? kernels->mul_int : kernels->add_int)(source->ints, AS_INT(arguments[1]), array->ints, source->length);
+    } else {
+        (multiply ? kernels->mul_float : kernels->add_float)(source->floats, AS_FLOAT(arguments[1]), array->floats, source->length);
+    }
+
+    return OBJECT_VALUE(result);
+}
+
+Value map_add_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    (void) interpreter;
+    (void) functionObject;
+
+    return map_run("map_add", false, arguments, argc);
+}
+
+Value map_mul_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    (void) interpreter;
+    (void) functionObject;
+
+    return map_run("map_mul", true, arguments, argc);
+}
+
+Value fill_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    (void) interpreter;
+    (void) functionObject;
+
+    bool valid = arguments != NULL && argc == 2;
+
+    ArrayObject* array = valid ? numeric_argument(arguments[0]) : NULL;
+
+    if (array == NULL || !scalar_matches(array, arguments[1]))
+        return error_value("fill", "invalid argument");
+
+    const SimdKernels* kernels = simd_kernels();
+
+    if (array->storage == ARRAY_INTS) {
+        kernels->fill_int(array->ints, AS_INT(arguments[1]), array->length);
+    } else {
+        kernels->fill_float(array->floats, AS_FLOAT(arguments[1]), array->length);
+    }
+
+    return NIL_VALUE();
+}
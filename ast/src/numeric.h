@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "interpreter.h"
+#include "object.h"
+#include "value.h"
+
+
+typedef struct NumericBuiltin {
+    char* name;
+    Value (*function)(struct Interpreter*, FunctionObject*, Value*, size_t);
+} NumericBuiltin;
+
+#define NUMERIC_BUILTIN_COUNT 8
+
+/*
+ * Builtins over []int and []float, dense arrays included, that hand whole
+ * buffers to the simd kernels: sum, min, max and dot reduce to a scalar,
+ * map_add and map_mul return a new array with a scalar added or multiplied
+ * into every element, axpy(alpha, x, y) and fill(array, value) update their
+ * array in place. Both engines register them after the core builtins, in
+ * this order.
+ */
+extern const NumericBuiltin numericBuiltins[NUMERIC_BUILTIN_COUNT];
+
+Value sum_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
+Value min_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
+Value max_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
+Value dot_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
+Value axpy_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
+Value map_add_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
+Value map_mul_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
+Value fill_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
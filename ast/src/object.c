@@ -8,8 +8,12 @@
 #include "ast.h"
 #include "buffer.h"
 #include "context.h"
+#include "gc.h"
 #include "interpreter.h"
 #include "list.h"
+#include "matrix.h"
+#include "output.h"
+#include "reader.h"
 #include "smem.h"
 #include "types.h"
 #include "utils.h"
@@ -23,7 +27,7 @@ Object* object_new(ObjectType type, void* object,
     void (*destroy)(void**))
 {
     Object* new_object = NULL;
-    new_object = safe_malloc(sizeof(Object), NULL);
+    new_object = smem_alloc(sizeof(Object));
     if (new_object == NULL) {
         if (destroy != NULL) {
             destroy(&object);
@@ -38,9 +42,14 @@ Object* object_new(ObjectType type, void* object,
         .copy = copy,
         .equals = equals,
         .to_string = to_string,
-        .destroy = destroy
+        .destroy = destroy,
+        .next = NULL,
+        .size = 0,
+        .mark = 0
     };
 
+    gc_track(new_object);
+
     return new_object;
 }
 
@@ -94,12 +103,12 @@ void object_free(Object** object) {
         (*object)->destroy(&(*object)->object);
     }
 
-    safe_free((void**) object);
+    smem_free((void**) object, sizeof(Object));
 }
 
 Error* error_new(ErrorType type, char* message) {
     Error* new_error = NULL;
-    new_error = safe_malloc(sizeof(Error), NULL);
+    new_error = smem_alloc(sizeof(Error));
     if (new_error == NULL) {
         return NULL;
     }
@@ -153,12 +162,12 @@ void error_free(Error** errorObject) {
         return;
 
     safe_free((void**) &(*errorObject)->message);
-    safe_free((void**) errorObject);
+    smem_free((void**) errorObject, sizeof(Error));
 }
 
 IdentObject* ident_object_new(Type* type, char* name, Object* value) {
     IdentObject* new_ident = NULL;
-    new_ident = safe_malloc(sizeof(IdentObject), NULL);
+    new_ident = smem_alloc(sizeof(IdentObject));
     if (new_ident == NULL) {
         type_free(&type);
         object_free(&value);
@@ -220,12 +229,12 @@ void ident_object_free(IdentObject** identObject) {
     safe_free((void**) &(*identObject)->name);
     object_free(&(*identObject)->value);
 
-    safe_free((void**) identObject);
+    smem_free((void**) identObject, sizeof(IdentObject));
 }
 
-IntegerObject* integer_object_new(Type* type, int value) {
+IntegerObject* integer_object_new(Type* type, int64_t value) {
     IntegerObject* new_integer_object = NULL;
-    new_integer_object = safe_malloc(sizeof(IntegerObject), NULL);
+    new_integer_object = smem_alloc(sizeof(IntegerObject));
     if (new_integer_object == NULL) {
         return NULL;
     }
@@ -268,7 +277,7 @@ void integer_object_to_string(ByteBuffer* byteBuffer, IntegerObject** integerObj
     if (byteBuffer == NULL || integerObject == NULL || *integerObject == NULL)
         return;
 
-    byte_buffer_appendf(byteBuffer, "%d", (*integerObject)->value);
+    byte_buffer_append_int(byteBuffer, (*integerObject)->value);
 }
 
 void integer_object_free(IntegerObject** integerObject) {
@@ -277,11 +286,11 @@ void integer_object_free(IntegerObject** integerObject) {
 
     type_free(&(*integerObject)->type);
 
-    safe_free((void**) integerObject);
+    smem_free((void**) integerObject, sizeof(IntegerObject));
 }
 
 FloatObject* float_object_new(Type* type, double value) {
-    FloatObject* new_float_object = safe_malloc(sizeof(FloatObject), NULL);
+    FloatObject* new_float_object = smem_alloc(sizeof(FloatObject));
     if (new_float_object == NULL) {
         return NULL;
     }
@@ -328,7 +337,7 @@ void float_object_to_string(ByteBuffer* byteBuffer, FloatObject** floatObject) {
     if (byteBuffer == NULL || floatObject == NULL || *floatObject == NULL)
         return;
 
-    byte_buffer_appendf(byteBuffer, "%f", (*floatObject)->value);
+    byte_buffer_append_double(byteBuffer, (*floatObject)->value);
 }
 
 void float_object_free(FloatObject** floatObject) {
@@ -337,12 +346,12 @@ void float_object_free(FloatObject** floatObject) {
 
     type_free(&(*floatObject)->type);
 
-    safe_free((void**) floatObject);
+    smem_free((void**) floatObject, sizeof(FloatObject));
 }
 
 CharacterObject* character_object_new(Type* type, char value) {
     CharacterObject* new_char_object = NULL;
-    new_char_object = safe_malloc(sizeof(CharacterObject), NULL);
+    new_char_object = smem_alloc(sizeof(CharacterObject));
     if (new_char_object == NULL) {
         return NULL;
     }
@@ -394,12 +403,12 @@ void character_object_free(CharacterObject** characterObject) {
 
     type_free(&(*characterObject)->type);
 
-    safe_free((void**) characterObject);
+    smem_free((void**) characterObject, sizeof(CharacterObject));
 }
 
 StringObject* string_object_new(Type* type, char* value) {
     StringObject* new_string_object = NULL;
-    new_string_object = safe_malloc(sizeof(StringObject), NULL);
+    new_string_object = smem_alloc(sizeof(StringObject));
     if (new_string_object == NULL) {
         return NULL;
     }
@@ -412,6 +421,32 @@ StringObject* string_object_new(Type* type, char* value) {
     return new_string_object;
 }
 
+StringObject* string_object_new_with_length(Type* type, const char* value, size_t length) {
+    char* copy = safe_malloc(length + 1, NULL);
+    if (copy == NULL) {
+        type_free(&type);
+        return NULL;
+    }
+
+    StringObject* new_string_object = NULL;
+    new_string_object = smem_alloc(sizeof(StringObject));
+    if (new_string_object == NULL) {
+        type_free(&type);
+        safe_free((void**) &copy);
+        return NULL;
+    }
+
+    memcpy(copy, value, length);
+    copy[length] = '\0';
+
+    *new_string_object = (StringObject) {
+        .type = type,
+        .value = copy
+    };
+
+    return new_string_object;
+}
+
 Type* string_object_get_type(StringObject* stringObject) {
     if (stringObject == NULL)
         return NULL;
@@ -496,12 +531,12 @@ void string_object_free(StringObject** stringObject) {
     type_free(&(*stringObject)->type);
     safe_free((void**) &(*stringObject)->value);
 
-    safe_free((void**) stringObject);
+    smem_free((void**) stringObject, sizeof(StringObject));
 }
 
 BooleanObject* boolean_object_new(Type* type, bool value) {
     BooleanObject* new_boolean_object = NULL;
-    new_boolean_object = safe_malloc(sizeof(BooleanObject), NULL);
+    new_boolean_object = smem_alloc(sizeof(BooleanObject));
     if (new_boolean_object == NULL) {
         return NULL;
     }
@@ -555,12 +590,12 @@ void boolean_object_free(BooleanObject** booleanObject) {
 
     type_free(&(*booleanObject)->type);
 
-    safe_free((void**) booleanObject);
+    smem_free((void**) booleanObject, sizeof(BooleanObject));
 }
 
 NilObject* nil_object_new(Type* type) {
     NilObject* new_nil_object = NULL;
-    new_nil_object = safe_malloc(sizeof(NilObject), NULL);
+    new_nil_object = smem_alloc(sizeof(NilObject));
     if (new_nil_object == NULL) {
         return NULL;
     }
@@ -606,12 +641,12 @@ void nil_object_free(NilObject** nilObject) {
 
     type_free(&(*nilObject)->type);
 
-    safe_free((void**) nilObject);
+    smem_free((void**) nilObject, sizeof(NilObject));
 }
 
 ReturnObject* return_object_new(Object* value) {
     ReturnObject* new_return_object = NULL;
-    new_return_object = safe_malloc(sizeof(ReturnObject), NULL);
+    new_return_object = smem_alloc(sizeof(ReturnObject));
     if (new_return_object == NULL) {
         return NULL;
     }
@@ -659,12 +694,12 @@ void return_object_free(ReturnObject** returnObject) {
         return;
 
     object_free(&(*returnObject)->value);
-    safe_free((void**) returnObject);
+    smem_free((void**) returnObject, sizeof(ReturnObject));
 }
 
 BreakObject* break_object_new(void) {
     BreakObject* new_break_object = NULL;
-    new_break_object = safe_malloc(sizeof(BreakObject), NULL);
+    new_break_object = smem_alloc(sizeof(BreakObject));
     if (new_break_object == NULL) {
         return NULL;
     }
@@ -682,12 +717,12 @@ void break_object_free(BreakObject** breakObject) {
     if (breakObject == NULL || *breakObject == NULL)
         return;
 
-    safe_free((void**) breakObject);
+    smem_free((void**) breakObject, sizeof(BreakObject));
 }
 
 ContinueObject* continue_object_new(void) {
     ContinueObject* new_continue_object = NULL;
-    new_continue_object = safe_malloc(sizeof(ContinueObject), NULL);
+    new_continue_object = smem_alloc(sizeof(ContinueObject));
     if (new_continue_object == NULL) {
         return NULL;
     }
@@ -705,17 +740,15 @@ void continue_object_free(ContinueObject** continueObject) {
     if (continueObject == NULL || *continueObject == NULL)
         return;
 
-    safe_free((void**) continueObject);
+    smem_free((void**) continueObject, sizeof(ContinueObject));
 }
 
-FunctionObject* function_object_new(Type* type, Context* env, List* parameters, Stmt* body) {
+FunctionObject* function_object_new(Type* type, Context* env, List* parameters, Stmt* body, ScopeLayout frame) {
     FunctionObject* new_function_object = NULL;
-    new_function_object = safe_malloc(sizeof(FunctionObject), NULL);
+    new_function_object = smem_alloc(sizeof(FunctionObject));
     if (new_function_object == NULL) {
         type_free(&type);
         context_free(&env);
-        list_free(&parameters);
-        stmt_free(&body);
         return NULL;
     }
 
@@ -723,7 +756,8 @@ FunctionObject* function_object_new(Type* type, Context* env, List* parameters,
         .type = type,
         .env = env,
         .parameters = parameters,
-        .body = body
+        .body = body,
+        .frame = frame
     };
 
     return new_function_object;
@@ -756,81 +790,224 @@ void function_object_free(FunctionObject** functionObject) {
     if (functionObject == NULL || *functionObject == NULL)
         return;
 
+    /* parameters and body belong to the AST, env to the collector */
     type_free(&(*functionObject)->type);
-    context_free(&(*functionObject)->env);
-    list_free(&(*functionObject)->parameters);
-    stmt_free(&(*functionObject)->body);
-
-    safe_free((void**) functionObject);
-}
 
-static bool entry_cmp(const MapEntry** entry, char** key) {
-    return strcmp((*entry)->key, *key) == 0;
+    smem_free((void**) functionObject, sizeof(FunctionObject));
 }
 
-static Context* extend_function_env(FunctionObject* functionObject, List* arguments) {
-    Context* functionEnv = context_enclosed_new(
-        functionObject->env,
-        MAP_NEW(32, entry_cmp, NULL, NULL)
-    );
+static Context* extend_function_env(Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    ScopeLayout frame = functionObject->frame;
 
-    size_t paramIndex = 0;
+    if (frame.size < argc) {
+        frame.size = argc;
+    }
 
-    list_foreach(parameter, functionObject->parameters) {
-        FieldDecl* paramDecl = ((Decl*) parameter->value)->decl;
-        char* parameterName = paramDecl->name->literal;
+    if (frame.size == 0)
+        return functionObject->env;
 
-        context_define(
-            functionEnv,
-            parameterName,
-            list_get_at(&arguments, paramIndex)
-        );
+    Context* functionEnv = context_stack_push(interpreter->stack, functionObject->env, frame.size, frame.isCapturable);
 
-        paramIndex++;
+    /* the resolver numbers parameters in declaration order */
+    for (size_t paramIndex = 0; paramIndex < argc; paramIndex++) {
+        context_define_at(functionEnv, paramIndex, arguments[paramIndex]);
     }
 
     return functionEnv;
 }
 
-static Object* unwrap_return_value(Object* object) {
-    if (object->type == OBJ_RETURN) {
-        ReturnObject* returnObject = object->object;
-        Object* result = returnObject->value;
-        returnObject->value = NULL;
-        object_free(&object);
-        return result;
+/* a return statement leaves its value on the interpreter and signals with OBJ_RETURN */
+static Value unwrap_return_value(Interpreter* interpreter, Value value) {
+    if (IS_OBJECT(value) && AS_OBJECT(value)->type == OBJ_RETURN) {
+        return interpreter->returnValue;
     }
 
-    return object;
+    if (IS_OBJECT(value) && AS_OBJECT(value)->type == OBJ_ERROR) {
+        return value;
+    }
+
+    return NIL_VALUE();
 }
 
-Object* function_object_run(Interpreter* interpreter, FunctionObject* functionObject, List* arguments) {
+Value function_object_run(Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
     Context* previous = interpreter->env;
 
-    Context* innerEnv = extend_function_env(functionObject, arguments);
+    Context* innerEnv = extend_function_env(interpreter, functionObject, arguments, argc);
+
+    gc_push_frame(interpreter->gc, previous);
 
     interpreter->env = innerEnv;
 
-    Object* result = eval_stmt(interpreter, functionObject->body);
+    Value result = eval_stmt(interpreter, functionObject->body);
 
     interpreter->env = previous;
 
-    return unwrap_return_value(result);
+    gc_pop_frame(interpreter->gc);
+
+    if (innerEnv != functionObject->env) {
+        context_stack_pop(interpreter->stack, innerEnv);
+    }
+
+    return unwrap_return_value(interpreter, result);
+}
+
+static ArrayStorage array_storage_of(Type* type) {
+    ArrayType* arrayType = type->type;
+
+    if (list_size(&arrayType->dimensions) != 1 && !array_type_is_dense(type))
+        return ARRAY_VALUES;
+
+    switch (arrayType->type->typeId) {
+    case INT_TYPE:
+        return ARRAY_INTS;
+    case FLOAT_TYPE:
+        return ARRAY_FLOATS;
+    case CHAR_TYPE:
+        return ARRAY_CHARS;
+    case BOOL_TYPE:
+        return ARRAY_BOOLS;
+    default:
+        return ARRAY_VALUES;
+    }
+}
+
+static size_t array_element_size(ArrayStorage storage) {
+    switch (storage) {
+    case ARRAY_INTS:
+        return sizeof(int64_t);
+    case ARRAY_FLOATS:
+        return sizeof(double);
+    case ARRAY_CHARS:
+        return sizeof(char);
+    case ARRAY_BOOLS:
+        return sizeof(bool);
+    default:
+        return sizeof(Value);
+    }
+}
+
+static Value array_load(ArrayObject* self, size_t index) {
+    switch (self->storage) {
+    case ARRAY_INTS:
+        return INT_VALUE(self->ints[index]);
+    case ARRAY_FLOATS:
+        return FLOAT_VALUE(self->floats[index]);
+    case ARRAY_CHARS:
+        return CHAR_VALUE(self->chars[index]);
+    case ARRAY_BOOLS:
+        return BOOL_VALUE(self->bools[index]);
+    default:
+        return self->values[index];
+    }
+}
+
+static void array_store(ArrayObject* self, size_t index, Value value) {
+    switch (self->storage) {
+    case ARRAY_INTS:
+        /* AS_INT follows a big int's box, so only a real int may reach it */
+        self->ints[index] = IS_INT(value) ? AS_INT(value) : IS_FLOAT(value) ? (int64_t) AS_FLOAT(value) : 0;
+        break;
+    case ARRAY_FLOATS:
+        self->floats[index] = IS_INT(value) ? (double) AS_INT(value) : AS_FLOAT(value);
+        break;
+    case ARRAY_CHARS:
+        self->chars[index] = AS_CHAR(value);
+        break;
+    case ARRAY_BOOLS:
+        self->bools[index] = AS_BOOL(value);
+        break;
+    default:
+        self->values[index] = value;
+        break;
+    }
+}
+
+/* lays out the whole block, values are either its scalars in row-major order or its rows */
+static bool array_init_dense(ArrayObject* self, Value* values, size_t count) {
+    size_t rank = array_type_rank(self->type);
+
+    self->shape = safe_malloc(2 * rank * sizeof(size_t), NULL);
+    if (self->shape == NULL)
+        return false;
+
+    self->rank = rank;
+    self->strides = self->shape + rank;
+
+    for (size_t axis = rank; axis-- > 0;) {
+        self->shape[axis] = array_type_extent(self->type, axis);
+        self->strides[axis] = axis + 1 < rank ? self->strides[axis + 1] * self->shape[axis + 1] : 1;
+    }
+
+    self->length = self->shape[0] * self->strides[0];
+    self->capacity = self->length;
+    self->elements = safe_calloc(self->length, array_element_size(self->storage), NULL);
+    if (self->elements == NULL)
+        return false;
+
+    for (size_t i = 0; i < count; i++) {
+        if (IS_OBJECT(values[i]) && AS_OBJECT(values[i])->type == OBJ_ARRAY) {
+            ArrayObject* row = AS_OBJECT(values[i])->object;
+            size_t size = row->length < self->strides[0] ? row->length : self->strides[0];
+
+            for (size_t j = 0; i < self->shape[0] && j < size; j++) {
+                array_store(self, i * self->strides[0] + j, array_load(row, j));
+            }
+        } else if (i < self->length) {
+            array_store(self, i, values[i]);
+        }
+    }
+
+    return true;
 }
 
-ArrayObject* array_object_new(Type* type, List* objects) {
+ArrayObject* array_object_new(Type* type, Value* values, size_t length) {
     ArrayObject* new_array_object = NULL;
-    new_array_object = safe_malloc(sizeof(ArrayObject), NULL);
+    new_array_object = smem_alloc(sizeof(ArrayObject));
     if (new_array_object == NULL) {
         type_free(&type);
-        list_free(&objects);
+        safe_free((void**) &values);
+        return NULL;
     }
 
     *new_array_object = (ArrayObject) {
         .type = type,
-        .objects = objects
+        .storage = array_storage_of(type),
+        .values = values,
+        .length = length,
+        .capacity = length,
+        .rank = 1,
+        .shape = NULL,
+        .strides = NULL
     };
 
+    if (array_type_is_dense(type)) {
+        new_array_object->elements = NULL;
+
+        bool initialized = array_init_dense(new_array_object, values, length);
+
+        safe_free((void**) &values);
+
+        if (!initialized) {
+            array_object_free(&new_array_object);
+            return NULL;
+        }
+    } else if (new_array_object->storage != ARRAY_VALUES) {
+        new_array_object->elements = NULL;
+        new_array_object->capacity = 0;
+
+        if (length > 0 && !array_object_reserve(new_array_object, length)) {
+            safe_free((void**) &values);
+            array_object_free(&new_array_object);
+            return NULL;
+        }
+
+        for (size_t i = 0; i < length; i++) {
+            array_store(new_array_object, i, values[i]);
+        }
+
+        safe_free((void**) &values);
+    }
+
     return new_array_object;
 }
 
@@ -850,16 +1027,54 @@ bool array_object_equals(ArrayObject* self, Object* other) {
     return type_equals(&self->type, &otherArrayObject->type);
 }
 
+/* numeric storage is formatted straight from the buffer, without boxing each element */
+static void array_element_to_string(ByteBuffer* byteBuffer, ArrayObject* self, size_t index) {
+    switch (self->storage) {
+    case ARRAY_INTS:
+        byte_buffer_append_int(byteBuffer, self->ints[index]);
+        break;
+    case ARRAY_FLOATS:
+        byte_buffer_append_double(byteBuffer, self->floats[index]);
+        break;
+    default:
+        value_to_string(byteBuffer, array_load(self, index));
+        break;
+    }
+}
+
+static void array_block_to_string(ByteBuffer* byteBuffer, ArrayObject* self, size_t axis, size_t offset) {
+    byte_buffer_append(byteBuffer, "[", 1);
+
+    for (size_t i = 0; i < self->shape[axis]; i++) {
+        if (axis + 1 == self->rank) {
+            array_element_to_string(byteBuffer, self, offset + i);
+        } else {
+            array_block_to_string(byteBuffer, self, axis + 1, offset + i * self->strides[axis]);
+        }
+
+        if (i + 1 < self->shape[axis]) {
+            byte_buffer_append(byteBuffer, ", ", 2);
+        }
+    }
+
+    byte_buffer_append(byteBuffer, "]", 1);
+}
+
 void array_object_to_string(ByteBuffer* byteBuffer, ArrayObject** arrayObject) {
     if (byteBuffer == NULL || arrayObject == NULL || *arrayObject == NULL)
         return;
 
+    if ((*arrayObject)->rank > 1) {
+        array_block_to_string(byteBuffer, *arrayObject, 0, 0);
+        return;
+    }
+
     byte_buffer_append(byteBuffer, "[", 1);
 
-    list_foreach(object, (*arrayObject)->objects) {
-        object_to_string(byteBuffer, (Object**) &object->value);
+    for (size_t i = 0; i < (*arrayObject)->length; i++) {
+        array_element_to_string(byteBuffer, *arrayObject, i);
 
-        if (object->next != NULL) {
+        if (i + 1 < (*arrayObject)->length) {
             byte_buffer_append(byteBuffer, ", ", 2);
         }
     }
@@ -872,9 +1087,10 @@ void array_object_free(ArrayObject** arrayObject) {
         return;
 
     type_free(&(*arrayObject)->type);
-    list_free(&(*arrayObject)->objects);
+    safe_free((void**) &(*arrayObject)->elements);
+    safe_free((void**) &(*arrayObject)->shape);
 
-    safe_free((void**) arrayObject);
+    smem_free((void**) arrayObject, sizeof(ArrayObject));
 }
 
 size_t array_object_get_dimensions(ArrayObject* self) {
@@ -886,20 +1102,416 @@ size_t array_object_get_dimensions(ArrayObject* self) {
     return list_size(&arrType->dimensions);
 }
 
-Object* array_object_get_object_at(ArrayObject* self, int index) {
-    if (index < 0 || index >= list_size(&self->objects))
-        return NEW_ERROR_OBJECT(RUNTIME_ERROR, "index out of bounds");
+size_t array_object_get_size(ArrayObject* self) {
+    if (self == NULL)
+        return 0;
+
+    size_t layout = self->rank > 1 ? 2 * self->rank * sizeof(size_t) : 0;
+
+    return self->capacity * array_element_size(self->storage) + layout;
+}
+
+/* the extent of the first axis, what len reports */
+size_t array_object_get_length(ArrayObject* self) {
+    if (self == NULL)
+        return 0;
+
+    return self->rank > 1 ? self->shape[0] : self->length;
+}
+
+Value array_object_get_at(ArrayObject* self, int64_t index) {
+    if (index < 0 || (size_t) index >= self->length)
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "index out of bounds"));
+
+    return array_load(self, index);
+}
+
+void array_object_set_at(ArrayObject* self, int64_t index, Value value) {
+    if (index < 0 || (size_t) index >= self->length)
+        return;
+
+    array_store(self, index, value);
+}
+
+static bool is_array(Value value) {
+    return IS_OBJECT(value) && AS_OBJECT(value)->type == OBJ_ARRAY;
+}
+
+/* follows nested arrays through every index but the last */
+static Value array_walk(ArrayObject** array, const int64_t* indices, size_t count) {
+    for (size_t level = 0; level + 1 < count; level++) {
+        Value element = array_object_get_at(*array, indices[level]);
+
+        if (!is_array(element)) {
+            return IS_OBJECT(element) && AS_OBJECT(element)->type == OBJ_ERROR
+                ? element
+                : OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "invalid array access"));
+        }
+
+        *array = AS_OBJECT(element)->object;
+    }
+
+    return NIL_VALUE();
+}
+
+static bool array_locate(ArrayObject* self, const int64_t* indices, size_t count, size_t* offset) {
+    size_t position = 0;
+
+    for (size_t axis = 0; axis < count; axis++) {
+        if (indices[axis] < 0 || (size_t) indices[axis] >= self->shape[axis])
+            return false;
+
+        position += (size_t) indices[axis] * self->strides[axis];
+    }
+
+    *offset = position;
+
+    return true;
+}
+
+/* reading part of the indices out of a dense array copies the addressed block */
+static Value array_block(ArrayObject* self, size_t levels, size_t offset) {
+    size_t size = self->strides[levels - 1];
+    size_t elementSize = array_element_size(self->storage);
+
+    Object* block = NEW_ARRAY_OBJECT(array_type_slice(self->type, levels), NULL, 0);
+    ArrayObject* array = block->object;
+
+    if (array->rank == 1) {
+        array_object_reserve(array, size);
+        array->length = size;
+    }
+
+    memcpy(array->elements, (char*) self->elements + offset * elementSize, size * elementSize);
+
+    return OBJECT_VALUE(block);
+}
+
+Value array_object_get_index(ArrayObject* self, const int64_t* indices, size_t count) {
+    if (self == NULL || count == 0 || (self->rank > 1 && count > self->rank))
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "invalid array access"));
+
+    if (self->rank == 1) {
+        ArrayObject* array = self;
+
+        Value walked = array_walk(&array, indices, count);
+        if (!IS_NIL(walked))
+            return walked;
+
+        return array_object_get_at(array, indices[count - 1]);
+    }
+
+    size_t offset = 0;
+
+    if (!array_locate(self, indices, count, &offset))
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "index out of bounds"));
+
+    return count == self->rank ? array_load(self, offset) : array_block(self, count, offset);
+}
+
+Value array_object_set_index(ArrayObject* self, const int64_t* indices, size_t count, Value value) {
+    if (self == NULL || count == 0 || (self->rank > 1 && count > self->rank))
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "invalid array access"));
+
+    if (self->rank == 1) {
+        ArrayObject* array = self;
+
+        Value walked = array_walk(&array, indices, count);
+        if (!IS_NIL(walked))
+            return walked;
+
+        int64_t index = indices[count - 1];
+        if (index < 0 || (size_t) index >= array->length)
+            return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "index out of bounds"));
+
+        array_store(array, index, value);
+
+        return value;
+    }
+
+    size_t offset = 0;
+
+    if (!array_locate(self, indices, count, &offset))
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "index out of bounds"));
+
+    if (count == self->rank) {
+        array_store(self, offset, value);
+        return value;
+    }
+
+    ArrayObject* source = is_array(value) ? AS_OBJECT(value)->object : NULL;
+    size_t size = self->strides[count - 1];
+
+    if (source == NULL || source->storage != self->storage || source->length != size)
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "invalid assign: shape mismatch"));
+
+    size_t elementSize = array_element_size(self->storage);
+    memcpy((char*) self->elements + offset * elementSize, source->elements, size * elementSize);
+
+    return value;
+}
+
+bool array_object_reserve(ArrayObject* self, size_t capacity) {
+    if (self == NULL || self->rank > 1)
+        return false;
+
+    if (capacity <= self->capacity)
+        return true;
+
+    size_t size = capacity * array_element_size(self->storage);
+    void* elements = self->elements == NULL
+        ? safe_malloc(size, NULL)
+        : safe_realloc((void**) &self->elements, size, NULL);
+    if (elements == NULL)
+        return false;
+
+    self->elements = elements;
+    self->capacity = capacity;
+
+    return true;
+}
+
+bool array_object_push(ArrayObject* self, Value value) {
+    if (self == NULL || self->rank > 1)
+        return false;
+
+    if (self->length == self->capacity) {
+        size_t capacity = self->capacity < 8 ? 8 : self->capacity * 2;
+
+        if (!array_object_reserve(self, capacity))
+            return false;
+    }
+
+    array_store(self, self->length++, value);
+
+    return true;
+}
+
+Value array_object_pop(ArrayObject* self) {
+    if (self == NULL || self->rank > 1)
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "pop from fixed-shape array"));
+
+    if (self->length == 0)
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "pop from empty array"));
+
+    return array_load(self, --self->length);
+}
+
+/* a key and its value share one allocation, the key owns it */
+static void release_pair(void** pair) {
+    smem_free(pair, 2 * sizeof(Value));
+}
+
+static size_t key_hash(const Value* key) {
+    return value_hash(*key);
+}
+
+static bool key_equals(const MapEntry** entry, Value** key) {
+    return value_equals(*(Value*) (*entry)->key, **key);
+}
+
+MapObject* map_object_new(Type* type, size_t capacity) {
+    MapObject* new_map_object = NULL;
+    new_map_object = smem_alloc(sizeof(MapObject));
+    if (new_map_object == NULL) {
+        type_free(&type);
+        return NULL;
+    }
+
+    *new_map_object = (MapObject) {
+        .type = type,
+        .entries = MAP_NEW_WITH_HASH(capacity, key_hash, key_equals, release_pair, NULL)
+    };
+
+    if (new_map_object->entries == NULL) {
+        map_object_free(&new_map_object);
+        return NULL;
+    }
+
+    return new_map_object;
+}
+
+Type* map_object_get_type(MapObject* self) {
+    if (self == NULL)
+        return NULL;
+
+    return self->type;
+}
+
+bool map_object_equals(MapObject* self, Object* other) {
+    if (other == NULL || other->type != OBJ_MAP)
+        return false;
+
+    return self == other->object;
+}
+
+void map_object_to_string(ByteBuffer* byteBuffer, MapObject** mapObject) {
+    if (byteBuffer == NULL || mapObject == NULL || *mapObject == NULL)
+        return;
+
+    byte_buffer_append(byteBuffer, "{", 1);
+
+    MapIterator iterator = { .map = (*mapObject)->entries, .index = 0 };
+    size_t remaining = map_size((*mapObject)->entries);
+
+    while (map_iterator_has_next(&iterator)) {
+        MapEntry* entry = map_iterator_next(&iterator);
+
+        value_to_string(byteBuffer, *(Value*) entry->key);
+        byte_buffer_append(byteBuffer, ": ", 2);
+        value_to_string(byteBuffer, *(Value*) entry->value);
+
+        if (--remaining > 0) {
+            byte_buffer_append(byteBuffer, ", ", 2);
+        }
+    }
+
+    byte_buffer_append(byteBuffer, "}", 1);
+}
+
+void map_object_free(MapObject** mapObject) {
+    if (mapObject == NULL || *mapObject == NULL)
+        return;
+
+    type_free(&(*mapObject)->type);
+    map_free(&(*mapObject)->entries);
+
+    smem_free((void**) mapObject, sizeof(MapObject));
+}
+
+size_t map_object_get_size(MapObject* self) {
+    if (self == NULL)
+        return 0;
+
+    Map* map = self->entries;
+    size_t table = map->slots != map->inline_slots ? map->capacity * sizeof(MapSlot) : 0;
+
+    return sizeof(Map) + table + map_size(map) * 2 * sizeof(Value);
+}
+
+size_t map_object_get_length(MapObject* self) {
+    if (self == NULL)
+        return 0;
+
+    return map_size(self->entries);
+}
+
+bool map_object_get(MapObject* self, Value key, Value* value) {
+    Value* found = map_get(self->entries, &key);
+    if (found == NULL)
+        return false;
+
+    *value = *found;
+
+    return true;
+}
+
+/* what a missing key reads as, strings get a fresh empty one */
+Value map_object_zero(MapObject* self) {
+    switch (((MapType*) self->type->type)->value->typeId) {
+    case INT_TYPE:
+        return INT_VALUE(0);
+    case FLOAT_TYPE:
+        return FLOAT_VALUE(0.0);
+    case CHAR_TYPE:
+        return CHAR_VALUE('\0');
+    case BOOL_TYPE:
+        return BOOL_VALUE(false);
+    case STRING_TYPE:
+        return OBJECT_VALUE(NEW_STRING_OBJECT(""));
+    default:
+        return NIL_VALUE();
+    }
+}
+
+bool map_object_set(MapObject* self, Value key, Value value) {
+    Value* found = map_get(self->entries, &key);
+    if (found != NULL) {
+        *found = value;
+        return true;
+    }
+
+    Value* pair = smem_alloc(2 * sizeof(Value));
+    if (pair == NULL)
+        return false;
+
+    pair[0] = key;
+    pair[1] = value;
+
+    size_t size = map_size(self->entries);
+    map_put(self->entries, pair, pair + 1);
+
+    return map_size(self->entries) > size;
+}
+
+bool map_object_delete(MapObject* self, Value key) {
+    if (!map_contains(self->entries, &key))
+        return false;
+
+    map_remove(self->entries, &key);
+
+    return true;
+}
+
+static size_t index_levels_taken(Object* container, size_t remaining) {
+    if (container->type == OBJ_MAP)
+        return 1;
+
+    ArrayObject* array = container->object;
+
+    return array->rank > 1 && remaining > 1 ? (remaining < array->rank ? remaining : array->rank) : 1;
+}
+
+Value index_target_resolve(IndexTarget* target, Value object, const Value* levels, size_t count) {
+    Value current = object;
+    size_t level = 0;
 
-    return list_get_at(&self->objects, index);
+    while (level < count) {
+        if (!IS_OBJECT(current) || (AS_OBJECT(current)->type != OBJ_ARRAY && AS_OBJECT(current)->type != OBJ_MAP))
+            return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "invalid array access"));
+
+        Object* container = AS_OBJECT(current);
+        size_t taken = index_levels_taken(container, count - level);
+
+        target->container = container;
+        target->count = taken;
+        target->key = NIL_VALUE();
+
+        if (container->type == OBJ_MAP) {
+            target->key = levels[level];
+        } else {
+            for (size_t i = 0; i < taken; i++) {
+                if (!IS_INT(levels[level + i]))
+                    return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "invalid array index"));
+
+                target->indices[i] = AS_INT(levels[level + i]);
+            }
+        }
+
+        level += taken;
+        if (level == count)
+            return NIL_VALUE();
+
+        if (container->type == OBJ_MAP) {
+            if (!map_object_get(container->object, target->key, &current))
+                return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "invalid map access"));
+        } else {
+            current = array_object_get_index(container->object, target->indices, taken);
+            if (IS_OBJECT(current) && AS_OBJECT(current)->type == OBJ_ERROR)
+                return current;
+        }
+    }
+
+    return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "invalid array access"));
 }
 
 Callable* callable_new(Object* functionObject,
-    Object* (*function)(struct Interpreter*, FunctionObject*, List*),
+    Value (*function)(struct Interpreter*, FunctionObject*, Value*, size_t),
     void (*to_string)(ByteBuffer*, void**),
     void (*destroy)(void**))
 {
     Callable* new_callable = NULL;
-    new_callable = safe_malloc(sizeof(Callable), NULL);
+    new_callable = smem_alloc(sizeof(Callable));
     if (new_callable == NULL) {
         if (destroy != NULL) {
             destroy((void**) &functionObject);
@@ -917,23 +1529,23 @@ Callable* callable_new(Object* functionObject,
     return new_callable;
 }
 
-Object* callable_run(Interpreter* interpreter, Object* callable, List* arguments) {
-    if (interpreter == NULL || callable == NULL || arguments == NULL)
-        return NEW_ERROR_OBJECT(RUNTIME_ERROR, "callable_run: cannot execute callable function");
+Value callable_run(Interpreter* interpreter, Object* callable, Value* arguments, size_t argc) {
+    if (interpreter == NULL || callable == NULL || (arguments == NULL && argc > 0))
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "callable_run: cannot execute callable function"));
 
     if (callable->type != OBJ_CALLABLE)
-        return NEW_ERROR_OBJECT(RUNTIME_ERROR, "callable_run: cannot execute callable function");
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "callable_run: cannot execute callable function"));
 
     Callable* callableObject = callable->object;
 
     if (callableObject->functionObject != NULL && callableObject->functionObject->type != OBJ_FUNCTION)
-        return NEW_ERROR_OBJECT(RUNTIME_ERROR, "callable_run: cannot execute callable function");
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "callable_run: cannot execute callable function"));
 
     FunctionObject* functionObject = NULL;
     if (callableObject->functionObject != NULL)
         functionObject = callableObject->functionObject->object;
 
-    Object* result = callableObject->function(interpreter, functionObject, arguments);
+    Value result = callableObject->function(interpreter, functionObject, arguments, argc);
 
     return result;
 }
@@ -953,113 +1565,548 @@ void callable_free(Callable** callable) {
         (*callable)->destroy((void**) &(*callable)->functionObject);
     }
 
-    safe_free((void**) callable);
+    smem_free((void**) callable, sizeof(Callable));
 }
 
-Object* print_function_run(Interpreter* interpreter, FunctionObject* functionObject, List* arguments) {
-    if (arguments == NULL)
-        return NEW_ERROR_OBJECT(RUNTIME_ERROR, "print_function_run: invalid arguments");
+/* renders straight into the process output, nothing is copied out first */
+static bool print_arguments(Value* arguments, size_t argc, bool newline) {
+    ByteBuffer* out = output_buffer();
+    if (out == NULL)
+        return false;
 
-    ByteBuffer* bb = byte_buffer_new();
-    char* str = NULL;
+    size_t mark = byte_buffer_size(out);
 
-    list_foreach(argument, arguments) {
-        Object* obj = argument->value;
+    for (size_t i = 0; i < argc; i++) {
+        value_to_string(out, arguments[i]);
+    }
 
-        object_to_string(bb, &obj);
+    if (newline) {
+        byte_buffer_append(out, "\n", 1);
     }
 
-    str = byte_buffer_to_string(bb);
+    output_commit(mark);
+
+    return true;
+}
 
-    printf("%s", str);
+Value print_function_run(Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    (void) interpreter;
+    (void) functionObject;
 
-    safe_free((void**) &str);
+    if (arguments == NULL && argc > 0)
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "print_function_run: invalid arguments"));
 
-    byte_buffer_free(&bb);
+    if (!print_arguments(arguments, argc, false))
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "print_function_run: output unavailable"));
 
-    return NULL;
+    return NIL_VALUE();
 }
 
-Object* println_function_run(Interpreter* interpreter, FunctionObject* functionObject, List* arguments) {
-    if (arguments == NULL)
-        return NEW_ERROR_OBJECT(RUNTIME_ERROR, "print_function_run: invalid arguments");
+Value println_function_run(Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    (void) interpreter;
+    (void) functionObject;
 
-    ByteBuffer* bb = byte_buffer_new();
-    char* str = NULL;
+    if (arguments == NULL && argc > 0)
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "print_function_run: invalid arguments"));
 
-    list_foreach(argument, arguments) {
-        Object* obj = argument->value;
+    if (!print_arguments(arguments, argc, true))
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "print_function_run: output unavailable"));
 
-        object_to_string(bb, &obj);
-    }
+    return NIL_VALUE();
+}
 
-    str = byte_buffer_to_string(bb);
+Value flush_function_run(Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    (void) interpreter;
+    (void) functionObject;
+    (void) arguments;
 
-    printf("%s\n", str);
+    if (argc > 0)
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "flush_function_run: invalid arguments"));
 
-    safe_free((void**) &str);
+    output_flush();
 
-    byte_buffer_free(&bb);
+    return NIL_VALUE();
+}
 
-    return NULL;
+Value input_function_run(Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    (void) interpreter;
+    (void) functionObject;
+
+    if (arguments == NULL && argc > 0)
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "input_function_run: invalid arguments"));
+
+    /* the prompt and everything printed before it must be visible before blocking on stdin */
+    print_arguments(arguments, argc, false);
+    output_flush();
+
+    /* shares the stdin reader with has_line() and next_line() */
+    const char* line = NULL;
+    size_t length = 0;
+
+    if (!reader_next_line(reader_stdin(), &line, &length))
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "input_function_run: error while trying to read from stdin"));
+
+    return OBJECT_VALUE(NEW_STRING_OBJECT_WITH_LENGTH(line, length));
 }
 
-Object* input_function_run(Interpreter* interpreter, FunctionObject* functionObject, List* arguments) {
-    if (arguments == NULL)
-        return NEW_ERROR_OBJECT(RUNTIME_ERROR, "input_function_run: invalid arguments");
+static const char* path_argument(Value* arguments, size_t argc) {
+    if (arguments == NULL || argc != 1 || !IS_OBJECT(arguments[0]) || AS_OBJECT(arguments[0])->type != OBJ_STRING)
+        return NULL;
+
+    return ((StringObject*) AS_OBJECT(arguments[0])->object)->value;
+}
 
+static Value reader_error(const char* name, const char* reason, const char* path) {
     ByteBuffer* bb = byte_buffer_new();
-    char* str = NULL;
+    byte_buffer_appendf(bb, "%s_function_run: %s", name, reason);
+    if (path != NULL) {
+        byte_buffer_appendf(bb, " '%s'", path);
+    }
+    char* message = byte_buffer_to_string(bb);
+    byte_buffer_free(&bb);
 
-    list_foreach(argument, arguments) {
-        Object* obj = argument->value;
+    Object* error = NEW_ERROR_OBJECT(RUNTIME_ERROR, message);
+    safe_free((void**) &message);
 
-        object_to_string(bb, &obj);
-    }
+    return OBJECT_VALUE(error);
+}
 
-    str = byte_buffer_to_string(bb);
+Value read_all_function_run(Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    (void) interpreter;
+    (void) functionObject;
 
-    printf("%s", str);
+    const char* path = path_argument(arguments, argc);
+    if (path == NULL)
+        return reader_error("read_all", "invalid argument", NULL);
 
-    safe_free((void**) &str);
+    Reader* reader = reader_open(path);
+    if (reader == NULL)
+        return reader_error("read_all", "cannot open", path);
 
-    byte_buffer_free(&bb);
+    const char* data = NULL;
+    size_t length = 0;
+    reader_rest(reader, &data, &length);
 
-    char* input = NULL;
-    size_t size = 0;
-    ssize_t read = getline(&input, &size, stdin);
+    Object* result = NEW_STRING_OBJECT_WITH_LENGTH(data, length);
 
-    if (read == -1) {
-        return NEW_ERROR_OBJECT(RUNTIME_ERROR, "input_function_run: error while trying to read from stdin");
-    }
+    reader_free(&reader);
+
+    return OBJECT_VALUE(result);
+}
+
+Value read_lines_function_run(Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    (void) interpreter;
+    (void) functionObject;
+
+    const char* path = path_argument(arguments, argc);
+    if (path == NULL)
+        return reader_error("read_lines", "invalid argument", NULL);
+
+    Reader* reader = reader_open(path);
+    if (reader == NULL)
+        return reader_error("read_lines", "cannot open", path);
+
+    size_t length = 0;
+    size_t capacity = 64;
+    Value* values = safe_malloc(capacity * sizeof(Value), NULL);
+
+    const char* line = NULL;
+    size_t lineLength = 0;
 
-    size_t len = strlen(input);
+    while (values != NULL && reader_next_line(reader, &line, &lineLength)) {
+        if (length == capacity) {
+            Value* grown = safe_realloc((void**) &values, capacity * 2 * sizeof(Value), NULL);
+            if (grown == NULL)
+                break;
 
-    if (len > 0 && input[len - 1] == '\n') {
-        input[len - 1] = '\0';
+            values = grown;
+            capacity *= 2;
+        }
+
+        values[length++] = OBJECT_VALUE(NEW_STRING_OBJECT_WITH_LENGTH(line, lineLength));
     }
 
-    Object* result = NEW_STRING_OBJECT(input);
-    safe_free((void**) &input);
+    reader_free(&reader);
 
-    return result;
+    if (values == NULL)
+        return reader_error("read_lines", "out of memory reading", path);
+
+    Type* arrayType = NEW_ARRAY_TYPE(NEW_STRING_TYPE());
+    ARRAY_TYPE_ADD_DIMENSION(arrayType, NEW_ARRAY_UNDEFINED_DIMENSION());
+
+    return OBJECT_VALUE(NEW_ARRAY_OBJECT(type_intern(arrayType), values, length));
+}
+
+/* no argument means stdin, a path keeps its file open between calls; NIL or an error */
+static Value line_reader(const char* name, Value* arguments, size_t argc, Reader** reader, const char** path) {
+    *path = argc == 0 ? NULL : path_argument(arguments, argc);
+
+    if (argc > 0 && *path == NULL)
+        return reader_error(name, "invalid argument", NULL);
+
+    *reader = reader_for(*path);
+    if (*reader == NULL)
+        return reader_error(name, "cannot open", *path != NULL ? *path : "stdin");
+
+    return NIL_VALUE();
+}
+
+Value has_line_function_run(Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    (void) interpreter;
+    (void) functionObject;
+
+    Reader* reader = NULL;
+    const char* path = NULL;
+
+    Value error = line_reader("has_line", arguments, argc, &reader, &path);
+    if (!IS_NIL(error))
+        return error;
+
+    if (reader_has_line(reader))
+        return BOOL_VALUE(true);
+
+    /* an exhausted file is closed, asking again starts it over */
+    reader_close(path);
+
+    return BOOL_VALUE(false);
+}
+
+Value next_line_function_run(Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    (void) interpreter;
+    (void) functionObject;
+
+    Reader* reader = NULL;
+    const char* path = NULL;
+
+    Value error = line_reader("next_line", arguments, argc, &reader, &path);
+    if (!IS_NIL(error))
+        return error;
+
+    const char* line = NULL;
+    size_t length = 0;
+
+    if (!reader_next_line(reader, &line, &length))
+        return reader_error("next_line", "no more lines in", path != NULL ? path : "stdin");
+
+    return OBJECT_VALUE(NEW_STRING_OBJECT_WITH_LENGTH(line, length));
 }
 
-Object* len_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, List* arguments) {
-    if (arguments == NULL || list_size(&arguments) != 1)
-        return NEW_ERROR_OBJECT(RUNTIME_ERROR, "len_function_run: invalid arguments");
+Value len_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    (void) interpreter;
+    (void) functionObject;
+
+    if (arguments == NULL || argc != 1)
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "len_function_run: invalid arguments"));
 
-    Object* argument = list_get_at(&arguments, 0);
+    Object* argument = IS_OBJECT(arguments[0]) ? AS_OBJECT(arguments[0]) : NULL;
+
+    if (argument == NULL) {
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "len_function_run: invalid argument"));
+    }
 
     if (argument->type == OBJ_STRING) {
         StringObject* strObj = argument->object;
-        return NEW_INTEGER_OBJECT(strlen(strObj->value));
+        return INT_VALUE(strlen(strObj->value));
     }
 
     if (argument->type == OBJ_ARRAY) {
         ArrayObject* arrObj = argument->object;
-        return NEW_INTEGER_OBJECT(list_size(&arrObj->objects));
+        return INT_VALUE(array_object_get_length(arrObj));
+    }
+
+    if (argument->type == OBJ_MAP) {
+        MapObject* mapObj = argument->object;
+        return INT_VALUE(map_object_get_length(mapObj));
+    }
+
+    return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "len_function_run: invalid argument"));
+}
+
+static ArrayObject* array_argument(Value value) {
+    if (!IS_OBJECT(value) || AS_OBJECT(value)->type != OBJ_ARRAY)
+        return NULL;
+
+    return AS_OBJECT(value)->object;
+}
+
+Value push_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    (void) interpreter;
+    (void) functionObject;
+
+    if (arguments == NULL || argc != 2)
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "push_function_run: invalid arguments"));
+
+    ArrayObject* array = array_argument(arguments[0]);
+
+    if (array == NULL || array->rank > 1) {
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "push_function_run: invalid argument"));
+    }
+
+    if (!array_object_push(array, arguments[1])) {
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "push_function_run: out of memory"));
     }
 
-    return NEW_ERROR_OBJECT(RUNTIME_ERROR, "len_function_run: invalid argument");
+    gc_resize(AS_OBJECT(arguments[0]));
+
+    return NIL_VALUE();
+}
+
+Value pop_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    (void) interpreter;
+    (void) functionObject;
+
+    if (arguments == NULL || argc != 1)
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "pop_function_run: invalid arguments"));
+
+    ArrayObject* array = array_argument(arguments[0]);
+
+    if (array == NULL) {
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "pop_function_run: invalid argument"));
+    }
+
+    return array_object_pop(array);
+}
+
+Value reserve_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    (void) interpreter;
+    (void) functionObject;
+
+    if (arguments == NULL || argc != 2)
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "reserve_function_run: invalid arguments"));
+
+    ArrayObject* array = array_argument(arguments[0]);
+
+    if (array == NULL || array->rank > 1 || !IS_INT(arguments[1]) || AS_INT(arguments[1]) < 0) {
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "reserve_function_run: invalid argument"));
+    }
+
+    if (!array_object_reserve(array, AS_INT(arguments[1]))) {
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "reserve_function_run: out of memory"));
+    }
+
+    gc_resize(AS_OBJECT(arguments[0]));
+
+    return NIL_VALUE();
+}
+
+static ArrayObject* matrix_argument(Value value) {
+    ArrayObject* array = array_argument(value);
+
+    if (array == NULL || (array->storage != ARRAY_INTS && array->storage != ARRAY_FLOATS))
+        return NULL;
+
+    return array;
+}
+
+static Type* matrix_type(ArrayObject* like, size_t rows, size_t cols) {
+    Type* type = NEW_ARRAY_TYPE(type_copy((const Type**) &((ArrayType*) like->type->type)->type));
+
+    ARRAY_TYPE_ADD_DIMENSION(type, NEW_ARRAY_DIMENSION(rows));
+    ARRAY_TYPE_ADD_DIMENSION(type, NEW_ARRAY_DIMENSION(cols));
+
+    return type_intern(type);
+}
+
+Value matmul_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    (void) interpreter;
+    (void) functionObject;
+
+    if (arguments == NULL || argc != 2)
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "matmul_function_run: invalid arguments"));
+
+    ArrayObject* left = matrix_argument(arguments[0]);
+    ArrayObject* right = matrix_argument(arguments[1]);
+
+    if (left == NULL || right == NULL || left->rank != 2 || right->rank != 2
+        || left->storage != right->storage || left->shape[1] != right->shape[0]) {
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "matmul_function_run: invalid argument"));
+    }
+
+    size_t n = left->shape[0];
+    size_t k = left->shape[1];
+    size_t m = right->shape[1];
+
+    Object* result = NEW_ARRAY_OBJECT(matrix_type(left, n, m), NULL, 0);
+    ArrayObject* product = result->object;
+
+    if (left->storage == ARRAY_INTS) {
+        matrix_multiply_int(left->ints, right->ints, product->ints, n, k, m);
+    } else {
+        matrix_multiply_float(left->floats, right->floats, product->floats, n, k, m);
+    }
+
+    return OBJECT_VALUE(result);
+}
+
+Value transpose_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    (void) interpreter;
+    (void) functionObject;
+
+    if (arguments == NULL || argc != 1)
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "transpose_function_run: invalid arguments"));
+
+    ArrayObject* matrix = matrix_argument(arguments[0]);
+
+    if (matrix == NULL || matrix->rank != 2) {
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "transpose_function_run: invalid argument"));
+    }
+
+    size_t rows = matrix->shape[0];
+    size_t cols = matrix->shape[1];
+
+    Object* result = NEW_ARRAY_OBJECT(matrix_type(matrix, cols, rows), NULL, 0);
+    ArrayObject* transposed = result->object;
+
+    matrix_transpose(matrix->elements, transposed->elements, rows, cols, array_element_size(matrix->storage));
+
+    return OBJECT_VALUE(result);
+}
+
+static Value elementwise_run(MatrixOperation operation, const char* name, Value* arguments, size_t argc) {
+    bool valid = arguments != NULL && argc == 2;
+
+    ArrayObject* left = valid ? matrix_argument(arguments[0]) : NULL;
+    ArrayObject* right = valid ? matrix_argument(arguments[1]) : NULL;
+
+    if (left == NULL || right == NULL || left->storage != right->storage
+        || left->rank != right->rank || left->length != right->length) {
+        ByteBuffer* bb = byte_buffer_new();
+        byte_buffer_appendf(bb, "%s_function_run: invalid argument", name);
+        char* message = byte_buffer_to_string(bb);
+        byte_buffer_free(&bb);
+
+        Object* error = NEW_ERROR_OBJECT(RUNTIME_ERROR, message);
+        safe_free((void**) &message);
+
+        return OBJECT_VALUE(error);
+    }
+
+    Object* result = NEW_ARRAY_OBJECT(type_copy((const Type**) &left->type), NULL, 0);
+    ArrayObject* array = result->object;
+
+    if (array->rank == 1 && left->length > 0) {
+        array_object_reserve(array, left->length);
+        array->length = left->length;
+    }
+
+    if (left->storage == ARRAY_INTS) {
+        matrix_elementwise_int(operation, left->ints, right->ints, array->ints, left->length);
+    } else {
+        matrix_elementwise_float(operation, left->floats, right->floats, array->floats, left->length);
+    }
+
+    return OBJECT_VALUE(result);
+}
+
+Value matadd_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    (void) interpreter;
+    (void) functionObject;
+
+    return elementwise_run(MATRIX_ADD, "matadd", arguments, argc);
+}
+
+Value matsub_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    (void) interpreter;
+    (void) functionObject;
+
+    return elementwise_run(MATRIX_SUB, "matsub", arguments, argc);
+}
+
+Value hadamard_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    (void) interpreter;
+    (void) functionObject;
+
+    return elementwise_run(MATRIX_MUL, "hadamard", arguments, argc);
+}
+
+static MapObject* map_argument(Value value) {
+    if (!IS_OBJECT(value) || AS_OBJECT(value)->type != OBJ_MAP)
+        return NULL;
+
+    return AS_OBJECT(value)->object;
+}
+
+Value delete_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    (void) interpreter;
+    (void) functionObject;
+
+    if (arguments == NULL || argc != 2)
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "delete_function_run: invalid arguments"));
+
+    MapObject* map = map_argument(arguments[0]);
+
+    if (map == NULL) {
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "delete_function_run: invalid argument"));
+    }
+
+    map_object_delete(map, arguments[1]);
+
+    gc_resize(AS_OBJECT(arguments[0]));
+
+    return NIL_VALUE();
+}
+
+Value has_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    (void) interpreter;
+    (void) functionObject;
+
+    if (arguments == NULL || argc != 2)
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "has_function_run: invalid arguments"));
+
+    MapObject* map = map_argument(arguments[0]);
+
+    if (map == NULL) {
+        return OBJECT_VALUE(NEW_ERROR_OBJECT(RUNTIME_ERROR, "has_function_run: invalid argument"));
+    }
+
+    return BOOL_VALUE(map_contains(map->entries, &arguments[1]));
+}
+
+/* copies the keys or the values out in slot order, the same order for both */
+static Value entries_run(const char* name, bool ofKeys, Value* arguments, size_t argc) {
+    MapObject* map = arguments != NULL && argc == 1 ? map_argument(arguments[0]) : NULL;
+
+    if (map == NULL) {
+        ByteBuffer* bb = byte_buffer_new();
+        byte_buffer_appendf(bb, "%s_function_run: invalid argument", name);
+        char* message = byte_buffer_to_string(bb);
+        byte_buffer_free(&bb);
+
+        Object* error = NEW_ERROR_OBJECT(RUNTIME_ERROR, message);
+        safe_free((void**) &message);
+
+        return OBJECT_VALUE(error);
+    }
+
+    MapType* mapType = map->type->type;
+
+    Type* arrayType = NEW_ARRAY_TYPE(type_copy((const Type**) (ofKeys ? &mapType->key : &mapType->value)));
+    ARRAY_TYPE_ADD_DIMENSION(arrayType, NEW_ARRAY_UNDEFINED_DIMENSION());
+
+    size_t length = map_size(map->entries);
+    Value* values = safe_malloc((length > 0 ? length : 1) * sizeof(Value), NULL);
+    size_t index = 0;
+
+    MapIterator iterator = { .map = map->entries, .index = 0 };
+
+    while (map_iterator_has_next(&iterator)) {
+        MapEntry* entry = map_iterator_next(&iterator);
+        values[index++] = *(Value*) (ofKeys ? entry->key : entry->value);
+    }
+
+    return OBJECT_VALUE(NEW_ARRAY_OBJECT(type_intern(arrayType), values, length));
+}
+
+Value keys_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    (void) interpreter;
+    (void) functionObject;
+
+    return entries_run("keys", true, arguments, argc);
+}
+
+Value values_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc) {
+    (void) interpreter;
+    (void) functionObject;
+
+    return entries_run("values", false, arguments, argc);
 }
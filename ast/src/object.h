@@ -5,10 +5,15 @@
 #include "context.h"
 #include "interpreter.h"
 #include "list.h"
+#include "map.h"
 #include "types.h"
+#include "value.h"
 #include <stddef.h>
+#include <stdint.h>
 
 
+struct Interpreter;
+
 typedef enum ObjectType {
     OBJ_ERROR,
 
@@ -27,6 +32,7 @@ typedef enum ObjectType {
     OBJ_FUNCTION,
     OBJ_STRUCT,
     OBJ_ARRAY,
+    OBJ_MAP,
 
     OBJ_IDENT,
     OBJ_CALLABLE
@@ -40,6 +46,9 @@ typedef struct Object {
     bool (*equals)(void*, void*);
     void (*to_string)(ByteBuffer*, void**);
     void (*destroy)(void**);
+    struct Object* next; /* heap list, see gc.h */
+    size_t size;
+    unsigned int mark;
 } Object;
 
 Object* object_new(ObjectType type, void* object,
@@ -86,10 +95,10 @@ void ident_object_free(IdentObject** identObject);
 
 typedef struct IntegerObject {
     Type* type;
-    int value;
+    int64_t value;
 } IntegerObject;
 
-IntegerObject* integer_object_new(Type* type, int value);
+IntegerObject* integer_object_new(Type* type, int64_t value);
 Type* integer_object_get_type(IntegerObject* integerObject);
 IntegerObject* integer_object_copy(IntegerObject* self);
 bool integer_object_equals(IntegerObject* self, Object* other);
@@ -126,6 +135,8 @@ typedef struct StringObject {
 } StringObject;
 
 StringObject* string_object_new(Type* type, char* value);
+/* copies length bytes of value, which need not be terminated */
+StringObject* string_object_new_with_length(Type* type, const char* value, size_t length);
 Type* string_object_get_type(StringObject* stringObject);
 StringObject* string_object_copy(StringObject* self);
 bool string_object_equals(StringObject* self, Object* other);
@@ -186,48 +197,139 @@ typedef struct FunctionObject {
     Context* env;
     List* parameters;
     Stmt* body;
+    ScopeLayout frame; /* opened for the parameters on every call */
 } FunctionObject;
 
-FunctionObject* function_object_new(Type* type, Context* env, List* parameters, Stmt* body);
+FunctionObject* function_object_new(Type* type, Context* env, List* parameters, Stmt* body, ScopeLayout frame);
 Type* function_object_get_type(FunctionObject* self);
 bool function_object_equals(FunctionObject* self, Object* other);
 void function_object_to_string(ByteBuffer* byteBuffer, FunctionObject** functionObject);
 void function_object_free(FunctionObject** functionObject);
-Object* function_object_run(struct Interpreter* interpreter, FunctionObject* functionObject, List* arguments);
-
+Value function_object_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
+
+typedef enum ArrayStorage {
+    ARRAY_VALUES, /* boxed values, the only storage the collector traces */
+    ARRAY_INTS,
+    ARRAY_FLOATS,
+    ARRAY_CHARS,
+    ARRAY_BOOLS
+} ArrayStorage;
+
+#define ARRAY_MAX_RANK 32
+
+/*
+ * Elements live in one growable buffer. One dimensional arrays of int,
+ * float, char and bool keep them unboxed, everything else keeps Values.
+ * Fixed-shape arrays of those scalars with more than one dimension are
+ * dense: a single row-major block addressed through shape and strides,
+ * so m[i][j] is one offset calculation instead of a walk through rows.
+ */
 typedef struct ArrayObject {
     Type* type;
-    List* objects;
+    ArrayStorage storage;
+    union {
+        void* elements;
+        Value* values;
+        int64_t* ints;
+        double* floats;
+        char* chars;
+        bool* bools;
+    };
+    size_t length;   /* stored elements, every cell of a dense array */
+    size_t capacity;
+    size_t rank;     /* 1 unless the array is dense */
+    size_t* shape;   /* dense arrays only, rank extents followed by rank strides */
+    size_t* strides;
 } ArrayObject;
 
-ArrayObject* array_object_new(Type* type, List* objects);
+ArrayObject* array_object_new(Type* type, Value* values, size_t length);
 Type* array_object_get_type(ArrayObject* self);
 bool array_object_equals(ArrayObject* self, Object* other);
 void array_object_to_string(ByteBuffer* byteBuffer, ArrayObject** arrayObject);
 void array_object_free(ArrayObject** arrayObject);
 
 size_t array_object_get_dimensions(ArrayObject* self);
-
-Object* array_object_get_object_at(ArrayObject* self, int index);
-
-#define NEW_FUNCTION_OBJECT(function_type, env, parameters, body)              \
-    object_new(OBJ_FUNCTION,                                                   \
-            function_object_new((function_type), (env), (parameters), (body)), \
+size_t array_object_get_size(ArrayObject* self);
+size_t array_object_get_length(ArrayObject* self);
+
+Value array_object_get_at(ArrayObject* self, int64_t index);
+void array_object_set_at(ArrayObject* self, int64_t index, Value value);
+
+Value array_object_get_index(ArrayObject* self, const int64_t* indices, size_t count);
+Value array_object_set_index(ArrayObject* self, const int64_t* indices, size_t count, Value value);
+
+bool array_object_reserve(ArrayObject* self, size_t capacity);
+bool array_object_push(ArrayObject* self, Value value);
+Value array_object_pop(ArrayObject* self);
+
+/*
+ * Entries live in a Map from boxed key to boxed value, each pair in one
+ * allocation. Keys are ints, chars, strings or bools and hash through
+ * value_hash, strings by their characters. A missing key reads as the zero
+ * value of the map's value type.
+ */
+typedef struct MapObject {
+    Type* type;
+    Map* entries;
+} MapObject;
+
+MapObject* map_object_new(Type* type, size_t capacity);
+Type* map_object_get_type(MapObject* self);
+bool map_object_equals(MapObject* self, Object* other);
+void map_object_to_string(ByteBuffer* byteBuffer, MapObject** mapObject);
+void map_object_free(MapObject** mapObject);
+
+size_t map_object_get_size(MapObject* self);
+size_t map_object_get_length(MapObject* self);
+
+bool map_object_get(MapObject* self, Value key, Value* value);
+Value map_object_zero(MapObject* self);
+bool map_object_set(MapObject* self, Value key, Value value);
+bool map_object_delete(MapObject* self, Value key);
+
+/*
+ * Where a chain of indices lands once every level before the last
+ * container's has been applied, so m["a"][1] reaches the array under "a".
+ * A map takes one level, its key, a dense array up to its rank and any
+ * other array one index. A key missing midway is an error, only the last
+ * level reads as a zero value.
+ */
+typedef struct IndexTarget {
+    Object* container;
+    int64_t indices[ARRAY_MAX_RANK]; /* arrays */
+    size_t count;
+    Value key;                       /* maps */
+} IndexTarget;
+
+Value index_target_resolve(IndexTarget* target, Value object, const Value* levels, size_t count);
+
+#define NEW_FUNCTION_OBJECT(function_type, env, parameters, body, frame)                \
+    object_new(OBJ_FUNCTION,                                                             \
+            function_object_new((function_type), (env), (parameters), (body), (frame)), \
         (Type* (*)(void*)) function_object_get_type,                           \
         (void* (*)(void*)) NULL,                                               \
         (bool (*)(void*, void*)) function_object_equals,                       \
         (void (*)(ByteBuffer*, void **)) function_object_to_string,            \
         (void (*)(void **)) function_object_free)
 
-#define NEW_ARRAY_OBJECT(array_type, objects)                                  \
+#define NEW_ARRAY_OBJECT(array_type, values, length)                          \
     object_new(OBJ_ARRAY,                                                      \
-            array_object_new((array_type), (objects)),                         \
+            array_object_new((array_type), (values), (length)),                \
         (Type* (*)(void*)) array_object_get_type,                              \
         (void* (*)(void*)) NULL,                                               \
         (bool (*)(void*, void*)) array_object_equals,                          \
         (void (*)(ByteBuffer*, void **)) array_object_to_string,               \
         (void (*)(void **)) array_object_free)
 
+#define NEW_MAP_OBJECT(map_type, capacity)                                     \
+    object_new(OBJ_MAP,                                                        \
+            map_object_new((map_type), (capacity)),                            \
+        (Type* (*)(void*)) map_object_get_type,                                \
+        (void* (*)(void*)) NULL,                                               \
+        (bool (*)(void*, void*)) map_object_equals,                            \
+        (void (*)(ByteBuffer*, void **)) map_object_to_string,                 \
+        (void (*)(void **)) map_object_free)
+
 #define NEW_ERROR_OBJECT(error_type, message)                                  \
     object_new(OBJ_ERROR, error_new((error_type), (message)),                  \
         (Type* (*)(void*)) NULL,                                               \
@@ -276,6 +378,15 @@ Object* array_object_get_object_at(ArrayObject* self, int index);
         (void (*)(ByteBuffer*, void**)) string_object_to_string,               \
         (void (*)(void**)) string_object_free)
 
+#define NEW_STRING_OBJECT_WITH_LENGTH(value, length)                           \
+    object_new(OBJ_STRING,                                                     \
+            string_object_new_with_length((NEW_STRING_TYPE()), (value), (length)), \
+        (Type* (*)(void*)) string_object_get_type,                             \
+        (void* (*)(void*)) string_object_copy,                                 \
+        (bool (*)(void*, void*)) string_object_equals,                         \
+        (void (*)(ByteBuffer*, void**)) string_object_to_string,               \
+        (void (*)(void**)) string_object_free)
+
 #define NEW_BOOLEAN_OBJECT(value)                                              \
     object_new(OBJ_BOOLEAN, boolean_object_new((NEW_BOOL_TYPE()), (value)),    \
         (Type* (*)(void*)) boolean_object_get_type,                            \
@@ -319,24 +430,41 @@ Object* array_object_get_object_at(ArrayObject* self, int index);
 
 typedef struct Callable {
     Object* functionObject;
-    Object* (*function)(struct Interpreter*, FunctionObject*, List*);
+    Value (*function)(struct Interpreter*, FunctionObject*, Value*, size_t);
     void (*to_string)(ByteBuffer*, void**);
     void (*destroy)(void**);
 } Callable;
 
 Callable* callable_new(
     Object* functionObject,
-    Object* (*function)(struct Interpreter*, FunctionObject*, List*),
+    Value (*function)(struct Interpreter*, FunctionObject*, Value*, size_t),
     void (*to_string)(ByteBuffer*, void**),
     void (*destroy)(void**));
-Object* callable_run(struct Interpreter* interpreter, Object* callable, List* arguments);
+Value callable_run(struct Interpreter* interpreter, Object* callable, Value* arguments, size_t argc);
 void callable_to_string(ByteBuffer* byteBuffer, Callable** callable);
 void callable_free(Callable** callable);
 
-Object* print_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, List* arguments);
-Object* println_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, List* arguments);
-Object* input_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, List* arguments);
-Object* len_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, List* arguments);
+Value print_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
+Value println_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
+Value input_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
+Value flush_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
+Value read_all_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
+Value read_lines_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
+Value has_line_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
+Value next_line_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
+Value len_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
+Value push_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
+Value pop_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
+Value reserve_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
+Value matmul_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
+Value transpose_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
+Value matadd_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
+Value matsub_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
+Value hadamard_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
+Value delete_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
+Value has_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
+Value keys_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
+Value values_function_run(struct Interpreter* interpreter, FunctionObject* functionObject, Value* arguments, size_t argc);
 
 #define NEW_CALLABLE(func_obj, func_executer, func_obj_to_str, func_obj_free)  \
     callable_new(                                                              \
@@ -402,13 +530,140 @@ Object* len_function_run(struct Interpreter* interpreter, FunctionObject* functi
         (void (*)(ByteBuffer*, void **)) callable_to_string,                   \
         (void (*)(void **)) callable_free)
 
+#define NEW_PUSH_FUNC()                                                        \
+    object_new(OBJ_CALLABLE,                                                   \
+            NEW_CALLABLE(                                                      \
+                NULL,                                                          \
+                push_function_run,                                             \
+                NULL,                                                          \
+                NULL                                                           \
+            ),                                                                 \
+        (Type* (*)(void*)) NULL,                                               \
+        (void* (*)(void*)) NULL,                                               \
+        (bool (*)(void*, void*)) NULL,                                         \
+        (void (*)(ByteBuffer*, void **)) callable_to_string,                   \
+        (void (*)(void **)) callable_free)
+
+#define NEW_POP_FUNC()                                                         \
+    object_new(OBJ_CALLABLE,                                                   \
+            NEW_CALLABLE(                                                      \
+                NULL,                                                          \
+                pop_function_run,                                              \
+                NULL,                                                          \
+                NULL                                                           \
+            ),                                                                 \
+        (Type* (*)(void*)) NULL,                                               \
+        (void* (*)(void*)) NULL,                                               \
+        (bool (*)(void*, void*)) NULL,                                         \
+        (void (*)(ByteBuffer*, void **)) callable_to_string,                   \
+        (void (*)(void **)) callable_free)
+
+#define NEW_RESERVE_FUNC()                                                     \
+    object_new(OBJ_CALLABLE,                                                   \
+            NEW_CALLABLE(                                                      \
+                NULL,                                                          \
+                reserve_function_run,                                          \
+                NULL,                                                          \
+                NULL                                                           \
+            ),                                                                 \
+        (Type* (*)(void*)) NULL,                                               \
+        (void* (*)(void*)) NULL,                                               \
+        (bool (*)(void*, void*)) NULL,                                         \
+        (void (*)(ByteBuffer*, void **)) callable_to_string,                   \
+        (void (*)(void **)) callable_free)
+
+#define NEW_MATMUL_FUNC()                                                      \
+    object_new(OBJ_CALLABLE,                                                   \
+            NEW_CALLABLE(                                                      \
+                NULL,                                                          \
+                matmul_function_run,                                           \
+                NULL,                                                          \
+                NULL                                                           \
+            ),                                                                 \
+        (Type* (*)(void*)) NULL,                                               \
+        (void* (*)(void*)) NULL,                                               \
+        (bool (*)(void*, void*)) NULL,                                         \
+        (void (*)(ByteBuffer*, void **)) callable_to_string,                   \
+        (void (*)(void **)) callable_free)
+
+#define NEW_TRANSPOSE_FUNC()                                                   \
+    object_new(OBJ_CALLABLE,                                                   \
+            NEW_CALLABLE(                                                      \
+                NULL,                                                          \
+                transpose_function_run,                                        \
+                NULL,                                                          \
+                NULL                                                           \
+            ),                                                                 \
+        (Type* (*)(void*)) NULL,                                               \
+        (void* (*)(void*)) NULL,                                               \
+        (bool (*)(void*, void*)) NULL,                                         \
+        (void (*)(ByteBuffer*, void **)) callable_to_string,                   \
+        (void (*)(void **)) callable_free)
+
+#define NEW_MATADD_FUNC()                                                      \
+    object_new(OBJ_CALLABLE,                                                   \
+            NEW_CALLABLE(                                                      \
+                NULL,                                                          \
+                matadd_function_run,                                           \
+                NULL,                                                          \
+                NULL                                                           \
+            ),                                                                 \
+        (Type* (*)(void*)) NULL,                                               \
+        (void* (*)(void*)) NULL,                                               \
+        (bool (*)(void*, void*)) NULL,                                         \
+        (void (*)(ByteBuffer*, void **)) callable_to_string,                   \
+        (void (*)(void **)) callable_free)
+
+#define NEW_MATSUB_FUNC()                                                      \
+    object_new(OBJ_CALLABLE,                                                   \
+            NEW_CALLABLE(                                                      \
+                NULL,                                                          \
+                matsub_function_run,                                           \
+                NULL,                                                          \
+                NULL                                                           \
+            ),                                                                 \
+        (Type* (*)(void*)) NULL,                                               \
+        (void* (*)(void*)) NULL,                                               \
+        (bool (*)(void*, void*)) NULL,                                         \
+        (void (*)(ByteBuffer*, void **)) callable_to_string,                   \
+        (void (*)(void **)) callable_free)
+
+#define NEW_HADAMARD_FUNC()                                                    \
+    object_new(OBJ_CALLABLE,                                                   \
+            NEW_CALLABLE(                                                      \
+                NULL,                                                          \
+                hadamard_function_run,                                         \
+                NULL,                                                          \
+                NULL                                                           \
+            ),                                                                 \
+        (Type* (*)(void*)) NULL,                                               \
+        (void* (*)(void*)) NULL,                                               \
+        (bool (*)(void*, void*)) NULL,                                         \
+        (void (*)(ByteBuffer*, void **)) callable_to_string,                   \
+        (void (*)(void **)) callable_free)
+
+/* a builtin with no state of its own, the map and numeric builtins register through it */
+#define NEW_NATIVE_FUNC(func_executer)                                         \
+    object_new(OBJ_CALLABLE,                                                   \
+            NEW_CALLABLE(                                                      \
+                NULL,                                                          \
+                (func_executer),                                               \
+                NULL,                                                          \
+                NULL                                                           \
+            ),                                                                 \
+        (Type* (*)(void*)) NULL,                                               \
+        (void* (*)(void*)) NULL,                                               \
+        (bool (*)(void*, void*)) NULL,                                         \
+        (void (*)(ByteBuffer*, void **)) callable_to_string,                   \
+        (void (*)(void **)) callable_free)
+
 #define NEW_CALLABLE_OBJECT(func_obj)                                          \
     object_new(OBJ_CALLABLE,                                                   \
             NEW_CALLABLE(                                                      \
                 (func_obj),                                                    \
                 function_object_run,                                           \
                 (void (*)(ByteBuffer*, void**)) function_object_to_string,     \
-                (void (*)(void **)) function_object_free                       \
+                NULL                                                           \
             ),                                                                 \
         (Type* (*)(void*)) NULL,                                               \
         (void* (*)(void*)) NULL,                                               \
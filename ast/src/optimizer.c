@@ -0,0 +1,1000 @@
+#include "optimizer.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "arena.h"
+#include "ast.h"
+#include "list.h"
+#include "literal-type.h"
+#include "map.h"
+#include "smem.h"
+#include "token.h"
+#include "value.h"
+
+
+#define GLOBAL_BUCKETS 1024
+#define LOCAL_BUCKETS  32
+
+/* bound to names that hide an outer constant */
+static _Thread_local int shadowed;
+
+static Decl* optimize_decl(Optimizer* optimizer, Decl* declaration);
+static Stmt* optimize_stmt(Optimizer* optimizer, Stmt* statement);
+static Expr* optimize_expr(Optimizer* optimizer, Expr* expression);
+
+static void scan_decl(Optimizer* optimizer, Decl* declaration);
+static void scan_stmt(Optimizer* optimizer, Stmt* statement);
+static void scan_expr(Optimizer* optimizer, Expr* expression);
+
+static void begin_scope(Optimizer* optimizer, size_t buckets) {
+    ConstantScope* scope = safe_malloc(sizeof(ConstantScope), NULL);
+    if (scope == NULL)
+        return;
+
+    *scope = (ConstantScope) {
+        .constants = SYMBOL_MAP_NEW(buckets, NULL),
+        .enclosing = optimizer->scope
+    };
+
+    optimizer->scope = scope;
+}
+
+static void end_scope(Optimizer* optimizer) {
+    ConstantScope* scope = optimizer->scope;
+    if (scope == NULL)
+        return;
+
+    optimizer->scope = scope->enclosing;
+
+    map_free(&scope->constants);
+    safe_free((void**) &scope);
+}
+
+/* binds name in the innermost scope, constant is NULL for anything that is not a literal */
+static void bind(Optimizer* optimizer, char* name, Expr* constant) {
+    if (optimizer->scope == NULL || name == NULL)
+        return;
+
+    map_put(optimizer->scope->constants, name, constant != NULL ? (void*) constant : (void*) &shadowed);
+}
+
+static Expr* lookup(Optimizer* optimizer, char* name) {
+    for (ConstantScope* scope = optimizer->scope; scope != NULL; scope = scope->enclosing) {
+        void* bound = map_get(scope->constants, name);
+        if (bound != NULL) {
+            return bound != (void*) &shadowed ? bound : NULL;
+        }
+    }
+
+    return NULL;
+}
+
+/* nodes built in an arena go away with it */
+static void discard_decl(Optimizer* optimizer, Decl* declaration) {
+    if (optimizer->arena == NULL)
+        decl_free(&declaration);
+}
+
+static void discard_stmt(Optimizer* optimizer, Stmt* statement) {
+    if (optimizer->arena == NULL)
+        stmt_free(&statement);
+}
+
+static void discard_expr(Optimizer* optimizer, Expr* expression) {
+    if (optimizer->arena == NULL)
+        expr_free(&expression);
+}
+
+static LiteralExpr* literal_of(Expr* expression) {
+    if (expression == NULL || expression->type != LITERAL_EXPR)
+        return NULL;
+
+    return expression->expr;
+}
+
+/* the value the interpreter would produce for a scalar literal, release it when done */
+static bool constant_value(Expr* expression, Value* value) {
+    LiteralExpr* literal = literal_of(expression);
+    if (literal == NULL)
+        return false;
+
+    switch (literal->type) {
+    case INT_LITERAL:
+        *value = INT_VALUE(((IntLiteral*) literal->value)->value);
+        return true;
+    case FLOAT_LITERAL:
+        *value = FLOAT_VALUE(((FloatLiteral*) literal->value)->value);
+        return true;
+    case CHAR_LITERAL:
+        *value = CHAR_VALUE(((CharLiteral*) literal->value)->value);
+        return true;
+    case BOOL_LITERAL:
+        *value = BOOL_VALUE(((BoolLiteral*) literal->value)->value);
+        return true;
+    case NIL_LITERAL:
+        *value = NIL_VALUE();
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool is_constant(Expr* expression) {
+    Value value;
+
+    if (constant_value(expression, &value)) {
+        value_release(value);
+        return true;
+    }
+
+    LiteralExpr* literal = literal_of(expression);
+
+    return literal != NULL && literal->type == STRING_LITERAL;
+}
+
+static bool constant_truthiness(Expr* expression, bool* truthy) {
+    Value value;
+
+    if (constant_value(expression, &value)) {
+        *truthy = value_is_truthy(value);
+        value_release(value);
+        return true;
+    }
+
+    /* strings are objects, and objects are always truthy */
+    LiteralExpr* literal = literal_of(expression);
+    if (literal != NULL && literal->type == STRING_LITERAL) {
+        *truthy = true;
+        return true;
+    }
+
+    return false;
+}
+
+static Expr* value_expr(Optimizer* optimizer, Value value) {
+    Arena* previous = arena_active();
+    arena_set_active(optimizer->arena);
+
+    Expr* expression = NULL;
+
+    switch (value_type(value)) {
+    case VAL_INT:
+        expression = NEW_INT_LITERAL(AS_INT(value));
+        break;
+    case VAL_FLOAT:
+        expression = NEW_FLOAT_LITERAL(AS_FLOAT(value));
+        break;
+    case VAL_CHAR:
+        expression = NEW_CHAR_LITERAL(AS_CHAR(value));
+        break;
+    case VAL_BOOL:
+        expression = NEW_BOOL_LITERAL(AS_BOOL(value));
+        break;
+    default:
+        expression = NEW_NIL_LITERAL();
+        break;
+    }
+
+    arena_set_active(previous);
+
+    return expression;
+}
+
+static Expr* copy_constant(Optimizer* optimizer, Expr* constant) {
+    Value value;
+
+    if (constant_value(constant, &value)) {
+        Expr* copy = value_expr(optimizer, value);
+        value_release(value);
+
+        return copy;
+    }
+
+    LiteralExpr* literal = literal_of(constant);
+
+    Arena* previous = arena_active();
+    arena_set_active(optimizer->arena);
+
+    /* built by hand, string_literal_new would strip quotes a second time */
+    StringLiteral* string = arena_active_alloc(sizeof(StringLiteral));
+    string->value = arena_active_str_dup(((StringLiteral*) literal->value)->value);
+
+    Expr* expression = NEW_LITERAL_EXPR(literal_expr_new(STRING_LITERAL, string,
+        (void (*)(void **)) string_literal_to_string,
+        (void (*)(void **)) string_literal_free));
+
+    arena_set_active(previous);
+
+    return expression;
+}
+
+/* the literal that replaces a folded expression, result is released once it is built */
+static Expr* folded_expr(Optimizer* optimizer, Expr* expression, Value result) {
+    discard_expr(optimizer, expression);
+
+    Expr* folded = value_expr(optimizer, result);
+    value_release(result);
+
+    return folded;
+}
+
+/* the engines' own operators, anything that would fail at runtime is left alone */
+static bool fold_binary(TokenType op, Value left, Value right, Value* result) {
+    return value_binary_op(op, left, right, result) == VALUE_OP_OK;
+}
+
+static bool fold_unary(TokenType op, Value right, Value* result) {
+    switch (op) {
+    case TOKEN_ADD:
+        *result = right;
+        return IS_NUMBER(right);
+    case TOKEN_SUB:
+        if (IS_INT(right)) {
+            *result = INT_VALUE(0u - (uint64_t) AS_INT(right));
+            return true;
+        }
+        *result = FLOAT_VALUE(-AS_FLOAT(right));
+        return IS_FLOAT(right);
+    case TOKEN_TILDE:
+        if (!IS_INT(right))
+            return false;
+        *result = INT_VALUE(~AS_INT(right));
+        return true;
+    case TOKEN_NOT:
+        *result = BOOL_VALUE(!value_is_truthy(right));
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool fold_cast(TypeID type, Value target, Value* result) {
+    if (IS_INT(target) && (type == INT_TYPE || type == FLOAT_TYPE)) {
+        *result = type == INT_TYPE ? target : FLOAT_VALUE(AS_INT(target));
+        return true;
+    }
+
+    if (IS_FLOAT(target) && (type == INT_TYPE || type == FLOAT_TYPE)) {
+        *result = type == FLOAT_TYPE ? target : INT_VALUE((int64_t) AS_FLOAT(target));
+        return true;
+    }
+
+    if (IS_CHAR(target) && (type == INT_TYPE || type == CHAR_TYPE)) {
+        *result = type == CHAR_TYPE ? target : INT_VALUE(AS_CHAR(target));
+        return true;
+    }
+
+    return false;
+}
+
+static void optimize_list(Optimizer* optimizer, List* expressions) {
+    if (expressions == NULL)
+        return;
+
+    list_foreach(node, expressions) {
+        node->value = optimize_expr(optimizer, node->value);
+    }
+}
+
+static void optimize_vector(Optimizer* optimizer, Vector* expressions) {
+    if (expressions == NULL)
+        return;
+
+    vector_foreach(item, expressions) {
+        *item = optimize_expr(optimizer, *item);
+    }
+}
+
+static void optimize_function(Optimizer* optimizer, List* parameters, Stmt** body) {
+    begin_scope(optimizer, LOCAL_BUCKETS);
+
+    list_foreach(parameter, parameters) {
+        FieldDecl* fieldDecl = ((Decl*) parameter->value)->decl;
+
+        bind(optimizer, fieldDecl->name->literal, NULL);
+    }
+
+    *body = optimize_stmt(optimizer, *body);
+
+    end_scope(optimizer);
+}
+
+static bool ends_flow(Decl* declaration) {
+    if (declaration->type != STMT_DECL)
+        return false;
+
+    Stmt* statement = ((StmtDecl*) declaration->decl)->stmt;
+
+    return statement != NULL && (statement->type == RETURN_STMT
+        || statement->type == BREAK_STMT || statement->type == CONTINUE_STMT);
+}
+
+/* keeps the surviving declarations in place and drops whatever follows a return, break or continue */
+static void optimize_block(Optimizer* optimizer, Vector* declarations) {
+    size_t kept = 0;
+    bool isUnreachable = false;
+
+    vector_foreach(item, declarations) {
+        Decl* declaration = *item;
+
+        Decl* optimized = isUnreachable ? NULL : optimize_decl(optimizer, declaration);
+
+        if (optimized == NULL) {
+            if (isUnreachable) {
+                discard_decl(optimizer, declaration);
+            }
+            continue;
+        }
+
+        declarations->items[kept++] = optimized;
+
+        isUnreachable = ends_flow(optimized);
+    }
+
+    vector_truncate(&declarations, kept);
+}
+
+static void optimize_program(Optimizer* optimizer, List* declarations) {
+    size_t index = 0;
+
+    ListNode* node = declarations->head;
+
+    while (node != NULL) {
+        ListNode* next = node->next;
+
+        Decl* optimized = optimize_decl(optimizer, node->value);
+
+        if (optimized == NULL) {
+            void* removed = NULL;
+            list_remove_at(&declarations, index, &removed);
+        } else {
+            node->value = optimized;
+            index++;
+        }
+
+        node = next;
+    }
+}
+
+/* returns NULL once the declaration is gone */
+static Decl* optimize_decl(Optimizer* optimizer, Decl* declaration) {
+    if (declaration == NULL)
+        return NULL;
+
+    switch (declaration->type) {
+    case LET_DECL: {
+        LetDecl* letDecl = declaration->decl;
+
+        letDecl->expression = optimize_expr(optimizer, letDecl->expression);
+        bind(optimizer, letDecl->name->literal, NULL);
+        break;
+    }
+    case CONST_DECL: {
+        ConstDecl* constDecl = declaration->decl;
+        char* name = constDecl->name->literal;
+
+        constDecl->expression = optimize_expr(optimizer, constDecl->expression);
+
+        bool isLiteral = is_constant(constDecl->expression) && map_get(optimizer->assigned, name) == NULL;
+        bind(optimizer, name, isLiteral ? constDecl->expression : NULL);
+        break;
+    }
+    case FUNC_DECL: {
+        FunctionDecl* functionDecl = declaration->decl;
+
+        bind(optimizer, functionDecl->name->literal, NULL);
+        optimize_function(optimizer, functionDecl->parameters, &functionDecl->body);
+        break;
+    }
+    case STMT_DECL: {
+        StmtDecl* stmtDecl = declaration->decl;
+
+        stmtDecl->stmt = optimize_stmt(optimizer, stmtDecl->stmt);
+        if (stmtDecl->stmt == NULL) {
+            discard_decl(optimizer, declaration);
+            return NULL;
+        }
+        break;
+    }
+    case FIELD_DECL:
+    case STRUCT_DECL:
+    default:
+        break;
+    }
+
+    return declaration;
+}
+
+/* returns the statement that takes its place, NULL when nothing is left */
+static Stmt* optimize_stmt(Optimizer* optimizer, Stmt* statement) {
+    if (statement == NULL)
+        return NULL;
+
+    switch (statement->type) {
+    case BLOCK_STMT: {
+        BlockStmt* blockStmt = statement->stmt;
+
+        begin_scope(optimizer, LOCAL_BUCKETS);
+        optimize_block(optimizer, blockStmt->declarations);
+        end_scope(optimizer);
+        break;
+    }
+    case EXPRESSION_STMT: {
+        ExpressionStmt* exprStmt = statement->stmt;
+
+        exprStmt->expression = optimize_expr(optimizer, exprStmt->expression);
+
+        /* a bare literal has no effect */
+        if (is_constant(exprStmt->expression)) {
+            discard_stmt(optimizer, statement);
+            return NULL;
+        }
+        break;
+    }
+    case RETURN_STMT: {
+        ReturnStmt* returnStmt = statement->stmt;
+
+        returnStmt->expression = optimize_expr(optimizer, returnStmt->expression);
+        break;
+    }
+    case IF_STMT: {
+        IfStmt* ifStmt = statement->stmt;
+
+        ifStmt->condition = optimize_expr(optimizer, ifStmt->condition);
+        ifStmt->thenBranch = optimize_stmt(optimizer, ifStmt->thenBranch);
+        ifStmt->elseBranch = optimize_stmt(optimizer, ifStmt->elseBranch);
+
+        bool truthy = false;
+        if (!constant_truthiness(ifStmt->condition, &truthy))
+            break;
+
+        Stmt* taken = truthy ? ifStmt->thenBranch : ifStmt->elseBranch;
+
+        if (truthy) {
+            ifStmt->thenBranch = NULL;
+        } else {
+            ifStmt->elseBranch = NULL;
+        }
+
+        discard_stmt(optimizer, statement);
+
+        return taken;
+    }
+    case WHILE_STMT: {
+        WhileStmt* whileStmt = statement->stmt;
+
+        whileStmt->condition = optimize_expr(optimizer, whileStmt->condition);
+
+        bool truthy = true;
+        if (constant_truthiness(whileStmt->condition, &truthy) && !truthy) {
+            discard_stmt(optimizer, statement);
+            return NULL;
+        }
+
+        whileStmt->body = optimize_stmt(optimizer, whileStmt->body);
+        break;
+    }
+    case FOR_STMT: {
+        ForStmt* forStmt = statement->stmt;
+
+        begin_scope(optimizer, LOCAL_BUCKETS);
+
+        forStmt->initialization = optimize_decl(optimizer, forStmt->initialization);
+        forStmt->condition = optimize_expr(optimizer, forStmt->condition);
+        forStmt->body = optimize_stmt(optimizer, forStmt->body);
+        forStmt->action = optimize_expr(optimizer, forStmt->action);
+
+        end_scope(optimizer);
+
+        /* the initializer still runs once, so only literal ones can go with the loop */
+        Decl* initialization = forStmt->initialization;
+        bool isPure = initialization == NULL
+            || (initialization->type == LET_DECL && is_constant(((LetDecl*) initialization->decl)->expression))
+            || (initialization->type == CONST_DECL && is_constant(((ConstDecl*) initialization->decl)->expression));
+
+        bool truthy = true;
+        if (isPure && constant_truthiness(forStmt->condition, &truthy) && !truthy) {
+            discard_stmt(optimizer, statement);
+            return NULL;
+        }
+        break;
+    }
+    case BREAK_STMT:
+    case CONTINUE_STMT:
+    default:
+        break;
+    }
+
+    return statement;
+}
+
+/* returns the expression that takes its place */
+static Expr* optimize_expr(Optimizer* optimizer, Expr* expression) {
+    if (expression == NULL)
+        return NULL;
+
+    Value left, right, result;
+
+    switch (expression->type) {
+    case BINARY_EXPR: {
+        BinaryExpr* binaryExpr = expression->expr;
+
+        binaryExpr->left = optimize_expr(optimizer, binaryExpr->left);
+        binaryExpr->right = optimize_expr(optimizer, binaryExpr->right);
+
+        left = right = NIL_VALUE();
+
+        bool folded = constant_value(binaryExpr->left, &left) && constant_value(binaryExpr->right, &right)
+            && fold_binary(binaryExpr->op->type, left, right, &result);
+
+        value_release(left);
+        value_release(right);
+
+        if (folded)
+            return folded_expr(optimizer, expression, result);
+        break;
+    }
+    case GROUP_EXPR: {
+        GroupExpr* groupExpr = expression->expr;
+
+        groupExpr->expression = optimize_expr(optimizer, groupExpr->expression);
+
+        if (is_constant(groupExpr->expression)) {
+            Expr* inner = groupExpr->expression;
+            groupExpr->expression = NULL;
+
+            discard_expr(optimizer, expression);
+
+            return inner;
+        }
+        break;
+    }
+    case ASSIGN_EXPR: {
+        AssignExpr* assignExpr = expression->expr;
+
+        /* the target stays as written */
+        assignExpr->expression = optimize_expr(optimizer, assignExpr->expression);
+        break;
+    }
+    case CALL_EXPR: {
+        CallExpr* callExpr = expression->expr;
+
+        callExpr->callee = optimize_expr(optimizer, callExpr->callee);
+        optimize_vector(optimizer, callExpr->arguments);
+        break;
+    }
+    case LOGICAL_EXPR: {
+        LogicalExpr* logicalExpr = expression->expr;
+
+        logicalExpr->left = optimize_expr(optimizer, logicalExpr->left);
+        logicalExpr->right = optimize_expr(optimizer, logicalExpr->right);
+
+        /* both sides are always evaluated, so both have to be known */
+        bool leftTruthy = false;
+        bool rightTruthy = false;
+        TokenType op = logicalExpr->op->type;
+
+        if ((op == TOKEN_LAND || op == TOKEN_LOR)
+            && constant_truthiness(logicalExpr->left, &leftTruthy)
+            && constant_truthiness(logicalExpr->right, &rightTruthy)) {
+            discard_expr(optimizer, expression);
+            return value_expr(optimizer, BOOL_VALUE(op == TOKEN_LAND
+                ? leftTruthy && rightTruthy : leftTruthy || rightTruthy));
+        }
+        break;
+    }
+    case UNARY_EXPR: {
+        UnaryExpr* unaryExpr = expression->expr;
+
+        unaryExpr->expression = optimize_expr(optimizer, unaryExpr->expression);
+
+        if (constant_value(unaryExpr->expression, &right)) {
+            /* unary + hands its operand back unchanged */
+            if (fold_unary(unaryExpr->op->type, right, &result)) {
+                if (result != right)
+                    value_release(right);
+
+                return folded_expr(optimizer, expression, result);
+            }
+
+            value_release(right);
+        }
+        break;
+    }
+    case UPDATE_EXPR:
+        break;
+    case FIELD_INIT_EXPR: {
+        FieldInitExpr* fieldInitExpr = expression->expr;
+
+        fieldInitExpr->value = optimize_expr(optimizer, fieldInitExpr->value);
+        break;
+    }
+    case STRUCT_INIT_EXPR:
+        optimize_list(optimizer, ((StructInitExpr*) expression->expr)->fields);
+        break;
+    case STRUCT_INLINE_EXPR:
+        optimize_list(optimizer, ((StructInlineExpr*) expression->expr)->fields);
+        break;
+    case ARRAY_INIT_EXPR:
+        optimize_list(optimizer, ((ArrayInitExpr*) expression->expr)->elements);
+        break;
+    case MAP_INIT_EXPR:
+        optimize_list(optimizer, ((MapInitExpr*) expression->expr)->keys);
+        optimize_list(optimizer, ((MapInitExpr*) expression->expr)->values);
+        break;
+    case FUNC_EXPR: {
+        FunctionExpr* functionExpr = expression->expr;
+
+        optimize_function(optimizer, functionExpr->parameters, &functionExpr->body);
+        break;
+    }
+    case CONDITIONAL_EXPR: {
+        ConditionalExpr* conditionalExpr = expression->expr;
+
+        conditionalExpr->condition = optimize_expr(optimizer, conditionalExpr->condition);
+        conditionalExpr->isTrue = optimize_expr(optimizer, conditionalExpr->isTrue);
+        conditionalExpr->isFalse = optimize_expr(optimizer, conditionalExpr->isFalse);
+
+        bool truthy = false;
+        if (!constant_truthiness(conditionalExpr->condition, &truthy))
+            break;
+
+        Expr* taken = truthy ? conditionalExpr->isTrue : conditionalExpr->isFalse;
+
+        if (truthy) {
+            conditionalExpr->isTrue = NULL;
+        } else {
+            conditionalExpr->isFalse = NULL;
+        }
+
+        discard_expr(optimizer, expression);
+
+        return taken != NULL ? taken : value_expr(optimizer, NIL_VALUE());
+    }
+    case MEMBER_EXPR: {
+        MemberExpr* memberExpr = expression->expr;
+
+        memberExpr->object = optimize_expr(optimizer, memberExpr->object);
+        break;
+    }
+    case ARRAY_MEMBER_EXPR: {
+        ArrayMemberExpr* arrayMemberExpr = expression->expr;
+
+        arrayMemberExpr->object = optimize_expr(optimizer, arrayMemberExpr->object);
+        optimize_list(optimizer, arrayMemberExpr->levelOfAccess);
+        break;
+    }
+    case CAST_EXPR: {
+        CastExpr* castExpr = expression->expr;
+
+        castExpr->target = optimize_expr(optimizer, castExpr->target);
+
+        if (castExpr->type != NULL && constant_value(castExpr->target, &right)) {
+            /* a cast to the operand's own type hands it back unchanged */
+            if (fold_cast(castExpr->type->typeId, right, &result)) {
+                if (result != right)
+                    value_release(right);
+
+                return folded_expr(optimizer, expression, result);
+            }
+
+            value_release(right);
+        }
+        break;
+    }
+    case LITERAL_EXPR: {
+        LiteralExpr* literalExpr = expression->expr;
+
+        if (literalExpr->type != IDENT_LITERAL)
+            break;
+
+        Expr* constant = lookup(optimizer, ((IdentLiteral*) literalExpr->value)->value);
+        if (constant != NULL) {
+            discard_expr(optimizer, expression);
+            return copy_constant(optimizer, constant);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+
+    return expression;
+}
+
+/* records a name read by reachable code and queues the function it names */
+static void reach(Optimizer* optimizer, char* name) {
+    if (optimizer->reached == NULL || map_get(optimizer->reached, name) != NULL)
+        return;
+
+    map_put(optimizer->reached, name, name);
+
+    Decl* function = map_get(optimizer->functions, name);
+    if (function != NULL) {
+        list_insert_last(&optimizer->pending, function);
+    }
+}
+
+static void scan_target(Optimizer* optimizer, Expr* target) {
+    if (target == NULL)
+        return;
+
+    if (target->type == ARRAY_MEMBER_EXPR) {
+        ArrayMemberExpr* arrayMemberExpr = target->expr;
+
+        scan_target(optimizer, arrayMemberExpr->object);
+
+        list_foreach(level, arrayMemberExpr->levelOfAccess) {
+            scan_expr(optimizer, level->value);
+        }
+        return;
+    }
+
+    LiteralExpr* literal = literal_of(target);
+    if (literal != NULL && literal->type == IDENT_LITERAL) {
+        char* name = ((IdentLiteral*) literal->value)->value;
+
+        map_put(optimizer->assigned, name, name);
+        reach(optimizer, name);
+        return;
+    }
+
+    scan_expr(optimizer, target);
+}
+
+static void scan_function(Optimizer* optimizer, Stmt* body) {
+    scan_stmt(optimizer, body);
+}
+
+static void scan_decl(Optimizer* optimizer, Decl* declaration) {
+    if (declaration == NULL)
+        return;
+
+    switch (declaration->type) {
+    case LET_DECL:
+        scan_expr(optimizer, ((LetDecl*) declaration->decl)->expression);
+        break;
+    case CONST_DECL:
+        scan_expr(optimizer, ((ConstDecl*) declaration->decl)->expression);
+        break;
+    case FUNC_DECL:
+        scan_function(optimizer, ((FunctionDecl*) declaration->decl)->body);
+        break;
+    case STMT_DECL:
+        scan_stmt(optimizer, ((StmtDecl*) declaration->decl)->stmt);
+        break;
+    default:
+        break;
+    }
+}
+
+static void scan_stmt(Optimizer* optimizer, Stmt* statement) {
+    if (statement == NULL)
+        return;
+
+    switch (statement->type) {
+    case BLOCK_STMT:
+        vector_foreach(declaration, ((BlockStmt*) statement->stmt)->declarations) {
+            scan_decl(optimizer, *declaration);
+        }
+        break;
+    case EXPRESSION_STMT:
+        scan_expr(optimizer, ((ExpressionStmt*) statement->stmt)->expression);
+        break;
+    case RETURN_STMT:
+        scan_expr(optimizer, ((ReturnStmt*) statement->stmt)->expression);
+        break;
+    case IF_STMT: {
+        IfStmt* ifStmt = statement->stmt;
+
+        scan_expr(optimizer, ifStmt->condition);
+        scan_stmt(optimizer, ifStmt->thenBranch);
+        scan_stmt(optimizer, ifStmt->elseBranch);
+        break;
+    }
+    case WHILE_STMT: {
+        WhileStmt* whileStmt = statement->stmt;
+
+        scan_expr(optimizer, whileStmt->condition);
+        scan_stmt(optimizer, whileStmt->body);
+        break;
+    }
+    case FOR_STMT: {
+        ForStmt* forStmt = statement->stmt;
+
+        scan_decl(optimizer, forStmt->initialization);
+        scan_expr(optimizer, forStmt->condition);
+        scan_stmt(optimizer, forStmt->body);
+        scan_expr(optimizer, forStmt->action);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+static void scan_list(Optimizer* optimizer, List* expressions) {
+    if (expressions == NULL)
+        return;
+
+    list_foreach(node, expressions) {
+        scan_expr(optimizer, node->value);
+    }
+}
+
+static void scan_vector(Optimizer* optimizer, Vector* expressions) {
+    if (expressions == NULL)
+        return;
+
+    vector_foreach(item, expressions) {
+        scan_expr(optimizer, *item);
+    }
+}
+
+static void scan_expr(Optimizer* optimizer, Expr* expression) {
+    if (expression == NULL)
+        return;
+
+    switch (expression->type) {
+    case BINARY_EXPR:
+        scan_expr(optimizer, ((BinaryExpr*) expression->expr)->left);
+        scan_expr(optimizer, ((BinaryExpr*) expression->expr)->right);
+        break;
+    case GROUP_EXPR:
+        scan_expr(optimizer, ((GroupExpr*) expression->expr)->expression);
+        break;
+    case ASSIGN_EXPR:
+        scan_target(optimizer, ((AssignExpr*) expression->expr)->identifier);
+        scan_expr(optimizer, ((AssignExpr*) expression->expr)->expression);
+        break;
+    case CALL_EXPR:
+        scan_expr(optimizer, ((CallExpr*) expression->expr)->callee);
+        scan_vector(optimizer, ((CallExpr*) expression->expr)->arguments);
+        break;
+    case LOGICAL_EXPR:
+        scan_expr(optimizer, ((LogicalExpr*) expression->expr)->left);
+        scan_expr(optimizer, ((LogicalExpr*) expression->expr)->right);
+        break;
+    case UNARY_EXPR:
+        scan_expr(optimizer, ((UnaryExpr*) expression->expr)->expression);
+        break;
+    case UPDATE_EXPR:
+        scan_target(optimizer, ((UpdateExpr*) expression->expr)->expression);
+        break;
+    case FIELD_INIT_EXPR:
+        scan_expr(optimizer, ((FieldInitExpr*) expression->expr)->value);
+        break;
+    case STRUCT_INIT_EXPR:
+        scan_list(optimizer, ((StructInitExpr*) expression->expr)->fields);
+        break;
+    case STRUCT_INLINE_EXPR:
+        scan_list(optimizer, ((StructInlineExpr*) expression->expr)->fields);
+        break;
+    case ARRAY_INIT_EXPR:
+        scan_list(optimizer, ((ArrayInitExpr*) expression->expr)->elements);
+        break;
+    case MAP_INIT_EXPR:
+        scan_list(optimizer, ((MapInitExpr*) expression->expr)->keys);
+        scan_list(optimizer, ((MapInitExpr*) expression->expr)->values);
+        break;
+    case FUNC_EXPR:
+        scan_function(optimizer, ((FunctionExpr*) expression->expr)->body);
+        break;
+    case CONDITIONAL_EXPR:
+        scan_expr(optimizer, ((ConditionalExpr*) expression->expr)->condition);
+        scan_expr(optimizer, ((ConditionalExpr*) expression->expr)->isTrue);
+        scan_expr(optimizer, ((ConditionalExpr*) expression->expr)->isFalse);
+        break;
+    case MEMBER_EXPR:
+        scan_expr(optimizer, ((MemberExpr*) expression->expr)->object);
+        break;
+    case ARRAY_MEMBER_EXPR:
+        scan_expr(optimizer, ((ArrayMemberExpr*) expression->expr)->object);
+        scan_list(optimizer, ((ArrayMemberExpr*) expression->expr)->levelOfAccess);
+        break;
+    case CAST_EXPR:
+        scan_expr(optimizer, ((CastExpr*) expression->expr)->target);
+        break;
+    case LITERAL_EXPR: {
+        LiteralExpr* literalExpr = expression->expr;
+
+        if (literalExpr->type == IDENT_LITERAL) {
+            reach(optimizer, ((IdentLiteral*) literalExpr->value)->value);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+/* everything but function declarations runs, functions only live if that code reaches them */
+static void drop_unreached_functions(Optimizer* optimizer, List* declarations) {
+    optimizer->functions = SYMBOL_MAP_NEW(GLOBAL_BUCKETS, NULL);
+    optimizer->reached = SYMBOL_MAP_NEW(GLOBAL_BUCKETS, NULL);
+    optimizer->pending = list_new(NULL);
+
+    list_foreach(declaration, declarations) {
+        Decl* decl = declaration->value;
+
+        if (decl->type == FUNC_DECL) {
+            map_put(optimizer->functions, ((FunctionDecl*) decl->decl)->name->literal, decl);
+        }
+    }
+
+    list_foreach(declaration, declarations) {
+        Decl* decl = declaration->value;
+
+        if (decl->type != FUNC_DECL) {
+            scan_decl(optimizer, decl);
+        }
+    }
+
+    while (!list_is_empty(&optimizer->pending)) {
+        Decl* function = NULL;
+        list_remove_first(&optimizer->pending, (void**) &function);
+
+        scan_decl(optimizer, function);
+    }
+
+    size_t index = 0;
+    ListNode* node = declarations->head;
+
+    while (node != NULL) {
+        ListNode* next = node->next;
+        Decl* decl = node->value;
+
+        if (decl->type == FUNC_DECL && map_get(optimizer->reached, ((FunctionDecl*) decl->decl)->name->literal) == NULL) {
+            void* removed = NULL;
+            list_remove_at(&declarations, index, &removed);
+
+            discard_decl(optimizer, decl);
+        } else {
+            index++;
+        }
+
+        node = next;
+    }
+
+    list_free(&optimizer->pending);
+    map_free(&optimizer->reached);
+    map_free(&optimizer->functions);
+}
+
+void optimize(List* declarations, int level) {
+    if (declarations == NULL || level <= OPTIMIZER_NONE)
+        return;
+
+    /* scratch maps and lists must not land in the tree's arena */
+    Arena* previous = arena_active();
+    arena_set_active(NULL);
+
+    Optimizer optimizer = {
+        .level = level,
+        .arena = declarations->arena,
+        .scope = NULL,
+        .assigned = SYMBOL_MAP_NEW(GLOBAL_BUCKETS, NULL),
+        .functions = NULL,
+        .reached = NULL,
+        .pending = NULL
+    };
+
+    list_foreach(declaration, declarations) {
+        scan_decl(&optimizer, declaration->value);
+    }
+
+    begin_scope(&optimizer, GLOBAL_BUCKETS);
+    optimize_program(&optimizer, declarations);
+    end_scope(&optimizer);
+
+    if (level >= OPTIMIZER_FULL) {
+        drop_unreached_functions(&optimizer, declarations);
+    }
+
+    map_free(&optimizer.assigned);
+
+    arena_set_active(previous);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "ast.h"
+#include "list.h"
+#include "map.h"
+
+
+#define OPTIMIZER_NONE  0
+#define OPTIMIZER_LOCAL 1 /* folding, const propagation and dead code */
+#define OPTIMIZER_FULL  2 /* also drops top-level functions nothing reaches */
+
+typedef struct ConstantScope {
+    Map* constants; /* Map of (char*, Expr*), a name without a literal hides outer ones */
+    struct ConstantScope* enclosing;
+} ConstantScope;
+
+typedef struct Optimizer {
+    int level;
+    struct Arena* arena;  /* where the tree lives, new nodes go there too */
+    ConstantScope* scope;
+    Map* assigned;        /* names written anywhere, never treated as constants */
+    Map* functions;       /* top-level functions by name */
+    Map* reached;         /* names referenced from reachable code */
+    List* pending;        /* reached functions whose bodies are not scanned yet */
+} Optimizer;
+
+/*
+ * Rewrites the checked tree in place before it is resolved. Constant unary,
+ * binary, logical, cast and conditional expressions are folded with the
+ * interpreter's own arithmetic, literal consts are propagated into their
+ * uses, branches and loops with constant conditions are pruned and
+ * statements after a return, break or continue are dropped. Nodes that are
+ * replaced are freed unless the tree lives in an arena.
+ */
+void optimize(List* declarations, int level);
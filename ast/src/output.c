@@ -0,0 +1,122 @@
+#include "output.h"
+
+#include <errno.h>
+#include <stdarg.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "buffer.h"
+
+
+/* configured once for the process, the buffer itself belongs to each thread */
+static size_t outputCapacity = OUTPUT_DEFAULT_CAPACITY;
+static OutputMode outputMode = OUTPUT_AUTO;
+
+static _Thread_local ByteBuffer* output = NULL;
+static _Thread_local bool lineBuffered = false;
+
+/* owned by the caller of output_capture, never flushed */
+static _Thread_local ByteBuffer* capture = NULL;
+
+static pthread_once_t flushAtExit = PTHREAD_ONCE_INIT;
+
+static void register_flush_at_exit(void) {
+    atexit(output_flush);
+}
+
+void output_configure(size_t capacity, OutputMode mode) {
+    output_free();
+
+    outputCapacity = capacity > 0 ? capacity : OUTPUT_DEFAULT_CAPACITY;
+    outputMode = mode;
+}
+
+ByteBuffer* output_buffer(void) {
+    if (capture != NULL)
+        return capture;
+
+    if (output != NULL)
+        return output;
+
+    /* one byte more for the terminator, so a full buffer never grows */
+    output = byte_buffer_new_with_capacity(outputCapacity + 1);
+    if (output == NULL) {
+        return NULL;
+    }
+
+    lineBuffered = outputMode == OUTPUT_AUTO ? isatty(STDOUT_FILENO) : outputMode == OUTPUT_LINE_BUFFERED;
+
+    pthread_once(&flushAtExit, register_flush_at_exit);
+
+    return output;
+}
+
+void output_commit(size_t mark) {
+    if (capture != NULL || output == NULL || output->size <= mark)
+        return;
+
+    if (output->size >= outputCapacity
+        || (lineBuffered && memchr(output->bytes + mark, '\n', output->size - mark) != NULL)) {
+        output_flush();
+    }
+}
+
+void output_printf(const char* format, ...) {
+    ByteBuffer* buffer = output_buffer();
+    if (buffer == NULL)
+        return;
+
+    size_t mark = buffer->size;
+
+    va_list args;
+    va_start(args, format);
+    byte_buffer_vappendf(buffer, format, args);
+    va_end(args);
+
+    output_commit(mark);
+}
+
+void output_capture(ByteBuffer* into) {
+    if (into != NULL) {
+        output_flush();
+    }
+
+    capture = into;
+}
+
+void output_flush(void) {
+    if (capture != NULL || output == NULL || output->size == 0)
+        return;
+
+    /* whatever went through stdio was printed before the buffered text */
+    fflush(stdout);
+
+    const char* bytes = output->bytes;
+    size_t pending = output->size;
+
+    while (pending > 0) {
+        ssize_t written = write(STDOUT_FILENO, bytes, pending);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+
+            /* a closed or failing stdout drops the text instead of growing forever */
+            break;
+        }
+
+        bytes += written;
+        pending -= written;
+    }
+
+    byte_buffer_clear(output);
+}
+
+void output_free(void) {
+    output_flush();
+    byte_buffer_free(&output);
+}
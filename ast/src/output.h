@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "buffer.h"
+
+
+#define OUTPUT_DEFAULT_CAPACITY (64 * 1024)
+
+typedef enum OutputMode {
+    OUTPUT_AUTO,            /* line buffered on a terminal, fully buffered otherwise */
+    OUTPUT_LINE_BUFFERED,
+    OUTPUT_FULLY_BUFFERED
+} OutputMode;
+
+/*
+ * The process's standard output. print and println render their arguments
+ * straight into this buffer, and it reaches the file descriptor in one
+ * write once it holds capacity bytes, on output_flush, or at exit. In line
+ * buffered mode any write that ends a line is flushed right away. Text sent
+ * through stdio is written out first, so both keep their relative order as
+ * long as the buffer is flushed before the next printf to stdout.
+ *
+ * Every thread renders into a buffer of its own and only the main thread's
+ * is flushed at exit; any other thread calls output_free before it ends.
+ * output_configure applies to all of them and is meant to be called before
+ * the first thread starts printing.
+ */
+void output_configure(size_t capacity, OutputMode mode);
+
+/* created on first use with the configured capacity */
+ByteBuffer* output_buffer(void);
+
+/* call after rendering into output_buffer, mark is the size it had before */
+void output_commit(size_t mark);
+
+/* printf into output_buffer, for diagnostics that must follow the program's own text */
+void output_printf(const char* format, ...) __attribute__((format(printf, 1, 2)));
+
+/*
+ * Sends this thread's output into a buffer the caller owns instead of the
+ * file descriptor, until output_capture(NULL). Nothing captured is flushed;
+ * what was pending before is written out first.
+ */
+void output_capture(ByteBuffer* into);
+
+void output_flush(void);
+
+/* flushes and releases the buffer, the next output_buffer starts a new one */
+void output_free(void);
@@ -0,0 +1,343 @@
+#include "reader.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "map.h"
+#include "smem.h"
+#include "symbol.h"
+
+
+static _Thread_local Reader* stdinReader = NULL;
+static _Thread_local Map* openReaders = NULL;
+
+static bool reader_map(Reader* reader) {
+    struct stat info;
+    if (fstat(reader->fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size == 0)
+        return false;
+
+    /* stdin may already be past the start of the file it was redirected from */
+    off_t position = lseek(reader->fd, 0, SEEK_CUR);
+    if (position < 0 || position > info.st_size)
+        return false;
+
+    void* data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, reader->fd, 0);
+    if (data == MAP_FAILED)
+        return false;
+
+    madvise(data, info.st_size, MADV_SEQUENTIAL);
+
+    reader->mapped = true;
+    reader->eof = true;
+    reader->data = data;
+    reader->size = info.st_size;
+    reader->offset = position;
+
+    return true;
+}
+
+Reader* reader_open(const char* path) {
+    int fd = path == NULL ? STDIN_FILENO : open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    Reader* reader = NULL;
+    reader = safe_malloc(sizeof(Reader), NULL);
+    if (reader == NULL) {
+        if (path != NULL) {
+            close(fd);
+        }
+        return NULL;
+    }
+
+    *reader = (Reader) {
+        .fd = fd,
+        .mapped = false,
+        .eof = false,
+        .data = NULL,
+        .size = 0,
+        .offset = 0,
+        .capacity = 0
+    };
+
+    if (reader_map(reader))
+        return reader;
+
+    reader->data = safe_malloc(READER_CHUNK_SIZE, NULL);
+    if (reader->data == NULL) {
+        reader_free(&reader);
+        return NULL;
+    }
+
+    reader->capacity = READER_CHUNK_SIZE;
+
+    return reader;
+}
+
+void reader_free(Reader** reader) {
+    if (reader == NULL || *reader == NULL)
+        return;
+
+    if ((*reader)->mapped) {
+        munmap((*reader)->data, (*reader)->size);
+    } else {
+        safe_free((void**) &(*reader)->data);
+    }
+
+    if ((*reader)->fd != STDIN_FILENO) {
+        close((*reader)->fd);
+    }
+
+    safe_free((void**) reader);
+}
+
+/* moves the unread bytes to the front and reads one more chunk behind them */
+static void reader_fill(Reader* reader) {
+    if (reader->eof)
+        return;
+
+    if (reader->offset > 0) {
+        memmove(reader->data, reader->data + reader->offset, reader->size - reader->offset);
+        reader->size -= reader->offset;
+        reader->offset = 0;
+    }
+
+    if (reader->size == reader->capacity) {
+        char* data = safe_realloc((void**) &reader->data, reader->capacity * 2, NULL);
+        if (data == NULL) {
+            reader->eof = true;
+            return;
+        }
+
+        reader->data = data;
+        reader->capacity *= 2;
+    }
+
+    ssize_t got = 0;
+    do {
+        got = read(reader->fd, reader->data + reader->size, reader->capacity - reader->size);
+    } while (got < 0 && errno == EINTR);
+
+    if (got <= 0) {
+        reader->eof = true;
+        return;
+    }
+
+    reader->size += got;
+}
+
+bool reader_has_line(Reader* reader) {
+    if (reader == NULL)
+        return false;
+
+    while (reader->offset == reader->size && !reader->eof) {
+        reader_fill(reader);
+    }
+
+    return reader->offset < reader->size;
+}
+
+bool reader_next_line(Reader* reader, const char** line, size_t* length) {
+    if (reader == NULL || line == NULL || length == NULL)
+        return false;
+
+    for (;;) {
+        char* start = reader->data + reader->offset;
+        size_t available = reader->size - reader->offset;
+
+        char* newline = available > 0 ? memchr(start, '\n', available) : NULL;
+
+        if (newline != NULL) {
+            *line = start;
+            *length = newline - start;
+            reader->offset += *length + 1;
+            return true;
+        }
+
+        /* the last line may have no '\n' */
+        if (reader->eof) {
+            if (available == 0)
+                return false;
+
+            *line = start;
+            *length = available;
+            reader->offset = reader->size;
+            return true;
+        }
+
+        reader_fill(reader);
+    }
+}
+
+bool reader_rest(Reader* reader, const char** data, size_t* length) {
+    if (reader == NULL || data == NULL || length == NULL)
+        return false;
+
+    while (!reader->eof) {
+        reader_fill(reader);
+    }
+
+    *data = reader->data + reader->offset;
+    *length = reader->size - reader->offset;
+    reader->offset = reader->size;
+
+    return true;
+}
+
+static bool source_map(Source* source, int fd) {
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size == 0)
+        return false;
+
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    size_t reserved = ((size_t) info.st_size + 2 + page - 1) / page * page;
+
+    char* text = mmap(NULL, reserved, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (text == MAP_FAILED)
+        return false;
+
+    /* past the end of the file the last page reads as zeros, and the rest of the reservation too */
+    if (mmap(text, info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        munmap(text, reserved);
+        return false;
+    }
+
+    madvise(text, info.st_size, MADV_SEQUENTIAL);
+
+    source->text = text;
+    source->size = info.st_size;
+    source->reserved = reserved;
+
+    return true;
+}
+
+static bool source_read(Source* source, int fd) {
+    size_t capacity = READER_CHUNK_SIZE;
+    char* text = safe_malloc(capacity, NULL);
+    size_t size = 0;
+
+    while (text != NULL) {
+        if (capacity - size <= 2) {
+            char* grown = safe_realloc((void**) &text, capacity * 2, NULL);
+            if (grown == NULL) {
+                safe_free((void**) &text);
+                break;
+            }
+
+            text = grown;
+            capacity *= 2;
+        }
+
+        ssize_t got = read(fd, text + size, capacity - size - 2);
+        if (got < 0 && errno == EINTR)
+            continue;
+
+        if (got < 0) {
+            safe_free((void**) &text);
+            break;
+        }
+
+        if (got == 0)
+            break;
+
+        size += got;
+    }
+
+    if (text == NULL)
+        return false;
+
+    text[size] = '\0';
+    text[size + 1] = '\0';
+
+    source->text = text;
+    source->size = size;
+    source->reserved = 0;
+
+    return true;
+}
+
+Source* source_open(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    Source* source = NULL;
+    source = safe_malloc(sizeof(Source), NULL);
+    if (source == NULL) {
+        close(fd);
+        return NULL;
+    }
+
+    if (!source_map(source, fd) && !source_read(source, fd)) {
+        safe_free((void**) &source);
+    }
+
+    /* a mapping outlives the descriptor it was made from */
+    int saved = errno;
+    close(fd);
+    errno = saved;
+
+    return source;
+}
+
+void source_free(Source** source) {
+    if (source == NULL || *source == NULL)
+        return;
+
+    if ((*source)->reserved > 0) {
+        munmap((*source)->text, (*source)->reserved);
+    } else {
+        safe_free((void**) &(*source)->text);
+    }
+
+    safe_free((void**) source);
+}
+
+Reader* reader_stdin(void) {
+    if (stdinReader == NULL) {
+        stdinReader = reader_open(NULL);
+    }
+
+    return stdinReader;
+}
+
+Reader* reader_for(const char* path) {
+    if (path == NULL)
+        return reader_stdin();
+
+    if (openReaders == NULL) {
+        openReaders = symbol_map_new(8, (void (*)(void**)) reader_free);
+    }
+
+    char* name = symbol_intern(path);
+
+    Reader* reader = map_get(openReaders, name);
+    if (reader == NULL) {
+        reader = reader_open(path);
+        if (reader != NULL) {
+            map_put(openReaders, name, reader);
+        }
+    }
+
+    return reader;
+}
+
+void reader_close(const char* path) {
+    if (path == NULL || openReaders == NULL)
+        return;
+
+    map_remove(openReaders, symbol_intern(path));
+}
+
+void reader_close_all(void) {
+    map_free(&openReaders);
+    reader_free(&stdinReader);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+
+#define READER_CHUNK_SIZE (64 * 1024)
+
+/*
+ * Line reader over a file or stdin. A regular file is mapped into memory
+ * and scanned in place, anything else, a pipe or a terminal, is read in
+ * chunks into a buffer that only grows to hold the longest line. Lines are
+ * found with memchr and handed out as a pointer and a length into the
+ * mapping or the buffer, without the '\n', valid until the next call on
+ * the same reader.
+ */
+typedef struct Reader {
+    int fd;
+    bool mapped;
+    bool eof;
+    char* data;
+    size_t size;      /* bytes of data holding input */
+    size_t offset;    /* where the next line starts */
+    size_t capacity;  /* of data when it is a buffer rather than a mapping */
+} Reader;
+
+/* a NULL path reads stdin from its current position */
+Reader* reader_open(const char* path);
+void reader_free(Reader** reader);
+
+bool reader_has_line(Reader* reader);
+bool reader_next_line(Reader* reader, const char** line, size_t* length);
+
+/* everything not consumed yet, leaving the reader at the end */
+bool reader_rest(Reader* reader, const char** data, size_t* length);
+
+/*
+ * A whole source file laid out the way flex's yy_scan_buffer scans in
+ * place: the text followed by two NUL bytes, writable. A regular file is
+ * mapped copy on write over a zeroed reservation one page longer than
+ * needed, so the lexer terminating its tokens never touches the file and
+ * the NULs cost nothing; anything else is read into memory.
+ */
+typedef struct Source {
+    char* text;
+    size_t size;      /* of the text, without the NULs */
+    size_t reserved;  /* bytes mapped, 0 when text was read into memory */
+} Source;
+
+Source* source_open(const char* path);
+void source_free(Source** source);
+
+/*
+ * Readers the builtins keep open between calls: the process's stdin, which
+ * input() shares, and one per path, closed once it runs out of lines.
+ */
+Reader* reader_stdin(void);
+Reader* reader_for(const char* path);
+void reader_close(const char* path);
+void reader_close_all(void);
@@ -0,0 +1,472 @@
+#include "resolver.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "ast.h"
+#include "list.h"
+#include "literal-type.h"
+#include "map.h"
+#include "output.h"
+#include "smem.h"
+#include "symbol.h"
+
+
+static void resolve_decl(Resolver* resolver, Decl* declaration);
+static void resolve_stmt(Resolver* resolver, Stmt* statement);
+static void resolve_expr(Resolver* resolver, Expr* expression);
+
+static void begin_scope(Resolver* resolver) {
+    Scope* scope = safe_malloc(sizeof(Scope), NULL);
+    if (scope == NULL) {
+        resolver->currentStatus = RESOLVER_FAILURE;
+        return;
+    }
+
+    *scope = (Scope) {
+        .names = SYMBOL_MAP_NEW(32, safe_free),
+        .count = 0,
+        .isCapturable = false,
+        .enclosing = resolver->scope
+    };
+
+    resolver->scope = scope;
+}
+
+static void end_scope(Resolver* resolver, ScopeLayout* layout) {
+    Scope* scope = resolver->scope;
+    if (scope == NULL)
+        return;
+
+    resolver->scope = scope->enclosing;
+
+    if (layout != NULL) {
+        *layout = (ScopeLayout) {
+            .size = scope->count,
+            .isCapturable = scope->isCapturable
+        };
+    }
+
+    map_free(&scope->names);
+    safe_free((void**) &scope);
+}
+
+/* redeclaring a name in the same scope reuses its slot, so the runtime
+   still reports it as already defined */
+static int declare(Resolver* resolver, char* name) {
+    Scope* scope = resolver->scope;
+
+    size_t* slot = map_get(scope->names, name);
+    if (slot != NULL) {
+        return (int) *slot;
+    }
+
+    slot = safe_malloc(sizeof(size_t), NULL);
+    *slot = scope->count++;
+
+    map_put(scope->names, name, slot);
+
+    return (int) *slot;
+}
+
+/* a function literal keeps every enclosing scope alive for as long as it lives */
+static void capture_scopes(Resolver* resolver) {
+    for (Scope* scope = resolver->scope; scope != NULL && !scope->isCapturable; scope = scope->enclosing) {
+        scope->isCapturable = true;
+    }
+}
+
+static bool declares_name(Decl* declaration) {
+    if (declaration == NULL)
+        return false;
+
+    return declaration->type == LET_DECL || declaration->type == CONST_DECL || declaration->type == FUNC_DECL;
+}
+
+static void resolve_ident(Resolver* resolver, IdentLiteral* identLiteral) {
+    int depth = 0;
+
+    for (Scope* scope = resolver->scope; scope != NULL; scope = scope->enclosing) {
+        size_t* slot = map_get(scope->names, identLiteral->value);
+        if (slot != NULL) {
+            identLiteral->depth = depth;
+            identLiteral->slot = (int) *slot;
+            return;
+        }
+
+        depth++;
+    }
+
+    output_printf("undefined: %s\n", identLiteral->value);
+
+    resolver->currentStatus = RESOLVER_FAILURE;
+}
+
+static void resolve_function(Resolver* resolver, List* parameters, Stmt* body, ScopeLayout* layout) {
+    capture_scopes(resolver);
+
+    /* calls without parameters run directly in the closure environment */
+    if (list_size(&parameters) == 0) {
+        resolve_stmt(resolver, body);
+        return;
+    }
+
+    begin_scope(resolver);
+
+    list_foreach(parameter, parameters) {
+        FieldDecl* parameterDecl = ((Decl*) parameter->value)->decl;
+
+        declare(resolver, parameterDecl->name->literal);
+    }
+
+    resolve_stmt(resolver, body);
+
+    end_scope(resolver, layout);
+}
+
+static void resolve_decl(Resolver* resolver, Decl* declaration) {
+    if (declaration == NULL)
+        return;
+
+    switch (declaration->type) {
+    case LET_DECL: {
+        LetDecl* letDecl = declaration->decl;
+
+        resolve_expr(resolver, letDecl->expression);
+        letDecl->slot = declare(resolver, letDecl->name->literal);
+        break;
+    }
+    case CONST_DECL: {
+        ConstDecl* constDecl = declaration->decl;
+
+        resolve_expr(resolver, constDecl->expression);
+        constDecl->slot = declare(resolver, constDecl->name->literal);
+        break;
+    }
+    case FUNC_DECL: {
+        FunctionDecl* functionDecl = declaration->decl;
+
+        functionDecl->slot = declare(resolver, functionDecl->name->literal);
+        resolve_function(resolver, functionDecl->parameters, functionDecl->body, &functionDecl->scope);
+        break;
+    }
+    case STMT_DECL: {
+        StmtDecl* stmtDecl = declaration->decl;
+
+        resolve_stmt(resolver, stmtDecl->stmt);
+        break;
+    }
+    case FIELD_DECL:
+    case STRUCT_DECL:
+    default:
+        break;
+    }
+}
+
+static void resolve_stmt(Resolver* resolver, Stmt* statement) {
+    if (statement == NULL)
+        return;
+
+    switch (statement->type) {
+    case BLOCK_STMT: {
+        BlockStmt* blockStmt = statement->stmt;
+
+        bool opensScope = false;
+        vector_foreach(declaration, blockStmt->declarations) {
+            opensScope = opensScope || declares_name(*declaration);
+        }
+
+        if (opensScope) {
+            begin_scope(resolver);
+        }
+
+        vector_foreach(declaration, blockStmt->declarations) {
+            resolve_decl(resolver, *declaration);
+        }
+
+        if (opensScope) {
+            end_scope(resolver, &blockStmt->scope);
+        }
+        break;
+    }
+    case EXPRESSION_STMT: {
+        ExpressionStmt* exprStmt = statement->stmt;
+
+        resolve_expr(resolver, exprStmt->expression);
+        break;
+    }
+    case RETURN_STMT: {
+        ReturnStmt* returnStmt = statement->stmt;
+
+        resolve_expr(resolver, returnStmt->expression);
+        break;
+    }
+    case IF_STMT: {
+        IfStmt* ifStmt = statement->stmt;
+
+        /* branches are statements, so the if itself never declares anything */
+        resolve_expr(resolver, ifStmt->condition);
+        resolve_stmt(resolver, ifStmt->thenBranch);
+        resolve_stmt(resolver, ifStmt->elseBranch);
+        break;
+    }
+    case WHILE_STMT: {
+        WhileStmt* whileStmt = statement->stmt;
+
+        resolve_expr(resolver, whileStmt->condition);
+        resolve_stmt(resolver, whileStmt->body);
+        break;
+    }
+    case FOR_STMT: {
+        ForStmt* forStmt = statement->stmt;
+
+        bool opensScope = declares_name(forStmt->initialization);
+
+        if (opensScope) {
+            begin_scope(resolver);
+        }
+
+        resolve_decl(resolver, forStmt->initialization);
+        resolve_expr(resolver, forStmt->condition);
+        resolve_stmt(resolver, forStmt->body);
+        resolve_expr(resolver, forStmt->action);
+
+        if (opensScope) {
+            end_scope(resolver, &forStmt->scope);
+        }
+        break;
+    }
+    case BREAK_STMT:
+    case CONTINUE_STMT:
+    default:
+        break;
+    }
+}
+
+static void resolve_expr(Resolver* resolver, Expr* expression) {
+    if (expression == NULL)
+        return;
+
+    switch (expression->type) {
+    case BINARY_EXPR: {
+        BinaryExpr* binaryExpr = expression->expr;
+
+        resolve_expr(resolver, binaryExpr->left);
+        resolve_expr(resolver, binaryExpr->right);
+        break;
+    }
+    case GROUP_EXPR: {
+        GroupExpr* groupExpr = expression->expr;
+
+        resolve_expr(resolver, groupExpr->expression);
+        break;
+    }
+    case ASSIGN_EXPR: {
+        AssignExpr* assignExpr = expression->expr;
+
+        resolve_expr(resolver, assignExpr->identifier);
+        resolve_expr(resolver, assignExpr->expression);
+        break;
+    }
+    case CALL_EXPR: {
+        CallExpr* callExpr = expression->expr;
+
+        resolve_expr(resolver, callExpr->callee);
+
+        vector_foreach(argument, callExpr->arguments) {
+            resolve_expr(resolver, *argument);
+        }
+        break;
+    }
+    case LOGICAL_EXPR: {
+        LogicalExpr* logicalExpr = expression->expr;
+
+        resolve_expr(resolver, logicalExpr->left);
+        resolve_expr(resolver, logicalExpr->right);
+        break;
+    }
+    case UNARY_EXPR: {
+        UnaryExpr* unaryExpr = expression->expr;
+
+        resolve_expr(resolver, unaryExpr->expression);
+        break;
+    }
+    case UPDATE_EXPR: {
+        UpdateExpr* updateExpr = expression->expr;
+
+        resolve_expr(resolver, updateExpr->expression);
+        break;
+    }
+    case FIELD_INIT_EXPR: {
+        FieldInitExpr* fieldInitExpr = expression->expr;
+
+        resolve_expr(resolver, fieldInitExpr->value);
+        break;
+    }
+    case STRUCT_INIT_EXPR: {
+        StructInitExpr* structInitExpr = expression->expr;
+
+        list_foreach(field, structInitExpr->fields) {
+            resolve_expr(resolver, field->value);
+        }
+        break;
+    }
+    case STRUCT_INLINE_EXPR: {
+        StructInlineExpr* structInlineExpr = expression->expr;
+
+        list_foreach(field, structInlineExpr->fields) {
+            resolve_expr(resolver, field->value);
+        }
+        break;
+    }
+    case ARRAY_INIT_EXPR: {
+        ArrayInitExpr* arrayInitExpr = expression->expr;
+
+        list_foreach(element, arrayInitExpr->elements) {
+            resolve_expr(resolver, element->value);
+        }
+        break;
+    }
+    case MAP_INIT_EXPR: {
+        MapInitExpr* mapInitExpr = expression->expr;
+
+        list_foreach(key, mapInitExpr->keys) {
+            resolve_expr(resolver, key->value);
+        }
+
+        list_foreach(value, mapInitExpr->values) {
+            resolve_expr(resolver, value->value);
+        }
+        break;
+    }
+    case FUNC_EXPR: {
+        FunctionExpr* functionExpr = expression->expr;
+
+        resolve_function(resolver, functionExpr->parameters, functionExpr->body, &functionExpr->scope);
+        break;
+    }
+    case CONDITIONAL_EXPR: {
+        ConditionalExpr* conditionalExpr = expression->expr;
+
+        resolve_expr(resolver, conditionalExpr->condition);
+        resolve_expr(resolver, conditionalExpr->isTrue);
+        resolve_expr(resolver, conditionalExpr->isFalse);
+        break;
+    }
+    case MEMBER_EXPR: {
+        MemberExpr* memberExpr = expression->expr;
+
+        /* members are field names, not variables */
+        resolve_expr(resolver, memberExpr->object);
+        break;
+    }
+    case ARRAY_MEMBER_EXPR: {
+        ArrayMemberExpr* arrayMemberExpr = expression->expr;
+
+        resolve_expr(resolver, arrayMemberExpr->object);
+
+        list_foreach(level, arrayMemberExpr->levelOfAccess) {
+            resolve_expr(resolver, level->value);
+        }
+        break;
+    }
+    case CAST_EXPR: {
+        CastExpr* castExpr = expression->expr;
+
+        resolve_expr(resolver, castExpr->target);
+        break;
+    }
+    case LITERAL_EXPR: {
+        LiteralExpr* literalExpr = expression->expr;
+
+        if (literalExpr->type == IDENT_LITERAL) {
+            resolve_ident(resolver, literalExpr->value);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+static void declare_top_level(Resolver* resolver, Decl* decl) {
+    if (decl->type == LET_DECL) {
+        declare(resolver, ((LetDecl*) decl->decl)->name->literal);
+    } else if (decl->type == CONST_DECL) {
+        declare(resolver, ((ConstDecl*) decl->decl)->name->literal);
+    } else if (decl->type == FUNC_DECL) {
+        declare(resolver, ((FunctionDecl*) decl->decl)->name->literal);
+    }
+}
+
+ResolverStatus resolve(List* declarations, char** builtins, size_t builtinCount) {
+    if (declarations == NULL)
+        return RESOLVER_SUCCESS;
+
+    Resolver resolver = {
+        .scope = NULL,
+        .currentStatus = RESOLVER_SUCCESS
+    };
+
+    begin_scope(&resolver);
+
+    for (size_t i = 0; i < builtinCount; i++) {
+        declare(&resolver, symbol_intern(builtins[i]));
+    }
+
+    /* top-level names are visible to every function body, even the ones
+       declared before them */
+    list_foreach(declaration, declarations) {
+        declare_top_level(&resolver, declaration->value);
+    }
+
+    list_foreach(declaration, declarations) {
+        resolve_decl(&resolver, declaration->value);
+    }
+
+    end_scope(&resolver, NULL);
+
+    return resolver.currentStatus;
+}
+
+Resolver* resolver_new(char** builtins, size_t builtinCount) {
+    Resolver* resolver = NULL;
+    resolver = safe_malloc(sizeof(Resolver), NULL);
+    if (resolver == NULL) {
+        return NULL;
+    }
+
+    *resolver = (Resolver) {
+        .scope = NULL,
+        .currentStatus = RESOLVER_SUCCESS
+    };
+
+    begin_scope(resolver);
+
+    for (size_t i = 0; i < builtinCount; i++) {
+        declare(resolver, symbol_intern(builtins[i]));
+    }
+
+    return resolver;
+}
+
+ResolverStatus resolve_next(Resolver* resolver, Decl* declaration) {
+    if (resolver == NULL || declaration == NULL)
+        return RESOLVER_SUCCESS;
+
+    declare_top_level(resolver, declaration);
+    resolve_decl(resolver, declaration);
+
+    return resolver->currentStatus;
+}
+
+void resolver_free(Resolver** resolver) {
+    if (resolver == NULL || *resolver == NULL)
+        return;
+
+    end_scope(*resolver, NULL);
+
+    safe_free((void**) resolver);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "ast.h"
+#include "list.h"
+#include "map.h"
+
+
+typedef enum ResolverStatus {
+    RESOLVER_SUCCESS,
+    RESOLVER_FAILURE
+} ResolverStatus;
+
+typedef struct Scope {
+    Map* names; /* Map of (char*, size_t*) */
+    size_t count;
+    bool isCapturable;
+    struct Scope* enclosing;
+} Scope;
+
+typedef struct Resolver {
+    Scope* scope;
+    ResolverStatus currentStatus;
+} Resolver;
+
+/*
+ * Annotates every identifier with the (depth, slot) pair of its binding and
+ * every declaration with its slot. Scopes mirror the ones the interpreter
+ * creates at runtime, so depth is the number of enclosing contexts to walk.
+ * Scopes that declare nothing are elided, and every scope that is opened
+ * gets its ScopeLayout recorded on the node that owns it.
+ */
+ResolverStatus resolve(List* declarations, char** builtins, size_t builtinCount);
+
+/*
+ * The same resolution one top-level declaration at a time, for a driver that
+ * runs each one as soon as it is parsed. The global scope lives on between
+ * calls, so a declaration sees the top-level names declared before it and
+ * its own, but none of the ones still to come.
+ */
+Resolver* resolver_new(char** builtins, size_t builtinCount);
+ResolverStatus resolve_next(Resolver* resolver, Decl* declaration);
+void resolver_free(Resolver** resolver);
@@ -0,0 +1,270 @@
+/*
+ * Vector kernels, included once per instruction set by simd.c with
+ * SIMD_TARGET (the target attribute), SIMD_WIDTH (vector bytes) and
+ * SIMD_NAME(name) (the suffixed function name) defined. The vectors are
+ * gcc's generic ones, so every level shares this code and the compiler picks
+ * the instructions the target allows. Loads and stores go through
+ * may_alias types aligned to the element, the buffers carry no stronger
+ * guarantee.
+ */
+
+#define SIMD_LANES (SIMD_WIDTH / 8)
+
+typedef uint64_t SIMD_NAME(vu) __attribute__((vector_size(SIMD_WIDTH), aligned(8), may_alias));
+typedef int64_t SIMD_NAME(vi) __attribute__((vector_size(SIMD_WIDTH), aligned(8), may_alias));
+typedef double SIMD_NAME(vf) __attribute__((vector_size(SIMD_WIDTH), aligned(8), may_alias));
+
+#define VU SIMD_NAME(vu)
+#define VI SIMD_NAME(vi)
+#define VF SIMD_NAME(vf)
+
+/* picks lanes of a where mask is set and of b elsewhere */
+#define SIMD_SELECT(mask, a, b) (((a) & (mask)) | ((b) & ~(mask)))
+
+__attribute__((target(SIMD_TARGET)))
+static int64_t SIMD_NAME(sum_int)(const int64_t* a, size_t size) {
+    VU acc = {0};
+    size_t i = 0;
+
+    for (; i + SIMD_LANES <= size; i += SIMD_LANES) {
+        acc += *(const VU*) (a + i);
+    }
+
+    uint64_t total = 0;
+    for (size_t lane = 0; lane < SIMD_LANES; lane++) {
+        total += acc[lane];
+    }
+    for (; i < size; i++) {
+        total += (uint64_t) a[i];
+    }
+
+    return (int64_t) total;
+}
+
+__attribute__((target(SIMD_TARGET)))
+static double SIMD_NAME(sum_float)(const double* a, size_t size) {
+    VF acc = {0};
+    size_t i = 0;
+
+    for (; i + SIMD_LANES <= size; i += SIMD_LANES) {
+        acc += *(const VF*) (a + i);
+    }
+
+    double total = 0;
+    for (size_t lane = 0; lane < SIMD_LANES; lane++) {
+        total += acc[lane];
+    }
+    for (; i < size; i++) {
+        total += a[i];
+    }
+
+    return total;
+}
+
+#define SIMD_EXTREME_INT(a, size, op)                                          \
+    size_t i = 0;                                                              \
+    int64_t best = (a)[0];                                                     \
+                                                                               \
+    if ((size) >= SIMD_LANES) {                                                \
+        VI acc = *(const VI*) (a);                                             \
+        for (i = SIMD_LANES; i + SIMD_LANES <= (size); i += SIMD_LANES) {      \
+            VI v = *(const VI*) ((a) + i);                                     \
+            acc = SIMD_SELECT(v op acc, v, acc);                               \
+        }                                                                      \
+        best = acc[0];                                                         \
+        for (size_t lane = 1; lane < SIMD_LANES; lane++) {                     \
+            best = acc[lane] op best ? acc[lane] : best;                       \
+        }                                                                      \
+    }                                                                          \
+    for (; i < (size); i++) {                                                  \
+        best = (a)[i] op best ? (a)[i] : best;                                 \
+    }                                                                          \
+    return best;
+
+#define SIMD_EXTREME_FLOAT(a, size, op)                                        \
+    size_t i = 0;                                                              \
+    double best = (a)[0];                                                      \
+                                                                               \
+    if ((size) >= SIMD_LANES) {                                                \
+        VF acc = *(const VF*) (a);                                             \
+        for (i = SIMD_LANES; i + SIMD_LANES <= (size); i += SIMD_LANES) {      \
+            VF v = *(const VF*) ((a) + i);                                     \
+            acc = (VF) SIMD_SELECT(v op acc, (VI) v, (VI) acc);                \
+        }                                                                      \
+        best = acc[0];                                                         \
+        for (size_t lane = 1; lane < SIMD_LANES; lane++) {                     \
+            best = acc[lane] op best ? acc[lane] : best;                       \
+        }                                                                      \
+    }                                                                          \
+    for (; i < (size); i++) {                                                  \
+        best = (a)[i] op best ? (a)[i] : best;                                 \
+    }                                                                          \
+    return best;
+
+__attribute__((target(SIMD_TARGET)))
+static int64_t SIMD_NAME(min_int)(const int64_t* a, size_t size) {
+    SIMD_EXTREME_INT(a, size, <)
+}
+
+__attribute__((target(SIMD_TARGET)))
+static double SIMD_NAME(min_float)(const double* a, size_t size) {
+    SIMD_EXTREME_FLOAT(a, size, <)
+}
+
+__attribute__((target(SIMD_TARGET)))
+static int64_t SIMD_NAME(max_int)(const int64_t* a, size_t size) {
+    SIMD_EXTREME_INT(a, size, >)
+}
+
+__attribute__((target(SIMD_TARGET)))
+static double SIMD_NAME(max_float)(const double* a, size_t size) {
+    SIMD_EXTREME_FLOAT(a, size, >)
+}
+
+__attribute__((target(SIMD_TARGET)))
+static int64_t SIMD_NAME(dot_int)(const int64_t* a, const int64_t* b, size_t size) {
+    VU acc = {0};
+    size_t i = 0;
+
+    for (; i + SIMD_LANES <= size; i += SIMD_LANES) {
+        acc += *(const VU*) (a + i) * *(const VU*) (b + i);
+    }
+
+    uint64_t total = 0;
+    for (size_t lane = 0; lane < SIMD_LANES; lane++) {
+        total += acc[lane];
+    }
+    for (; i < size; i++) {
+        total += (uint64_t) a[i] * (uint64_t) b[i];
+    }
+
+    return (int64_t) total;
+}
+
+__attribute__((target(SIMD_TARGET)))
+static double SIMD_NAME(dot_float)(const double* a, const double* b, size_t size) {
+    VF acc = {0};
+    size_t i = 0;
+
+    for (; i + SIMD_LANES <= size; i += SIMD_LANES) {
+        acc += *(const VF*) (a + i) * *(const VF*) (b + i);
+    }
+
+    double total = 0;
+    for (size_t lane = 0; lane < SIMD_LANES; lane++) {
+        total += acc[lane];
+    }
+    for (; i < size; i++) {
+        total += a[i] * b[i];
+    }
+
+    return total;
+}
+
+__attribute__((target(SIMD_TARGET)))
+static void SIMD_NAME(axpy_int)(int64_t alpha, const int64_t* x, int64_t* y, size_t size) {
+    size_t i = 0;
+
+    for (; i + SIMD_LANES <= size; i += SIMD_LANES) {
+        *(VU*) (y + i) = (uint64_t) alpha * *(const VU*) (x + i) + *(VU*) (y + i);
+    }
+    for (; i < size; i++) {
+        y[i] = (int64_t) ((uint64_t) alpha * (uint64_t) x[i] + (uint64_t) y[i]);
+    }
+}
+
+__attribute__((target(SIMD_TARGET)))
+static void SIMD_NAME(axpy_float)(double alpha, const double* x, double* y, size_t size) {
+    size_t i = 0;
+
+    for (; i + SIMD_LANES <= size; i += SIMD_LANES) {
+        *(VF*) (y + i) = alpha * *(const VF*) (x + i) + *(VF*) (y + i);
+    }
+    for (; i < size; i++) {
+        y[i] = alpha * x[i] + y[i];
+    }
+}
+
+#define SIMD_MAP(vector, scalar, a, k, out, size, op)                          \
+    size_t i = 0;                                                              \
+                                                                               \
+    for (; i + SIMD_LANES <= (size); i += SIMD_LANES) {                        \
+        *(vector*) ((out) + i) = *(const vector*) ((a) + i) op (scalar) (k);   \
+    }                                                                          \
+    for (; i < (size); i++) {                                                  \
+        (out)[i] = (scalar) (a)[i] op (scalar) (k);                            \
+    }
+
+__attribute__((target(SIMD_TARGET)))
+static void SIMD_NAME(add_int)(const int64_t* a, int64_t k, int64_t* out, size_t size) {
+    SIMD_MAP(VU, uint64_t, a, k, out, size, +)
+}
+
+__attribute__((target(SIMD_TARGET)))
+static void SIMD_NAME(add_float)(const double* a, double k, double* out, size_t size) {
+    SIMD_MAP(VF, double, a, k, out, size, +)
+}
+
+__attribute__((target(SIMD_TARGET)))
+static void SIMD_NAME(mul_int)(const int64_t* a, int64_t k, int64_t* out, size_t size) {
+    SIMD_MAP(VU, uint64_t, a, k, out, size, *)
+}
+
+__attribute__((target(SIMD_TARGET)))
+static void SIMD_NAME(mul_float)(const double* a, double k, double* out, size_t size) {
+    SIMD_MAP(VF, double, a, k, out, size, *)
+}
+
+__attribute__((target(SIMD_TARGET)))
+static void SIMD_NAME(fill_int)(int64_t* a, int64_t value, size_t size) {
+    VI broadcast = (VI) {0} + value;
+    size_t i = 0;
+
+    for (; i + SIMD_LANES <= size; i += SIMD_LANES) {
+        *(VI*) (a + i) = broadcast;
+    }
+    for (; i < size; i++) {
+        a[i] = value;
+    }
+}
+
+__attribute__((target(SIMD_TARGET)))
+static void SIMD_NAME(fill_float)(double* a, double value, size_t size) {
+    VF broadcast = (VF) {0} + value;
+    size_t i = 0;
+
+    for (; i + SIMD_LANES <= size; i += SIMD_LANES) {
+        *(VF*) (a + i) = broadcast;
+    }
+    for (; i < size; i++) {
+        a[i] = value;
+    }
+}
+
+static const SimdKernels SIMD_NAME(kernels) = {
+    .sum_int    = SIMD_NAME(sum_int),
+    .sum_float  = SIMD_NAME(sum_float),
+    .min_int    = SIMD_NAME(min_int),
+    .min_float  = SIMD_NAME(min_float),
+    .max_int    = SIMD_NAME(max_int),
+    .max_float  = SIMD_NAME(max_float),
+    .dot_int    = SIMD_NAME(dot_int),
+    .dot_float  = SIMD_NAME(dot_float),
+    .axpy_int   = SIMD_NAME(axpy_int),
+    .axpy_float = SIMD_NAME(axpy_float),
+    .add_int    = SIMD_NAME(add_int),
+    .add_float  = SIMD_NAME(add_float),
+    .mul_int    = SIMD_NAME(mul_int),
+    .mul_float  = SIMD_NAME(mul_float),
+    .fill_int   = SIMD_NAME(fill_int),
+    .fill_float = SIMD_NAME(fill_float)
+};
+
+#undef SIMD_MAP
+#undef SIMD_EXTREME_FLOAT
+#undef SIMD_EXTREME_INT
+#undef SIMD_SELECT
+#undef VF
+#undef VI
+#undef VU
+#undef SIMD_LANES
@@ -0,0 +1,208 @@
+#include "simd.h"
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_X86 1
+#endif
+
+static int64_t sum_int_scalar(const int64_t* a, size_t size) {
+    uint64_t total = 0;
+    for (size_t i = 0; i < size; i++) {
+        total += (uint64_t) a[i];
+    }
+    return (int64_t) total;
+}
+
+static double sum_float_scalar(const double* a, size_t size) {
+    double total = 0;
+    for (size_t i = 0; i < size; i++) {
+        total += a[i];
+    }
+    return total;
+}
+
+static int64_t min_int_scalar(const int64_t* a, size_t size) {
+    int64_t best = a[0];
+    for (size_t i = 1; i < size; i++) {
+        best = a[i] < best ? a[i] : best;
+    }
+    return best;
+}
+
+static double min_float_scalar(const double* a, size_t size) {
+    double best = a[0];
+    for (size_t i = 1; i < size; i++) {
+        best = a[i] < best ? a[i] : best;
+    }
+    return best;
+}
+
+static int64_t max_int_scalar(const int64_t* a, size_t size) {
+    int64_t best = a[0];
+    for (size_t i = 1; i < size; i++) {
+        best = a[i] > best ? a[i] : best;
+    }
+    return best;
+}
+
+static double max_float_scalar(const double* a, size_t size) {
+    double best = a[0];
+    for (size_t i = 1; i < size; i++) {
+        best = a[i] > best ? a[i] : best;
+    }
+    return best;
+}
+
+static int64_t dot_int_scalar(const int64_t* a, const int64_t* b, size_t size) {
+    uint64_t total = 0;
+    for (size_t i = 0; i < size; i++) {
+        total += (uint64_t) a[i] * (uint64_t) b[i];
+    }
+    return (int64_t) total;
+}
+
+static double dot_float_scalar(const double* a, const double* b, size_t size) {
+    double total = 0;
+    for (size_t i = 0; i < size; i++) {
+        total += a[i] * b[i];
+    }
+    return total;
+}
+
+static void axpy_int_scalar(int64_t alpha, const int64_t* x, int64_t* y, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        y[i] = (int64_t) ((uint64_t) alpha * (uint64_t) x[i] + (uint64_t) y[i]);
+    }
+}
+
+static void axpy_float_scalar(double alpha, const double* x, double* y, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        y[i] = alpha * x[i] + y[i];
+    }
+}
+
+static void add_int_scalar(const int64_t* a, int64_t k, int64_t* out, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        out[i] = (int64_t) ((uint64_t) a[i] + (uint64_t) k);
+    }
+}
+
+static void add_float_scalar(const double* a, double k, double* out, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        out[i] = a[i] + k;
+    }
+}
+
+static void mul_int_scalar(const int64_t* a, int64_t k, int64_t* out, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        out[i] = (int64_t) ((uint64_t) a[i] * (uint64_t) k);
+    }
+}
+
+static void mul_float_scalar(const double* a, double k, double* out, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        out[i] = a[i] * k;
+    }
+}
+
+static void fill_int_scalar(int64_t* a, int64_t value, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        a[i] = value;
+    }
+}
+
+static void fill_float_scalar(double* a, double value, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        a[i] = value;
+    }
+}
+
+static const SimdKernels kernels_scalar = {
+    .sum_int    = sum_int_scalar,
+    .sum_float  = sum_float_scalar,
+    .min_int    = min_int_scalar,
+    .min_float  = min_float_scalar,
+    .max_int    = max_int_scalar,
+    .max_float  = max_float_scalar,
+    .dot_int    = dot_int_scalar,
+    .dot_float  = dot_float_scalar,
+    .axpy_int   = axpy_int_scalar,
+    .axpy_float = axpy_float_scalar,
+    .add_int    = add_int_scalar,
+    .add_float  = add_float_scalar,
+    .mul_int    = mul_int_scalar,
+    .mul_float  = mul_float_scalar,
+    .fill_int   = fill_int_scalar,
+    .fill_float = fill_float_scalar
+};
+
+#ifdef SIMD_X86
+
+#define SIMD_TARGET "sse2"
+#define SIMD_WIDTH 16
+#define SIMD_NAME(name) name##_sse2
+#include "simd-kernels.h"
+#undef SIMD_NAME
+#undef SIMD_WIDTH
+#undef SIMD_TARGET
+
+#define SIMD_TARGET "avx2"
+#define SIMD_WIDTH 32
+#define SIMD_NAME(name) name##_avx2
+#include "simd-kernels.h"
+#undef SIMD_NAME
+#undef SIMD_WIDTH
+#undef SIMD_TARGET
+
+#endif
+
+/* probed once for the process, whichever thread asks first */
+static SimdLevel level = SIMD_SCALAR;
+static pthread_once_t probed = PTHREAD_ONCE_INIT;
+
+static void probe_level(void) {
+#ifdef SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        level = SIMD_AVX2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        level = SIMD_SSE2;
+    } else {
+        level = SIMD_SCALAR;
+    }
+#else
+    level = SIMD_SCALAR;
+#endif
+}
+
+SimdLevel simd_level(void) {
+    pthread_once(&probed, probe_level);
+
+    return level;
+}
+
+const SimdKernels* simd_kernels(void) {
+    return simd_kernels_for(simd_level());
+}
+
+const SimdKernels* simd_kernels_for(SimdLevel level) {
+    if (level > simd_level())
+        return NULL;
+
+    switch (level) {
+#ifdef SIMD_X86
+    case SIMD_AVX2:
+        return &kernels_avx2;
+    case SIMD_SSE2:
+        return &kernels_sse2;
+#endif
+    case SIMD_SCALAR:
+        return &kernels_scalar;
+    default:
+        return NULL;
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+typedef enum SimdLevel {
+    SIMD_SCALAR,
+    SIMD_SSE2,
+    SIMD_AVX2
+} SimdLevel;
+
+/*
+ * Kernels over contiguous int64 and double buffers. min and max expect at
+ * least one element. add and mul write a[i] + k and a[i] * k into out, axpy
+ * updates y in place with alpha * x[i] + y[i]. Integer arithmetic wraps
+ * like the interpreter's; float reductions keep one partial sum per lane,
+ * so their rounding may differ from a left-to-right loop.
+ */
+typedef struct SimdKernels {
+    int64_t (*sum_int)(const int64_t* a, size_t size);
+    double (*sum_float)(const double* a, size_t size);
+    int64_t (*min_int)(const int64_t* a, size_t size);
+    double (*min_float)(const double* a, size_t size);
+    int64_t (*max_int)(const int64_t* a, size_t size);
+    double (*max_float)(const double* a, size_t size);
+    int64_t (*dot_int)(const int64_t* a, const int64_t* b, size_t size);
+    double (*dot_float)(const double* a, const double* b, size_t size);
+    void (*axpy_int)(int64_t alpha, const int64_t* x, int64_t* y, size_t size);
+    void (*axpy_float)(double alpha, const double* x, double* y, size_t size);
+    void (*add_int)(const int64_t* a, int64_t k, int64_t* out, size_t size);
+    void (*add_float)(const double* a, double k, double* out, size_t size);
+    void (*mul_int)(const int64_t* a, int64_t k, int64_t* out, size_t size);
+    void (*mul_float)(const double* a, double k, double* out, size_t size);
+    void (*fill_int)(int64_t* a, int64_t value, size_t size);
+    void (*fill_float)(double* a, double value, size_t size);
+} SimdKernels;
+
+/* the widest level the cpu supports, probed with cpuid on first use */
+SimdLevel simd_level(void);
+
+/* kernels for the detected level */
+const SimdKernels* simd_kernels(void);
+
+/* kernels for a given level, NULL when this build or cpu lacks it */
+const SimdKernels* simd_kernels_for(SimdLevel level);
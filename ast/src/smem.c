@@ -76,3 +76,160 @@ void safe_free(void** ptr) {
     free(*ptr);
     *ptr = NULL;
 }
+
+/* slab header padded so the first object keeps malloc's alignment */
+#define SLAB_HEADER_SIZE \
+    ((sizeof(SmemSlab) + SMEM_SIZE_CLASS_ALIGN - 1) & ~((size_t) SMEM_SIZE_CLASS_ALIGN - 1))
+
+#define SIZE_CLASS_COUNT (SMEM_MAX_SIZE_CLASS / SMEM_SIZE_CLASS_ALIGN)
+
+static _Thread_local SmemPool sizeClasses[SIZE_CLASS_COUNT];
+
+static size_t round_up(size_t size) {
+    return (size + SMEM_SIZE_CLASS_ALIGN - 1) & ~((size_t) SMEM_SIZE_CLASS_ALIGN - 1);
+}
+
+static void pool_init(SmemPool* pool, size_t objectSize, size_t objectsPerSlab) {
+    objectSize = round_up(objectSize < sizeof(void*) ? sizeof(void*) : objectSize);
+
+    if (objectsPerSlab == 0) {
+        objectsPerSlab = SMEM_SLAB_SIZE / objectSize;
+    }
+
+    *pool = (SmemPool) {
+        .objectSize = objectSize,
+        .objectsPerSlab = objectsPerSlab > 0 ? objectsPerSlab : 1,
+        .freeList = NULL,
+        .bump = NULL,
+        .bumpEnd = NULL,
+        .slabs = NULL,
+        .slabCount = 0,
+        .liveObjects = 0
+    };
+}
+
+static void pool_release(SmemPool* pool) {
+    SmemSlab* slab = pool->slabs;
+    while (slab != NULL) {
+        SmemSlab* next = slab->next;
+        free(slab);
+        slab = next;
+    }
+
+    pool_init(pool, pool->objectSize, pool->objectsPerSlab);
+}
+
+SmemPool* smem_pool_new(size_t objectSize, size_t objectsPerSlab) {
+    if (objectSize < 1)
+        return NULL;
+
+    SmemPool* pool = NULL;
+    pool = safe_malloc(sizeof(SmemPool), NULL);
+    if (pool == NULL) {
+        return NULL;
+    }
+
+    pool_init(pool, objectSize, objectsPerSlab);
+
+    return pool;
+}
+
+void* smem_pool_alloc(SmemPool* pool) {
+    if (pool == NULL)
+        return NULL;
+
+#ifdef SMEM_NO_POOLS
+    pool->liveObjects++;
+    return safe_malloc(pool->objectSize, NULL);
+#else
+    void* ptr = pool->freeList;
+
+    if (ptr != NULL) {
+        pool->freeList = *(void**) ptr;
+    } else {
+        if (pool->bump == pool->bumpEnd) {
+            SmemSlab* slab = malloc(SLAB_HEADER_SIZE + pool->objectSize * pool->objectsPerSlab);
+            if (slab == NULL)
+                return NULL;
+
+            slab->next = pool->slabs;
+            pool->slabs = slab;
+            pool->slabCount++;
+
+            pool->bump = (char*) slab + SLAB_HEADER_SIZE;
+            pool->bumpEnd = pool->bump + pool->objectSize * pool->objectsPerSlab;
+        }
+
+        ptr = pool->bump;
+        pool->bump += pool->objectSize;
+    }
+
+    pool->liveObjects++;
+
+    return ptr;
+#endif
+}
+
+void smem_pool_free(SmemPool* pool, void** ptr) {
+    if (pool == NULL || ptr == NULL || *ptr == NULL)
+        return;
+
+    pool->liveObjects--;
+
+#ifdef SMEM_NO_POOLS
+    safe_free(ptr);
+#else
+    *(void**) *ptr = pool->freeList;
+    pool->freeList = *ptr;
+    *ptr = NULL;
+#endif
+}
+
+void smem_pool_destroy(SmemPool** pool) {
+    if (pool == NULL || *pool == NULL)
+        return;
+
+    pool_release(*pool);
+
+    safe_free((void**) pool);
+}
+
+SmemPool* smem_size_class(size_t size) {
+    if (size < 1 || size > SMEM_MAX_SIZE_CLASS)
+        return NULL;
+
+    SmemPool* pool = &sizeClasses[round_up(size) / SMEM_SIZE_CLASS_ALIGN - 1];
+
+    if (pool->objectSize == 0) {
+        pool_init(pool, round_up(size), 0);
+    }
+
+    return pool;
+}
+
+void* smem_alloc(size_t size) {
+    SmemPool* pool = smem_size_class(size);
+    if (pool == NULL)
+        return safe_malloc(size, NULL);
+
+    return smem_pool_alloc(pool);
+}
+
+void smem_free(void** ptr, size_t size) {
+    SmemPool* pool = smem_size_class(size);
+    if (pool == NULL) {
+        safe_free(ptr);
+        return;
+    }
+
+    smem_pool_free(pool, ptr);
+}
+
+/* drops every size class slab, only safe once nothing allocated from them is alive */
+void smem_release(void) {
+    for (size_t i = 0; i < SIZE_CLASS_COUNT; i++) {
+        if (sizeClasses[i].objectSize != 0) {
+            pool_release(&sizeClasses[i]);
+        }
+    }
+}
@@ -9,3 +9,43 @@ void* safe_malloc(size_t size, error_callback cb);
 void* safe_calloc(size_t nmemb, size_t size, error_callback cb);
 void* safe_realloc(void** ptr, size_t size, error_callback cb);
 void safe_free(void** ptr);
+
+/*
+ * Slab pools for small fixed-size structures. A pool carves objects out of
+ * large slabs and recycles freed objects through an intrusive free list;
+ * slabs are only returned to the system when the pool is destroyed.
+ *
+ * smem_alloc/smem_free route sizes up to SMEM_MAX_SIZE_CLASS to a pool per
+ * size class and everything else to malloc, so they must always be called
+ * with the same size. Each thread has its own size classes and smem_release
+ * drops the calling thread's. Building with -DSMEM_NO_POOLS sends every
+ * request to malloc, which keeps valgrind and sanitizers precise.
+ */
+#define SMEM_SIZE_CLASS_ALIGN 16
+#define SMEM_MAX_SIZE_CLASS 256
+#define SMEM_SLAB_SIZE (32 * 1024)
+
+typedef struct SmemSlab {
+    struct SmemSlab* next;
+} SmemSlab;
+
+typedef struct SmemPool {
+    size_t objectSize;
+    size_t objectsPerSlab;
+    void* freeList;
+    char* bump;       /* unused tail of the newest slab */
+    char* bumpEnd;
+    SmemSlab* slabs;
+    size_t slabCount;
+    size_t liveObjects;
+} SmemPool;
+
+SmemPool* smem_pool_new(size_t objectSize, size_t objectsPerSlab);
+void* smem_pool_alloc(SmemPool* pool);
+void smem_pool_free(SmemPool* pool, void** ptr);
+void smem_pool_destroy(SmemPool** pool);
+
+SmemPool* smem_size_class(size_t size);
+void* smem_alloc(size_t size);
+void smem_free(void** ptr, size_t size);
+void smem_release(void);
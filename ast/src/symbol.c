@@ -0,0 +1,102 @@
+#include "symbol.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "map.h"
+#include "smem.h"
+#include "utils.h"
+
+
+struct SymbolTable {
+    Map* symbols; /* Map of (char*, Symbol*), the key is the symbol's own name */
+    const SymbolTable* builtins;
+};
+
+static _Thread_local SymbolTable* active = NULL;
+
+static bool entry_cmp(const MapEntry** entry, char** key) {
+    return strcmp((*entry)->key, *key) == 0;
+}
+
+SymbolTable* symbol_table_new(const SymbolTable* builtins) {
+    SymbolTable* table = safe_malloc(sizeof(SymbolTable), NULL);
+    if (table == NULL) {
+        return NULL;
+    }
+
+    *table = (SymbolTable) {
+        .symbols = MAP_NEW(256, entry_cmp, NULL, safe_free),
+        .builtins = builtins
+    };
+
+    return table;
+}
+
+void symbol_table_set_active(SymbolTable* table) {
+    active = table;
+}
+
+SymbolTable* symbol_table_active(void) {
+    return active;
+}
+
+char* symbol_table_intern(SymbolTable* table, const char* name) {
+    if (table == NULL || name == NULL)
+        return NULL;
+
+    Symbol* symbol = table->builtins != NULL ? map_get(table->builtins->symbols, (void*) name) : NULL;
+    if (symbol != NULL) {
+        return symbol->name;
+    }
+
+    symbol = map_get(table->symbols, (void*) name);
+    if (symbol != NULL) {
+        return symbol->name;
+    }
+
+    size_t length = strlen(name);
+
+    symbol = safe_malloc(sizeof(Symbol) + length + 1, NULL);
+    if (symbol == NULL) {
+        return NULL;
+    }
+
+    symbol->hash = hash_string(name);
+    symbol->length = length;
+    memcpy(symbol->name, name, length + 1);
+
+    map_put(table->symbols, symbol->name, symbol);
+
+    return symbol->name;
+}
+
+char* symbol_intern(const char* name) {
+    return symbol_table_intern(active, name);
+}
+
+Symbol* symbol_of(const char* name) {
+    return (Symbol*) (name - offsetof(Symbol, name));
+}
+
+size_t symbol_hash(const char* name) {
+    return symbol_of(name)->hash;
+}
+
+size_t symbol_table_size(const SymbolTable* table) {
+    return table != NULL ? map_size(table->symbols) : 0;
+}
+
+void symbol_table_free(SymbolTable** table) {
+    if (table == NULL || *table == NULL)
+        return;
+
+    if (active == *table) {
+        active = NULL;
+    }
+
+    map_free(&(*table)->symbols);
+
+    safe_free((void**) table);
+}
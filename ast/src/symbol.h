@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stddef.h>
+
+
+/*
+ * Interned identifiers. A name interned into a table is the one copy of it
+ * in that table, so two names interned into the same table are equal exactly
+ * when they are the same pointer, and its hash is computed once and kept in
+ * front of the characters. The returned name is an ordinary string that must
+ * not be modified or freed; it stays valid until its table is freed.
+ */
+typedef struct Symbol {
+    size_t hash;
+    size_t length;
+    char name[];
+} Symbol;
+
+/*
+ * Every run owns a table, the driver keeps it in the run's ParserState.
+ * builtins, when given, is read first and never written, so one table of
+ * builtin names can back the tables of any number of runs at once, as long
+ * as it outlives them.
+ */
+typedef struct SymbolTable SymbolTable;
+
+SymbolTable* symbol_table_new(const SymbolTable* builtins);
+char* symbol_table_intern(SymbolTable* table, const char* name);
+size_t symbol_table_size(const SymbolTable* table);
+void symbol_table_free(SymbolTable** table);
+
+/* the table symbol_intern uses on this thread, like the active arena */
+void symbol_table_set_active(SymbolTable* table);
+SymbolTable* symbol_table_active(void);
+
+/* interns into the active table, NULL when there is none */
+char* symbol_intern(const char* name);
+
+/* the header of a name returned by symbol_intern */
+Symbol* symbol_of(const char* name);
+size_t symbol_hash(const char* name);
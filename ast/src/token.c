@@ -1,21 +1,141 @@
 #include "token.h"
 
 #include <stdio.h>
+#include <string.h>
 
+#include "arena.h"
+#include "output.h"
 #include "smem.h"
+#include "symbol.h"
 
 
+#define SPAN_INTERN_BUFFER 128
+
+static _Thread_local const char* source = NULL;
+
+/* token text copied out of a streamed script, stream.text[0] is at offset stream.base */
+typedef struct TokenStream {
+    char* text;
+    size_t base;
+    size_t size;
+    size_t capacity;
+    size_t last; /* offset of the text copied last */
+} TokenStream;
+
+static _Thread_local TokenStream stream = {0};
+
+void token_set_source(const char* text) {
+    source = text;
+}
+
+const char* token_source(void) {
+    return source;
+}
+
+const char* span_text(Span span) {
+    if (source == NULL)
+        return stream.text + (span.offset - stream.base);
+
+    return source + span.offset;
+}
+
+Span span_of(const char* text, size_t length) {
+    if (source != NULL)
+        return (Span) {.offset = (size_t) (text - source), .length = length};
+
+    if (stream.size + length > stream.capacity) {
+        size_t capacity = stream.capacity < 256 ? 256 : stream.capacity;
+        while (capacity < stream.size + length) {
+            capacity *= 2;
+        }
+
+        char* grown = stream.text == NULL
+            ? safe_malloc(capacity, NULL)
+            : safe_realloc((void**) &stream.text, capacity, NULL);
+        if (grown == NULL)
+            return (Span) {0, 0};
+
+        stream.text = grown;
+        stream.capacity = capacity;
+    }
+
+    Span span = {.offset = stream.base + stream.size, .length = length};
+
+    memcpy(stream.text + stream.size, text, length);
+    stream.size += length;
+    stream.last = span.offset;
+
+    return span;
+}
+
+void token_stream_discard(void) {
+    size_t kept = stream.base + stream.size - stream.last;
+
+    if (stream.text != NULL) {
+        memmove(stream.text, stream.text + (stream.last - stream.base), kept);
+    }
+
+    stream.base = stream.last;
+    stream.size = kept;
+}
+
+void token_stream_free(void) {
+    safe_free((void**) &stream.text);
+    stream = (TokenStream) {0};
+}
+
+char* span_intern(Span span) {
+    if (source == NULL && stream.text == NULL)
+        return NULL;
+
+    /* identifiers are short, only an unusually long one needs a heap copy to be terminated */
+    char buffer[SPAN_INTERN_BUFFER];
+    char* name = span.length < sizeof(buffer) ? buffer : safe_malloc(span.length + 1, NULL);
+    if (name == NULL) {
+        return NULL;
+    }
+
+    memcpy(name, span_text(span), span.length);
+    name[span.length] = '\0';
+
+    char* symbol = symbol_intern(name);
+
+    if (name != buffer) {
+        safe_free((void**) &name);
+    }
+
+    return symbol;
+}
+
 Token* token_new(TokenType type, const char* literal, size_t line) {
     Token* tok = NULL;
-    tok = safe_malloc(sizeof(Token), NULL);
+    tok = arena_active_alloc(sizeof(Token));
+    if (tok == NULL) {
+        return NULL;
+    }
+
+    *tok = (Token) {
+        .type = type,
+        .literal = symbol_intern(literal),
+        .line = line,
+        .span = {0, 0}
+    };
+
+    return tok;
+}
+
+Token* token_new_at(TokenType type, Span span, size_t line) {
+    Token* tok = NULL;
+    tok = arena_active_alloc(sizeof(Token));
     if (tok == NULL) {
         return NULL;
     }
 
     *tok = (Token) {
         .type = type,
-        .literal = str_dup(literal),
-        .line = line
+        .literal = span_intern(span),
+        .line = line,
+        .span = span
     };
 
     return tok;
@@ -25,14 +145,14 @@ void token_to_string(Token** token) {
     if (token == NULL || *token == NULL)
         return;
 
-    printf("%s", (*token)->literal);
+    output_printf("%s", (*token)->literal);
 }
 
 void token_free(Token** token) {
     if (token == NULL || *token == NULL)
         return;
 
-    safe_free((void**) &(*token)->literal);
+    /* the literal is interned and outlives the token */
     safe_free((void**) token);
 }
 
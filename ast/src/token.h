@@ -101,13 +101,46 @@ typedef enum TokenType {
 } TokenType;
 
 
+/* where a token's text sits in the scanned source, in bytes */
+typedef struct Span {
+    size_t offset;
+    size_t length;
+} Span;
+
 typedef struct Token {
     TokenType type;
     char* literal;
     size_t line;
+    Span span; /* empty for tokens the parser spells out itself, like "+=" */
 } Token;
 
+/*
+ * The text the lexer scans in place. Spans are offsets into it, so it must
+ * stay alive as long as they are read; the driver keeps the file mapped
+ * until it releases the tree.
+ */
+void token_set_source(const char* source);
+const char* token_source(void);
+
+/* where text the lexer just matched sits, for either kind of source */
+Span span_of(const char* text, size_t length);
+
+/*
+ * With no source set the script is being streamed through the lexer's own
+ * buffer, so span_of copies the text of each token out and spans address
+ * the copy. The driver discards it once the declarations it belonged to are
+ * parsed, keeping the token scanned last, which may start the next one.
+ */
+void token_stream_discard(void);
+void token_stream_free(void);
+
+/* the span's characters, not terminated */
+const char* span_text(Span span);
+/* the interned name spelled by the span */
+char* span_intern(Span span);
+
 Token* token_new(TokenType type, const char* literal, size_t line);
+Token* token_new_at(TokenType type, Span span, size_t line);
 void token_to_string(Token** token);
 void token_free(Token** token);
 
@@ -117,3 +150,4 @@ bool token_is_keyword(Token** token);
 
 
 #define NEW_TOKEN(type, literal, line) token_new((type), (literal), (line))
+#define NEW_TOKEN_AT(type, span, line) token_new_at((type), (span), (line))
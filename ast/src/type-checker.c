@@ -11,6 +11,7 @@
 #include "list.h"
 #include "literal-type.h"
 #include "map.h"
+#include "output.h"
 #include "smem.h"
 #include "token.h"
 #include "types.h"
@@ -29,10 +30,6 @@ static bool cmp_namedType_fieldName(const Type** namedType, char** fieldName) {
     return strcmp(nt->name, *fieldName) == 0;
 }
 
-static bool entry_cmp(const MapEntry** entry, char** key) {
-    return strcmp((*entry)->key, *key) == 0;
-}
-
 static TypeChecker* type_checker_init(void) {
     TypeChecker* type_checker = NULL;
     type_checker = safe_malloc(sizeof(TypeChecker), NULL);
@@ -41,7 +38,7 @@ static TypeChecker* type_checker_init(void) {
     }
 
     *type_checker = (TypeChecker) {
-        .env = context_new(MAP_NEW(32, entry_cmp, NULL, NULL)),
+        .env = context_new(SYMBOL_MAP_NEW(32, NULL)),
         .currentFunctionReturnType = NULL,
         .hasCurrentFunctionReturned = false,
         .hasFunctionTypeToDefine = false,
@@ -60,7 +57,7 @@ static void type_checker_free(TypeChecker** typeChecker) {
     safe_free((void**) typeChecker);
 }
 
-static Type* type_lookup[] = {
+static _Thread_local Type* type_lookup[] = {
     [INT_TYPE]    = NULL,
     [FLOAT_TYPE]  = NULL,
     [CHAR_TYPE]   = NULL,
@@ -88,15 +85,22 @@ static Type* check_while_stmt(TypeChecker* typeChecker, WhileStmt* whileStmt);
 static Type* check_for_stmt(TypeChecker* typeChecker, ForStmt* forStmt);
 
 static Type* check_expr(TypeChecker* typeChecker, Expr* expression);
+static Type* check_expr_type(TypeChecker* typeChecker, Expr* expression);
 static Type* check_binary_expr(TypeChecker* typeChecker, BinaryExpr* binaryExpr);
 static Type* check_assign_expr(TypeChecker* typeChecker, AssignExpr* assignExpr);
 static Type* check_call_expr(TypeChecker* typeChecker, CallExpr* callExpr);
+static Type* check_array_builtin(TypeChecker* typeChecker, CallExpr* callExpr, const char* name);
+static Type* check_matrix_builtin(TypeChecker* typeChecker, CallExpr* callExpr, const char* name);
+static Type* check_numeric_builtin(TypeChecker* typeChecker, CallExpr* callExpr, const char* name);
+static Type* check_map_builtin(TypeChecker* typeChecker, CallExpr* callExpr, const char* name);
+static Type* check_reader_builtin(TypeChecker* typeChecker, CallExpr* callExpr, const char* name);
 static Type* check_logical_expr(TypeChecker* typeChecker, LogicalExpr* logicalExpr);
 static Type* check_unary_expr(TypeChecker* typeChecker, UnaryExpr* unaryExpr);
 static Type* check_update_expr(TypeChecker* typeChecker, UpdateExpr* updateExpr);
 static Type* check_struct_init_expr(TypeChecker* typeChecker, StructInitExpr* structInitExpr);
 static Type* check_struct_inline_expr(TypeChecker* typeChecker, StructInlineExpr* structInlineExpr);
 static Type* check_array_init_expr(TypeChecker* typeChecker, ArrayInitExpr* arrayInitExpr);
+static Type* check_map_init_expr(TypeChecker* typeChecker, MapInitExpr* mapInitExpr);
 static Type* check_function_expr(TypeChecker* typeChecker, FunctionExpr* functionExpr);
 static Type* check_conditional_expr(TypeChecker* typeChecker, ConditionalExpr* conditionalExpr);
 static Type* check_array_member_expr(TypeChecker* typeChecker, ArrayMemberExpr* arrayMemberExpr);
@@ -110,6 +114,8 @@ static bool expect_expr_type(Type* exprType, size_t n_elements, ...);
 static bool expect_type_id(TypeID type, size_t n_elements, ...);
 static bool expect_token_type(TokenType type, size_t n_elements, ...);
 
+static OperandTypes operand_types(Type* leftType, Type* rightType, TokenType operation);
+
 static bool struct_type_has_fields_with_valid_types(StructType* structType);
 static bool function_has_valid_parameters(TypeChecker* typeChecker, List* parameters);
 static bool struct_has_valid_fields(TypeChecker* typeChecker, List* fields);
@@ -117,7 +123,7 @@ static bool struct_has_valid_fields(TypeChecker* typeChecker, List* fields);
 static bool is_argument_valid_for_parameter(TypeChecker* typeChecker,
     Expr* argument, Type* parameterType);
 static bool call_expr_args_match_function_parameters(TypeChecker* typeChecker,
-    List* arguments, FunctionType* functionType);
+    Vector* arguments, FunctionType* functionType);
 
 TypeCheckerStatus check(List* declarations) {
     if (declarations == NULL)
@@ -157,6 +163,21 @@ TypeCheckerStatus init_and_check(TypeChecker** typeChecker, List* declarations)
     return status;
 }
 
+TypeChecker* type_checker_new(void) {
+    init_type_lookup_object();
+
+    return type_checker_init();
+}
+
+TypeCheckerStatus check_next(TypeChecker* typeChecker, Decl* declaration) {
+    if (typeChecker == NULL)
+        return TYPE_CHECKER_FAILURE;
+
+    check_decl(typeChecker, declaration);
+
+    return typeChecker->currentStatus;
+}
+
 void type_checker_destroy(TypeChecker** typeChecker) {
     if (typeChecker == NULL || *typeChecker == NULL)
         return;
@@ -235,7 +256,7 @@ static Type* check_decl(TypeChecker* typeChecker, Decl* declaration) {
     default:
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
 
-        printf("\nUnexpected declaration type\n");
+        output_printf("\nUnexpected declaration type\n");
 
         return NULL;
     }
@@ -285,13 +306,24 @@ static Type* check_stmt(TypeChecker* typeChecker, Stmt* statement) {
     default:
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
 
-        printf("\nUnexpected statement type\n");
+        output_printf("\nUnexpected statement type\n");
 
         return NULL;
     }
 }
 
+/* every expression keeps the type it was checked with, so nothing has to be checked again at runtime */
 static Type* check_expr(TypeChecker* typeChecker, Expr* expression) {
+    Type* type = check_expr_type(typeChecker, expression);
+
+    if (expression != NULL && type != NULL) {
+        expression->resolvedType = copy(type);
+    }
+
+    return type;
+}
+
+static Type* check_expr_type(TypeChecker* typeChecker, Expr* expression) {
     if (typeChecker == NULL || expression == NULL)
         return NULL;
 
@@ -351,6 +383,11 @@ static Type* check_expr(TypeChecker* typeChecker, Expr* expression) {
 
         return check_array_init_expr(typeChecker, arrayInitExpr);
     }
+    case MAP_INIT_EXPR: {
+        MapInitExpr* mapInitExpr = (MapInitExpr*) expression->expr;
+
+        return check_map_init_expr(typeChecker, mapInitExpr);
+    }
     case FUNC_EXPR: {
         FunctionExpr* functionExpr = (FunctionExpr*) expression->expr;
 
@@ -367,14 +404,14 @@ static Type* check_expr(TypeChecker* typeChecker, Expr* expression) {
         Type* objectType = check_expr(typeChecker, memberExpr->object);
 
         if (objectType != NULL && !expect_type_id(objectType->typeId, 2, CUSTOM_TYPE, STRUCT_TYPE)) {
-            printf("\nInvalid MemberExpr: cannot access this object\n\t");
+            output_printf("\nInvalid MemberExpr: cannot access this object\n\t");
             expr_to_string(&memberExpr->object);
-            printf(" (");
+            output_printf(" (");
             type_to_string(&objectType);
-            printf(")");
-            printf("\n\tIn: ");
+            output_printf(")");
+            output_printf("\n\tIn: ");
             member_expr_to_string(&memberExpr);
-            printf("\n");
+            output_printf("\n");
             return NULL;
         }
 
@@ -401,7 +438,7 @@ static Type* check_expr(TypeChecker* typeChecker, Expr* expression) {
     default:
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
 
-        printf("\nUnexpected expression type\n");
+        output_printf("\nUnexpected expression type\n");
 
         return NULL;
     }
@@ -415,9 +452,9 @@ static Type* check_let_decl(TypeChecker* typeChecker, LetDecl* letDecl) {
 
     if (letDecl->type == NULL && letDecl->expression == NULL) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nInvalid LetDecl:\n\t");
+        output_printf("\nInvalid LetDecl:\n\t");
         let_decl_to_string(&letDecl);
-        printf("?\n");
+        output_printf("?\n");
         return NULL;
     }
 
@@ -430,9 +467,9 @@ static Type* check_let_decl(TypeChecker* typeChecker, LetDecl* letDecl) {
     if (letDecl->type == NULL) {
         if (equals(initializerType, get_type_of(NIL_TYPE))) {
             typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-            printf("\nInvalid LetDecl: assigning nil to an untyped declaration is not allowed\n\t");
+            output_printf("\nInvalid LetDecl: assigning nil to an untyped declaration is not allowed\n\t");
             let_decl_to_string(&letDecl);
-            printf("\n");
+            output_printf("\n");
             return NULL;
         }
 
@@ -446,24 +483,24 @@ static Type* check_let_decl(TypeChecker* typeChecker, LetDecl* letDecl) {
 
     if (invalidTypeInDecl) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nInvalid LetDecl: declaration with type not allowed\n\t");
+        output_printf("\nInvalid LetDecl: declaration with type not allowed\n\t");
         let_decl_to_string(&letDecl);
-        printf("\n");
+        output_printf("\n");
         return NULL;
     }
 
     if (declaredType == NULL || initializerType == NULL) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nCould not do type checking on:\n\t");
+        output_printf("\nCould not do type checking on:\n\t");
         let_decl_to_string(&letDecl);
-        printf("\n");
+        output_printf("\n");
         return NULL;
     }
 
     bool declaredTypeIsCustomType = declaredType->typeId == CUSTOM_TYPE;
     bool initializerTypeIsCustomType = initializerType->typeId == CUSTOM_TYPE;
     bool isAssigningNilToCompositeType = equals(initializerType, get_type_of(NIL_TYPE)) &&
-            expect_type_id(declaredType->typeId, 4, CUSTOM_TYPE, STRUCT_TYPE, ARRAY_TYPE, FUNC_TYPE);
+            expect_type_id(declaredType->typeId, 5, CUSTOM_TYPE, STRUCT_TYPE, ARRAY_TYPE, MAP_TYPE, FUNC_TYPE);
 
     bool typeMatch = false;
 
@@ -483,14 +520,14 @@ static Type* check_let_decl(TypeChecker* typeChecker, LetDecl* letDecl) {
 
     if (!typeMatch) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf( "\nIncompatible type in LetDecl.");
-        printf("\n\tRequired: ");
+        output_printf( "\nIncompatible type in LetDecl.");
+        output_printf("\n\tRequired: ");
         type_to_string(&declaredType);
-        printf("\n\tGot: ");
+        output_printf("\n\tGot: ");
         type_to_string(&initializerType);
-        printf("\n\tIn: ");
+        output_printf("\n\tIn: ");
         let_decl_to_string(&letDecl);
-        printf("\n");
+        output_printf("\n");
         return NULL;
     }
 
@@ -509,9 +546,9 @@ static Type* check_const_decl(TypeChecker* typeChecker, ConstDecl* constDecl) {
 
     if (constDecl->type == NULL && constDecl->expression == NULL) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nInvalid ConstDecl:\n\t");
+        output_printf("\nInvalid ConstDecl:\n\t");
         const_decl_to_string(&constDecl);
-        printf("?\n");
+        output_printf("?\n");
         return NULL;
     }
 
@@ -524,9 +561,9 @@ static Type* check_const_decl(TypeChecker* typeChecker, ConstDecl* constDecl) {
     if (constDecl->type == NULL) {
         if (equals(initializerType, get_type_of(NIL_TYPE))) {
             typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-            printf("\nInvalid ConstDecl: assigning nil to an untyped declaration is not allowed\n\t");
+            output_printf("\nInvalid ConstDecl: assigning nil to an untyped declaration is not allowed\n\t");
             const_decl_to_string(&constDecl);
-            printf("\n");
+            output_printf("\n");
             return NULL;
         }
 
@@ -540,24 +577,24 @@ static Type* check_const_decl(TypeChecker* typeChecker, ConstDecl* constDecl) {
 
     if (invalidTypeInDecl) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nInvalid ConstDecl: declaration with type not allowed\n\t");
+        output_printf("\nInvalid ConstDecl: declaration with type not allowed\n\t");
         const_decl_to_string(&constDecl);
-        printf("\n");
+        output_printf("\n");
         return NULL;
     }
 
     if (declaredType == NULL || initializerType == NULL) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nCould not do type checking on:\n\t");
+        output_printf("\nCould not do type checking on:\n\t");
         const_decl_to_string(&constDecl);
-        printf("\n");
+        output_printf("\n");
         return NULL;
     }
 
     bool declaredTypeIsCustomType = declaredType->typeId == CUSTOM_TYPE;
     bool initializerTypeIsCustomType = initializerType->typeId == CUSTOM_TYPE;
     bool isAssigningNilToCompositeType = equals(initializerType, get_type_of(NIL_TYPE)) &&
-            expect_type_id(declaredType->typeId, 4, CUSTOM_TYPE, STRUCT_TYPE, ARRAY_TYPE, FUNC_TYPE);
+            expect_type_id(declaredType->typeId, 5, CUSTOM_TYPE, STRUCT_TYPE, ARRAY_TYPE, MAP_TYPE, FUNC_TYPE);
 
     bool typeMatch = false;
 
@@ -577,14 +614,14 @@ static Type* check_const_decl(TypeChecker* typeChecker, ConstDecl* constDecl) {
 
     if (!typeMatch) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nIncompatible type in ConstDecl.");
-        printf("\n\trequired: ");
+        output_printf("\nIncompatible type in ConstDecl.");
+        output_printf("\n\trequired: ");
         type_to_string(&declaredType);
-        printf("\n\tGot: ");
+        output_printf("\n\tGot: ");
         type_to_string(&initializerType);
-        printf("\n\tIn: ");
+        output_printf("\n\tIn: ");
         const_decl_to_string(&constDecl);
-        printf("\n");
+        output_printf("\n");
         return NULL;
     }
 
@@ -603,25 +640,27 @@ static Type* check_function_decl(TypeChecker* typeChecker, FunctionDecl* functio
 
     if (!function_has_valid_parameters(typeChecker, functionDecl->parameters)) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nInvalid FunctionDecl: the function has parameters with invalid types --> (void) or (nil)\n");
+        output_printf("\nInvalid FunctionDecl: the function has parameters with invalid types --> (void) or (nil)\n");
         function_decl_to_string(&functionDecl);
-        printf("\n");
+        output_printf("\n");
         return NULL;
     }
 
-    List* paramTypes = list_new(NULL);
+    List* paramTypes = list_new((void (*)(void **)) type_free);
     list_foreach(param, functionDecl->parameters) {
-        list_insert_last(&paramTypes, check_decl(typeChecker, param->value));
+        list_insert_last(&paramTypes, copy(check_decl(typeChecker, param->value)));
     }
 
-    Type* returnType = functionDecl->returnType;
+    Type* returnType = copy(functionDecl->returnType);
+
+    Type* functionType = type_intern(NEW_FUNCTION_TYPE_WITH_PARAMS_AND_RETURN(paramTypes, returnType));
 
-    Type* functionType = NEW_FUNCTION_TYPE_WITH_PARAMS_AND_RETURN(paramTypes, returnType);
+    functionDecl->functionType = functionType;
 
     context_define(typeChecker->env, functionDecl->name->literal, functionType);
 
     Context* previous = typeChecker->env;
-    typeChecker->env = context_enclosed_new(previous, MAP_NEW(32, entry_cmp, NULL, NULL));
+    typeChecker->env = context_enclosed_new(previous, SYMBOL_MAP_NEW(32, NULL));
 
     typeChecker->hasCurrentFunctionReturned = false;
 
@@ -651,9 +690,9 @@ static Type* check_function_decl(TypeChecker* typeChecker, FunctionDecl* functio
         !typeChecker->hasCurrentFunctionReturned
     ) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("Invalid FunctionDecl: a return value is specified in the function but none is provided\n");
+        output_printf("Invalid FunctionDecl: a return value is specified in the function but none is provided\n");
         function_decl_to_string(&functionDecl);
-        printf("\n");
+        output_printf("\n");
         return NULL;
     }
 
@@ -666,18 +705,18 @@ static Type* check_struct_decl(TypeChecker* typeChecker, StructDecl* structDecl)
 
     if (!struct_has_valid_fields(typeChecker, structDecl->fields)) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nInvalid StructDecl: the struct has fields with invalid types --> (void) or (nil)\n");
+        output_printf("\nInvalid StructDecl: the struct has fields with invalid types --> (void) or (nil)\n");
         struct_decl_to_string(&structDecl);
-        printf("\n");
+        output_printf("\n");
         return NULL;
     }
 
-    List* listOfFieldTypes = list_new((void (*)(void **)) NULL);
+    List* listOfFieldTypes = list_new((void (*)(void **)) type_free);
     list_foreach(field, structDecl->fields) {
-        list_insert_last(&listOfFieldTypes, field->value);
+        list_insert_last(&listOfFieldTypes, copy(field->value));
     }
 
-    Type* structType = NEW_STRUCT_TYPE_WITH_FIELDS(0, listOfFieldTypes);
+    Type* structType = type_intern(NEW_STRUCT_TYPE_WITH_FIELDS(0, listOfFieldTypes));
 
     context_define(typeChecker->env, structDecl->name->literal, structType);
 
@@ -694,11 +733,11 @@ static Type* check_block_stmt(TypeChecker* typeChecker, BlockStmt* blockStmt) {
 
     typeChecker->env = context_enclosed_new(
         previous,
-        MAP_NEW(32, entry_cmp, NULL, NULL)
+        SYMBOL_MAP_NEW(32, NULL)
     );
 
-    list_foreach(declaration, blockStmt->declarations) {
-        check_decl(typeChecker, declaration->value);
+    vector_foreach(declaration, blockStmt->declarations) {
+        check_decl(typeChecker, *declaration);
     }
 
     context_free(&typeChecker->env);
@@ -718,13 +757,13 @@ static Type* check_return_stmt(TypeChecker* typeChecker, ReturnStmt* returnStmt)
     if (returningAnExpressionInAFunctionThatHasNotReturnValue) {
         Type* returnType =  check_expr(typeChecker, returnStmt->expression);
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nTo many return values");
-        printf("\n\tHave: ");
+        output_printf("\nTo many return values");
+        output_printf("\n\tHave: ");
         return_stmt_to_string(&returnStmt);
-        printf(" (");
+        output_printf(" (");
         type_to_string(&returnType);
-        printf(")");
-        printf("\n\tWant: ()\n");
+        output_printf(")");
+        output_printf("\n\tWant: ()\n");
         return NULL;
     }
 
@@ -735,12 +774,12 @@ static Type* check_return_stmt(TypeChecker* typeChecker, ReturnStmt* returnStmt)
 
     if (returningAnExpressionInAFunctionThatHasVoidReturn) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nNot expecting any return value");
-        printf("\n\tRequire: ");
+        output_printf("\nNot expecting any return value");
+        output_printf("\n\tRequire: ");
         type_to_string(&typeChecker->currentFunctionReturnType);
-        printf("\n\tGot: ");
+        output_printf("\n\tGot: ");
         return_stmt_to_string(&returnStmt);
-        printf("\n");
+        output_printf("\n");
         return NULL;
     }
 
@@ -751,12 +790,12 @@ static Type* check_return_stmt(TypeChecker* typeChecker, ReturnStmt* returnStmt)
 
     if (returnValudIsSpecifiedInTheFunctionButNoneIsProvided) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nExpecting return value");
-        printf("\n\tRequire: ");
+        output_printf("\nExpecting return value");
+        output_printf("\n\tRequire: ");
         type_to_string(&typeChecker->currentFunctionReturnType);
-        printf("\n\tGot: ");
+        output_printf("\n\tGot: ");
         return_stmt_to_string(&returnStmt);
-        printf("\n");
+        output_printf("\n");
         return NULL;
     }
 
@@ -770,7 +809,7 @@ static Type* check_return_stmt(TypeChecker* typeChecker, ReturnStmt* returnStmt)
     bool returnIsNilAndFunctionReturnIsCompositeType =
         returnType != NULL && functionReturn != NULL &&
         equals(returnType, get_type_of(NIL_TYPE)) &&
-        expect_type_id(functionReturn->typeId, 3, STRUCT_TYPE, ARRAY_TYPE, FUNC_TYPE);
+        expect_type_id(functionReturn->typeId, 4, STRUCT_TYPE, ARRAY_TYPE, MAP_TYPE, FUNC_TYPE);
 
     bool emptyReturnInAFunctionThatHasVoidReturn = returnStmt->expression == NULL &&
         (functionReturn == NULL || equals(functionReturn, get_type_of(VOID_TYPE)));
@@ -780,12 +819,12 @@ static Type* check_return_stmt(TypeChecker* typeChecker, ReturnStmt* returnStmt)
         !equals(returnType, functionReturn)
     ) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nInvalid FunctionReturn:");
-        printf("\n\tRequired: ");
+        output_printf("\nInvalid FunctionReturn:");
+        output_printf("\n\tRequired: ");
         type_to_string(&functionReturn);
-        printf("\n\tGot: ");
+        output_printf("\n\tGot: ");
         type_to_string(&returnType);
-        printf("\n");
+        output_printf("\n");
         return NULL;
     }
 
@@ -801,13 +840,13 @@ static Type* check_if_stmt(TypeChecker* typeChecker, IfStmt* ifStmt) {
     Type* conditionType = check_expr(typeChecker, ifStmt->condition);
     if (!equals(conditionType, get_type_of(BOOL_TYPE))) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nInvalid IfStmt: incompatible condition type");
-        printf("\n\tRequired: bool");
-        printf("\n\tGot: ");
+        output_printf("\nInvalid IfStmt: incompatible condition type");
+        output_printf("\n\tRequired: bool");
+        output_printf("\n\tGot: ");
         type_to_string(&conditionType);
-        printf("\n\t");
+        output_printf("\n\t");
         expr_to_string(&ifStmt->condition);
-        printf("\n");
+        output_printf("\n");
         return NULL;
     }
 
@@ -827,13 +866,13 @@ static Type* check_while_stmt(TypeChecker* typeChecker, WhileStmt* whileStmt) {
     Type* conditionType = check_expr(typeChecker, whileStmt->condition);
     if (!equals(conditionType, get_type_of(BOOL_TYPE))) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nInvalid WhileStmt: incompatible condition type");
-        printf("\n\trequired: bool");
-        printf("\n\tGot: ");
+        output_printf("\nInvalid WhileStmt: incompatible condition type");
+        output_printf("\n\trequired: bool");
+        output_printf("\n\tGot: ");
         type_to_string(&conditionType);
-        printf("\n\t");
+        output_printf("\n\t");
         expr_to_string(&whileStmt->condition);
-        printf("\n");
+        output_printf("\n");
         return NULL;
     }
 
@@ -850,7 +889,7 @@ static Type* check_for_stmt(TypeChecker* typeChecker, ForStmt* forStmt) {
 
     typeChecker->env = context_enclosed_new(
         previous,
-        MAP_NEW(32, entry_cmp, NULL, NULL)
+        SYMBOL_MAP_NEW(32, NULL)
     );
 
     check_decl(typeChecker, forStmt->initialization);
@@ -858,9 +897,9 @@ static Type* check_for_stmt(TypeChecker* typeChecker, ForStmt* forStmt) {
     Type* conditionType = check_expr(typeChecker, forStmt->condition);
     if (conditionType != NULL && !equals(conditionType, get_type_of(BOOL_TYPE))) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("Invalid ForStmt: condition expression should have type bool\n\t");
+        output_printf("Invalid ForStmt: condition expression should have type bool\n\t");
         for_stmt_to_string(&forStmt);
-        printf("\n");
+        output_printf("\n");
 
         context_free(&typeChecker->env);
         typeChecker->env = previous;
@@ -889,9 +928,9 @@ static Type* check_binary_expr(TypeChecker* typeChecker, BinaryExpr* binaryExpr)
 
     if (leftType == NULL || rightType == NULL) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nInvalid BinaryExpr: ");
+        output_printf("\nInvalid BinaryExpr: ");
         binary_expr_to_string(&binaryExpr);
-        printf("\n");
+        output_printf("\n");
         return NULL;
     }
 
@@ -908,7 +947,7 @@ static Type* check_binary_expr(TypeChecker* typeChecker, BinaryExpr* binaryExpr)
     }
 
     if (expect_token_type(operation, 2, TOKEN_EQL, TOKEN_NEQ)) {
-        leftIsOk = (leftType != NULL && expect_type_id(leftType->typeId, 4, CUSTOM_TYPE, STRUCT_TYPE, ARRAY_TYPE, FUNC_TYPE))
+        leftIsOk = (leftType != NULL && expect_type_id(leftType->typeId, 5, CUSTOM_TYPE, STRUCT_TYPE, ARRAY_TYPE, MAP_TYPE, FUNC_TYPE))
             || expect_expr_type(leftType, 6, INT_TYPE, FLOAT_TYPE, CHAR_TYPE, STRING_TYPE, BOOL_TYPE, NIL_TYPE);
     }
 
@@ -917,27 +956,29 @@ static Type* check_binary_expr(TypeChecker* typeChecker, BinaryExpr* binaryExpr)
 
         if (leftIsOk && !equals(leftType, rightType)) {
             typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-            printf("\nInvalid BinaryExpr: left type must be equals to right type\n\t");
+            output_printf("\nInvalid BinaryExpr: left type must be equals to right type\n\t");
             binary_expr_to_string(&binaryExpr);
-            printf("\n");
+            output_printf("\n");
             return NULL;
         }
     }
 
     if (!leftIsOk) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nUnexpected left type in BinaryExpr:\n\t");
+        output_printf("\nUnexpected left type in BinaryExpr:\n\t");
         type_to_string(&leftType);
-        printf(" ");
+        output_printf(" ");
         token_to_string(&binaryExpr->op);
-        printf(" ");
+        output_printf(" ");
         type_to_string(&rightType);
-        printf("\n\t");
+        output_printf("\n\t");
         binary_expr_to_string(&binaryExpr);
-        printf("\n");
+        output_printf("\n");
         return NULL;
     }
 
+    binaryExpr->operands = operand_types(leftType, rightType, operation);
+
     bool leftIntAndRightFloat =
         equals(leftType, get_type_of(INT_TYPE)) &&
         equals(rightType, get_type_of(FLOAT_TYPE));
@@ -958,10 +999,10 @@ static Type* check_binary_expr(TypeChecker* typeChecker, BinaryExpr* binaryExpr)
 
     bool validNullCheck =
         (
-            expect_type_id(leftType->typeId, 5, STRING_TYPE, CUSTOM_TYPE, STRUCT_TYPE, ARRAY_TYPE, FUNC_TYPE) &&
+            expect_type_id(leftType->typeId, 6, STRING_TYPE, CUSTOM_TYPE, STRUCT_TYPE, ARRAY_TYPE, MAP_TYPE, FUNC_TYPE) &&
             equals(rightType, get_type_of(NIL_TYPE))
         ) || (
-            expect_type_id(rightType->typeId, 5, STRING_TYPE, CUSTOM_TYPE, STRUCT_TYPE, ARRAY_TYPE, FUNC_TYPE) &&
+            expect_type_id(rightType->typeId, 6, STRING_TYPE, CUSTOM_TYPE, STRUCT_TYPE, ARRAY_TYPE, MAP_TYPE, FUNC_TYPE) &&
             equals(leftType, get_type_of(NIL_TYPE))
         );
 
@@ -974,15 +1015,15 @@ static Type* check_binary_expr(TypeChecker* typeChecker, BinaryExpr* binaryExpr)
 
     if (!isConcat && !equals(leftType, rightType)) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nInvalid BinaryExpr: left type must be equals to right type\n\t");
+        output_printf("\nInvalid BinaryExpr: left type must be equals to right type\n\t");
         type_to_string(&leftType);
-        printf(" ");
+        output_printf(" ");
         token_to_string(&binaryExpr->op);
-        printf(" ");
+        output_printf(" ");
         type_to_string(&rightType);
-        printf("\n\t");
+        output_printf("\n\t");
         binary_expr_to_string(&binaryExpr);
-        printf("\n");
+        output_printf("\n");
         return NULL;
     }
 
@@ -1007,30 +1048,30 @@ static Type* check_assign_expr(TypeChecker* typeChecker, AssignExpr* assignExpr)
         equals(valueType, get_type_of(VOID_TYPE))
     ) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nInvalid AssignExpr: call expression has no return");
-        printf("\n\tRequired: ");
+        output_printf("\nInvalid AssignExpr: call expression has no return");
+        output_printf("\n\tRequired: ");
         type_to_string(&varType);
-        printf("\n\tGot: ");
+        output_printf("\n\tGot: ");
         type_to_string(&valueType);
-        printf("\n\t");
+        output_printf("\n\t");
         assign_expr_to_string(&assignExpr);
-        printf("\n");
+        output_printf("\n");
         return NULL;
     }
 
     if (!equals(varType, valueType)) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nInvalid AssignExpr: incompatible types");
-        printf("\n\tRequired: ");
+        output_printf("\nInvalid AssignExpr: incompatible types");
+        output_printf("\n\tRequired: ");
         type_to_string(&varType);
-        printf("\n\tGot: ");
+        output_printf("\n\tGot: ");
         type_to_string(&valueType);
-        printf("\n\t");
+        output_printf("\n\t");
         assign_expr_to_string(&assignExpr);
-        printf(" (");
+        output_printf(" (");
         type_to_string(&valueType);
-        printf(")");
-        printf("\n");
+        output_printf(")");
+        output_printf("\n");
         return NULL;
     }
 
@@ -1055,6 +1096,10 @@ static Type* check_call_expr(TypeChecker* typeChecker, CallExpr* callExpr) {
             return get_type_of(VOID_TYPE);
         }
 
+        if (strcmp(calleName, "flush") == 0) {
+            return get_type_of(VOID_TYPE);
+        }
+
         if (strcmp(calleName, "input") == 0) {
             return get_type_of(STRING_TYPE);
         }
@@ -1062,28 +1107,56 @@ static Type* check_call_expr(TypeChecker* typeChecker, CallExpr* callExpr) {
         if (strcmp(calleName, "len") == 0) {
             return get_type_of(INT_TYPE);
         }
+
+        if (strcmp(calleName, "push") == 0 || strcmp(calleName, "pop") == 0 || strcmp(calleName, "reserve") == 0) {
+            return check_array_builtin(typeChecker, callExpr, calleName);
+        }
+
+        if (strcmp(calleName, "matmul") == 0 || strcmp(calleName, "transpose") == 0 || strcmp(calleName, "matadd") == 0
+            || strcmp(calleName, "matsub") == 0 || strcmp(calleName, "hadamard") == 0) {
+            return check_matrix_builtin(typeChecker, callExpr, calleName);
+        }
+
+        if (strcmp(calleName, "read_all") == 0 || strcmp(calleName, "read_lines") == 0
+            || strcmp(calleName, "has_line") == 0 || strcmp(calleName, "next_line") == 0) {
+            return check_reader_builtin(typeChecker, callExpr, calleName);
+        }
+
+        if (strcmp(calleName, "delete") == 0 || strcmp(calleName, "has") == 0 || strcmp(calleName, "keys") == 0
+            || strcmp(calleName, "values") == 0) {
+            return check_map_builtin(typeChecker, callExpr, calleName);
+        }
+
+        /* unlike the core builtins these names may be taken by the program */
+        bool isNumeric = context_get(typeChecker->env, calleName) == NULL;
+
+        if (isNumeric && (strcmp(calleName, "sum") == 0 || strcmp(calleName, "min") == 0 || strcmp(calleName, "max") == 0
+            || strcmp(calleName, "dot") == 0 || strcmp(calleName, "axpy") == 0 || strcmp(calleName, "map_add") == 0
+            || strcmp(calleName, "map_mul") == 0 || strcmp(calleName, "fill") == 0)) {
+            return check_numeric_builtin(typeChecker, callExpr, calleName);
+        }
     }
 
     Type* calleeType = check_expr(typeChecker, callExpr->callee);
     if (calleeType == NULL) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nInvalid CallExpr: function not defined.");
-        printf("\n\t---> ");
+        output_printf("\nInvalid CallExpr: function not defined.");
+        output_printf("\n\t---> ");
         call_expr_to_string(&callExpr);
-        printf("\n");
+        output_printf("\n");
         return NULL;
     }
 
     if (calleeType->typeId != FUNC_TYPE) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
         expr_to_string(&callExpr->callee);
-        printf(": not a function.\n");
+        output_printf(": not a function.\n");
         return NULL;
     }
 
     FunctionType* functionType = calleeType->type;
 
-    size_t nArgs = list_size(&callExpr->arguments);
+    size_t nArgs = vector_size(&callExpr->arguments);
     size_t nParam = list_size(&functionType->parameterTypes);
 
     // TODO: implement rest "args: ...string" operator
@@ -1091,37 +1164,37 @@ static Type* check_call_expr(TypeChecker* typeChecker, CallExpr* callExpr) {
     if (nArgs != nParam) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
 
-        printf("\nInvalid CallExpr: number of arguments does not match ---> ");
+        output_printf("\nInvalid CallExpr: number of arguments does not match ---> ");
 
         function_type_to_string(&functionType);
 
-        printf("\n\tRequired: %ld (", nParam);
+        output_printf("\n\tRequired: %ld (", nParam);
 
         list_foreach(parameterType, functionType->parameterTypes) {
             type_to_string((Type**) &parameterType->value);
 
             if (parameterType->next != NULL) {
-                printf(", ");
+                output_printf(", ");
             }
         }
 
-        printf(")\n\tGot: %ld (", nArgs);
+        output_printf(")\n\tGot: %ld (", nArgs);
 
-        list_foreach(argument, callExpr->arguments) {
-            Type* argumentType = check_expr(typeChecker, argument->value);
+        vector_foreach(argument, callExpr->arguments) {
+            if (argument != callExpr->arguments->items) {
+                output_printf(", ");
+            }
 
-            type_to_string(&argumentType);
+            Type* argumentType = check_expr(typeChecker, *argument);
 
-            if (argument->next != NULL) {
-                printf(", ");
-            }
+            type_to_string(&argumentType);
         }
 
-        printf(")\n\tIn: ");
+        output_printf(")\n\tIn: ");
 
         call_expr_to_string(&callExpr);
 
-        printf("\n");
+        output_printf("\n");
 
         return NULL;
     }
@@ -1129,33 +1202,33 @@ static Type* check_call_expr(TypeChecker* typeChecker, CallExpr* callExpr) {
     if (!call_expr_args_match_function_parameters(typeChecker, callExpr->arguments, functionType)) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
 
-        printf("\nInvalid CallExpr: ");
+        output_printf("\nInvalid CallExpr: ");
 
         call_expr_to_string(&callExpr);
 
-        printf("\n\tRequired: %ld (", nParam);
+        output_printf("\n\tRequired: %ld (", nParam);
 
         list_foreach(parameterType, functionType->parameterTypes) {
             type_to_string((Type**) &parameterType->value);
 
             if (parameterType->next != NULL) {
-                printf(", ");
+                output_printf(", ");
             }
         }
 
-        printf(")\n\tGot: %ld (", nArgs);
+        output_printf(")\n\tGot: %ld (", nArgs);
 
-        list_foreach(argument, callExpr->arguments) {
-            Type* argumentType = check_expr(typeChecker, argument->value);
+        vector_foreach(argument, callExpr->arguments) {
+            if (argument != callExpr->arguments->items) {
+                output_printf(", ");
+            }
+
+            Type* argumentType = check_expr(typeChecker, *argument);
 
             type_to_string(&argumentType);
-            
-            if (argument->next != NULL) {
-                printf(", ");
-            }
         }
 
-        printf(")\n");
+        output_printf(")\n");
 
         return NULL;
     }
@@ -1174,17 +1247,17 @@ static Type* check_logical_expr(TypeChecker* typeChecker, LogicalExpr* logicalEx
 
     if (!equals(leftType, get_type_of(BOOL_TYPE))) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nInvalid LogicalExpr: invalid left type\n\t");
+        output_printf("\nInvalid LogicalExpr: invalid left type\n\t");
         logical_expr_to_string(&logicalExpr);
-        printf("\n");
+        output_printf("\n");
         return NULL;
     }
 
     if (!equals(rightType, get_type_of(BOOL_TYPE))) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nInvalid LogicalExpr: invalid right type\n\t");
+        output_printf("\nInvalid LogicalExpr: invalid right type\n\t");
         logical_expr_to_string(&logicalExpr);
-        printf("\n");
+        output_printf("\n");
         return NULL;
     }
 
@@ -1215,11 +1288,11 @@ static Type* check_unary_expr(TypeChecker* typeChecker, UnaryExpr* unaryExpr) {
 
     if (!ok) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nInvalid UnaryExpr: invalid right type\n\t");
+        output_printf("\nInvalid UnaryExpr: invalid right type\n\t");
         unary_expr_to_string(&unaryExpr);
-        printf(" (");
+        output_printf(" (");
         type_to_string(&rightType);
-        printf(")\n");
+        output_printf(")\n");
         return NULL;
     }
 
@@ -1234,12 +1307,12 @@ static Type* check_update_expr(TypeChecker* typeChecker, UpdateExpr* updateExpr)
 
     if (!expect_expr_type(leftType, 2, INT_TYPE, FLOAT_TYPE)) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nInvalid UpdatedExpr: invalid left type");
-        printf("\n\t(");
+        output_printf("\nInvalid UpdatedExpr: invalid left type");
+        output_printf("\n\t(");
         type_to_string(&leftType);
-        printf(") ");
+        output_printf(") ");
         update_expr_to_string(&updateExpr);
-        printf("\n");
+        output_printf("\n");
         return NULL;
     }
 
@@ -1253,9 +1326,9 @@ static Type* check_struct_init_expr(TypeChecker* typeChecker, StructInitExpr* st
     Type* structType = context_get(typeChecker->env, structInitExpr->name->literal);
     if (structType == NULL) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nInvalid StructInitExpr: undefined struct.\n\t");
+        output_printf("\nInvalid StructInitExpr: undefined struct.\n\t");
         struct_init_expr_to_string(&structInitExpr);
-        printf("\n");
+        output_printf("\n");
         return NULL;
     }
 
@@ -1276,11 +1349,11 @@ static Type* check_struct_init_expr(TypeChecker* typeChecker, StructInitExpr* st
 
         if (namedType == NULL) {
             typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-            printf("\nInvalid StructInitExpr: undeclared field\n\t");
+            output_printf("\nInvalid StructInitExpr: undeclared field\n\t");
             expr_to_string((Expr**) &field->value);
-            printf("\n\tIn: ");
+            output_printf("\n\tIn: ");
             struct_init_expr_to_string(&structInitExpr);
-            printf("\n");
+            output_printf("\n");
             return NULL;
         }
 
@@ -1289,17 +1362,17 @@ static Type* check_struct_init_expr(TypeChecker* typeChecker, StructInitExpr* st
 
         if (!equals(requiredType, fieldType)) {
             typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-            printf("\nInvalid StructInitExpr: type not match");
-            printf("\n\tRequired: ");
+            output_printf("\nInvalid StructInitExpr: type not match");
+            output_printf("\n\tRequired: ");
             type_to_string(&namedType);
-            printf("\n\tGot: ");
+            output_printf("\n\tGot: ");
             field_init_expr_to_string(&fieldInitExpr);
-            printf(" (");
+            output_printf(" (");
             type_to_string(&fieldType);
-            printf(")");
-            printf("\n\tIn: ");
+            output_printf(")");
+            output_printf("\n\tIn: ");
             struct_init_expr_to_string(&structInitExpr);
-            printf("\n");
+            output_printf("\n");
             return NULL;
         }
     }
@@ -1315,9 +1388,9 @@ static Type* check_struct_inline_expr(TypeChecker* typeChecker, StructInlineExpr
 
     if (!struct_has_valid_fields(typeChecker, inlineStructTypeDefinition->fields)) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nInvalid StructInlineExpr: the struct has fields with invalid types --> (void) or (nil)\n");
+        output_printf("\nInvalid StructInlineExpr: the struct has fields with invalid types --> (void) or (nil)\n");
         struct_type_to_string(&inlineStructTypeDefinition);
-        printf("\n");
+        output_printf("\n");
         return NULL;
     }
 
@@ -1336,11 +1409,11 @@ static Type* check_struct_inline_expr(TypeChecker* typeChecker, StructInlineExpr
 
         if (namedType == NULL) {
             typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-            printf("\nInvalid StructInlineExpr: undeclared field\n\t");
+            output_printf("\nInvalid StructInlineExpr: undeclared field\n\t");
             expr_to_string((Expr**) &initExpr->value);
-            printf("\n\tIn: ");
+            output_printf("\n\tIn: ");
             struct_inline_expr_to_string(&structInlineExpr);
-            printf("\n");
+            output_printf("\n");
             return NULL;
         }
 
@@ -1349,17 +1422,17 @@ static Type* check_struct_inline_expr(TypeChecker* typeChecker, StructInlineExpr
 
         if (!equals(requiredType, fieldInitExprType)) {
             typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-            printf("\nInvalid StructInlineExpr: type not match");
-            printf("\n\tRequired: ");
+            output_printf("\nInvalid StructInlineExpr: type not match");
+            output_printf("\n\tRequired: ");
             type_to_string(&namedType);
-            printf("\n\tGot: ");
+            output_printf("\n\tGot: ");
             field_init_expr_to_string(&fieldInitExpr);
-            printf(" (");
+            output_printf(" (");
             type_to_string(&fieldInitExprType);
-            printf(")");
-            printf("\n\tIn: ");
+            output_printf(")");
+            output_printf("\n\tIn: ");
             struct_inline_expr_to_string(&structInlineExpr);
-            printf("\n");
+            output_printf("\n");
             return NULL;
         }
     }
@@ -1371,6 +1444,43 @@ static bool array_init_expr_has_elements(ArrayInitExpr* arrayInitExpr) {
     return arrayInitExpr != NULL && list_size(&arrayInitExpr->elements) > 0;
 }
 
+/* a fixed-shape literal lists either its scalars in row-major order or its rows */
+static bool check_dense_array_elements(TypeChecker* typeChecker, ArrayInitExpr* arrayInitExpr, Type* arrayType) {
+    if (!array_init_expr_has_elements(arrayInitExpr))
+        return true;
+
+    Type* elementType = ((Expr*) arrayInitExpr->elements->head->value)->resolvedType;
+    ArrayType* array = arrayType->type;
+
+    size_t rows = array_type_extent(arrayType, 0);
+    size_t size = 1;
+
+    for (size_t axis = 0; axis < array_type_rank(arrayType); axis++) {
+        size *= array_type_extent(arrayType, axis);
+    }
+
+    size_t limit = 0;
+
+    if (equals(elementType, array->type)) {
+        limit = size;
+    } else if (equals(elementType, array_type_slice(arrayType, 1))) {
+        limit = rows;
+    }
+
+    if (list_size(&arrayInitExpr->elements) > limit) {
+        typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
+        output_printf("\nInvalid ArrayInitExpr: elements do not fit the array shape");
+        output_printf("\n\tGot: %ld (", list_size(&arrayInitExpr->elements));
+        type_to_string(&elementType);
+        output_printf(")\n\tIn: ");
+        array_init_expr_to_string(&arrayInitExpr);
+        output_printf("\n");
+        return false;
+    }
+
+    return true;
+}
+
 static Type* check_array_init_expr(TypeChecker* typeChecker, ArrayInitExpr* arrayInitExpr) {
     if (typeChecker == NULL || arrayInitExpr == NULL)
         return NULL;
@@ -1382,12 +1492,12 @@ static Type* check_array_init_expr(TypeChecker* typeChecker, ArrayInitExpr* arra
             Type* elementType = check_expr(typeChecker, element->value);
             if (!equals(firstElementType, elementType)) {
                 typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-                printf("\nInvalid ArrayInitExpr: elements have diferent types");
-                printf("\n\tGot: ");
+                output_printf("\nInvalid ArrayInitExpr: elements have diferent types");
+                output_printf("\n\tGot: ");
                 type_to_string(&elementType);
-                printf("\n\tIn: ");
+                output_printf("\n\tIn: ");
                 array_init_expr_to_string(&arrayInitExpr);
-                printf("\n");
+                output_printf("\n");
                 return NULL;
             }
         }
@@ -1395,7 +1505,7 @@ static Type* check_array_init_expr(TypeChecker* typeChecker, ArrayInitExpr* arra
 
     ArrayType* arrayInitExprType = (ArrayType*) arrayInitExpr->type->type;
 
-    Type* arrayType = NEW_ARRAY_TYPE(arrayInitExprType->type);
+    Type* arrayType = NEW_ARRAY_TYPE(copy(arrayInitExprType->type));
 
     list_foreach(dimension, arrayInitExprType->dimensions) {
         const ArrayDimension* dim = (ArrayDimension*) ((Type*) dimension->value)->type;
@@ -1403,29 +1513,81 @@ static Type* check_array_init_expr(TypeChecker* typeChecker, ArrayInitExpr* arra
         ARRAY_TYPE_ADD_DIMENSION(arrayType, NEW_ARRAY_DIMENSION(dim->size));
     }
 
+    arrayType = type_intern(arrayType);
+
+    if (array_type_is_dense(arrayType) && !check_dense_array_elements(typeChecker, arrayInitExpr, arrayType))
+        return NULL;
+
     return arrayType;
 }
 
+static Type* check_map_init_expr(TypeChecker* typeChecker, MapInitExpr* mapInitExpr) {
+    if (typeChecker == NULL || mapInitExpr == NULL)
+        return NULL;
+
+    Type* mapType = mapInitExpr->type;
+    MapType* map = mapType->type;
+
+    if (!map_type_is_valid_key(map->key)) {
+        typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
+        output_printf("\nInvalid MapInitExpr: keys must be int, char, string or bool");
+        output_printf("\n\tGot: ");
+        type_to_string(&map->key);
+        output_printf("\n\tIn: ");
+        map_init_expr_to_string(&mapInitExpr);
+        output_printf("\n");
+        return NULL;
+    }
+
+    ListNode* value = mapInitExpr->values->head;
+
+    list_foreach(key, mapInitExpr->keys) {
+        Type* keyType = check_expr(typeChecker, key->value);
+        Type* valueType = check_expr(typeChecker, value->value);
+
+        if (!equals(keyType, map->key) || !equals(valueType, map->value)) {
+            typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
+            output_printf("\nInvalid MapInitExpr: incompatible entry");
+            output_printf("\n\tRequired: ");
+            type_to_string(&map->key);
+            output_printf(": ");
+            type_to_string(&map->value);
+            output_printf("\n\tGot: ");
+            type_to_string(&keyType);
+            output_printf(": ");
+            type_to_string(&valueType);
+            output_printf("\n\tIn: ");
+            map_init_expr_to_string(&mapInitExpr);
+            output_printf("\n");
+            return NULL;
+        }
+
+        value = value->next;
+    }
+
+    return mapType;
+}
+
 static Type* check_function_expr(TypeChecker* typeChecker, FunctionExpr* functionExpr) {
     if (typeChecker == NULL || functionExpr == NULL)
         return NULL;
 
     if (!function_has_valid_parameters(typeChecker, functionExpr->parameters)) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nInvalid FunctionExpr: the function has parameters with invalid types --> (void) or (nil)\n");
+        output_printf("\nInvalid FunctionExpr: the function has parameters with invalid types --> (void) or (nil)\n");
         function_expr_to_string(&functionExpr);
-        printf("\n");
+        output_printf("\n");
         return NULL;
     }
 
-    List* paramTypes = list_new(NULL);
+    List* paramTypes = list_new((void (*)(void **)) type_free);
     list_foreach(param, functionExpr->parameters) {
-        list_insert_last(&paramTypes, check_decl(typeChecker, param->value));
+        list_insert_last(&paramTypes, copy(check_decl(typeChecker, param->value)));
     }
 
-    Type* returnType = functionExpr->returnType;
+    Type* returnType = copy(functionExpr->returnType);
 
-    Type* functionType = NEW_FUNCTION_TYPE_WITH_PARAMS_AND_RETURN(paramTypes, returnType);
+    Type* functionType = type_intern(NEW_FUNCTION_TYPE_WITH_PARAMS_AND_RETURN(paramTypes, returnType));
 
     // TODO: (bug fix)
     // FunctionExpr is returned by another and it is not possible to continue type checking
@@ -1436,7 +1598,7 @@ static Type* check_function_expr(TypeChecker* typeChecker, FunctionExpr* functio
     }
 
     Context* previous = typeChecker->env;
-    typeChecker->env = context_enclosed_new(previous, MAP_NEW(32, entry_cmp, NULL, NULL));
+    typeChecker->env = context_enclosed_new(previous, SYMBOL_MAP_NEW(32, NULL));
 
     typeChecker->hasFunctionTypeToDefine = false;
     typeChecker->hasCurrentFunctionReturned = false;
@@ -1467,9 +1629,9 @@ static Type* check_function_expr(TypeChecker* typeChecker, FunctionExpr* functio
         !typeChecker->hasCurrentFunctionReturned
     ) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("Invalid FunctionExpr: a return value is specified in the function but none is provided\n");
+        output_printf("Invalid FunctionExpr: a return value is specified in the function but none is provided\n");
         function_expr_to_string(&functionExpr);
-        printf("\n");
+        output_printf("\n");
         return NULL;
     }
 
@@ -1484,9 +1646,9 @@ static Type* check_conditional_expr(TypeChecker* typeChecker, ConditionalExpr* c
 
     if (!equals(conditionType, get_type_of(BOOL_TYPE))) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nInvalid ConditionalExpr: condition should have type bool\n\t");
+        output_printf("\nInvalid ConditionalExpr: condition should have type bool\n\t");
         conditional_expr_to_string(&conditionalExpr);
-        printf("\n");
+        output_printf("\n");
         return NULL;
     }
 
@@ -1495,63 +1657,344 @@ static Type* check_conditional_expr(TypeChecker* typeChecker, ConditionalExpr* c
 
     if (!equals(isTrueType, isFalseType)) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nInvalid ConditionalExpr: type mismatch in conditional expression\n\t");
+        output_printf("\nInvalid ConditionalExpr: type mismatch in conditional expression\n\t");
         conditional_expr_to_string(&conditionalExpr);
-        printf(" (");
+        output_printf(" (");
         type_to_string(&isTrueType);
-        printf(" : ");
+        output_printf(" : ");
         type_to_string(&isFalseType);
-        printf(")\n");
+        output_printf(")\n");
         return NULL;
     }
 
     return isTrueType;
 }
 
-static Type* check_array_member_expr(TypeChecker* typeChecker, ArrayMemberExpr* arrayMemberExpr) {
-    if (typeChecker == NULL || arrayMemberExpr == NULL)
+/* push(array, element) and reserve(array, capacity) return nothing, pop(array) the element */
+static Type* check_array_builtin(TypeChecker* typeChecker, CallExpr* callExpr, const char* name) {
+    bool isPop = strcmp(name, "pop") == 0;
+
+    if (vector_size(&callExpr->arguments) != (isPop ? 1 : 2)) {
+        typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
+        output_printf("\nInvalid CallExpr: number of arguments does not match ---> ");
+        call_expr_to_string(&callExpr);
+        output_printf("\n");
         return NULL;
+    }
 
-    Type* objectType = check_expr(typeChecker, arrayMemberExpr->object);
-    if (objectType == NULL || objectType->typeId != ARRAY_TYPE) {
+    Type* arrayType = check_expr(typeChecker, vector_get_at(&callExpr->arguments, 0));
+    if (arrayType == NULL || arrayType->typeId != ARRAY_TYPE) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nInvalid ArrayMemberExpr: invalid member access\n\t");
-        array_member_expr_to_string(&arrayMemberExpr);
-        printf("\n");
+        output_printf("\nInvalid CallExpr: %s expects an array", name);
+        output_printf("\n\t---> ");
+        call_expr_to_string(&callExpr);
+        output_printf("\n");
+        return NULL;
+    }
+
+    /* a declared length is part of the type, dense blocks included */
+    if (array_type_extent(arrayType, 0) != 0) {
+        typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
+        output_printf("\nInvalid CallExpr: %s cannot resize a fixed-size array", name);
+        output_printf("\n\t---> ");
+        call_expr_to_string(&callExpr);
+        output_printf("\n");
         return NULL;
     }
 
-    ArrayType* arrayType = objectType->type;
+    Type* elementType = array_type_slice(arrayType, 1);
 
-    if (list_size(&arrayMemberExpr->levelOfAccess) > list_size(&arrayType->dimensions)) {
+    if (isPop)
+        return elementType;
+
+    Type* expectedType = strcmp(name, "push") == 0 ? elementType : get_type_of(INT_TYPE);
+    Type* argumentType = check_expr(typeChecker, vector_last(&callExpr->arguments));
+
+    if (argumentType == NULL || !equals(expectedType, argumentType)) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nInvalid ArrayMemberExpr: invalid member access\n\t");
-        array_member_expr_to_string(&arrayMemberExpr);
-        printf("\n");
+        output_printf("\nInvalid CallExpr: incompatible types");
+        output_printf("\n\tRequired: ");
+        type_to_string(&expectedType);
+        output_printf("\n\tGot: ");
+        type_to_string(&argumentType);
+        output_printf("\n\t");
+        call_expr_to_string(&callExpr);
+        output_printf("\n");
         return NULL;
     }
 
-    if (list_size(&arrayMemberExpr->levelOfAccess) == list_size(&arrayType->dimensions)) {
-        return type_copy((const Type**) &arrayType->type);
+    return get_type_of(VOID_TYPE);
+}
+
+static bool is_numeric_array(Type* type) {
+    if (array_type_rank(type) == 0 || (array_type_rank(type) > 1 && !array_type_is_dense(type)))
+        return false;
+
+    TypeID elementId = ((ArrayType*) type->type)->type->typeId;
+
+    return elementId == INT_TYPE || elementId == FLOAT_TYPE;
+}
+
+/*
+ * matmul([n][k]T, [k][m]T) and transpose([n][m]T) take fixed-shape matrices,
+ * matadd, matsub and hadamard work elementwise on two arrays of one type
+ */
+static Type* check_matrix_builtin(TypeChecker* typeChecker, CallExpr* callExpr, const char* name) {
+    bool isTranspose = strcmp(name, "transpose") == 0;
+    bool isMatmul = strcmp(name, "matmul") == 0;
+
+    if (vector_size(&callExpr->arguments) != (isTranspose ? 1 : 2)) {
+        typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
+        output_printf("\nInvalid CallExpr: number of arguments does not match ---> ");
+        call_expr_to_string(&callExpr);
+        output_printf("\n");
+        return NULL;
     }
 
-    Type* memberType = NEW_ARRAY_TYPE(type_copy((const Type**) &arrayType->type));
+    Type* left = check_expr(typeChecker, vector_get_at(&callExpr->arguments, 0));
+    Type* right = isTranspose ? left : check_expr(typeChecker, vector_last(&callExpr->arguments));
 
-    size_t current_dimension = 0;
-    Type* arrayDimension = list_get_at(&arrayType->dimensions, current_dimension);
+    bool valid = is_numeric_array(left) && is_numeric_array(right);
 
-    list_foreach(level, arrayMemberExpr->levelOfAccess) {
-        size_t dimension_size = ((ArrayDimension*) arrayDimension->type)->size;
+    if (valid && (isTranspose || isMatmul)) {
+        valid = array_type_rank(left) == 2 && array_type_rank(right) == 2
+            && equals(((ArrayType*) left->type)->type, ((ArrayType*) right->type)->type)
+            && (isTranspose || array_type_extent(left, 1) == array_type_extent(right, 0));
+    } else if (valid) {
+        valid = equals(left, right);
+    }
+
+    if (!valid) {
+        typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
+        output_printf("\nInvalid CallExpr: %s got arrays of incompatible shapes", name);
+        output_printf("\n\t---> ");
+        call_expr_to_string(&callExpr);
+        output_printf("\n");
+        return NULL;
+    }
+
+    if (!isTranspose && !isMatmul)
+        return left;
+
+    Type* result = NEW_ARRAY_TYPE(copy(((ArrayType*) left->type)->type));
+    ARRAY_TYPE_ADD_DIMENSION(result, NEW_ARRAY_DIMENSION(isTranspose ? array_type_extent(left, 1) : array_type_extent(left, 0)));
+    ARRAY_TYPE_ADD_DIMENSION(result, NEW_ARRAY_DIMENSION(isTranspose ? array_type_extent(left, 0) : array_type_extent(right, 1)));
+
+    return type_intern(result);
+}
+
+/*
+ * sum, min and max take one numeric array, dot two of one type, and all four
+ * return its element type. axpy(T, A, A) and fill(A, T) update the array,
+ * map_add(A, T) and map_mul(A, T) return a new one.
+ */
+static Type* check_numeric_builtin(TypeChecker* typeChecker, CallExpr* callExpr, const char* name) {
+    bool isAxpy = strcmp(name, "axpy") == 0;
+    bool isDot = strcmp(name, "dot") == 0;
+    bool isReduce = strcmp(name, "sum") == 0 || strcmp(name, "min") == 0 || strcmp(name, "max") == 0;
+    bool isFill = strcmp(name, "fill") == 0;
+
+    size_t expected = isReduce ? 1 : isAxpy ? 3 : 2;
+
+    if (vector_size(&callExpr->arguments) != expected) {
+        typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
+        output_printf("\nInvalid CallExpr: number of arguments does not match ---> ");
+        call_expr_to_string(&callExpr);
+        output_printf("\n");
+        return NULL;
+    }
+
+    Type* arguments[3] = {NULL, NULL, NULL};
+    size_t index = 0;
+
+    vector_foreach(argument, callExpr->arguments) {
+        arguments[index++] = check_expr(typeChecker, *argument);
+    }
+
+    /* axpy leads with its scalar, the others with the array */
+    Type* array = arguments[isAxpy ? 1 : 0];
+    Type* other = isReduce ? array : arguments[isAxpy ? 2 : 1];
+    Type* scalar = isAxpy ? arguments[0] : other;
+
+    bool valid = is_numeric_array(array);
+    Type* element = valid ? ((ArrayType*) array->type)->type : NULL;
+
+    if (valid && (isDot || isAxpy)) {
+        valid = equals(array, other);
+    }
+    if (valid && !isReduce && !isDot) {
+        valid = scalar != NULL && equals(scalar, element);
+    }
+
+    if (!valid) {
+        typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
+        output_printf("\nInvalid CallExpr: %s expects []int or []float operands", name);
+        output_printf("\n\t---> ");
+        call_expr_to_string(&callExpr);
+        output_printf("\n");
+        return NULL;
+    }
+
+    if (isReduce || isDot)
+        return element;
+
+    if (isAxpy || isFill)
+        return get_type_of(VOID_TYPE);
+
+    return array;
+}
 
-        ARRAY_TYPE_ADD_DIMENSION(memberType, NEW_ARRAY_DIMENSION(dimension_size));
+/*
+ * delete(m, k) and has(m, k) take a key of the map's key type, keys(m) and
+ * values(m) return the map's contents as []K and []V in the same order
+ */
+static Type* check_map_builtin(TypeChecker* typeChecker, CallExpr* callExpr, const char* name) {
+    bool takesKey = strcmp(name, "delete") == 0 || strcmp(name, "has") == 0;
 
-        if (level->next != NULL) {
-            current_dimension += 1;
-            arrayDimension = list_get_at(&arrayType->dimensions, current_dimension);
+    if (vector_size(&callExpr->arguments) != (takesKey ? 2 : 1)) {
+        typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
+        output_printf("\nInvalid CallExpr: number of arguments does not match ---> ");
+        call_expr_to_string(&callExpr);
+        output_printf("\n");
+        return NULL;
+    }
+
+    Type* mapType = check_expr(typeChecker, vector_get_at(&callExpr->arguments, 0));
+    if (mapType == NULL || mapType->typeId != MAP_TYPE) {
+        typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
+        output_printf("\nInvalid CallExpr: %s expects a map", name);
+        output_printf("\n\t---> ");
+        call_expr_to_string(&callExpr);
+        output_printf("\n");
+        return NULL;
+    }
+
+    MapType* map = mapType->type;
+
+    if (!takesKey) {
+        Type* arrayType = NEW_ARRAY_TYPE(copy(strcmp(name, "keys") == 0 ? map->key : map->value));
+        ARRAY_TYPE_ADD_DIMENSION(arrayType, NEW_ARRAY_UNDEFINED_DIMENSION());
+
+        return type_intern(arrayType);
+    }
+
+    Type* keyType = check_expr(typeChecker, vector_last(&callExpr->arguments));
+
+    if (keyType == NULL || !equals(map->key, keyType)) {
+        typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
+        output_printf("\nInvalid CallExpr: incompatible types");
+        output_printf("\n\tRequired: ");
+        type_to_string(&map->key);
+        output_printf("\n\tGot: ");
+        type_to_string(&keyType);
+        output_printf("\n\t");
+        call_expr_to_string(&callExpr);
+        output_printf("\n");
+        return NULL;
+    }
+
+    return strcmp(name, "has") == 0 ? get_type_of(BOOL_TYPE) : get_type_of(VOID_TYPE);
+}
+
+/* read_all and read_lines take a path, has_line and next_line an optional one and read stdin without it */
+static Type* check_reader_builtin(TypeChecker* typeChecker, CallExpr* callExpr, const char* name) {
+    bool pathOptional = strcmp(name, "has_line") == 0 || strcmp(name, "next_line") == 0;
+    size_t argc = vector_size(&callExpr->arguments);
+
+    if (argc > 1 || (argc == 0 && !pathOptional)) {
+        typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
+        output_printf("\nInvalid CallExpr: number of arguments does not match ---> ");
+        call_expr_to_string(&callExpr);
+        output_printf("\n");
+        return NULL;
+    }
+
+    if (argc == 1) {
+        Type* pathType = check_expr(typeChecker, vector_get_at(&callExpr->arguments, 0));
+        if (pathType == NULL || pathType->typeId != STRING_TYPE) {
+            typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
+            output_printf("\nInvalid CallExpr: %s expects a string path", name);
+            output_printf("\n\t---> ");
+            call_expr_to_string(&callExpr);
+            output_printf("\n");
+            return NULL;
         }
     }
 
-    return memberType;
+    if (strcmp(name, "has_line") == 0)
+        return get_type_of(BOOL_TYPE);
+
+    if (strcmp(name, "read_lines") == 0) {
+        Type* arrayType = NEW_ARRAY_TYPE(NEW_STRING_TYPE());
+        ARRAY_TYPE_ADD_DIMENSION(arrayType, NEW_ARRAY_UNDEFINED_DIMENSION());
+
+        return type_intern(arrayType);
+    }
+
+    return get_type_of(STRING_TYPE);
+}
+
+/* a map is indexed by one key and yields its value type */
+static Type* check_map_key(TypeChecker* typeChecker, ArrayMemberExpr* arrayMemberExpr, MapType* mapType, Expr* key) {
+    Type* keyType = check_expr(typeChecker, key);
+
+    if (!equals(keyType, mapType->key)) {
+        typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
+        output_printf("\nInvalid ArrayMemberExpr: incompatible key type");
+        output_printf("\n\tRequired: ");
+        type_to_string(&mapType->key);
+        output_printf("\n\tGot: ");
+        type_to_string(&keyType);
+        output_printf("\n\t");
+        array_member_expr_to_string(&arrayMemberExpr);
+        output_printf("\n");
+        return NULL;
+    }
+
+    return mapType->value;
+}
+
+/* a map takes one level, its key, an array as many as it has dimensions */
+static Type* check_array_member_expr(TypeChecker* typeChecker, ArrayMemberExpr* arrayMemberExpr) {
+    if (typeChecker == NULL || arrayMemberExpr == NULL)
+        return NULL;
+
+    Type* currentType = check_expr(typeChecker, arrayMemberExpr->object);
+    ListNode* level = arrayMemberExpr->levelOfAccess->head;
+
+    while (level != NULL && currentType != NULL) {
+        if (currentType->typeId == MAP_TYPE) {
+            currentType = check_map_key(typeChecker, arrayMemberExpr, currentType->type, level->value);
+            if (currentType == NULL)
+                return NULL;
+
+            level = level->next;
+            continue;
+        }
+
+        if (currentType->typeId != ARRAY_TYPE)
+            break;
+
+        size_t rank = list_size(&((ArrayType*) currentType->type)->dimensions);
+        size_t taken = 0;
+
+        while (level != NULL && taken < rank) {
+            level = level->next;
+            taken++;
+        }
+
+        currentType = array_type_slice(currentType, taken);
+    }
+
+    if (level != NULL || currentType == NULL) {
+        typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
+        output_printf("\nInvalid ArrayMemberExpr: invalid member access\n\t");
+        array_member_expr_to_string(&arrayMemberExpr);
+        output_printf("\n");
+        return NULL;
+    }
+
+    return currentType;
 }
 
 static Type* check_literal_expr(TypeChecker* typeChecker, LiteralExpr* literalExpr) {
@@ -1580,7 +2023,7 @@ static Type* check_literal_expr(TypeChecker* typeChecker, LiteralExpr* literalEx
     default:
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
 
-        printf("\nUnexpected literal type\n");
+        output_printf("\nUnexpected literal type\n");
 
         return NULL;
     }
@@ -1601,6 +2044,8 @@ static Expr* get_zero_value(const Type* type) {
         return NEW_STRING_LITERAL("");
     case BOOL_TYPE:
         return NEW_BOOL_LITERAL(false);
+    case MAP_TYPE:
+        return NEW_MAP_INIT_EXPR(copy((Type*) type));
     default:
         return NEW_NIL_LITERAL();
     }
@@ -1612,9 +2057,9 @@ static Type* do_struct_lookup(TypeChecker* typeChecker, StructType* type, Expr*
 
     if (expression->type != MEMBER_EXPR) {
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-        printf("\nInvalid member access: \n\t");
+        output_printf("\nInvalid member access: \n\t");
         expr_to_string(&expression);
-        printf("\n");
+        output_printf("\n");
         return NULL;
     }
 
@@ -1635,7 +2080,7 @@ static Type* do_struct_lookup(TypeChecker* typeChecker, StructType* type, Expr*
         );
 
         if (structFieldType == NULL) {
-            printf("\nStruct field does not exist: (%s)\n\t", memberName->value);
+            output_printf("\nStruct field does not exist: (%s)\n\t", memberName->value);
             currentMemberType = NULL; // remove previous assignment
             break;
         }
@@ -1694,9 +2139,9 @@ static Type* lookup_object(TypeChecker* typeChecker, Expr* object, Expr* objectA
 
         if (currentMemberType == NULL) {
             typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-            printf("\nInvalid member access: ");
+            output_printf("\nInvalid member access: ");
             expr_to_string(&objectAccess);
-            printf("\n\tIn: ");
+            output_printf("\n\tIn: ");
             type_to_string(&identType);
             return NULL;
         }
@@ -1708,7 +2153,7 @@ static Type* lookup_object(TypeChecker* typeChecker, Expr* object, Expr* objectA
         Type* isStruct = context_get(typeChecker->env, name);
         if (isStruct == NULL || isStruct->typeId != STRUCT_TYPE) {
             typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-            printf("\nUndefined: %s\n", name);
+            output_printf("\nUndefined: %s\n", name);
             return NULL;
         }
 
@@ -1718,11 +2163,11 @@ static Type* lookup_object(TypeChecker* typeChecker, Expr* object, Expr* objectA
 
         if (currentMemberType == NULL) {
             typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
-            printf("\nInvalid member access: ");
+            output_printf("\nInvalid member access: ");
             expr_to_string(&objectAccess);
-            printf("\n\tIn: ");
+            output_printf("\n\tIn: ");
             type_to_string(&isStruct);
-            printf("\n");
+            output_printf("\n");
             return NULL;
         }
 
@@ -1731,13 +2176,13 @@ static Type* lookup_object(TypeChecker* typeChecker, Expr* object, Expr* objectA
     default:
         typeChecker->currentStatus = TYPE_CHECKER_FAILURE;
 
-        printf("\nCan only lookup strings, arrays, structs\n\t");
+        output_printf("\nCan only lookup strings, arrays, structs\n\t");
         expr_to_string(&object);
-        printf(" (");
+        output_printf(" (");
         type_to_string(&identType);
-        printf(")\n\tInvalid access ---> ");
+        output_printf(")\n\tInvalid access ---> ");
         expr_to_string(&objectAccess);
-        printf("\n");
+        output_printf("\n");
 
         return NULL;
     }
@@ -1817,6 +2262,23 @@ static bool expect_token_type(TokenType type, size_t n_elements, ...) {
     return false;
 }
 
+static OperandTypes operand_types(Type* leftType, Type* rightType, TokenType operation) {
+    TypeID left = leftType->typeId;
+    TypeID right = rightType->typeId;
+
+    if (left == INT_TYPE && right == INT_TYPE)
+        return OPERANDS_INT;
+
+    if (expect_type_id(left, 2, INT_TYPE, FLOAT_TYPE) && expect_type_id(right, 2, INT_TYPE, FLOAT_TYPE))
+        return OPERANDS_FLOAT;
+
+    if (operation == TOKEN_ADD && expect_type_id(left, 2, CHAR_TYPE, STRING_TYPE)
+        && expect_type_id(right, 2, CHAR_TYPE, STRING_TYPE))
+        return OPERANDS_CONCAT;
+
+    return OPERANDS_ANY;
+}
+
 static bool struct_type_has_fields_with_valid_types(StructType* structType) {
     if (structType == NULL)
         return false;
@@ -1892,7 +2354,7 @@ static bool is_argument_valid_for_parameter(TypeChecker* typeChecker,
         return false;
 
     if (equals(argumentType, get_type_of(NIL_TYPE)) &&
-        expect_type_id(parameterType->typeId, 4, CUSTOM_TYPE, STRUCT_TYPE, ARRAY_TYPE, FUNC_TYPE)
+        expect_type_id(parameterType->typeId, 5, CUSTOM_TYPE, STRUCT_TYPE, ARRAY_TYPE, MAP_TYPE, FUNC_TYPE)
     ) {
         return true;
     }
@@ -1909,30 +2371,30 @@ static bool is_argument_valid_for_parameter(TypeChecker* typeChecker,
 }
 
 static bool call_expr_args_match_function_parameters(TypeChecker* typeChecker,
-    List* arguments, FunctionType* functionType
+    Vector* arguments, FunctionType* functionType
 ) {
     if (typeChecker == NULL || arguments == NULL || functionType == NULL)
         return false;
 
     bool success = true;
 
-    ListNode* argNode = arguments->head;
+    size_t index = 0;
     ListNode* paramNode = functionType->parameterTypes->head;
 
-    while (argNode != NULL && paramNode != NULL) {
-        Expr* argument = argNode->value;
+    while (index < arguments->size && paramNode != NULL) {
+        Expr* argument = arguments->items[index];
         Type* parameterType = paramNode->value;
 
         if (!is_argument_valid_for_parameter(typeChecker, argument, parameterType)) {
-            printf("Type mismatch:\n\t");
+            output_printf("Type mismatch:\n\t");
             expr_to_string(&argument);
-            printf(" != ");
+            output_printf(" != ");
             type_to_string(&parameterType);
-            printf("\n");
+            output_printf("\n");
             success = false;
         }
 
-        argNode = argNode->next;
+        index++;
         paramNode = paramNode->next;
     }
 
@@ -24,5 +24,9 @@ TypeCheckerStatus check(List* declarations);
 TypeCheckerStatus init_and_check(TypeChecker** typeChecker, List* declarations);
 void type_checker_destroy(TypeChecker** typeChecker);
 
+/* checks a program one top-level declaration at a time, a failure sticks */
+TypeChecker* type_checker_new(void);
+TypeCheckerStatus check_next(TypeChecker* typeChecker, Decl* declaration);
+
 Type* get_decl_type(TypeChecker* typeChecker, Decl* declaration);
 Type* get_expr_type(TypeChecker* typeChecker, Expr* expression);
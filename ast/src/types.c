@@ -4,9 +4,12 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "arena.h"
 #include "list.h"
-#include "utils.h"
+#include "output.h"
 #include "smem.h"
+#include "symbol.h"
+#include "utils.h"
 
 
 static bool compare_list_of_types(List* a, List* b) {
@@ -27,17 +30,330 @@ static bool compare_list_of_types(List* a, List* b) {
     return true;
 }
 
-Type* type_new(TypeID typeId, void* type,
-    void* (*copy)(const void**),
-    bool (*equals)(void**, void**),
-    void (*to_string)(void**),
-    void (*destroy)(void**))
-{
+static const TypeVTable atomic_vtable = {
+    .copy = (void* (*)(const void**)) atomic_type_copy,
+    .equals = (bool (*)(void**, void**)) atomic_type_equals,
+    .to_string = (void (*)(void**)) atomic_type_to_string,
+    .destroy = (void (*)(void**)) atomic_type_free
+};
+
+static const TypeVTable vtables[] = {
+    [INT_TYPE] = atomic_vtable,
+    [FLOAT_TYPE] = atomic_vtable,
+    [CHAR_TYPE] = atomic_vtable,
+    [STRING_TYPE] = atomic_vtable,
+    [BOOL_TYPE] = atomic_vtable,
+    [VOID_TYPE] = atomic_vtable,
+    [NIL_TYPE] = atomic_vtable,
+    [CUSTOM_TYPE] = atomic_vtable,
+    [NAMED_TYPE] = {
+        .copy = (void* (*)(const void**)) named_type_copy,
+        .equals = (bool (*)(void**, void**)) named_type_equals,
+        .to_string = (void (*)(void**)) named_type_to_string,
+        .destroy = (void (*)(void**)) named_type_free
+    },
+    [STRUCT_TYPE] = {
+        .copy = (void* (*)(const void**)) struct_type_copy,
+        .equals = (bool (*)(void**, void**)) struct_type_equals,
+        .to_string = (void (*)(void**)) struct_type_to_string,
+        .destroy = (void (*)(void**)) struct_type_free
+    },
+    [ARRAY_DIMENSION_TYPE] = {
+        .copy = (void* (*)(const void**)) array_dimension_copy,
+        .equals = (bool (*)(void**, void**)) array_dimension_equals,
+        .to_string = (void (*)(void**)) array_dimension_to_string,
+        .destroy = (void (*)(void**)) array_dimension_free
+    },
+    [ARRAY_TYPE] = {
+        .copy = (void* (*)(const void**)) array_type_copy,
+        .equals = (bool (*)(void**, void**)) array_type_equals,
+        .to_string = (void (*)(void**)) array_type_to_string,
+        .destroy = (void (*)(void**)) array_type_free
+    },
+    [MAP_TYPE] = {
+        .copy = (void* (*)(const void**)) map_type_copy,
+        .equals = (bool (*)(void**, void**)) map_type_equals,
+        .to_string = (void (*)(void**)) map_type_to_string,
+        .destroy = (void (*)(void**)) map_type_free
+    },
+    [FUNC_TYPE] = {
+        .copy = (void* (*)(const void**)) function_type_copy,
+        .equals = (bool (*)(void**, void**)) function_type_equals,
+        .to_string = (void (*)(void**)) function_type_to_string,
+        .destroy = (void (*)(void**)) function_type_free
+    }
+};
+
+static const struct {
+    size_t size;
+    char* name;
+} atomic_types[] = {
+    [INT_TYPE] = { sizeof(int), "int" },
+    [FLOAT_TYPE] = { sizeof(double), "float" },
+    [CHAR_TYPE] = { sizeof(char), "char" },
+    [STRING_TYPE] = { sizeof(char*), "string" },
+    [BOOL_TYPE] = { sizeof(bool), "bool" },
+    [VOID_TYPE] = { 0, "void" },
+    [NIL_TYPE] = { 0, "nil" }
+};
+
+/* open addressing table of canonical types, keyed by structure */
+struct TypeTable {
+    Type** slots;
+    size_t capacity;
+    size_t count;
+    Type* atomics[_atomic_end];
+    const TypeTable* builtins;
+};
+
+static _Thread_local TypeTable* active = NULL;
+
+#define TYPE_TABLE_MIN_CAPACITY 64
+
+static size_t hash_combine(size_t hash, size_t value) {
+    return (hash ^ value) * 1099511628211UL;
+}
+
+static size_t hash_list_of_types(size_t hash, List* types) {
+    hash = hash_combine(hash, list_size(&types));
+    list_foreach(type, types) {
+        hash = hash_combine(hash, (size_t) type->value);
+    }
+
+    return hash;
+}
+
+static bool is_void(const Type* type) {
+    return type != NULL && type->typeId == VOID_TYPE;
+}
+
+/* children are canonical by the time this runs, so they hash by address */
+static size_t type_hash(const Type* type) {
+    size_t hash = hash_combine(14695981039346656037UL, type->typeId);
+
+    switch (type->typeId) {
+    case NAMED_TYPE: {
+        const NamedType* namedType = type->type;
+        hash = hash_combine(hash, symbol_hash(namedType->name));
+        return hash_combine(hash, (size_t) namedType->type);
+    }
+    case STRUCT_TYPE:
+        return hash_list_of_types(hash, ((StructType*) type->type)->fields);
+    case ARRAY_DIMENSION_TYPE:
+        return hash_combine(hash, ((ArrayDimension*) type->type)->size);
+    case ARRAY_TYPE: {
+        const ArrayType* arrayType = type->type;
+        hash = hash_combine(hash, (size_t) arrayType->type);
+        return hash_list_of_types(hash, arrayType->dimensions);
+    }
+    case MAP_TYPE: {
+        const MapType* mapType = type->type;
+        hash = hash_combine(hash, (size_t) mapType->key);
+        return hash_combine(hash, (size_t) mapType->value);
+    }
+    case FUNC_TYPE: {
+        const FunctionType* functionType = type->type;
+        hash = hash_combine(hash, (size_t) functionType->returnType);
+        return hash_list_of_types(hash, functionType->parameterTypes);
+    }
+    default:
+        return hash_combine(hash, symbol_hash(((AtomicType*) type->type)->name));
+    }
+}
+
+static bool same_list_of_types(List* a, List* b) {
+    if (list_size(&a) != list_size(&b))
+        return false;
+
+    ListNode* bNode = b->head;
+    list_foreach(aNode, a) {
+        if (aNode->value != bNode->value)
+            return false;
+
+        bNode = bNode->next;
+    }
+
+    return true;
+}
+
+static bool same_structure(const Type* a, const Type* b) {
+    if (a->hash != b->hash || a->typeId != b->typeId)
+        return false;
+
+    switch (a->typeId) {
+    case NAMED_TYPE: {
+        const NamedType* x = a->type;
+        const NamedType* y = b->type;
+        return x->type == y->type && x->name == y->name;
+    }
+    case STRUCT_TYPE:
+        return same_list_of_types(((StructType*) a->type)->fields, ((StructType*) b->type)->fields);
+    case ARRAY_DIMENSION_TYPE:
+        return ((ArrayDimension*) a->type)->size == ((ArrayDimension*) b->type)->size;
+    case ARRAY_TYPE: {
+        const ArrayType* x = a->type;
+        const ArrayType* y = b->type;
+        return x->type == y->type && same_list_of_types(x->dimensions, y->dimensions);
+    }
+    case MAP_TYPE: {
+        const MapType* x = a->type;
+        const MapType* y = b->type;
+        return x->key == y->key && x->value == y->value;
+    }
+    case FUNC_TYPE: {
+        const FunctionType* x = a->type;
+        const FunctionType* y = b->type;
+        return x->returnType == y->returnType
+            && same_list_of_types(x->parameterTypes, y->parameterTypes);
+    }
+    default:
+        return ((AtomicType*) a->type)->name == ((AtomicType*) b->type)->name;
+    }
+}
+
+static Type* table_find(const TypeTable* from, const Type* type) {
+    if (from->capacity == 0)
+        return NULL;
+
+    size_t index = type->hash & (from->capacity - 1);
+    for (; from->slots[index] != NULL; index = (index + 1) & (from->capacity - 1)) {
+        if (same_structure(from->slots[index], type))
+            return from->slots[index];
+    }
+
+    return NULL;
+}
+
+static bool table_grow(TypeTable* table) {
+    if ((table->count + 1) * 4 <= table->capacity * 3)
+        return true;
+
+    size_t capacity = table->capacity < TYPE_TABLE_MIN_CAPACITY
+        ? TYPE_TABLE_MIN_CAPACITY
+        : table->capacity * 2;
+
+    Type** slots = safe_calloc(capacity, sizeof(Type*), NULL);
+    if (slots == NULL)
+        return false;
+
+    for (size_t i = 0; i < table->capacity; i++) {
+        Type* type = table->slots[i];
+        if (type == NULL)
+            continue;
+
+        size_t index = type->hash & (capacity - 1);
+        while (slots[index] != NULL) {
+            index = (index + 1) & (capacity - 1);
+        }
+
+        slots[index] = type;
+    }
+
+    safe_free((void**) &table->slots);
+
+    table->slots = slots;
+    table->capacity = capacity;
+
+    return true;
+}
+
+static void intern_list_of_types(TypeTable* table, List* types) {
+    list_foreach(type, types) {
+        type->value = type_table_intern(table, type->value);
+    }
+}
+
+static void intern_children(TypeTable* table, Type* type) {
+    switch (type->typeId) {
+    case NAMED_TYPE: {
+        NamedType* namedType = type->type;
+        namedType->type = type_table_intern(table, namedType->type);
+        break;
+    }
+    case STRUCT_TYPE:
+        intern_list_of_types(table, ((StructType*) type->type)->fields);
+        break;
+    case ARRAY_TYPE: {
+        ArrayType* arrayType = type->type;
+        arrayType->type = type_table_intern(table, arrayType->type);
+        intern_list_of_types(table, arrayType->dimensions);
+        break;
+    }
+    case MAP_TYPE: {
+        MapType* mapType = type->type;
+        mapType->key = type_table_intern(table, mapType->key);
+        mapType->value = type_table_intern(table, mapType->value);
+        break;
+    }
+    case FUNC_TYPE: {
+        FunctionType* functionType = type->type;
+        functionType->returnType = type_table_intern(table, functionType->returnType);
+        intern_list_of_types(table, functionType->parameterTypes);
+
+        /* a missing return type and void are the same type */
+        if (is_void(functionType->returnType)) {
+            functionType->returnType = NULL;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+/* canonical types outlive any parse arena, so they keep their lists on the heap */
+static List* heap_list_of_types(List* types) {
+    if (types == NULL || types->arena == NULL)
+        return types;
+
+    Arena* arena = arena_active();
+    arena_set_active(NULL);
+
+    List* copy = list_new((void (*)(void **)) type_free);
+    list_foreach(type, types) {
+        list_insert_last(&copy, type->value);
+    }
+
+    arena_set_active(arena);
+
+    return copy;
+}
+
+static void adopt_children(Type* type) {
+    switch (type->typeId) {
+    case STRUCT_TYPE: {
+        StructType* structType = type->type;
+        structType->fields = heap_list_of_types(structType->fields);
+        break;
+    }
+    case ARRAY_TYPE: {
+        ArrayType* arrayType = type->type;
+        arrayType->dimensions = heap_list_of_types(arrayType->dimensions);
+        break;
+    }
+    case FUNC_TYPE: {
+        FunctionType* functionType = type->type;
+        functionType->parameterTypes = heap_list_of_types(functionType->parameterTypes);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+static void release(Type* type) {
+    if (vtables[type->typeId].destroy != NULL)
+        vtables[type->typeId].destroy(&type->type);
+
+    smem_free((void**) &type, sizeof(Type));
+}
+
+Type* type_new(TypeID typeId, void* type) {
     Type* new_type = NULL;
-    new_type = safe_malloc(sizeof(Type), NULL);
+    new_type = smem_alloc(sizeof(Type));
     if (new_type == NULL) {
-        if (destroy != NULL) {
-            destroy(&type);
+        if (vtables[typeId].destroy != NULL) {
+            vtables[typeId].destroy(&type);
         }
         return NULL;
     }
@@ -45,29 +361,98 @@ Type* type_new(TypeID typeId, void* type,
     *new_type = (Type) {
         .typeId = typeId,
         .type = type,
-        .copy = copy,
-        .equals = equals,
-        .to_string = to_string,
-        .destroy = destroy
+        .hash = 0,
+        .interned = false
     };
 
     return new_type;
 }
 
+TypeTable* type_table_new(const TypeTable* builtins) {
+    TypeTable* table = safe_calloc(1, sizeof(TypeTable), NULL);
+    if (table == NULL) {
+        return NULL;
+    }
+
+    table->builtins = builtins;
+
+    return table;
+}
+
+void type_table_set_active(TypeTable* table) {
+    active = table;
+}
+
+TypeTable* type_table_active(void) {
+    return active;
+}
+
+Type* type_atomic(TypeID typeId) {
+    if (typeId <= _atomic_start || typeId >= _atomic_end || active == NULL)
+        return NULL;
+
+    if (active->builtins != NULL && active->builtins->atomics[typeId] != NULL)
+        return active->builtins->atomics[typeId];
+
+    if (active->atomics[typeId] == NULL) {
+        active->atomics[typeId] = type_intern(type_new(typeId,
+            atomic_type_new(atomic_types[typeId].size, atomic_types[typeId].name)));
+    }
+
+    return active->atomics[typeId];
+}
+
+/* takes ownership of type and returns its canonical instance in table */
+Type* type_table_intern(TypeTable* table, Type* type) {
+    if (table == NULL || type == NULL || type->interned)
+        return type;
+
+    intern_children(table, type);
+
+    type->hash = type_hash(type);
+
+    Type* canonical = table->builtins != NULL ? table_find(table->builtins, type) : NULL;
+    if (canonical == NULL) {
+        canonical = table_find(table, type);
+    }
+
+    if (canonical != NULL) {
+        release(type);
+        return canonical;
+    }
+
+    if (!table_grow(table))
+        return type;
+
+    size_t index = type->hash & (table->capacity - 1);
+    while (table->slots[index] != NULL) {
+        index = (index + 1) & (table->capacity - 1);
+    }
+
+    adopt_children(type);
+
+    type->interned = true;
+    table->slots[index] = type;
+    table->count++;
+
+    return type;
+}
+
+Type* type_intern(Type* type) {
+    return type_table_intern(active, type);
+}
+
 Type* type_copy(const Type** self) {
     if (self == NULL || *self == NULL)
         return NULL;
 
-    if ((*self)->copy != NULL) {
-        void* self_copy = (*self)->copy((const void**) &(*self)->type);
-        return type_new(
-            (*self)->typeId,
-            self_copy,
-            (*self)->copy,
-            (*self)->equals,
-            (*self)->to_string,
-            (*self)->destroy
-        );
+    if ((*self)->interned)
+        return (Type*) *self;
+
+    const TypeVTable* vtable = &vtables[(*self)->typeId];
+    if (vtable->copy != NULL) {
+        void* self_copy = vtable->copy((const void**) &(*self)->type);
+        return type_intern(type_new((*self)->typeId, self_copy));
     }
 
     return NULL;
@@ -77,8 +462,15 @@ bool type_equals(Type** self, Type** other) {
     if (self == NULL || *self == NULL || other == NULL || *other == NULL)
         return false;
 
-    if ((*self)->equals != NULL)
-        return (*self)->equals(&(*self)->type, (void**) other);
+    if (*self == *other)
+        return true;
+
+    if ((*self)->interned && (*other)->interned)
+        return false;
+
+    const TypeVTable* vtable = &vtables[(*self)->typeId];
+    if (vtable->equals != NULL)
+        return vtable->equals(&(*self)->type, (void**) other);
 
     return false;
 }
@@ -87,18 +479,55 @@ void type_to_string(Type** type) {
     if (type == NULL || *type == NULL)
         return;
 
-    if ((*type)->to_string != NULL)
-        (*type)->to_string(&(*type)->type);
+    const TypeVTable* vtable = &vtables[(*type)->typeId];
+    if (vtable->to_string != NULL)
+        vtable->to_string(&(*type)->type);
 }
 
 void type_free(Type** type) {
     if (type == NULL || *type == NULL)
         return;
 
-    if ((*type)->destroy != NULL)
-        (*type)->destroy(&(*type)->type);
+    if ((*type)->interned) {
+        *type = NULL;
+        return;
+    }
+
+    release(*type);
+
+    *type = NULL;
+}
 
-    safe_free((void**) type);
+size_t type_table_size(const TypeTable* table) {
+    return table != NULL ? table->count : 0;
+}
+
+void type_table_free(TypeTable** table) {
+    if (table == NULL || *table == NULL)
+        return;
+
+    if (active == *table) {
+        active = NULL;
+    }
+
+    Type** slots = (*table)->slots;
+    size_t capacity = (*table)->capacity;
+
+    /* payloads first: destroying one still looks at its canonical children */
+    for (size_t i = 0; i < capacity; i++) {
+        Type* type = slots[i];
+        if (type != NULL && vtables[type->typeId].destroy != NULL) {
+            vtables[type->typeId].destroy(&type->type);
+        }
+    }
+
+    for (size_t i = 0; i < capacity; i++) {
+        smem_free((void**) &slots[i], sizeof(Type));
+    }
+
+    safe_free((void**) &(*table)->slots);
+
+    safe_free((void**) table);
 }
 
 AtomicType* atomic_type_new(size_t size, char* name) {
@@ -110,7 +539,7 @@ AtomicType* atomic_type_new(size_t size, char* name) {
 
     *type = (AtomicType) {
         .size = size,
-        .name = str_dup(name)
+        .name = symbol_intern(name)
     };
 
     return type;
@@ -136,22 +565,20 @@ bool atomic_type_equals(AtomicType** self, Type** other) {
 
     const AtomicType* otherAtomicType = (AtomicType*) (*other)->type;
 
-    return strcmp((*self)->name, otherAtomicType->name) == 0;
+    return (*self)->name == otherAtomicType->name;
 }
 
 void atomic_type_to_string(AtomicType** atomicType) {
     if (atomicType == NULL || *atomicType == NULL)
         return;
 
-    printf("%s", (*atomicType)->name);
+    output_printf("%s", (*atomicType)->name);
 }
 
 void atomic_type_free(AtomicType** atomicType) {
     if (atomicType == NULL || *atomicType == NULL)
         return;
 
-    safe_free((void**) &(*atomicType)->name);
-
     safe_free((void**) atomicType);
 }
 
@@ -164,7 +591,7 @@ NamedType* named_type_new(char* name, Type* type) {
     }
 
     *new_type = (NamedType) {
-        .name = str_dup(name),
+        .name = symbol_intern(name),
         .type = type
     };
 
@@ -187,7 +614,7 @@ bool named_type_equals(NamedType** self, Type** other) {
 
     NamedType* otherNamedType = (NamedType*) (*other)->type;
 
-    bool hasEqualName = strcmp((*self)->name, otherNamedType->name) == 0;
+    bool hasEqualName = (*self)->name == otherNamedType->name;
     bool hasEqualType = type_equals(&(*self)->type, &otherNamedType->type);
 
     return hasEqualName && hasEqualType;
@@ -197,9 +624,9 @@ void named_type_to_string(NamedType** namedType) {
     if (namedType == NULL || *namedType == NULL)
         return;
 
-    printf("%s", (*namedType)->name);
+    output_printf("%s", (*namedType)->name);
 
-    printf(": ");
+    output_printf(": ");
 
     type_to_string(&(*namedType)->type);
 }
@@ -208,7 +635,6 @@ void named_type_free(NamedType** namedType) {
     if (namedType == NULL || *namedType == NULL)
         return;
 
-    safe_free((void**) &(*namedType)->name);
     type_free(&(*namedType)->type);
 
     safe_free((void**) namedType);
@@ -224,7 +650,7 @@ StructType* struct_type_new(size_t size, char* name, List* fields) {
 
     *type = (StructType) {
         .size = size,
-        .name = str_dup(name),
+        .name = symbol_intern(name),
         .fields = fields
     };
 
@@ -266,31 +692,30 @@ void struct_type_to_string(StructType** structType) {
     if (structType == NULL || *structType == NULL)
         return;
 
-    printf("%s{", (*structType)->name);
+    output_printf("%s{", (*structType)->name);
 
     List* fields = (*structType)->fields;
     if (!list_is_empty(&fields)) {
-        printf(" ");
+        output_printf(" ");
 
         list_foreach(field, (*structType)->fields) {
             type_to_string((Type**) &field->value);
 
             if (field->next != NULL) {
-                printf(", ");
+                output_printf(", ");
             }
         }
 
-        printf(" ");
+        output_printf(" ");
     }
 
-    printf("}");
+    output_printf("}");
 }
 
 void struct_type_free(StructType** structType) {
     if (structType == NULL || *structType == NULL)
         return;
 
-    safe_free((void**) &(*structType)->name);
     list_free(&(*structType)->fields);
 
     safe_free((void**) structType);
@@ -334,9 +759,9 @@ void array_dimension_to_string(ArrayDimension** arrayDimension) {
         return;
 
     if ((*arrayDimension)->size > 0) {
-        printf("[%ld]", (*arrayDimension)->size);
+        output_printf("[%ld]", (*arrayDimension)->size);
     } else {
-        printf("[]");
+        output_printf("[]");
     }
 }
 
@@ -419,6 +844,139 @@ void array_type_free(ArrayType** arrayType) {
     safe_free((void**) arrayType);
 }
 
+size_t array_type_rank(const Type* type) {
+    if (type == NULL || type->typeId != ARRAY_TYPE)
+        return 0;
+
+    return list_size(&((ArrayType*) type->type)->dimensions);
+}
+
+/* the fixed size along axis, 0 when it is open */
+size_t array_type_extent(const Type* type, size_t axis) {
+    if (axis >= array_type_rank(type))
+        return 0;
+
+    Type* dimension = list_get_at(&((ArrayType*) type->type)->dimensions, axis);
+
+    return ((ArrayDimension*) dimension->type)->size;
+}
+
+/* every dimension fixed over a scalar element, stored as one row-major block */
+bool array_type_is_dense(const Type* type) {
+    if (array_type_rank(type) < 2)
+        return false;
+
+    ArrayType* arrayType = type->type;
+
+    list_foreach(dimension, arrayType->dimensions) {
+        if (((ArrayDimension*) ((Type*) dimension->value)->type)->size == 0)
+            return false;
+    }
+
+    switch (arrayType->type->typeId) {
+    case INT_TYPE:
+    case FLOAT_TYPE:
+    case CHAR_TYPE:
+    case BOOL_TYPE:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/* the canonical type left after indexing the first levels dimensions */
+Type* array_type_slice(const Type* type, size_t levels) {
+    ArrayType* arrayType = type->type;
+    size_t rank = list_size(&arrayType->dimensions);
+
+    if (levels >= rank)
+        return type_copy((const Type**) &arrayType->type);
+
+    Type* slice = NEW_ARRAY_TYPE(type_copy((const Type**) &arrayType->type));
+    size_t level = 0;
+
+    list_foreach(dimension, arrayType->dimensions) {
+        if (level++ < levels)
+            continue;
+
+        ARRAY_TYPE_ADD_DIMENSION(slice, type_copy((const Type**) &dimension->value));
+    }
+
+    return type_intern(slice);
+}
+
+MapType* map_type_new(Type* key, Type* value) {
+    MapType* type = NULL;
+    type = safe_malloc(sizeof(MapType), NULL);
+    if (type == NULL) {
+        type_free(&key);
+        type_free(&value);
+        return NULL;
+    }
+
+    *type = (MapType) {
+        .key = key,
+        .value = value
+    };
+
+    return type;
+}
+
+MapType* map_type_copy(const MapType** self) {
+    if (self == NULL || *self == NULL)
+        return NULL;
+
+    return map_type_new(type_copy((const Type**) &(*self)->key), type_copy((const Type**) &(*self)->value));
+}
+
+bool map_type_equals(MapType** self, Type** other) {
+    if (self == NULL || *self == NULL || other == NULL || *other == NULL)
+        return false;
+
+    if ((*other)->typeId != MAP_TYPE)
+        return false;
+
+    MapType* otherMapType = (MapType*) (*other)->type;
+
+    return type_equals(&(*self)->key, &otherMapType->key)
+        && type_equals(&(*self)->value, &otherMapType->value);
+}
+
+void map_type_to_string(MapType** mapType) {
+    if (mapType == NULL || *mapType == NULL)
+        return;
+
+    output_printf("map[");
+    type_to_string(&(*mapType)->key);
+    output_printf("]");
+    type_to_string(&(*mapType)->value);
+}
+
+void map_type_free(MapType** mapType) {
+    if (mapType == NULL || *mapType == NULL)
+        return;
+
+    type_free(&(*mapType)->key);
+    type_free(&(*mapType)->value);
+
+    safe_free((void**) mapType);
+}
+
+bool map_type_is_valid_key(const Type* type) {
+    if (type == NULL)
+        return false;
+
+    switch (type->typeId) {
+    case INT_TYPE:
+    case CHAR_TYPE:
+    case STRING_TYPE:
+    case BOOL_TYPE:
+        return true;
+    default:
+        return false;
+    }
+}
+
 FunctionType* function_type_new(List* parameterTypes, Type* returnType) {
     FunctionType* type = NULL;
     type = safe_malloc(sizeof(FunctionType), NULL);
@@ -472,8 +1030,6 @@ bool function_type_equals(FunctionType** self, Type** other) {
     bool otherReturnIsVoid = otherFunctionType->returnType == NULL
                         || type_equals(&otherFunctionType->returnType, &voidType);
 
-    type_free(&voidType);
-
     bool hasEqualParameters = compare_list_of_types((*self)->parameterTypes, otherFunctionType->parameterTypes);
 
     if (hasEqualParameters && selfReturnIsVoid && otherReturnIsVoid)
@@ -488,20 +1044,20 @@ void function_type_to_string(FunctionType** functionType) {
     if (functionType == NULL || *functionType == NULL)
         return;
 
-    printf("func(");
+    output_printf("func(");
 
     list_foreach(parameter, (*functionType)->parameterTypes) {
         type_to_string((Type**) &parameter->value);
 
         if (parameter->next != NULL) {
-            printf(", ");
+            output_printf(", ");
         }
     }
 
-    printf(")");
+    output_printf(")");
 
     if ((*functionType)->returnType != NULL) {
-        printf(": ");
+        output_printf(": ");
         type_to_string(&(*functionType)->returnType);
     }
 }
@@ -23,23 +23,51 @@ typedef enum TypeID {
     STRUCT_TYPE,
     ARRAY_DIMENSION_TYPE,
     ARRAY_TYPE,
+    MAP_TYPE,
     FUNC_TYPE
 } TypeID;
 
+/*
+ * Types are hash-consed: type_intern returns the single canonical instance of
+ * a structure, so two interned types are equal exactly when they are the same
+ * pointer. Atomic types are always canonical. Composite types start out as
+ * mutable builders (NEW_ARRAY_TYPE, STRUCT_TYPE_ADD_FIELD, ...) and become
+ * canonical, and immutable, once interned; type_copy interns its result.
+ * Canonical types are owned by the type table they were interned into,
+ * type_free ignores them. Like names, types are interned into the table of
+ * the run they belong to, which the driver keeps in its ParserState, so
+ * canonical types are never handed between runs except the ones in a
+ * read-only builtins table shared by several.
+ */
 typedef struct Type {
     TypeID typeId;
     void* type;
+    size_t hash;
+    bool interned;
+} Type;
+
+typedef struct TypeVTable {
     void* (*copy)(const void**);
     bool (*equals)(void**, void**);
     void (*to_string)(void**);
     void (*destroy)(void**);
-} Type;
+} TypeVTable;
+
+typedef struct TypeTable TypeTable;
+
+/* builtins, when given, is read first and never written, and must outlive the table */
+TypeTable* type_table_new(const TypeTable* builtins);
+Type* type_table_intern(TypeTable* table, Type* type);
+size_t type_table_size(const TypeTable* table);
+void type_table_free(TypeTable** table);
+
+/* the table type_intern and type_atomic use on this thread, like the active arena */
+void type_table_set_active(TypeTable* table);
+TypeTable* type_table_active(void);
 
-Type* type_new(TypeID typeID, void* type,
-    void* (*copy)(const void**),
-    bool (*equals)(void**, void**),
-    void (*to_string)(void**),
-    void (*destroy)(void**));
+Type* type_new(TypeID typeID, void* type);
+Type* type_atomic(TypeID typeId);
+Type* type_intern(Type* type);
 Type* type_copy(const Type** self);
 bool type_equals(Type** self, Type** other);
 void type_to_string(Type** type);
@@ -102,6 +130,25 @@ bool array_type_equals(ArrayType** self, Type** other);
 void array_type_to_string(ArrayType** arrayType);
 void array_type_free(ArrayType** arrayType);
 
+size_t array_type_rank(const Type* type);
+size_t array_type_extent(const Type* type, size_t axis);
+bool array_type_is_dense(const Type* type);
+Type* array_type_slice(const Type* type, size_t levels);
+
+typedef struct MapType {
+    Type* key;
+    Type* value;
+} MapType;
+
+MapType* map_type_new(Type* key, Type* value);
+MapType* map_type_copy(const MapType** self);
+bool map_type_equals(MapType** self, Type** other);
+void map_type_to_string(MapType** mapType);
+void map_type_free(MapType** mapType);
+
+/* the scalar types a map can be keyed by: int, char, string and bool */
+bool map_type_is_valid_key(const Type* type);
+
 typedef struct FunctionType {
     List* parameterTypes;
     Type* returnType;
@@ -115,93 +162,42 @@ void function_type_to_string(FunctionType** functionType);
 void function_type_free(FunctionType** functionType);
 
 #define NEW_INT_TYPE()                                                         \
-    type_new(INT_TYPE,                                                         \
-        atomic_type_new(sizeof(int), "int"),                                   \
-        (void* (*)(const void**)) atomic_type_copy,                            \
-        (bool (*)(void**, void**)) atomic_type_equals,                         \
-        (void (*)(void**)) atomic_type_to_string,                              \
-        (void (*)(void**)) atomic_type_free)
+    type_atomic(INT_TYPE)
 
 #define NEW_FLOAT_TYPE()                                                       \
-    type_new(FLOAT_TYPE,                                                       \
-        atomic_type_new(sizeof(double), "float"),                              \
-        (void* (*)(const void**)) atomic_type_copy,                            \
-        (bool (*)(void**, void**)) atomic_type_equals,                         \
-        (void (*)(void**)) atomic_type_to_string,                              \
-        (void (*)(void**)) atomic_type_free)
+    type_atomic(FLOAT_TYPE)
 
 #define NEW_CHAR_TYPE()                                                        \
-    type_new(CHAR_TYPE,                                                        \
-        atomic_type_new(sizeof(char), "char"),                                 \
-        (void* (*)(const void**)) atomic_type_copy,                            \
-        (bool (*)(void**, void**)) atomic_type_equals,                         \
-        (void (*)(void**)) atomic_type_to_string,                              \
-        (void (*)(void**)) atomic_type_free)
+    type_atomic(CHAR_TYPE)
 
 #define NEW_STRING_TYPE()                                                      \
-    type_new(STRING_TYPE,                                                      \
-        atomic_type_new(sizeof(char*), "string"),                              \
-        (void* (*)(const void**)) atomic_type_copy,                            \
-        (bool (*)(void**, void**)) atomic_type_equals,                         \
-        (void (*)(void**)) atomic_type_to_string,                              \
-        (void (*)(void**)) atomic_type_free)
+    type_atomic(STRING_TYPE)
 
 #define NEW_BOOL_TYPE()                                                        \
-    type_new(BOOL_TYPE,                                                        \
-        atomic_type_new(sizeof(bool), "bool"),                                 \
-        (void* (*)(const void**)) atomic_type_copy,                            \
-        (bool (*)(void**, void**)) atomic_type_equals,                         \
-        (void (*)(void**)) atomic_type_to_string,                              \
-        (void (*)(void**)) atomic_type_free)
+    type_atomic(BOOL_TYPE)
 
 #define NEW_VOID_TYPE()                                                        \
-    type_new(VOID_TYPE,                                                        \
-        atomic_type_new(0, "void"),                                            \
-        (void* (*)(const void**)) atomic_type_copy,                            \
-        (bool (*)(void**, void**)) atomic_type_equals,                         \
-        (void (*)(void**)) atomic_type_to_string,                              \
-        (void (*)(void**)) atomic_type_free)
+    type_atomic(VOID_TYPE)
 
 #define NEW_NIL_TYPE()                                                         \
-    type_new(NIL_TYPE,                                                         \
-        atomic_type_new(0, "nil"),                                             \
-        (void* (*)(const void**)) atomic_type_copy,                            \
-        (bool (*)(void**, void**)) atomic_type_equals,                         \
-        (void (*)(void**)) atomic_type_to_string,                              \
-        (void (*)(void**)) atomic_type_free)
+    type_atomic(NIL_TYPE)
 
 #define NEW_CUSTOM_TYPE(size, name)                                            \
-    type_new(CUSTOM_TYPE,                                                      \
-        atomic_type_new((size), (name)),                                       \
-        (void* (*)(const void**)) atomic_type_copy,                            \
-        (bool (*)(void**, void**)) atomic_type_equals,                         \
-        (void (*)(void**)) atomic_type_to_string,                              \
-        (void (*)(void**)) atomic_type_free)
+    type_intern(type_new(CUSTOM_TYPE,                                          \
+        atomic_type_new((size), (name))))
 
 #define NEW_NAMED_TYPE(name, type)                                             \
     type_new(NAMED_TYPE,                                                       \
-        named_type_new((name), (type)),                                        \
-        (void* (*)(const void**)) named_type_copy,                             \
-        (bool (*)(void**, void**)) named_type_equals,                          \
-        (void (*)(void**)) named_type_to_string,                               \
-        (void (*)(void**)) named_type_free)
+        named_type_new((name), (type)))
 
 #define NEW_STRUCT_TYPE(size)                                                  \
     type_new(STRUCT_TYPE,                                                      \
         struct_type_new((size), "struct",                                      \
-            (list_new((void (*)(void **)) type_free))),                        \
-        (void* (*)(const void**)) struct_type_copy,                            \
-        (bool (*)(void**, void**)) struct_type_equals,                         \
-        (void (*)(void**)) struct_type_to_string,                              \
-        (void (*)(void**)) struct_type_free)
+            (list_new((void (*)(void **)) type_free))))
 
 #define NEW_STRUCT_TYPE_WITH_FIELDS(size, fields)                              \
     type_new(STRUCT_TYPE,                                                      \
-        struct_type_new((size), "struct", (fields)),                           \
-        (void* (*)(const void**)) struct_type_copy,                            \
-        (bool (*)(void**, void**)) struct_type_equals,                         \
-        (void (*)(void**)) struct_type_to_string,                              \
-        (void (*)(void**)) struct_type_free)
+        struct_type_new((size), "struct", (fields)))
 
 #define STRUCT_TYPE_ADD_FIELD(struct_type, field)                              \
     struct_type_add_field(                                                     \
@@ -217,36 +213,20 @@ void function_type_free(FunctionType** functionType);
     } while(0)
 
 #define NEW_ARRAY_DIMENSION(size)                                              \
-    type_new(ARRAY_DIMENSION_TYPE,                                             \
-        array_dimension_new((size)),                                           \
-        (void* (*)(const void**)) array_dimension_copy,                        \
-        (bool (*)(void**, void**)) array_dimension_equals,                     \
-        (void (*)(void**)) array_dimension_to_string,                          \
-        (void (*)(void**)) array_dimension_free)
+    type_intern(type_new(ARRAY_DIMENSION_TYPE,                                 \
+        array_dimension_new((size))))
 
 #define NEW_ARRAY_UNDEFINED_DIMENSION()                                        \
-    type_new(ARRAY_DIMENSION_TYPE,                                             \
-        array_dimension_new(0),                                                \
-        (void* (*)(const void**)) array_dimension_copy,                        \
-        (bool (*)(void**, void**)) array_dimension_equals,                     \
-        (void (*)(void**)) array_dimension_to_string,                          \
-        (void (*)(void**)) array_dimension_free)
+    type_intern(type_new(ARRAY_DIMENSION_TYPE,                                 \
+        array_dimension_new(0)))
 
 #define NEW_ARRAY_TYPE(type)                                                   \
     type_new(ARRAY_TYPE,                                                       \
-        array_type_new((list_new((void (*)(void **)) type_free)), (type)),     \
-        (void* (*)(const void**)) array_type_copy,                             \
-        (bool (*)(void**, void**)) array_type_equals,                          \
-        (void (*)(void**)) array_type_to_string,                               \
-        (void (*)(void**)) array_type_free)
+        array_type_new((list_new((void (*)(void **)) type_free)), (type)))
 
 #define NEW_ARRAY_TYPE_WITH_DIMENSION(dimension, type)                         \
     type_new(ARRAY_TYPE,                                                       \
-        array_type_new((dimension), (type)),                                   \
-        (void* (*)(const void**)) array_type_copy,                             \
-        (bool (*)(void**, void**)) array_type_equals,                          \
-        (void (*)(void**)) array_type_to_string,                               \
-        (void (*)(void**)) array_type_free)
+        array_type_new((dimension), (type)))
 
 #define ARRAY_TYPE_ADD_DIMENSION(array_type, dimension)                        \
     array_type_add_dimension((ArrayType**) (&(array_type)->type), dimension)
@@ -260,41 +240,29 @@ void function_type_free(FunctionType** functionType);
         }                                                                      \
     } while(0)
 
+#define NEW_MAP_TYPE(key, value)                                               \
+    type_new(MAP_TYPE,                                                         \
+        map_type_new((key), (value)))
+
 #define NEW_FUNCTION_TYPE()                                                    \
     type_new(FUNC_TYPE,                                                        \
         function_type_new(                                                     \
             (list_new((void (*)(void **)) type_free)),                         \
-            NULL),                                                             \
-        (void* (*)(const void**)) function_type_copy,                          \
-        (bool (*)(void**, void**)) function_type_equals,                       \
-        (void (*)(void**)) function_type_to_string,                            \
-        (void (*)(void**)) function_type_free)
+            NULL))
 
 #define NEW_FUNCTION_TYPE_WITH_PARAMS(parameters)                              \
     type_new(FUNC_TYPE,                                                        \
         function_type_new(                                                     \
-            (parameters), NULL),                                               \
-        (void* (*)(const void**)) function_type_copy,                          \
-        (bool (*)(void**, void**)) function_type_equals,                       \
-        (void (*)(void**)) function_type_to_string,                            \
-        (void (*)(void**)) function_type_free)
+            (parameters), NULL))
 
 #define NEW_FUNCTION_TYPE_WITH_RETURN(retrn)                                   \
     type_new(FUNC_TYPE,                                                        \
         function_type_new(                                                     \
-            (list_new((void (*)(void **)) type_free)), (retrn)),               \
-        (void* (*)(const void**)) function_type_copy,                          \
-        (bool (*)(void**, void**)) function_type_equals,                       \
-        (void (*)(void**)) function_type_to_string,                            \
-        (void (*)(void**)) function_type_free)
+            (list_new((void (*)(void **)) type_free)), (retrn)))
 
 #define NEW_FUNCTION_TYPE_WITH_PARAMS_AND_RETURN(parameters, retrn)            \
     type_new(FUNC_TYPE,                                                        \
-        function_type_new((parameters), (retrn)),                              \
-        (void* (*)(const void**)) function_type_copy,                          \
-        (bool (*)(void**, void**)) function_type_equals,                       \
-        (void (*)(void**)) function_type_to_string,                            \
-        (void (*)(void**)) function_type_free)
+        function_type_new((parameters), (retrn)))
 
 #define FUNCTION_TYPE_ADD_PARAM(func_type, param)                              \
     function_type_add_parameter((FunctionType**) (&(func_type)->type), param)
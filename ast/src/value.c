@@ -0,0 +1,223 @@
+#include "value.h"
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "buffer.h"
+#include "object.h"
+#include "token.h"
+#include "utils.h"
+#include "vm.h"
+
+
+ValueType value_type(Value value) {
+    if (IS_FLOAT(value))
+        return VAL_FLOAT;
+
+    if ((value & SIGN_BIT) != 0) {
+        switch ((value & TAG_MASK) >> 48) {
+        case TAG_OBJECT:   return VAL_OBJECT;
+        case TAG_FUNCTION: return VAL_FUNCTION;
+        case TAG_BIG_INT:  return VAL_INT;
+        case TAG_CLOSURE:  return VAL_CLOSURE;
+        case TAG_NATIVE:   return VAL_NATIVE;
+        default:           return VAL_UNDEFINED;
+        }
+    }
+
+    switch ((value & TAG_MASK) >> 48) {
+    case TAG_NIL:  return VAL_NIL;
+    case TAG_BOOL: return VAL_BOOL;
+    case TAG_INT:  return VAL_INT;
+    case TAG_CHAR: return VAL_CHAR;
+    default:       return VAL_UNDEFINED;
+    }
+}
+
+/* the box is an ordinary object, so the active GC owns it like any other */
+Value value_box_int(int64_t integer) {
+    Object* box = NEW_INTEGER_OBJECT(integer);
+
+    return (Value) (POINTER(TAG_BIG_INT) | (uintptr_t) box);
+}
+
+int64_t value_unbox_int(Value value) {
+    return ((IntegerObject*) AS_BIG_INT(value)->object)->value;
+}
+
+/* frees a big int boxed while no GC was active, gc_track sizes everything a heap owns */
+void value_release(Value value) {
+    if (!IS_BIG_INT(value) || AS_BIG_INT(value)->size != 0)
+        return;
+
+    Object* box = AS_BIG_INT(value);
+    object_free(&box);
+}
+
+bool value_is_truthy(Value value) {
+    /* what every condition sees, so it skips decoding the tag */
+    if (IS_BOOL(value))
+        return AS_BOOL(value);
+
+    switch (value_type(value)) {
+    case VAL_UNDEFINED:
+    case VAL_NIL:
+        return false;
+    case VAL_BOOL:
+        return AS_BOOL(value);
+    case VAL_INT:
+        return AS_INT(value) != 0;
+    case VAL_FLOAT:
+        return AS_FLOAT(value) != 0.0;
+    default:
+        return true;
+    }
+}
+
+bool value_equals(Value left, Value right) {
+    if (IS_NUMBER(left) && IS_NUMBER(right)) {
+        if (IS_INT(left) && IS_INT(right))
+            return AS_INT(left) == AS_INT(right);
+
+        return AS_NUMBER(left) == AS_NUMBER(right);
+    }
+
+    if (IS_OBJECT(left) && IS_OBJECT(right)) {
+        Object* leftObject = AS_OBJECT(left);
+        Object* rightObject = AS_OBJECT(right);
+
+        if (leftObject == rightObject)
+            return true;
+
+        if (leftObject->type == OBJ_STRING && rightObject->type == OBJ_STRING)
+            return strcmp(((StringObject*) leftObject->object)->value,
+                ((StringObject*) rightObject->object)->value) == 0;
+
+        return object_equals(leftObject, rightObject);
+    }
+
+    return left == right;
+}
+
+static ValueOpStatus float_op(TokenType op, double left, double right, Value* result) {
+    switch (op) {
+    case TOKEN_ADD: case TOKEN_ADD_ASSIGN:
+        *result = FLOAT_VALUE(left + right);
+        return VALUE_OP_OK;
+    case TOKEN_SUB: case TOKEN_SUB_ASSIGN:
+        *result = FLOAT_VALUE(left - right);
+        return VALUE_OP_OK;
+    case TOKEN_MUL: case TOKEN_MUL_ASSIGN:
+        *result = FLOAT_VALUE(left * right);
+        return VALUE_OP_OK;
+    case TOKEN_QUO: case TOKEN_QUO_ASSIGN:
+        if (right == 0)
+            return VALUE_OP_DIVISION_BY_ZERO;
+        *result = FLOAT_VALUE(left / right);
+        return VALUE_OP_OK;
+    case TOKEN_REM: case TOKEN_REM_ASSIGN:
+        if (right == 0)
+            return VALUE_OP_DIVISION_BY_ZERO;
+        *result = FLOAT_VALUE(fmod(left, right));
+        return VALUE_OP_OK;
+    case TOKEN_LSS:
+        *result = BOOL_VALUE(left < right);
+        return VALUE_OP_OK;
+    case TOKEN_GTR:
+        *result = BOOL_VALUE(left > right);
+        return VALUE_OP_OK;
+    case TOKEN_LEQ:
+        *result = BOOL_VALUE(left <= right);
+        return VALUE_OP_OK;
+    case TOKEN_GEQ:
+        *result = BOOL_VALUE(left >= right);
+        return VALUE_OP_OK;
+    default:
+        return VALUE_OP_INVALID;
+    }
+}
+
+/*
+ * The arithmetic, bitwise and comparison operators of both engines and the
+ * optimizer. Two ints stay ints, an int meets a float as a float, and ==
+ * and != compare any two values the way value_equals does. Concatenation
+ * and the error messages are left to the callers.
+ */
+ValueOpStatus value_binary_op(TokenType op, Value left, Value right, Value* result) {
+    if (op == TOKEN_EQL || op == TOKEN_NEQ) {
+        *result = BOOL_VALUE(value_equals(left, right) == (op == TOKEN_EQL));
+        return VALUE_OP_OK;
+    }
+
+    if (IS_INT(left) && IS_INT(right))
+        return value_int_op(op, AS_INT(left), AS_INT(right), result);
+
+    if (IS_NUMBER(left) && IS_NUMBER(right))
+        return float_op(op, AS_NUMBER(left), AS_NUMBER(right), result);
+
+    return VALUE_OP_INVALID;
+}
+
+/* keys of one type that value_equals matches hash alike, other objects hash by identity */
+size_t value_hash(Value value) {
+    switch (value_type(value)) {
+    case VAL_BOOL:
+        return hash_int(AS_BOOL(value));
+    case VAL_INT:
+        return hash_int((int) (AS_INT(value) ^ (AS_INT(value) >> 32)));
+    case VAL_FLOAT:
+        return hash_double(AS_FLOAT(value));
+    case VAL_CHAR:
+        return hash_char(AS_CHAR(value));
+    case VAL_OBJECT:
+        if (AS_OBJECT(value)->type == OBJ_STRING)
+            return hash_string(((StringObject*) AS_OBJECT(value)->object)->value);
+
+        return (size_t) AS_OBJECT(value);
+    default:
+        return (size_t) value;
+    }
+}
+
+void value_to_string(ByteBuffer* byteBuffer, Value value) {
+    if (byteBuffer == NULL)
+        return;
+
+    switch (value_type(value)) {
+    case VAL_NIL:
+        byte_buffer_append(byteBuffer, "nil", 3);
+        break;
+    case VAL_BOOL:
+        if (AS_BOOL(value)) {
+            byte_buffer_append(byteBuffer, "true", 4);
+        } else {
+            byte_buffer_append(byteBuffer, "false", 5);
+        }
+        break;
+    case VAL_INT:
+        byte_buffer_append_int(byteBuffer, AS_INT(value));
+        break;
+    case VAL_FLOAT:
+        byte_buffer_append_double(byteBuffer, AS_FLOAT(value));
+        break;
+    case VAL_CHAR:
+        byte_buffer_appendf(byteBuffer, "%c", AS_CHAR(value));
+        break;
+    case VAL_OBJECT: {
+        Object* object = AS_OBJECT(value);
+        object_to_string(byteBuffer, &object);
+        break;
+    }
+    case VAL_NATIVE:
+        byte_buffer_appendf(byteBuffer, "[Function: %s]", AS_NATIVE(value)->name);
+        break;
+    case VAL_FUNCTION:
+    case VAL_CLOSURE:
+        byte_buffer_appendf(byteBuffer, "[Function: %p]", (void*) AS_CLOSURE(value));
+        break;
+    default:
+        break;
+    }
+}
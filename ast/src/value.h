@@ -0,0 +1,206 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "buffer.h"
+#include "token.h"
+
+
+struct Object;
+struct FunctionProto;
+struct Closure;
+struct Native;
+
+typedef enum ValueType {
+    VAL_UNDEFINED,
+    VAL_NIL,
+    VAL_BOOL,
+    VAL_INT,
+    VAL_FLOAT,
+    VAL_CHAR,
+    VAL_OBJECT,   /* strings, arrays and functions */
+    VAL_FUNCTION, /* compiled function, lives only in constant pools */
+    VAL_CLOSURE,
+    VAL_NATIVE
+} ValueType;
+
+/*
+ * NaN-boxed value. Doubles are stored as themselves; everything else lives in
+ * the payload of a quiet NaN, with bits 48-50 holding the tag and the sign bit
+ * set for heap pointers. Real NaNs are canonicalized so they never collide
+ * with a tag. An int that fits in the 48-bit payload is stored inline, a
+ * bigger one goes to a heap box tagged TAG_INT as well, so IS_INT and AS_INT
+ * see both and an int still keeps all of its 64 bits.
+ */
+typedef uint64_t Value;
+
+#define QNAN         ((uint64_t) 0x7ff8000000000000)
+#define SIGN_BIT     ((uint64_t) 0x8000000000000000)
+#define TAG_MASK     ((uint64_t) 0x0007000000000000)
+#define PAYLOAD_MASK ((uint64_t) 0x0000ffffffffffff)
+#define HEADER_MASK  (SIGN_BIT | QNAN | TAG_MASK)
+
+#define TAG_NIL       1
+#define TAG_BOOL      2
+#define TAG_INT       3
+#define TAG_CHAR      4
+#define TAG_UNDEFINED 5
+
+#define TAG_OBJECT    1
+#define TAG_FUNCTION  2
+#define TAG_BIG_INT   TAG_INT
+#define TAG_CLOSURE   4
+#define TAG_NATIVE    5
+
+#define BOXED(tag)   (QNAN | ((uint64_t) (tag) << 48))
+#define POINTER(tag) (SIGN_BIT | BOXED(tag))
+
+/* inline ints run from -2^47 to 2^47 - 1 */
+#define INT_PAYLOAD_BIAS ((uint64_t) 1 << 47)
+
+Value value_box_int(int64_t integer);
+int64_t value_unbox_int(Value value);
+
+static inline Value value_from_double(double number) {
+    Value value;
+
+    if (number != number)
+        return QNAN;
+
+    memcpy(&value, &number, sizeof(double));
+
+    return value;
+}
+
+static inline double value_to_double(Value value) {
+    double number;
+
+    memcpy(&number, &value, sizeof(double));
+
+    return number;
+}
+
+static inline Value value_from_int(int64_t integer) {
+    if ((uint64_t) integer + INT_PAYLOAD_BIAS > PAYLOAD_MASK)
+        return value_box_int(integer);
+
+    return BOXED(TAG_INT) | ((uint64_t) integer & PAYLOAD_MASK);
+}
+
+/* an int stored inline, the one case the engines' fast paths take */
+#define IS_SMALL_INT(v)    (((v) & HEADER_MASK) == BOXED(TAG_INT))
+#define AS_SMALL_INT(v)    ((int64_t) ((v) << 16) >> 16)
+
+static inline int64_t value_to_int(Value value) {
+    if ((value & SIGN_BIT) != 0)
+        return value_unbox_int(value);
+
+    return AS_SMALL_INT(value);
+}
+
+#define UNDEFINED_VALUE()  ((Value) BOXED(TAG_UNDEFINED))
+#define NIL_VALUE()        ((Value) BOXED(TAG_NIL))
+#define BOOL_VALUE(v)      ((Value) (BOXED(TAG_BOOL) | ((v) ? 1 : 0)))
+#define INT_VALUE(v)       value_from_int((int64_t) (v))
+#define FLOAT_VALUE(v)     value_from_double((v))
+#define CHAR_VALUE(v)      ((Value) (BOXED(TAG_CHAR) | (uint8_t) (v)))
+#define OBJECT_VALUE(v)    ((Value) (POINTER(TAG_OBJECT) | (uintptr_t) (v)))
+#define FUNCTION_VALUE(v)  ((Value) (POINTER(TAG_FUNCTION) | (uintptr_t) (v)))
+#define CLOSURE_VALUE(v)   ((Value) (POINTER(TAG_CLOSURE) | (uintptr_t) (v)))
+#define NATIVE_VALUE(v)    ((Value) (POINTER(TAG_NATIVE) | (uintptr_t) (v)))
+
+#define IS_FLOAT(v)        (((v) & QNAN) != QNAN || ((v) & TAG_MASK) == 0)
+#define IS_UNDEFINED(v)    ((v) == UNDEFINED_VALUE())
+#define IS_NIL(v)          ((v) == NIL_VALUE())
+#define IS_BOOL(v)         (((v) & HEADER_MASK) == BOXED(TAG_BOOL))
+#define IS_INT(v)          (((v) & (QNAN | TAG_MASK)) == BOXED(TAG_INT))
+#define IS_BIG_INT(v)      (((v) & HEADER_MASK) == POINTER(TAG_BIG_INT))
+#define IS_CHAR(v)         (((v) & HEADER_MASK) == BOXED(TAG_CHAR))
+#define IS_OBJECT(v)       (((v) & HEADER_MASK) == POINTER(TAG_OBJECT))
+#define IS_FUNCTION(v)     (((v) & HEADER_MASK) == POINTER(TAG_FUNCTION))
+#define IS_CLOSURE(v)      (((v) & HEADER_MASK) == POINTER(TAG_CLOSURE))
+#define IS_NATIVE(v)       (((v) & HEADER_MASK) == POINTER(TAG_NATIVE))
+#define IS_NUMBER(v)       (IS_INT(v) || IS_FLOAT(v))
+
+#define AS_BOOL(v)         (((v) & 1) != 0)
+#define AS_INT(v)          value_to_int((v))
+#define AS_BIG_INT(v)      ((struct Object*) (uintptr_t) ((v) & PAYLOAD_MASK))
+#define AS_FLOAT(v)        value_to_double((v))
+#define AS_CHAR(v)         ((char) (uint8_t) (v))
+#define AS_OBJECT(v)       ((struct Object*) (uintptr_t) ((v) & PAYLOAD_MASK))
+#define AS_FUNCTION(v)     ((struct FunctionProto*) (uintptr_t) ((v) & PAYLOAD_MASK))
+#define AS_CLOSURE(v)      ((struct Closure*) (uintptr_t) ((v) & PAYLOAD_MASK))
+#define AS_NATIVE(v)       ((struct Native*) (uintptr_t) ((v) & PAYLOAD_MASK))
+#define AS_NUMBER(v)       (IS_INT(v) ? (double) AS_INT(v) : AS_FLOAT(v))
+
+ValueType value_type(Value value);
+
+typedef enum ValueOpStatus {
+    VALUE_OP_OK,
+    VALUE_OP_DIVISION_BY_ZERO,
+    VALUE_OP_INVALID /* not numbers, or a bitwise operator on a float */
+} ValueOpStatus;
+
+/* exact 64-bit arithmetic, overflow wraps around; inline so a constant op folds to its one case */
+static inline ValueOpStatus value_int_op(TokenType op, int64_t left, int64_t right, Value* result) {
+    switch (op) {
+    case TOKEN_ADD: case TOKEN_ADD_ASSIGN:
+        *result = INT_VALUE((uint64_t) left + (uint64_t) right);
+        return VALUE_OP_OK;
+    case TOKEN_SUB: case TOKEN_SUB_ASSIGN:
+        *result = INT_VALUE((uint64_t) left - (uint64_t) right);
+        return VALUE_OP_OK;
+    case TOKEN_MUL: case TOKEN_MUL_ASSIGN:
+        *result = INT_VALUE((uint64_t) left * (uint64_t) right);
+        return VALUE_OP_OK;
+    case TOKEN_QUO: case TOKEN_QUO_ASSIGN:
+        if (right == 0)
+            return VALUE_OP_DIVISION_BY_ZERO;
+        *result = INT_VALUE(right == -1 ? 0u - (uint64_t) left : (uint64_t) (left / right));
+        return VALUE_OP_OK;
+    case TOKEN_REM: case TOKEN_REM_ASSIGN:
+        if (right == 0)
+            return VALUE_OP_DIVISION_BY_ZERO;
+        *result = INT_VALUE(right == -1 ? 0 : left % right);
+        return VALUE_OP_OK;
+    case TOKEN_AND: case TOKEN_AND_ASSIGN:
+        *result = INT_VALUE(left & right);
+        return VALUE_OP_OK;
+    case TOKEN_OR: case TOKEN_OR_ASSIGN:
+        *result = INT_VALUE(left | right);
+        return VALUE_OP_OK;
+    case TOKEN_XOR: case TOKEN_XOR_ASSIGN:
+        *result = INT_VALUE(left ^ right);
+        return VALUE_OP_OK;
+    case TOKEN_SHL: case TOKEN_SHL_ASSIGN:
+        *result = INT_VALUE((uint64_t) left << (right & 63));
+        return VALUE_OP_OK;
+    case TOKEN_SHR: case TOKEN_SHR_ASSIGN:
+        *result = INT_VALUE(left >> (right & 63));
+        return VALUE_OP_OK;
+    case TOKEN_LSS:
+        *result = BOOL_VALUE(left < right);
+        return VALUE_OP_OK;
+    case TOKEN_GTR:
+        *result = BOOL_VALUE(left > right);
+        return VALUE_OP_OK;
+    case TOKEN_LEQ:
+        *result = BOOL_VALUE(left <= right);
+        return VALUE_OP_OK;
+    case TOKEN_GEQ:
+        *result = BOOL_VALUE(left >= right);
+        return VALUE_OP_OK;
+    default:
+        return VALUE_OP_INVALID;
+    }
+}
+
+bool value_is_truthy(Value value);
+bool value_equals(Value left, Value right);
+ValueOpStatus value_binary_op(TokenType op, Value left, Value right, Value* result);
+size_t value_hash(Value value);
+void value_to_string(ByteBuffer* byteBuffer, Value value);
+void value_release(Value value);
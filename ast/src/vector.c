@@ -0,0 +1,179 @@
+#include "vector.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "arena.h"
+#include "smem.h"
+
+
+static inline bool vector_is_initialized(Vector** vector) {
+    return vector != NULL && *vector != NULL;
+}
+
+static void** items_alloc(Vector* vector, size_t capacity) {
+    if (vector->arena != NULL)
+        return arena_alloc(vector->arena, capacity * sizeof(void*));
+
+    return safe_malloc(capacity * sizeof(void*), NULL);
+}
+
+Vector* vector_new(void (*destroy)(void**)) {
+    Arena* arena = arena_active();
+
+    Vector* new_vector = NULL;
+    new_vector = arena != NULL ? arena_alloc(arena, sizeof(Vector)) : smem_alloc(sizeof(Vector));
+    if (new_vector == NULL) {
+        return NULL;
+    }
+
+    *new_vector = (Vector) {
+        .capacity = VECTOR_MIN_CAPACITY,
+        .destroy = destroy,
+        .arena = arena
+    };
+
+    new_vector->items = items_alloc(new_vector, VECTOR_MIN_CAPACITY);
+    if (new_vector->items == NULL) {
+        if (arena == NULL) {
+            smem_free((void**) &new_vector, sizeof(Vector));
+        }
+        return NULL;
+    }
+
+    return new_vector;
+}
+
+void vector_free(Vector** vector) {
+    if (!vector_is_initialized(vector))
+        return;
+
+    vector_clear(vector);
+
+    if ((*vector)->arena != NULL) {
+        *vector = NULL;
+        return;
+    }
+
+    safe_free((void**) &(*vector)->items);
+    smem_free((void**) vector, sizeof(Vector));
+}
+
+size_t vector_size(Vector** vector) {
+    return (*vector)->size;
+}
+
+bool vector_is_empty(Vector** vector) {
+    if (!vector_is_initialized(vector))
+        return true;
+
+    return (*vector)->size == 0;
+}
+
+bool vector_reserve(Vector** vector, size_t capacity) {
+    if (!vector_is_initialized(vector))
+        return false;
+
+    Vector* self = *vector;
+    if (capacity <= self->capacity)
+        return true;
+
+    if (self->arena == NULL) {
+        void** items = safe_realloc((void**) &self->items, capacity * sizeof(void*), NULL);
+        if (items == NULL)
+            return false;
+
+        self->items = items;
+        self->capacity = capacity;
+        return true;
+    }
+
+    void** items = items_alloc(self, capacity);
+    if (items == NULL)
+        return false;
+
+    memcpy(items, self->items, self->size * sizeof(void*));
+
+    self->items = items;
+    self->capacity = capacity;
+
+    return true;
+}
+
+void vector_push(Vector** vector, void* object) {
+    if (!vector_is_initialized(vector))
+        return;
+
+    Vector* self = *vector;
+
+    if (self->size == self->capacity && !vector_reserve(vector, self->capacity * 2))
+        return;
+
+    self->items[self->size++] = object;
+}
+
+void* vector_get_at(Vector** vector, size_t index) {
+    if (!vector_is_initialized(vector) || index >= (*vector)->size)
+        return NULL;
+
+    return (*vector)->items[index];
+}
+
+void* vector_last(Vector** vector) {
+    if (vector_is_empty(vector))
+        return NULL;
+
+    return (*vector)->items[(*vector)->size - 1];
+}
+
+void vector_replace_at(Vector** vector, size_t index, void* object) {
+    if (!vector_is_initialized(vector) || object == NULL || index >= (*vector)->size)
+        return;
+
+    void* old_value = (*vector)->items[index];
+
+    (*vector)->items[index] = object;
+
+    if ((*vector)->destroy != NULL)
+        (*vector)->destroy(&old_value);
+}
+
+void vector_remove_at(Vector** vector, size_t index, void** return_buffer) {
+    if (!vector_is_initialized(vector) || index >= (*vector)->size)
+        return;
+
+    Vector* self = *vector;
+    void* value = self->items[index];
+
+    memmove(&self->items[index], &self->items[index + 1], (self->size - index - 1) * sizeof(void*));
+    self->size -= 1;
+
+    if (return_buffer != NULL && *return_buffer == NULL) {
+        *return_buffer = value;
+    } else if (self->destroy != NULL) {
+        self->destroy(&value);
+    }
+}
+
+void vector_truncate(Vector** vector, size_t size) {
+    if (!vector_is_initialized(vector) || size >= (*vector)->size)
+        return;
+
+    (*vector)->size = size;
+}
+
+void vector_clear(Vector** vector) {
+    if (!vector_is_initialized(vector))
+        return;
+
+    Vector* self = *vector;
+
+    if (self->destroy != NULL) {
+        for (size_t i = 0; i < self->size; i++) {
+            self->destroy(&self->items[i]);
+        }
+    }
+
+    self->size = 0;
+}
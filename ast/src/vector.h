@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+
+#define VECTOR_MIN_CAPACITY 4
+
+struct Arena;
+
+/*
+ * Growable array of pointers, the contiguous counterpart of List for
+ * sequences that are built once and then walked or indexed: block bodies
+ * and call arguments. Items never move between slots except on removal,
+ * and items is never NULL, so vector_foreach needs no special case for an
+ * empty vector. A vector created while an arena is active allocates its
+ * items there, growing leaves the old block behind until arena_free.
+ */
+typedef struct Vector {
+    void** items;
+    size_t size;
+    size_t capacity;
+    void (*destroy)(void**);
+    struct Arena* arena; /* set when the vector was created inside an arena */
+} Vector;
+
+Vector* vector_new(void (*destroy)(void**));
+void vector_free(Vector** vector);
+
+size_t vector_size(Vector** vector);
+bool vector_is_empty(Vector** vector);
+
+bool vector_reserve(Vector** vector, size_t capacity);
+void vector_push(Vector** vector, void* object);
+
+void* vector_get_at(Vector** vector, size_t index);
+void* vector_last(Vector** vector);
+
+void vector_replace_at(Vector** vector, size_t index, void* object);
+void vector_remove_at(Vector** vector, size_t index, void** return_buffer);
+
+/* drops every item from size on without destroying them, the caller kept or released them */
+void vector_truncate(Vector** vector, size_t size);
+
+void vector_clear(Vector** vector);
+
+
+#define vector_foreach(item, vector)                                           \
+    for (void **(item) = (vector)->items;                                      \
+        (item) < (vector)->items + (vector)->size; (item)++)
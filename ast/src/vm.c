@@ -0,0 +1,1146 @@
+#include "vm.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "buffer.h"
+#include "compiler.h"
+#include "gc.h"
+#include "interpreter.h"
+#include "list.h"
+#include "numeric.h"
+#include "object.h"
+#include "optimizer.h"
+#include "output.h"
+#include "smem.h"
+#include "token.h"
+#include "type-checker.h"
+#include "types.h"
+#include "utils.h"
+
+
+static bool isInteger(const char* str) {
+    char* endptr;
+    strtol(str, &endptr, 10);
+    return (*endptr == '\0');
+}
+
+static bool isFloat(const char* str) {
+    char* endptr;
+    strtod(str, &endptr);
+    return (*endptr == '\0');
+}
+
+static bool isChar(const char* str) {
+    return (strlen(str) == 1);
+}
+
+static bool isBool(const char* str) {
+    bool isTrue = strcmp(str, "true") == 0;
+    bool isFalse = strcmp(str, "false") == 0;
+    return isTrue || isFalse;
+}
+
+static void log_error(Object* error) {
+    if (error == NULL)
+        return;
+
+    /* the error follows whatever the program printed so far */
+    output_flush();
+
+    ByteBuffer* bb = byte_buffer_new();
+
+    error_to_string(bb, (Error**) &error->object);
+
+    char* error_message = byte_buffer_to_string(bb);
+
+    byte_buffer_free(&bb);
+
+    fprintf(stderr, "%s\n", error_message);
+
+    safe_free((void**) &error_message);
+}
+
+static void closure_free(Closure** closure) {
+    if (closure == NULL || *closure == NULL)
+        return;
+
+    safe_free((void**) &(*closure)->upvalues);
+
+    safe_free((void**) closure);
+}
+
+static void native_free(Native** native) {
+    if (native == NULL || *native == NULL)
+        return;
+
+    safe_free((void**) &(*native)->name);
+
+    safe_free((void**) native);
+}
+
+static Native* native_new(const char* name, Value (*function)(struct Interpreter*, FunctionObject*, Value*, size_t)) {
+    Native* native = NULL;
+    native = safe_malloc(sizeof(Native), NULL);
+    if (native == NULL) {
+        return NULL;
+    }
+
+    *native = (Native) {
+        .name = str_dup(name),
+        .function = function
+    };
+
+    return native;
+}
+
+static Closure* closure_new(VM* vm, FunctionProto* function) {
+    Closure* closure = NULL;
+    closure = safe_malloc(sizeof(Closure), NULL);
+    if (closure == NULL) {
+        return NULL;
+    }
+
+    *closure = (Closure) {
+        .function = function,
+        .upvalues = safe_calloc(function->upvalueCount + 1, sizeof(Upvalue*), NULL),
+        .upvalueCount = function->upvalueCount,
+        .allocated = vm->closures,
+        .mark = 0
+    };
+
+    vm->closures = closure;
+
+    return closure;
+}
+
+static void define_native(VM* vm, const char* name, Value (*function)(struct Interpreter*, FunctionObject*, Value*, size_t)) {
+    for (size_t i = 0; i < vm->globalCount; i++) {
+        if (strcmp(vm->globalNames[i], name) == 0) {
+            Native* native = native_new(name, function);
+            list_insert_last(&vm->natives, native);
+            vm->globals[i] = NATIVE_VALUE(native);
+            return;
+        }
+    }
+}
+
+static VM* vm_new(Program* program, size_t gcThreshold) {
+    VM* vm = NULL;
+    vm = safe_malloc(sizeof(VM), NULL);
+    if (vm == NULL) {
+        return NULL;
+    }
+
+    vm->frames = safe_malloc(FRAMES_INIT * sizeof(CallFrame), NULL);
+    vm->frameCount = 0;
+    vm->frameCapacity = FRAMES_INIT;
+    vm->stack = safe_malloc(STACK_INIT * sizeof(Value), NULL);
+    vm->stackTop = vm->stack;
+    vm->stackEnd = vm->stack + STACK_INIT;
+    vm->globals = safe_calloc(program->globalCount + 1, sizeof(Value), NULL);
+    vm->globalNames = program->globalNames;
+    vm->globalCount = program->globalCount;
+    vm->openUpvalues = NULL;
+    vm->natives = list_new((void (*)(void**)) native_free);
+    vm->closures = NULL;
+    vm->upvalues = NULL;
+    vm->gray = NULL;
+    vm->grayCount = 0;
+    vm->grayCapacity = 0;
+    vm->gc = gc_new(gcThreshold);
+    vm->status = INTERPRETER_SUCCESS;
+
+    for (size_t i = 0; i < vm->globalCount; i++) {
+        vm->globals[i] = UNDEFINED_VALUE();
+    }
+
+    define_native(vm, "print", print_function_run);
+    define_native(vm, "println", println_function_run);
+    define_native(vm, "input", input_function_run);
+    define_native(vm, "len", len_function_run);
+    define_native(vm, "push", push_function_run);
+    define_native(vm, "pop", pop_function_run);
+    define_native(vm, "reserve", reserve_function_run);
+    define_native(vm, "matmul", matmul_function_run);
+    define_native(vm, "transpose", transpose_function_run);
+    define_native(vm, "matadd", matadd_function_run);
+    define_native(vm, "matsub", matsub_function_run);
+    define_native(vm, "hadamard", hadamard_function_run);
+    define_native(vm, "delete", delete_function_run);
+    define_native(vm, "has", has_function_run);
+    define_native(vm, "keys", keys_function_run);
+    define_native(vm, "values", values_function_run);
+    define_native(vm, "flush", flush_function_run);
+    define_native(vm, "read_all", read_all_function_run);
+    define_native(vm, "has_line", has_line_function_run);
+    define_native(vm, "next_line", next_line_function_run);
+    define_native(vm, "read_lines", read_lines_function_run);
+
+    for (size_t i = 0; i < NUMERIC_BUILTIN_COUNT; i++) {
+        define_native(vm, numericBuiltins[i].name, numericBuiltins[i].function);
+    }
+
+    return vm;
+}
+
+static void vm_free(VM** vm) {
+    if (vm == NULL || *vm == NULL)
+        return;
+
+    safe_free((void**) &(*vm)->frames);
+    safe_free((void**) &(*vm)->stack);
+    safe_free((void**) &(*vm)->globals);
+    list_free(&(*vm)->natives);
+    while ((*vm)->closures != NULL) {
+        Closure* closure = (*vm)->closures;
+        (*vm)->closures = closure->allocated;
+        closure_free(&closure);
+    }
+
+    while ((*vm)->upvalues != NULL) {
+        Upvalue* upvalue = (*vm)->upvalues;
+        (*vm)->upvalues = upvalue->allocated;
+        safe_free((void**) &upvalue);
+    }
+
+    safe_free((void**) &(*vm)->gray);
+    gc_free(&(*vm)->gc);
+
+    safe_free((void**) vm);
+}
+
+static bool is_string(Value value) {
+    return IS_OBJECT(value) && AS_OBJECT(value)->type == OBJ_STRING;
+}
+
+static Object* invalid_operation(Value left, const char* op, Value right) {
+    ByteBuffer* bb = byte_buffer_new();
+    byte_buffer_append(bb, "invalid operation: ", strlen("invalid operation: "));
+    value_to_string(bb, left);
+    byte_buffer_appendf(bb, " %s ", op);
+    value_to_string(bb, right);
+    char* error_message = byte_buffer_to_string(bb);
+    byte_buffer_free(&bb);
+
+    Object* error = NEW_ERROR_OBJECT(RUNTIME_ERROR, error_message);
+
+    safe_free((void**) &error_message);
+
+    return error;
+}
+
+/* ++ and -- on an int or a float, in place */
+static Object* step_op(Value* value, bool isIncrement) {
+    int64_t delta = isIncrement ? 1 : -1;
+
+    if (IS_INT(*value)) {
+        *value = INT_VALUE((uint64_t) AS_INT(*value) + (uint64_t) delta);
+        return NULL;
+    }
+
+    if (IS_FLOAT(*value)) {
+        *value = FLOAT_VALUE(AS_FLOAT(*value) + delta);
+        return NULL;
+    }
+
+    return invalid_operation(*value, isIncrement ? "++" : "--", NIL_VALUE());
+}
+
+static Value concat_values(Value left, Value right) {
+    ByteBuffer* bb = byte_buffer_new();
+    value_to_string(bb, left);
+    value_to_string(bb, right);
+    char* str = byte_buffer_to_string(bb);
+    byte_buffer_free(&bb);
+
+    Object* result = NEW_STRING_OBJECT(str);
+
+    safe_free((void**) &str);
+
+    return OBJECT_VALUE(result);
+}
+
+static const char* op_literal(OpCode op) {
+    switch (op) {
+    case OP_ADD: return "+";
+    case OP_SUB: return "-";
+    case OP_MUL: return "*";
+    case OP_QUO: return "/";
+    case OP_REM: return "%";
+    case OP_AND: return "&";
+    case OP_OR:  return "|";
+    case OP_XOR: return "^";
+    case OP_SHL: return "<<";
+    case OP_SHR: return ">>";
+    case OP_EQL: return "==";
+    case OP_NEQ: return "!=";
+    case OP_LSS: return "<";
+    case OP_GTR: return ">";
+    case OP_LEQ: return "<=";
+    case OP_GEQ: return ">=";
+    default:     return "?";
+    }
+}
+
+static TokenType op_token(OpCode op) {
+    switch (op) {
+    case OP_ADD: return TOKEN_ADD;
+    case OP_SUB: return TOKEN_SUB;
+    case OP_MUL: return TOKEN_MUL;
+    case OP_QUO: return TOKEN_QUO;
+    case OP_REM: return TOKEN_REM;
+    case OP_AND: return TOKEN_AND;
+    case OP_OR:  return TOKEN_OR;
+    case OP_XOR: return TOKEN_XOR;
+    case OP_SHL: return TOKEN_SHL;
+    case OP_SHR: return TOKEN_SHR;
+    case OP_EQL: return TOKEN_EQL;
+    case OP_NEQ: return TOKEN_NEQ;
+    case OP_LSS: return TOKEN_LSS;
+    case OP_GTR: return TOKEN_GTR;
+    case OP_LEQ: return TOKEN_LEQ;
+    case OP_GEQ: return TOKEN_GEQ;
+    default:     return TOKEN_ILLEGAL;
+    }
+}
+
+/* slow path of the arithmetic and comparison opcodes, BINARY_OP handles int op int inline */
+static Object* binary_op(OpCode op, Value left, Value right, Value* result) {
+    if (op == OP_ADD && (is_string(left) || is_string(right) || IS_CHAR(left) || IS_CHAR(right))) {
+        *result = concat_values(left, right);
+        return NULL;
+    }
+
+    switch (value_binary_op(op_token(op), left, right, result)) {
+    case VALUE_OP_OK:
+        return NULL;
+    case VALUE_OP_DIVISION_BY_ZERO:
+        return NEW_ERROR_OBJECT(DIVISION_BY_ZERO_ERROR, "division by zero");
+    default:
+        return invalid_operation(left, op_literal(op), right);
+    }
+}
+
+static Object* cast_op(Value target, TypeID typeId, Value* result) {
+    if (is_string(target)) {
+        char* value = ((StringObject*) AS_OBJECT(target)->object)->value;
+
+        if (typeId == STRING_TYPE) {
+            *result = target;
+            return NULL;
+        }
+
+        if (typeId == INT_TYPE && isInteger(value)) {
+            *result = INT_VALUE(strtoll(value, NULL, 10));
+            return NULL;
+        }
+
+        if (typeId == FLOAT_TYPE && (isInteger(value) || isFloat(value))) {
+            *result = FLOAT_VALUE(atof(value));
+            return NULL;
+        }
+
+        if (typeId == CHAR_TYPE && isChar(value)) {
+            *result = CHAR_VALUE(value[0]);
+            return NULL;
+        }
+
+        if (typeId == BOOL_TYPE && isBool(value)) {
+            *result = BOOL_VALUE(strcmp(value, "true") == 0);
+            return NULL;
+        }
+    }
+
+    if (IS_INT(target)) {
+        if (typeId == INT_TYPE) {
+            *result = target;
+            return NULL;
+        }
+
+        if (typeId == FLOAT_TYPE) {
+            *result = FLOAT_VALUE(AS_INT(target));
+            return NULL;
+        }
+    }
+
+    if (IS_FLOAT(target)) {
+        if (typeId == FLOAT_TYPE) {
+            *result = target;
+            return NULL;
+        }
+
+        if (typeId == INT_TYPE) {
+            *result = INT_VALUE((int64_t) AS_FLOAT(target));
+            return NULL;
+        }
+    }
+
+    if (IS_CHAR(target)) {
+        if (typeId == INT_TYPE) {
+            *result = INT_VALUE(AS_CHAR(target));
+            return NULL;
+        }
+
+        if (typeId == CHAR_TYPE) {
+            *result = target;
+            return NULL;
+        }
+
+        if (typeId == STRING_TYPE) {
+            char str[2] = { AS_CHAR(target), '\0' };
+            *result = OBJECT_VALUE(NEW_STRING_OBJECT(str));
+            return NULL;
+        }
+    }
+
+    return NEW_ERROR_OBJECT(RUNTIME_ERROR, "invalid cast");
+}
+
+static Object* error_of(Value value) {
+    return IS_OBJECT(value) && AS_OBJECT(value)->type == OBJ_ERROR ? AS_OBJECT(value) : NULL;
+}
+
+/* operands hold the indexed object followed by count levels */
+static Object* index_op(Value* operands, uint8_t count, IndexTarget* target) {
+    return error_of(index_target_resolve(target, operands[0], operands + 1, count));
+}
+
+static Object* load_op(IndexTarget* target, Value* element) {
+    if (target->container->type == OBJ_MAP) {
+        MapObject* mapObject = target->container->object;
+
+        /* a missing key reads as the zero value */
+        if (!map_object_get(mapObject, target->key, element)) {
+            *element = map_object_zero(mapObject);
+        }
+
+        return NULL;
+    }
+
+    ArrayObject* arrayObject = target->container->object;
+
+    *element = array_object_get_index(arrayObject, target->indices, target->count);
+
+    return error_of(*element);
+}
+
+static Object* store_op(IndexTarget* target, Value value) {
+    if (target->container->type == OBJ_MAP) {
+        return map_object_set(target->container->object, target->key, value)
+            ? NULL
+            : NEW_ERROR_OBJECT(RUNTIME_ERROR, "invalid map access");
+    }
+
+    return error_of(array_object_set_index(target->container->object, target->indices, target->count, value));
+}
+
+static Upvalue* capture_upvalue(VM* vm, Value* local) {
+    Upvalue* previous = NULL;
+    Upvalue* upvalue = vm->openUpvalues;
+
+    while (upvalue != NULL && upvalue->location > local) {
+        previous = upvalue;
+        upvalue = upvalue->next;
+    }
+
+    if (upvalue != NULL && upvalue->location == local)
+        return upvalue;
+
+    Upvalue* created = safe_malloc(sizeof(Upvalue), NULL);
+    *created = (Upvalue) {
+        .location = local,
+        .closed = NIL_VALUE(),
+        .next = upvalue,
+        .allocated = vm->upvalues,
+        .mark = 0
+    };
+
+    vm->upvalues = created;
+
+    if (previous == NULL) {
+        vm->openUpvalues = created;
+    } else {
+        previous->next = created;
+    }
+
+    return created;
+}
+
+static void close_upvalues(VM* vm, Value* last) {
+    while (vm->openUpvalues != NULL && vm->openUpvalues->location >= last) {
+        Upvalue* upvalue = vm->openUpvalues;
+        upvalue->closed = *upvalue->location;
+        upvalue->location = &upvalue->closed;
+        vm->openUpvalues = upvalue->next;
+    }
+}
+
+/* moves the stack to a block twice as large, the frames and open upvalues follow it */
+static Object* grow_stack(VM* vm) {
+    size_t capacity = (size_t) (vm->stackEnd - vm->stack);
+
+    if (capacity >= STACK_MAX)
+        return NEW_ERROR_OBJECT(RUNTIME_ERROR, "stack overflow");
+
+    Value* stack = safe_malloc(2 * capacity * sizeof(Value), NULL);
+    if (stack == NULL)
+        return NEW_ERROR_OBJECT(RUNTIME_ERROR, "stack overflow");
+
+    Value* previous = vm->stack;
+    memcpy(stack, previous, (size_t) (vm->stackTop - previous) * sizeof(Value));
+
+    for (size_t i = 0; i < vm->frameCount; i++) {
+        vm->frames[i].slots = stack + (vm->frames[i].slots - previous);
+    }
+
+    for (Upvalue* upvalue = vm->openUpvalues; upvalue != NULL; upvalue = upvalue->next) {
+        upvalue->location = stack + (upvalue->location - previous);
+    }
+
+    vm->stackTop = stack + (vm->stackTop - previous);
+    vm->stackEnd = stack + 2 * capacity;
+
+    safe_free((void**) &vm->stack);
+    vm->stack = stack;
+
+    return NULL;
+}
+
+static Object* call_native(VM* vm, Native* native, int argc, Value* result) {
+    Value returned = native->function(NULL, NULL, vm->stackTop - argc, (size_t) argc);
+
+    if (IS_OBJECT(returned) && AS_OBJECT(returned)->type == OBJ_ERROR)
+        return AS_OBJECT(returned);
+
+    *result = returned;
+
+    return NULL;
+}
+
+static Object* call_value(VM* vm, Value callee, int argc) {
+    if (IS_CLOSURE(callee)) {
+        FunctionProto* function = AS_CLOSURE(callee)->function;
+
+        if ((size_t) argc != function->arity) {
+            ByteBuffer* bb = byte_buffer_new();
+            byte_buffer_appendf(bb, "%s: expected %zu arguments but got %d", function->name, function->arity, argc);
+            char* error_message = byte_buffer_to_string(bb);
+            byte_buffer_free(&bb);
+
+            Object* error = NEW_ERROR_OBJECT(RUNTIME_ERROR, error_message);
+            safe_free((void**) &error_message);
+
+            return error;
+        }
+
+        if (vm->frameCount == vm->frameCapacity) {
+            if (vm->frameCapacity >= FRAMES_MAX)
+                return NEW_ERROR_OBJECT(RUNTIME_ERROR, "stack overflow");
+
+            CallFrame* frames = safe_realloc((void**) &vm->frames, 2 * vm->frameCapacity * sizeof(CallFrame), NULL);
+            if (frames == NULL)
+                return NEW_ERROR_OBJECT(RUNTIME_ERROR, "stack overflow");
+
+            vm->frames = frames;
+            vm->frameCapacity *= 2;
+        }
+
+        CallFrame* frame = &vm->frames[vm->frameCount++];
+        frame->closure = AS_CLOSURE(callee);
+        frame->ip = function->chunk.code;
+        frame->slots = vm->stackTop - argc - 1;
+
+        return NULL;
+    }
+
+    if (IS_NATIVE(callee)) {
+        Value result = NIL_VALUE();
+
+        Object* error = call_native(vm, AS_NATIVE(callee), argc, &result);
+        if (error != NULL)
+            return error;
+
+        vm->stackTop -= argc + 1;
+        *vm->stackTop++ = result;
+
+        return NULL;
+    }
+
+    return NEW_ERROR_OBJECT(RUNTIME_ERROR, "callable_run: cannot execute callable function");
+}
+
+/*
+ * Pops frames until one is inside a handler for the instruction that
+ * failed, or called from inside one, and moves it to the handler's target.
+ * False when nothing handles the error.
+ */
+static bool unwind(VM* vm) {
+    while (vm->frameCount > 0) {
+        CallFrame* frame = &vm->frames[vm->frameCount - 1];
+        Chunk* chunk = &frame->closure->function->chunk;
+        size_t offset = (size_t) (frame->ip - chunk->code) - 1;
+
+        for (size_t i = 0; i < chunk->handlerCount; i++) {
+            Handler* handler = &chunk->handlers[i];
+
+            if (offset >= handler->start && offset < handler->end) {
+                close_upvalues(vm, frame->slots + handler->depth);
+                vm->stackTop = frame->slots + handler->depth;
+                frame->ip = chunk->code + handler->target;
+                return true;
+            }
+        }
+
+        close_upvalues(vm, frame->slots);
+        vm->frameCount--;
+    }
+
+    return false;
+}
+
+/* the heap's hook for closure values, they are traced by trace_closures */
+static void mark_closure(GC* gc, Value value) {
+    if (!IS_CLOSURE(value) || AS_CLOSURE(value)->mark == gc->epoch)
+        return;
+
+    VM* vm = gc->foreign;
+    Closure* closure = AS_CLOSURE(value);
+
+    closure->mark = gc->epoch;
+
+    if (vm->grayCount == vm->grayCapacity) {
+        size_t capacity = vm->grayCapacity < 8 ? 8 : vm->grayCapacity * 2;
+        Closure** gray = vm->gray == NULL
+            ? safe_malloc(capacity * sizeof(Closure*), NULL)
+            : safe_realloc((void**) &vm->gray, capacity * sizeof(Closure*), NULL);
+        if (gray == NULL)
+            return;
+
+        vm->gray = gray;
+        vm->grayCapacity = capacity;
+    }
+
+    vm->gray[vm->grayCount++] = closure;
+}
+
+static bool trace_closures(GC* gc) {
+    VM* vm = gc->foreign;
+
+    if (vm->grayCount == 0)
+        return false;
+
+    while (vm->grayCount > 0) {
+        Closure* closure = vm->gray[--vm->grayCount];
+
+        for (size_t i = 0; i < closure->upvalueCount; i++) {
+            Upvalue* upvalue = closure->upvalues[i];
+
+            if (upvalue != NULL && upvalue->mark != gc->epoch) {
+                upvalue->mark = gc->epoch;
+                gc_mark_value(gc, *upvalue->location);
+            }
+        }
+    }
+
+    return true;
+}
+
+/* open upvalues stay, the locals they point at are still on the stack */
+static void sweep_closures(VM* vm) {
+    unsigned int epoch = vm->gc->epoch;
+
+    for (Closure** closure = &vm->closures; *closure != NULL;) {
+        Closure* current = *closure;
+
+        if (current->mark == epoch) {
+            closure = &current->allocated;
+            continue;
+        }
+
+        *closure = current->allocated;
+        closure_free(&current);
+    }
+
+    for (Upvalue** upvalue = &vm->upvalues; *upvalue != NULL;) {
+        Upvalue* current = *upvalue;
+
+        if (current->mark == epoch || current->location != &current->closed) {
+            upvalue = &current->allocated;
+            continue;
+        }
+
+        *upvalue = current->allocated;
+        safe_free((void**) &current);
+    }
+}
+
+/* everything the program can reach starts from the stack, the globals or a running closure */
+static void collect(VM* vm) {
+    size_t rootCount = 0;
+
+    for (Value* slot = vm->stack; slot < vm->stackTop; slot++, rootCount++) {
+        gc_push_root(vm->gc, *slot);
+    }
+
+    for (size_t i = 0; i < vm->globalCount; i++, rootCount++) {
+        gc_push_root(vm->gc, vm->globals[i]);
+    }
+
+    for (size_t i = 0; i < vm->frameCount; i++, rootCount++) {
+        gc_push_root(vm->gc, CLOSURE_VALUE(vm->frames[i].closure));
+    }
+
+    gc_collect(vm->gc, NULL);
+    gc_pop_roots(vm->gc, rootCount);
+
+    sweep_closures(vm);
+}
+
+static InterpreterStatus run(VM* vm) {
+    CallFrame* frame = &vm->frames[vm->frameCount - 1];
+    uint8_t* ip = frame->ip;
+    Value* constants = frame->closure->function->chunk.constants;
+    Object* error = NULL;
+
+#define READ_BYTE() (*ip++)
+#define READ_SHORT() (ip += 2, (uint16_t) ((ip[-2] << 8) | ip[-1]))
+#define PUSH(value)                                                            \
+    do {                                                                       \
+        if (vm->stackTop == vm->stackEnd)                                      \
+            CHECK(grow_stack(vm));                                             \
+        *vm->stackTop++ = (value);                                             \
+    } while (0)
+#define POP() (*--vm->stackTop)
+#define PEEK(distance) (vm->stackTop[-1 - (distance)])
+#define LOAD_FRAME()                                                           \
+    do {                                                                       \
+        frame = &vm->frames[vm->frameCount - 1];                               \
+        ip = frame->ip;                                                        \
+        constants = frame->closure->function->chunk.constants;                 \
+    } while (0)
+/* where everything live is on the stack: calls, loop back edges and literals */
+#define SAFEPOINT()                                                            \
+    do {                                                                       \
+        if (vm->gc->bytesAllocated >= vm->gc->threshold)                       \
+            collect(vm);                                                       \
+    } while (0)
+#define CHECK(expr)                                                            \
+    do {                                                                       \
+        error = (expr);                                                        \
+        if (error != NULL) {                                                   \
+            frame->ip = ip;                                                    \
+            goto runtime_error;                                                \
+        }                                                                      \
+    } while (0)
+/* two inline ints run here, anything else or a failed int op goes through binary_op */
+#define BINARY_OP(token)                                                       \
+    do {                                                                       \
+        Value right = POP();                                                   \
+        Value* left = &vm->stackTop[-1];                                       \
+        if (!IS_SMALL_INT(*left) || !IS_SMALL_INT(right)                       \
+            || value_int_op((token), AS_SMALL_INT(*left), AS_SMALL_INT(right), \
+                left) != VALUE_OP_OK)                                          \
+            CHECK(binary_op(instruction, *left, right, left));                 \
+    } while (0)
+
+dispatch:
+    for (;;) {
+        uint8_t instruction = READ_BYTE();
+
+        switch (instruction) {
+        case OP_CONSTANT:
+            PUSH(constants[READ_SHORT()]);
+            break;
+        case OP_NIL:
+            PUSH(NIL_VALUE());
+            break;
+        case OP_TRUE:
+            PUSH(BOOL_VALUE(true));
+            break;
+        case OP_FALSE:
+            PUSH(BOOL_VALUE(false));
+            break;
+        case OP_POP:
+            vm->stackTop--;
+            break;
+        case OP_DUP: {
+            Value top = PEEK(0);
+            PUSH(top);
+            break;
+        }
+        case OP_DUPN: {
+            uint8_t count = READ_BYTE();
+
+            for (uint8_t i = 0; i < count; i++) {
+                Value operand = PEEK(count - 1);
+                PUSH(operand);
+            }
+            break;
+        }
+        case OP_DEFINE_GLOBAL:
+            vm->globals[READ_SHORT()] = POP();
+            break;
+        case OP_GET_GLOBAL: {
+            uint16_t index = READ_SHORT();
+            Value value = vm->globals[index];
+
+            if (IS_UNDEFINED(value)) {
+                ByteBuffer* bb = byte_buffer_new();
+                byte_buffer_appendf(bb, "undefined: %s", vm->globalNames[index]);
+                char* error_message = byte_buffer_to_string(bb);
+                byte_buffer_free(&bb);
+
+                error = NEW_ERROR_OBJECT(RUNTIME_ERROR, error_message);
+                safe_free((void**) &error_message);
+
+                frame->ip = ip;
+                goto runtime_error;
+            }
+
+            PUSH(value);
+            break;
+        }
+        case OP_SET_GLOBAL:
+            vm->globals[READ_SHORT()] = PEEK(0);
+            break;
+        case OP_GET_LOCAL:
+            PUSH(frame->slots[READ_BYTE()]);
+            break;
+        case OP_SET_LOCAL:
+            frame->slots[READ_BYTE()] = PEEK(0);
+            break;
+        case OP_GET_UPVALUE:
+            PUSH(*frame->closure->upvalues[READ_BYTE()]->location);
+            break;
+        case OP_SET_UPVALUE:
+            *frame->closure->upvalues[READ_BYTE()]->location = PEEK(0);
+            break;
+        case OP_CLOSE_UPVALUE:
+            close_upvalues(vm, vm->stackTop - 1);
+            vm->stackTop--;
+            break;
+        case OP_INC:
+        case OP_DEC:
+            CHECK(step_op(&vm->stackTop[-1], instruction == OP_INC));
+            break;
+        case OP_INC_LOCAL:
+        case OP_DEC_LOCAL: {
+            uint8_t index = READ_BYTE();
+
+            PUSH(frame->slots[index]);
+
+            CHECK(step_op(&frame->slots[index], instruction == OP_INC_LOCAL));
+            break;
+        }
+        case OP_ADD: BINARY_OP(TOKEN_ADD); break;
+        case OP_SUB: BINARY_OP(TOKEN_SUB); break;
+        case OP_MUL: BINARY_OP(TOKEN_MUL); break;
+        case OP_QUO: BINARY_OP(TOKEN_QUO); break;
+        case OP_REM: BINARY_OP(TOKEN_REM); break;
+        case OP_AND: BINARY_OP(TOKEN_AND); break;
+        case OP_OR:  BINARY_OP(TOKEN_OR);  break;
+        case OP_XOR: BINARY_OP(TOKEN_XOR); break;
+        case OP_SHL: BINARY_OP(TOKEN_SHL); break;
+        case OP_SHR: BINARY_OP(TOKEN_SHR); break;
+        case OP_EQL: {
+            Value right = POP();
+            Value left = POP();
+            PUSH(BOOL_VALUE(value_equals(left, right)));
+            break;
+        }
+        case OP_NEQ: {
+            Value right = POP();
+            Value left = POP();
+            PUSH(BOOL_VALUE(!value_equals(left, right)));
+            break;
+        }
+        case OP_LSS: BINARY_OP(TOKEN_LSS); break;
+        case OP_GTR: BINARY_OP(TOKEN_GTR); break;
+        case OP_LEQ: BINARY_OP(TOKEN_LEQ); break;
+        case OP_GEQ: BINARY_OP(TOKEN_GEQ); break;
+        case OP_PLUS: {
+            Value value = PEEK(0);
+            if (!IS_NUMBER(value)) {
+                CHECK(invalid_operation(NIL_VALUE(), "+", value));
+            }
+            break;
+        }
+        case OP_NEG: {
+            Value* value = &vm->stackTop[-1];
+
+            if (IS_INT(*value)) {
+                *value = INT_VALUE(0u - (uint64_t) AS_INT(*value));
+            } else if (IS_FLOAT(*value)) {
+                *value = FLOAT_VALUE(-AS_FLOAT(*value));
+            } else {
+                CHECK(invalid_operation(NIL_VALUE(), "-", *value));
+            }
+            break;
+        }
+        case OP_NOT:
+            vm->stackTop[-1] = BOOL_VALUE(!value_is_truthy(vm->stackTop[-1]));
+            break;
+        case OP_TILDE: {
+            Value* value = &vm->stackTop[-1];
+
+            if (!IS_INT(*value)) {
+                CHECK(invalid_operation(NIL_VALUE(), "~", *value));
+            }
+
+            *value = INT_VALUE(~AS_INT(*value));
+            break;
+        }
+        case OP_JUMP: {
+            uint16_t offset = READ_SHORT();
+            ip += offset;
+            break;
+        }
+        case OP_JUMP_IF_FALSE: {
+            uint16_t offset = READ_SHORT();
+            if (!value_is_truthy(POP()))
+                ip += offset;
+            break;
+        }
+        case OP_JUMP_IF_TRUE: {
+            uint16_t offset = READ_SHORT();
+            if (value_is_truthy(POP()))
+                ip += offset;
+            break;
+        }
+        case OP_LOOP: {
+            uint16_t offset = READ_SHORT();
+            ip -= offset;
+            SAFEPOINT();
+            break;
+        }
+        case OP_CALL: {
+            int argc = READ_BYTE();
+            frame->ip = ip;
+
+            SAFEPOINT();
+
+            CHECK(call_value(vm, PEEK(argc), argc));
+
+            LOAD_FRAME();
+            break;
+        }
+        case OP_CLOSURE: {
+            FunctionProto* function = AS_FUNCTION(constants[READ_SHORT()]);
+            Closure* closure = closure_new(vm, function);
+
+            PUSH(CLOSURE_VALUE(closure));
+
+            for (size_t i = 0; i < closure->upvalueCount; i++) {
+                uint8_t isLocal = READ_BYTE();
+                uint8_t index = READ_BYTE();
+
+                if (isLocal) {
+                    closure->upvalues[i] = capture_upvalue(vm, frame->slots + index);
+                } else {
+                    closure->upvalues[i] = frame->closure->upvalues[index];
+                }
+            }
+            break;
+        }
+        case OP_RETURN: {
+            Value result = POP();
+
+            close_upvalues(vm, frame->slots);
+
+            vm->frameCount--;
+            if (vm->frameCount == 0) {
+                vm->stackTop = vm->stack;
+                return vm->status;
+            }
+
+            vm->stackTop = frame->slots;
+            PUSH(result);
+
+            LOAD_FRAME();
+            break;
+        }
+        case OP_ARRAY: {
+            Type* arrayType = chunk_get_type(&frame->closure->function->chunk, READ_SHORT());
+            uint16_t count = READ_SHORT();
+
+            SAFEPOINT();
+
+            Value* values = safe_malloc((count > 0 ? count : 1) * sizeof(Value), NULL);
+            memcpy(values, vm->stackTop - count, count * sizeof(Value));
+
+            vm->stackTop -= count;
+
+            Object* array = NEW_ARRAY_OBJECT(type_copy((const Type**) &arrayType), values, count);
+            PUSH(OBJECT_VALUE(array));
+            break;
+        }
+        case OP_MAP: {
+            Type* mapType = chunk_get_type(&frame->closure->function->chunk, READ_SHORT());
+            uint16_t count = READ_SHORT();
+
+            SAFEPOINT();
+
+            Object* map = NEW_MAP_OBJECT(type_copy((const Type**) &mapType), count);
+
+            Value* entries = vm->stackTop - 2 * count;
+            for (uint16_t i = 0; i < count; i++) {
+                map_object_set(map->object, entries[2 * i], entries[2 * i + 1]);
+            }
+
+            vm->stackTop -= 2 * count;
+
+            PUSH(OBJECT_VALUE(map));
+            break;
+        }
+        case OP_INDEX: {
+            uint8_t count = READ_BYTE();
+            IndexTarget target;
+            Value element = NIL_VALUE();
+
+            CHECK(index_op(vm->stackTop - count - 1, count, &target));
+            vm->stackTop -= count + 1;
+
+            CHECK(load_op(&target, &element));
+
+            PUSH(element);
+            break;
+        }
+        case OP_SET_INDEX: {
+            uint8_t count = READ_BYTE();
+            Value value = POP();
+            IndexTarget target;
+
+            CHECK(index_op(vm->stackTop - count - 1, count, &target));
+            vm->stackTop -= count + 1;
+
+            CHECK(store_op(&target, value));
+
+            PUSH(value);
+            break;
+        }
+        case OP_INC_INDEX:
+        case OP_DEC_INDEX: {
+            uint8_t count = READ_BYTE();
+            IndexTarget target;
+            Value element = NIL_VALUE();
+
+            CHECK(index_op(vm->stackTop - count - 1, count, &target));
+            vm->stackTop -= count + 1;
+
+            CHECK(load_op(&target, &element));
+
+            Value updated = element;
+
+            CHECK(step_op(&updated, instruction == OP_INC_INDEX));
+            CHECK(store_op(&target, updated));
+
+            PUSH(element);
+            break;
+        }
+        case OP_CAST: {
+            TypeID typeId = READ_BYTE();
+            Value* target = &vm->stackTop[-1];
+
+            CHECK(cast_op(*target, typeId, target));
+            break;
+        }
+        default:
+            error = NEW_ERROR_OBJECT(RUNTIME_ERROR, "unknown instruction");
+            frame->ip = ip;
+            goto runtime_error;
+        }
+    }
+
+runtime_error:
+    log_error(error);
+
+    vm->status = INTERPRETER_FAILURE;
+
+    if (unwind(vm)) {
+        LOAD_FRAME();
+        goto dispatch;
+    }
+
+    vm->frameCount = 0;
+    vm->stackTop = vm->stack;
+    vm->openUpvalues = NULL;
+
+    return INTERPRETER_FAILURE;
+
+#undef READ_BYTE
+#undef READ_SHORT
+#undef PUSH
+#undef POP
+#undef PEEK
+#undef LOAD_FRAME
+#undef SAFEPOINT
+#undef CHECK
+#undef BINARY_OP
+}
+
+InterpreterStatus vm_eval(List* declarations) {
+    return vm_eval_with_options(declarations, (InterpreterOptions) {0});
+}
+
+InterpreterStatus vm_eval_with_options(List* declarations, InterpreterOptions options) {
+    if (declarations == NULL)
+        return INTERPRETER_SUCCESS;
+
+    if (!options.checked && check(declarations) == TYPE_CHECKER_FAILURE) {
+        return INTERPRETER_FAILURE;
+    }
+
+    optimize(declarations, options.optimizationLevel);
+
+    Program* program = compile(declarations);
+    if (program == NULL) {
+        /* past one of the compiler's limits the program still runs, only slower */
+        fprintf(stderr, "note: running on the tree engine instead\n");
+
+        options.checked = true;
+        options.optimizationLevel = OPTIMIZER_NONE;
+
+        return eval_with_options(declarations, options);
+    }
+
+    VM* vm = vm_new(program, options.gcThreshold);
+
+    Closure* script = closure_new(vm, program->script);
+
+    *vm->stackTop++ = CLOSURE_VALUE(script);
+    call_value(vm, CLOSURE_VALUE(script), 0);
+
+    vm->gc->markForeign = mark_closure;
+    vm->gc->traceForeign = trace_closures;
+    vm->gc->foreign = vm;
+
+    /* the constants were made before, so the chunks keep owning them */
+    gc_set_active(vm->gc);
+
+    InterpreterStatus status = run(vm);
+
+    output_flush();
+
+    if (options.gcStats) {
+        ByteBuffer* bb = byte_buffer_new();
+        gc_stats_to_string(bb, vm->gc);
+        char* stats = byte_buffer_to_string(bb);
+        byte_buffer_free(&bb);
+
+        fprintf(stderr, "%s\n", stats);
+
+        safe_free((void**) &stats);
+    }
+
+    gc_set_active(NULL);
+
+    vm_free(&vm);
+    program_free(&program);
+
+    return status;
+}
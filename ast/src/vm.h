@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "compiler.h"
+#include "gc.h"
+#include "interpreter.h"
+#include "list.h"
+#include "object.h"
+
+
+#define FRAMES_INIT 64
+#define FRAMES_MAX (64 * 1024) /* calls, the frames double up to it */
+#define STACK_INIT (64 * UINT8_COUNT)
+#define STACK_MAX (64 * 1024 * UINT8_COUNT) /* values, the stack doubles up to it */
+
+typedef struct Upvalue {
+    Value* location;
+    Value closed;
+    struct Upvalue* next;      /* open upvalues, from the top of the stack down */
+    struct Upvalue* allocated; /* every upvalue the VM holds */
+    unsigned int mark;
+} Upvalue;
+
+typedef struct Closure {
+    FunctionProto* function;
+    Upvalue** upvalues;
+    size_t upvalueCount;
+    struct Closure* allocated; /* every closure the VM holds */
+    unsigned int mark;
+} Closure;
+
+typedef struct Native {
+    char* name;
+    Value (*function)(struct Interpreter*, FunctionObject*, Value*, size_t);
+} Native;
+
+typedef struct CallFrame {
+    Closure* closure;
+    uint8_t* ip;
+    Value* slots;
+} CallFrame;
+
+typedef struct VM {
+    CallFrame* frames;
+    size_t frameCount;
+    size_t frameCapacity;
+    Value* stack;
+    Value* stackTop;
+    Value* stackEnd;
+    Value* globals;
+    char** globalNames;
+    size_t globalCount;
+    Upvalue* openUpvalues;
+    List* natives;  /* List of (Native*) */
+    Closure* closures;
+    Upvalue* upvalues;
+    Closure** gray; /* closures marked but not traced yet */
+    size_t grayCount;
+    size_t grayCapacity;
+    GC* gc;         /* owns every Object created while running */
+    InterpreterStatus status; /* failure once a runtime error was reported */
+} VM;
+
+InterpreterStatus vm_eval(List* declarations);
+InterpreterStatus vm_eval_with_options(List* declarations, InterpreterOptions options);
@@ -1,19 +1,63 @@
 #include <stdlib.h>
 
+#include "src/symbol.h"
+#include "src/types.h"
+
 #include "tests/smem/smem_test.h"
 #include "tests/token/token_test.h"
 #include "tests/utils/utils_test.h"
 #include "tests/types/types_test.h"
 #include "tests/buffer/buffer_test.h"
 #include "tests/object/object_test.h"
+#include "tests/compiler/compiler_test.h"
+#include "tests/resolver/resolver_test.h"
+#include "tests/value/value_test.h"
+#include "tests/gc/gc_test.h"
+#include "tests/arena/arena_test.h"
+#include "tests/optimizer/optimizer_test.h"
+#include "tests/matrix/matrix_test.h"
+#include "tests/simd/simd_test.h"
+#include "tests/map/map_test.h"
+#include "tests/symbol/symbol_test.h"
+#include "tests/vector/vector_test.h"
+#include "tests/output/output_test.h"
+#include "tests/reader/reader_test.h"
+#include "tests/cache/cache_test.h"
+#include "tests/ast/ast_test.h"
+#include "tests/vm/vm_test.h"
 
 int main(void) {
+    /* every test interns into these, the way a run does into its ParserState's */
+    SymbolTable* symbols = symbol_table_new(NULL);
+    TypeTable* types = type_table_new(NULL);
+    symbol_table_set_active(symbols);
+    type_table_set_active(types);
+
     run_smem_tests();
     run_token_tests();
     run_utils_tests();
     run_type_tests();
     run_buffer_tests();
     run_object_tests();
+    run_compiler_tests();
+    run_resolver_tests();
+    run_value_tests();
+    run_gc_tests();
+    run_arena_tests();
+    run_optimizer_tests();
+    run_matrix_tests();
+    run_simd_tests();
+    run_map_tests();
+    run_symbol_tests();
+    run_vector_tests();
+    run_output_tests();
+    run_reader_tests();
+    run_cache_tests();
+    run_ast_tests();
+    run_vm_tests();
+
+    type_table_free(&types);
+    symbol_table_free(&symbols);
 
     return EXIT_SUCCESS;
 }
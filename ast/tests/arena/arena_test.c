@@ -0,0 +1,118 @@
+#include "arena_test.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../../src/arena.h"
+#include "../../src/ast.h"
+#include "../../src/list.h"
+#include "../../src/smem.h"
+#include "../../src/token.h"
+
+
+static void test_arena_alloc(void) {
+    Arena* arena = arena_new(256);
+    assert(arena != NULL);
+
+    char* previous = NULL;
+    for (size_t i = 0; i < 100; i++) {
+        char* ptr = arena_alloc(arena, 24);
+        assert(ptr != NULL);
+        assert((uintptr_t) ptr % ARENA_ALIGNMENT == 0);
+        assert(ptr != previous);
+
+        memset(ptr, 0xab, 24);
+        previous = ptr;
+    }
+
+    char* large = arena_alloc(arena, 4096);
+    assert(large != NULL);
+    memset(large, 0, 4096);
+
+    assert(arena_alloc(arena, 0) == NULL);
+    assert(arena->bytesAllocated >= 100 * 24 + 4096);
+
+    char* str = arena_str_dup(arena, "rose");
+    assert(strcmp(str, "rose") == 0);
+
+    arena_free(&arena);
+    assert(arena == NULL);
+}
+
+static void test_arena_reset(void) {
+    Arena* arena = arena_new(256);
+
+    for (size_t i = 0; i < 100; i++) {
+        arena_alloc(arena, 24);
+    }
+    arena_alloc(arena, 4096);
+
+    arena_reset(arena);
+    assert(arena->bytesAllocated == 0);
+    assert(arena->chunks != NULL && arena->chunks->next == NULL);
+    assert(arena->chunks->used == 0 && arena->chunks->size == arena->chunkSize);
+
+    /* refilled from the chunk it kept */
+    char* again = arena_alloc(arena, 24);
+    assert(again != NULL && (uintptr_t) again % ARENA_ALIGNMENT == 0);
+    assert(arena->chunks->next == NULL);
+
+    arena_reset(arena);
+    arena_free(&arena);
+
+    Arena* empty = arena_new(0);
+    arena_reset(empty);
+    assert(empty->chunks == NULL);
+    arena_free(&empty);
+}
+
+static void test_arena_active(void) {
+    assert(arena_active() == NULL);
+
+    char* heap = arena_active_str_dup("heap");
+    assert(strcmp(heap, "heap") == 0);
+    safe_free((void**) &heap);
+
+    Arena* arena = arena_new(0);
+    arena_set_active(arena);
+
+    List* list = list_new(NULL);
+    assert(list->arena == arena);
+
+    for (int i = 0; i < 10; i++) {
+        list_insert_last(&list, NULL);
+    }
+    list_remove_first(&list, NULL);
+    assert(list_size(&list) == 9);
+
+    /* a tree built while the arena is active is released with it */
+    Expr* expr = NEW_BINARY_EXPR(
+        NEW_INT_LITERAL(1),
+        NEW_TOKEN(TOKEN_ADD, "+", 1),
+        NEW_INT_LITERAL(2)
+    );
+    Decl* decl = NEW_LET_DECL(NEW_TOKEN(TOKEN_IDENT, "x", 1), NULL, expr);
+    assert(decl != NULL);
+
+    List* declarations = list_new((void (*)(void**)) decl_free);
+    list_insert_last(&declarations, decl);
+
+    arena_set_active(NULL);
+
+    List* heapList = list_new(NULL);
+    assert(heapList->arena == NULL);
+    list_free(&heapList);
+
+    arena_free(&arena);
+    assert(arena_active() == NULL);
+}
+
+void run_arena_tests(void) {
+    test_arena_alloc();
+    test_arena_reset();
+    test_arena_active();
+
+    printf("%s: All tests passed successfully!\n", __FILE__);
+}
@@ -0,0 +1,61 @@
+#include "ast_test.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../../src/ast.h"
+#include "../../src/buffer.h"
+#include "../../src/output.h"
+#include "../../src/token.h"
+#include "../../src/types.h"
+
+
+static void test_function_decl_to_string(void) {
+    Stmt* body = NEW_BLOCK_STMT();
+    BLOCK_STMT_ADD_DECL(body, NEW_STMT_DECL(NEW_RETURN_STMT(NEW_IDENT_LITERAL("a"))));
+
+    Decl* lerp = NEW_FUNCTION_DECL_WITH_RETURN(NEW_TOKEN(TOKEN_IDENT, "lerp", 1), NEW_FLOAT_TYPE(), body);
+    FUNCTION_ADD_PARAMS(lerp,
+        NEW_FIELD_DECL(NEW_TOKEN(TOKEN_IDENT, "a", 1), NEW_FLOAT_TYPE()),
+        NEW_FIELD_DECL(NEW_TOKEN(TOKEN_IDENT, "t", 1), NEW_FLOAT_TYPE())
+    );
+
+    ByteBuffer* text = byte_buffer_new();
+    output_capture(text);
+    decl_to_string(&lerp);
+    output_capture(NULL);
+
+    const char* expected = "func lerp(a: float, t: float): float ";
+    assert(strncmp(text->bytes, expected, strlen(expected)) == 0);
+
+    byte_buffer_free(&text);
+    decl_free(&lerp);
+}
+
+static void test_function_expr_to_string(void) {
+    Stmt* body = NEW_BLOCK_STMT();
+    BLOCK_STMT_ADD_DECL(body, NEW_STMT_DECL(NEW_RETURN_STMT(NEW_IDENT_LITERAL("n"))));
+
+    Expr* identity = NEW_FUNCTION_EXPR_WITH_PARAMS_AND_RETURN(
+        list_new((void (*)(void**)) decl_free), NEW_INT_TYPE(), body);
+    FUNCTION_EXPR_ADD_PARAMS(identity, NEW_FIELD_DECL(NEW_TOKEN(TOKEN_IDENT, "n", 1), NEW_INT_TYPE()));
+
+    ByteBuffer* text = byte_buffer_new();
+    output_capture(text);
+    expr_to_string(&identity);
+    output_capture(NULL);
+
+    const char* expected = "func(n: int): int ";
+    assert(strncmp(text->bytes, expected, strlen(expected)) == 0);
+
+    byte_buffer_free(&text);
+    expr_free(&identity);
+}
+
+void run_ast_tests(void) {
+    test_function_decl_to_string();
+    test_function_expr_to_string();
+
+    printf("%s: All tests passed successfully!\n", __FILE__);
+}
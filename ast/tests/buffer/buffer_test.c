@@ -1,6 +1,9 @@
 #include "buffer_test.h"
 
 #include <assert.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -76,6 +79,19 @@ static void test_byte_buffer_appendf(void) {
     byte_buffer_free(&buffer);
 }
 
+static void test_byte_buffer_appendf_grows(void) {
+    ByteBuffer* buffer = byte_buffer_new_with_capacity(8);
+
+    assert(byte_buffer_appendf(buffer, "%s", "abc") == 3);
+    assert(byte_buffer_appendf(buffer, "%d-%d", 12345, 67890) == 11);
+
+    assert(byte_buffer_size(buffer) == 14);
+    assert(byte_buffer_capacity(buffer) > 14);
+    assert(strcmp(buffer->bytes, "abc12345-67890") == 0);
+
+    byte_buffer_free(&buffer);
+}
+
 static void test_byte_buffer_nappendf(void) {
     ByteBuffer* buffer = byte_buffer_new();
 
@@ -91,6 +107,57 @@ static void test_byte_buffer_nappendf(void) {
     byte_buffer_free(&buffer);
 }
 
+static void assert_int_text(int64_t value) {
+    char expected[32];
+    snprintf(expected, sizeof(expected), "%" PRId64, value);
+
+    ByteBuffer* buffer = byte_buffer_new();
+    assert(byte_buffer_append_int(buffer, value) == strlen(expected));
+    assert(strcmp(buffer->bytes, expected) == 0);
+    byte_buffer_free(&buffer);
+}
+
+static void assert_double_text(double value) {
+    char expected[512];
+    snprintf(expected, sizeof(expected), "%f", value);
+
+    ByteBuffer* buffer = byte_buffer_new();
+    assert(byte_buffer_append_double(buffer, value) == strlen(expected));
+    assert(strcmp(buffer->bytes, expected) == 0);
+    byte_buffer_free(&buffer);
+}
+
+static void test_byte_buffer_append_numbers(void) {
+    int64_t ints[] = {0, 7, -7, 10, 99, 100, -1000, 123456789, INT64_MAX, INT64_MIN};
+    for (size_t i = 0; i < sizeof(ints) / sizeof(ints[0]); i++) {
+        assert_int_text(ints[i]);
+    }
+
+    /* halfway cases round to even exactly as printf does */
+    double floats[] = {
+        0.0, -0.0, 1.5, -2.25, 0.1, 3.14159265, 0.0000005, 0.0000015, 0.0000025, -0.0000004,
+        1e-300, 5e-324, 123456789.987654321, 9007199254740993.0, 9.2e18, 1e300,
+        INFINITY, -INFINITY, NAN
+    };
+    for (size_t i = 0; i < sizeof(floats) / sizeof(floats[0]); i++) {
+        assert_double_text(floats[i]);
+    }
+
+    uint64_t state = 88172645463325252ULL;
+    for (size_t i = 0; i < 20000; i++) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+
+        assert_int_text((int64_t) state);
+
+        double value = 0;
+        memcpy(&value, &state, sizeof(value));
+        assert_double_text(value);
+        assert_double_text((double) (int64_t) (state % 2000000001) / 1024.0 - 1e6);
+    }
+}
+
 static void test_byte_buffer_to_string(void) {
     ByteBuffer* buffer = byte_buffer_new();
 
@@ -123,7 +190,9 @@ void run_buffer_tests(void) {
     test_byte_buffer_clear();
     test_byte_buffer_append();
     test_byte_buffer_appendf();
+    test_byte_buffer_appendf_grows();
     test_byte_buffer_nappendf();
+    test_byte_buffer_append_numbers();
     test_byte_buffer_to_string();
 
     printf("%s: All tests passed successfully!\n", __FILE__);
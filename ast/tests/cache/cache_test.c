@@ -0,0 +1,159 @@
+#include "cache_test.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../../src/arena.h"
+#include "../../src/ast.h"
+#include "../../src/cache.h"
+#include "../../src/list.h"
+#include "../../src/smem.h"
+#include "../../src/token.h"
+#include "../../src/type-checker.h"
+#include "../../src/types.h"
+
+
+static const char SOURCE[] = "the source the tree stands for";
+
+static char* read_file(const char* path, size_t* size) {
+    FILE* file = fopen(path, "rb");
+    assert(file != NULL);
+
+    fseek(file, 0, SEEK_END);
+    *size = (size_t) ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char* data = malloc(*size);
+    assert(fread(data, 1, *size, file) == *size);
+    fclose(file);
+
+    return data;
+}
+
+/*
+ * func twice(x: int): int { return x * 2; }
+ * let a = twice(1) + 2;
+ * let xs = []int{1, 2};
+ * let s = "text";
+ */
+static List* sample_program(void) {
+    List* declarations = list_new((void (*)(void**)) decl_free);
+
+    List* parameters = list_new((void (*)(void**)) decl_free);
+    list_insert_last(&parameters, NEW_FIELD_DECL(NEW_TOKEN(TOKEN_IDENT, "x", 1), NEW_INT_TYPE()));
+
+    Stmt* body = NEW_BLOCK_STMT();
+    BLOCK_STMT_ADD_DECL(body, NEW_STMT_DECL(NEW_RETURN_STMT(NEW_BINARY_EXPR(
+        NEW_IDENT_LITERAL("x"), NEW_TOKEN(TOKEN_MUL, "*", 1), NEW_INT_LITERAL(2)))));
+
+    list_insert_last(&declarations, NEW_FUNCTION_DECL_WITH_PARAMS_AND_RETURN(
+        NEW_TOKEN(TOKEN_IDENT, "twice", 1), parameters, NEW_INT_TYPE(), body));
+
+    Expr* call = NEW_CALL_EXPR(NEW_IDENT_LITERAL("twice"));
+    CALL_EXPR_ADD_ARG(call, NEW_INT_LITERAL(1));
+    list_insert_last(&declarations, NEW_LET_DECL(NEW_TOKEN(TOKEN_IDENT, "a", 2), NULL,
+        NEW_BINARY_EXPR(call, NEW_TOKEN(TOKEN_ADD, "+", 2), NEW_INT_LITERAL(2))));
+
+    Type* arrayType = NEW_ARRAY_TYPE(NEW_INT_TYPE());
+    ARRAY_TYPE_ADD_DIMENSION(arrayType, NEW_ARRAY_UNDEFINED_DIMENSION());
+    Expr* array = NEW_ARRAY_INIT_EXPR(arrayType);
+    ARRAY_INIT_EXPR_ADD_ELEMENTS(array, NEW_INT_LITERAL(1), NEW_INT_LITERAL(2));
+    list_insert_last(&declarations, NEW_LET_DECL(NEW_TOKEN(TOKEN_IDENT, "xs", 3), NULL, array));
+
+    list_insert_last(&declarations, NEW_LET_DECL(NEW_TOKEN(TOKEN_IDENT, "s", 4), NULL,
+        NEW_STRING_LITERAL("text")));
+
+    return declarations;
+}
+
+static void test_cache_path(void) {
+    char* path = cache_path("dir/script.rose");
+    assert(strcmp(path, "dir/script.rosec") == 0);
+    safe_free((void**) &path);
+
+    path = cache_path("script");
+    assert(strcmp(path, "script.rosec") == 0);
+    safe_free((void**) &path);
+
+    assert(cache_hash(SOURCE, sizeof(SOURCE)) == cache_hash(SOURCE, sizeof(SOURCE)));
+    assert(cache_hash(SOURCE, sizeof(SOURCE)) != cache_hash(SOURCE, sizeof(SOURCE) - 1));
+}
+
+static void test_cache_round_trip(void) {
+    char first[] = "/tmp/rose_cache_testXXXXXX";
+    char second[] = "/tmp/rose_cache_testXXXXXX";
+    close(mkstemp(first));
+    close(mkstemp(second));
+
+    List* declarations = sample_program();
+    assert(check(declarations) == TYPE_CHECKER_SUCCESS);
+    assert(cache_store(first, SOURCE, sizeof(SOURCE), declarations));
+
+    Arena* arena = arena_new(0);
+    arena_set_active(arena);
+    List* loaded = cache_load(first, SOURCE, sizeof(SOURCE));
+    arena_set_active(NULL);
+
+    assert(loaded != NULL && list_size(&loaded) == 4);
+
+    /* what the checker worked out comes back without checking again */
+    FunctionDecl* twice = ((Decl*) list_get_at(&loaded, 0))->decl;
+    assert(twice->functionType == ((FunctionDecl*) ((Decl*) list_get_at(&declarations, 0))->decl)->functionType);
+    assert(strcmp(twice->name->literal, "twice") == 0 && list_size(&twice->parameters) == 1);
+
+    LetDecl* a = ((Decl*) list_get_at(&loaded, 1))->decl;
+    assert(a->type == NEW_INT_TYPE());
+    assert(a->expression->resolvedType == NEW_INT_TYPE());
+    assert(((BinaryExpr*) a->expression->expr)->operands == OPERANDS_INT);
+    assert(a->name->line == 2);
+
+    LetDecl* s = ((Decl*) list_get_at(&loaded, 3))->decl;
+    LiteralExpr* text = s->expression->expr;
+    assert(strcmp(((StringLiteral*) text->value)->value, "text") == 0);
+
+    /* the loaded tree writes the same file back */
+    assert(cache_store(second, SOURCE, sizeof(SOURCE), loaded));
+
+    size_t firstSize = 0;
+    size_t secondSize = 0;
+    char* firstData = read_file(first, &firstSize);
+    char* secondData = read_file(second, &secondSize);
+    assert(firstSize == secondSize && memcmp(firstData, secondData, firstSize) == 0);
+
+    /* a changed source, a damaged file or no file at all fall back to parsing */
+    arena_set_active(arena);
+    assert(cache_load(first, "another source", strlen("another source")) == NULL);
+
+    firstData[firstSize - 1] ^= 1;
+    FILE* file = fopen(first, "wb");
+    fwrite(firstData, 1, firstSize, file);
+    fclose(file);
+    assert(cache_load(first, SOURCE, sizeof(SOURCE)) == NULL);
+
+    assert(truncate(second, secondSize / 2) == 0);
+    assert(cache_load(second, SOURCE, sizeof(SOURCE)) == NULL);
+
+    unlink(first);
+    unlink(second);
+    assert(cache_load(first, SOURCE, sizeof(SOURCE)) == NULL);
+    arena_set_active(NULL);
+
+    /* types live outside the arena, the one builder type in the tree goes by hand */
+    LetDecl* xs = ((Decl*) list_get_at(&loaded, 2))->decl;
+    type_free(&((ArrayInitExpr*) xs->expression->expr)->type);
+
+    free(firstData);
+    free(secondData);
+    arena_free(&arena);
+    list_free(&declarations);
+}
+
+void run_cache_tests(void) {
+    test_cache_path();
+    test_cache_round_trip();
+
+    printf("%s: All tests passed successfully!\n", __FILE__);
+}
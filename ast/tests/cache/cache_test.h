@@ -0,0 +1,3 @@
+#pragma once
+
+void run_cache_tests(void);
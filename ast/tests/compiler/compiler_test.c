@@ -0,0 +1,135 @@
+#include "compiler_test.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../src/ast.h"
+#include "../../src/compiler.h"
+#include "../../src/list.h"
+#include "../../src/token.h"
+
+
+static void test_chunk_write(void) {
+    Chunk chunk;
+    chunk_init(&chunk);
+
+    for (int i = 0; i < 100; i++) {
+        chunk_write(&chunk, (uint8_t) i);
+    }
+
+    assert(chunk.count == 100);
+    assert(chunk.capacity >= 100);
+    assert(chunk.code[0] == 0);
+    assert(chunk.code[99] == 99);
+
+    chunk_free(&chunk);
+
+    assert(chunk.code == NULL);
+    assert(chunk.count == 0);
+}
+
+static void test_chunk_add_constant(void) {
+    Chunk chunk;
+    chunk_init(&chunk);
+
+    for (int i = 0; i < 20; i++) {
+        assert(chunk_add_constant(&chunk, INT_VALUE(i)) == (size_t) i);
+    }
+
+    assert(chunk.constantCount == 20);
+    assert(IS_INT(chunk.constants[7]));
+    assert(AS_INT(chunk.constants[7]) == 7);
+
+    chunk_free(&chunk);
+}
+
+static void test_compile_global_let(void) {
+    List* declarations = list_new((void (*)(void**)) decl_free);
+
+    list_insert_last(&declarations, NEW_LET_DECL(
+        NEW_TOKEN(TOKEN_IDENT, "a", 1),
+        NULL,
+        NEW_BINARY_EXPR(
+            NEW_INT_LITERAL(1),
+            NEW_TOKEN(TOKEN_ADD, "+", 1),
+            NEW_INT_LITERAL(2)
+        )
+    ));
+
+    Program* program = compile(declarations);
+
+    assert(program != NULL);
+    assert(program->globalCount == 1);
+    assert(strcmp(program->globalNames[0], "a") == 0);
+
+    uint8_t expected[] = {
+        OP_CONSTANT, 0, 0,
+        OP_CONSTANT, 0, 1,
+        OP_ADD,
+        OP_DEFINE_GLOBAL, 0, 0,
+        OP_NIL,
+        OP_RETURN
+    };
+
+    Chunk* chunk = &program->script->chunk;
+
+    assert(chunk->count == sizeof(expected));
+    assert(memcmp(chunk->code, expected, sizeof(expected)) == 0);
+    assert(AS_INT(chunk->constants[0]) == 1);
+    assert(AS_INT(chunk->constants[1]) == 2);
+
+    program_free(&program);
+    list_free(&declarations);
+
+    assert(program == NULL);
+}
+
+static void test_compile_block_uses_local_slots(void) {
+    List* declarations = list_new((void (*)(void**)) decl_free);
+
+    Stmt* block = NEW_BLOCK_STMT();
+    block_stmt_add_declaration((BlockStmt**) &block->stmt, NEW_LET_DECL(
+        NEW_TOKEN(TOKEN_IDENT, "b", 1),
+        NULL,
+        NEW_INT_LITERAL(3)
+    ));
+    block_stmt_add_declaration((BlockStmt**) &block->stmt, NEW_STMT_DECL(
+        NEW_EXPR_STMT(NEW_UPDATE_EXPR(NEW_IDENT_LITERAL("b"), NEW_TOKEN(TOKEN_INC, "++", 1)))
+    ));
+
+    list_insert_last(&declarations, NEW_STMT_DECL(block));
+
+    Program* program = compile(declarations);
+
+    assert(program != NULL);
+    assert(program->globalCount == 0);
+
+    uint8_t expected[] = {
+        OP_CONSTANT, 0, 0,
+        OP_INC_LOCAL, 1,
+        OP_POP,
+        OP_POP,
+        OP_NIL,
+        OP_RETURN
+    };
+
+    Chunk* chunk = &program->script->chunk;
+
+    assert(chunk->count == sizeof(expected));
+    assert(memcmp(chunk->code, expected, sizeof(expected)) == 0);
+
+    program_free(&program);
+    list_free(&declarations);
+}
+
+void run_compiler_tests(void) {
+    test_chunk_write();
+    test_chunk_add_constant();
+    test_compile_global_let();
+    test_compile_block_uses_local_slots();
+
+    printf("%s: All tests passed successfully!\n", __FILE__);
+}
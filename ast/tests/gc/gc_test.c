@@ -0,0 +1,116 @@
+#include "gc_test.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../src/context.h"
+#include "../../src/gc.h"
+#include "../../src/interpreter.h"
+#include "../../src/object.h"
+#include "../../src/smem.h"
+#include "../../src/types.h"
+#include "../../src/value.h"
+
+
+static void test_gc_collects_unreachable_objects(void) {
+    GC* gc = gc_new(0);
+    gc_set_active(gc);
+
+    Context* env = context_new(NULL);
+    Interpreter interpreter = { .env = env, .returnValue = NIL_VALUE(), .gc = gc };
+
+    Object* kept = NEW_STRING_OBJECT("kept");
+    Object* temporary = NEW_STRING_OBJECT("temporary");
+    NEW_STRING_OBJECT("garbage");
+
+    context_define_at(env, 0, OBJECT_VALUE(kept));
+    gc_push_root(gc, OBJECT_VALUE(temporary));
+
+    assert(gc->stats.objectsAllocated == 3);
+
+    gc_collect(gc, &interpreter);
+
+    assert(gc->stats.collections == 1);
+    assert(gc->stats.objectsFreed == 1);
+    assert(strcmp(((StringObject*) kept->object)->value, "kept") == 0);
+    assert(strcmp(((StringObject*) temporary->object)->value, "temporary") == 0);
+
+    gc_pop_roots(gc, 1);
+    gc_collect(gc, &interpreter);
+
+    assert(gc->stats.objectsFreed == 2);
+    assert(gc->objects == kept && kept->next == NULL);
+
+    context_free(&env);
+    gc_free(&gc);
+}
+
+static void test_gc_traces_arrays_and_closures(void) {
+    GC* gc = gc_new(0);
+    gc_set_active(gc);
+
+    Context* global = context_new(NULL);
+    Context* captured = context_enclosed_new(global, NULL);
+    Interpreter interpreter = { .env = global, .returnValue = NIL_VALUE(), .gc = gc };
+
+    Value* values = safe_malloc(2 * sizeof(Value), NULL);
+    values[0] = OBJECT_VALUE(NEW_STRING_OBJECT("first"));
+    values[1] = INT_VALUE(2);
+
+    Object* array = NEW_ARRAY_OBJECT(NEW_ARRAY_TYPE(NEW_INT_TYPE()), values, 2);
+    context_define_at(captured, 0, OBJECT_VALUE(array));
+
+    Object* function = NEW_FUNCTION_OBJECT(NULL, captured, NULL, NULL, (ScopeLayout) {0});
+    gc_capture(gc, captured);
+    context_define_at(global, 0, OBJECT_VALUE(NEW_CALLABLE_OBJECT(function)));
+
+    assert(global->isCaptured && captured->isCaptured);
+
+    gc_collect(gc, &interpreter);
+
+    assert(gc->stats.objectsFreed == 0);
+    assert(gc->stats.contextsFreed == 0);
+
+    /* dropping the only reference releases the closure, its scope and the array */
+    interpreter.env = NULL;
+    gc_collect(gc, &interpreter);
+
+    assert(gc->stats.objectsFreed == 4);
+    assert(gc->stats.contextsFreed == 2);
+    assert(gc->objects == NULL && gc->contexts == NULL);
+
+    gc_free(&gc);
+}
+
+static void test_gc_safepoint_threshold(void) {
+    GC* gc = gc_new(1);
+    gc_set_active(gc);
+
+    Interpreter interpreter = { .env = NULL, .returnValue = NIL_VALUE(), .gc = gc };
+
+    gc_safepoint(gc, &interpreter);
+    assert(gc->stats.collections == 0);
+
+    NEW_STRING_OBJECT("garbage");
+    assert(gc->bytesAllocated >= gc->threshold);
+
+    gc_safepoint(gc, &interpreter);
+    assert(gc->stats.collections == 1);
+    assert(gc->bytesAllocated == 0);
+
+    gc_free(&gc);
+
+    Object* untracked = NEW_STRING_OBJECT("untracked");
+    assert(untracked->size == 0);
+    object_free(&untracked);
+}
+
+void run_gc_tests(void) {
+    test_gc_collects_unreachable_objects();
+    test_gc_traces_arrays_and_closures();
+    test_gc_safepoint_threshold();
+
+    printf("%s: All tests passed successfully!\n", __FILE__);
+}
@@ -0,0 +1,170 @@
+#include "map_test.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../../src/map.h"
+#include "../../src/smem.h"
+#include "../../src/utils.h"
+
+
+#define KEYS 1000
+
+static size_t released;
+
+static bool entry_cmp(const MapEntry** entry, char** key) {
+    return strcmp((*entry)->key, *key) == 0;
+}
+
+static void count_release(void** value) {
+    released += 1;
+    safe_free(value);
+}
+
+static char* key_of(size_t i) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "key-%zu", i);
+    return str_dup(buffer);
+}
+
+static size_t* number(size_t value) {
+    size_t* boxed = safe_malloc(sizeof(size_t), NULL);
+    *boxed = value;
+    return boxed;
+}
+
+static void test_map_inline_and_spill(void) {
+    Map* map = MAP_NEW(4, entry_cmp, NULL, NULL);
+
+    char* keys[] = {"a", "b", "c", "d", "e", "f", "g", "h", "i"};
+
+    for (size_t i = 0; i < MAP_INLINE_CAPACITY; i++) {
+        map_put(map, keys[i], keys[i]);
+    }
+    assert(map->slots == map->inline_slots);
+    assert(map_size(map) == MAP_INLINE_CAPACITY);
+
+    map_remove(map, "c");
+    assert(!map_contains(map, "c"));
+    assert(map_get(map, "h") == keys[7]);
+    map_put(map, "c", keys[2]);
+
+    /* the ninth key moves everything into a table */
+    map_put(map, keys[8], keys[8]);
+    assert(map->slots != map->inline_slots);
+    assert(map_size(map) == 9);
+
+    for (size_t i = 0; i < 9; i++) {
+        assert(map_get(map, keys[i]) == keys[i]);
+    }
+
+    map_free(&map);
+    assert(map == NULL);
+}
+
+static void test_map_grow_update_and_remove(void) {
+    released = 0;
+
+    Map* map = MAP_NEW(32, entry_cmp, safe_free, count_release);
+
+    for (size_t i = 0; i < KEYS; i++) {
+        map_put(map, key_of(i), number(i));
+    }
+    assert(map_size(map) == KEYS);
+    assert(map->capacity * 3 >= KEYS * 4);
+
+    /* an update keeps the slot and releases the replaced key and value */
+    for (size_t i = 0; i < KEYS; i += 2) {
+        map_put(map, key_of(i), number(i * 10));
+    }
+    assert(map_size(map) == KEYS);
+    assert(released == KEYS / 2);
+
+    for (size_t i = 0; i < KEYS; i++) {
+        char* key = key_of(i);
+        size_t* value = map_get(map, key);
+        assert(value != NULL && *value == (i % 2 == 0 ? i * 10 : i));
+        safe_free((void**) &key);
+    }
+
+    for (size_t i = 0; i < KEYS; i += 3) {
+        char* key = key_of(i);
+        map_remove(map, key);
+        map_remove(map, key);
+        safe_free((void**) &key);
+    }
+
+    size_t removed = (KEYS + 2) / 3;
+    assert(map_size(map) == KEYS - removed);
+
+    for (size_t i = 0; i < KEYS; i++) {
+        char* key = key_of(i);
+        assert(map_contains(map, key) == (i % 3 != 0));
+        safe_free((void**) &key);
+    }
+
+    size_t visited = 0;
+    MapIterator* iterator = map_iterator_new(map);
+    while (map_iterator_has_next(iterator)) {
+        MapEntry* entry = map_iterator_next(iterator);
+        assert(map_get(map, entry->key) == entry->value);
+        visited += 1;
+    }
+    assert(map_iterator_next(iterator) == NULL);
+    map_iterator_free(&iterator);
+    assert(visited == map_size(map));
+
+    map_clear(map);
+    assert(map_size(map) == 0);
+    assert(released == KEYS / 2 + KEYS);
+
+    map_put(map, key_of(1), number(1));
+    assert(map_size(map) == 1);
+
+    map_free(&map);
+    assert(released == KEYS / 2 + KEYS + 1);
+}
+
+/* collides on purpose so probing does the work */
+static size_t number_hash(const size_t* key) {
+    return *key % 7;
+}
+
+static bool number_cmp(const MapEntry** entry, size_t** key) {
+    return *(size_t*) (*entry)->key == **key;
+}
+
+static void test_map_with_hash(void) {
+    assert(MAP_NEW_WITH_HASH(4, NULL, number_cmp, NULL, NULL) == NULL);
+
+    released = 0;
+    Map* map = MAP_NEW_WITH_HASH(4, number_hash, number_cmp, count_release, count_release);
+
+    for (size_t i = 0; i < KEYS; i++) {
+        map_put(map, number(i), number(i * 2));
+    }
+    assert(map_size(map) == KEYS);
+
+    size_t probe = 500;
+    assert(*(size_t*) map_get(map, &probe) == 1000);
+
+    map_put(map, number(probe), number(1));
+    assert(map_size(map) == KEYS && released == 2);
+    assert(*(size_t*) map_get(map, &probe) == 1);
+
+    map_remove(map, &probe);
+    assert(!map_contains(map, &probe) && released == 4);
+
+    map_free(&map);
+    assert(released == 2 * KEYS + 2);
+}
+
+void run_map_tests(void) {
+    test_map_inline_and_spill();
+    test_map_grow_update_and_remove();
+    test_map_with_hash();
+
+    printf("%s: All tests passed successfully!\n", __FILE__);
+}
@@ -0,0 +1,104 @@
+#include "matrix_test.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../../src/matrix.h"
+#include "../../src/smem.h"
+
+
+/* sizes that are not multiples of MATRIX_BLOCK exercise the partial tiles */
+#define N 70
+#define K 131
+#define M 65
+
+static void test_matrix_multiply_matches_naive(void) {
+    int64_t* a = safe_malloc(N * K * sizeof(int64_t), NULL);
+    int64_t* b = safe_malloc(K * M * sizeof(int64_t), NULL);
+    int64_t* c = safe_calloc(N * M, sizeof(int64_t), NULL);
+
+    for (size_t i = 0; i < N * K; i++) {
+        a[i] = (int64_t) (i % 17) - 8;
+    }
+
+    for (size_t i = 0; i < K * M; i++) {
+        b[i] = (int64_t) (i % 13) - 6;
+    }
+
+    matrix_multiply_int(a, b, c, N, K, M);
+
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = 0; j < M; j++) {
+            int64_t expected = 0;
+
+            for (size_t p = 0; p < K; p++) {
+                expected += a[i * K + p] * b[p * M + j];
+            }
+
+            assert(c[i * M + j] == expected);
+        }
+    }
+
+    double left[] = {1.0, 2.0, 3.0, 4.0};
+    double right[] = {0.5, 0.0, 0.0, 0.5};
+    double product[4] = {0};
+
+    matrix_multiply_float(left, right, product, 2, 2, 2);
+    assert(product[0] == 0.5 && product[1] == 1.0 && product[2] == 1.5 && product[3] == 2.0);
+
+    safe_free((void**) &a);
+    safe_free((void**) &b);
+    safe_free((void**) &c);
+}
+
+static void test_matrix_transpose(void) {
+    double* source = safe_malloc(N * M * sizeof(double), NULL);
+    double* target = safe_malloc(N * M * sizeof(double), NULL);
+
+    for (size_t i = 0; i < N * M; i++) {
+        source[i] = (double) i;
+    }
+
+    matrix_transpose(source, target, N, M, sizeof(double));
+
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = 0; j < M; j++) {
+            assert(target[j * N + i] == source[i * M + j]);
+        }
+    }
+
+    safe_free((void**) &source);
+    safe_free((void**) &target);
+}
+
+static void test_matrix_elementwise(void) {
+    int64_t a[] = {INT64_MAX, 2, -3};
+    int64_t b[] = {1, 5, 4};
+    int64_t c[3];
+
+    matrix_elementwise_int(MATRIX_ADD, a, b, c, 3);
+    assert(c[0] == INT64_MIN && c[1] == 7 && c[2] == 1);
+
+    matrix_elementwise_int(MATRIX_SUB, a, b, c, 3);
+    assert(c[1] == -3 && c[2] == -7);
+
+    matrix_elementwise_int(MATRIX_MUL, a, b, c, 3);
+    assert(c[1] == 10 && c[2] == -12);
+
+    double x[] = {1.5, -2.0};
+    double y[] = {2.0, 0.25};
+    double z[2];
+
+    matrix_elementwise_float(MATRIX_MUL, x, y, z, 2);
+    assert(z[0] == 3.0 && z[1] == -0.5);
+}
+
+void run_matrix_tests(void) {
+    test_matrix_multiply_matches_naive();
+    test_matrix_transpose();
+    test_matrix_elementwise();
+
+    printf("%s: All tests passed successfully!\n", __FILE__);
+}
@@ -5,7 +5,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "../../src/buffer.h"
 #include "../../src/object.h"
+#include "../../src/smem.h"
+#include "../../src/types.h"
 
 
 static void test_error_object(void) {
@@ -243,6 +246,199 @@ static void test_continue_object(void) {
     object_free(&continue_obj);
 }
 
+static void test_array_object(void) {
+    Type* intArrayType = NEW_ARRAY_TYPE(NEW_INT_TYPE());
+    ARRAY_TYPE_ADD_DIMENSION(intArrayType, NEW_ARRAY_DIMENSION(0));
+
+    Value* values = safe_malloc(2 * sizeof(Value), NULL);
+    values[0] = INT_VALUE(1);
+    values[1] = INT_VALUE(2);
+
+    Object* array_obj = NEW_ARRAY_OBJECT(intArrayType, values, 2);
+    ArrayObject* array = array_obj->object;
+    assert(array->storage == ARRAY_INTS);
+    assert(AS_INT(array_object_get_at(array, 1)) == 2);
+
+    for (int64_t i = 0; i < 1000; i++) {
+        assert(array_object_push(array, INT_VALUE(i)));
+    }
+
+    assert(array->length == 1002 && array->capacity >= 1002);
+    assert(array_object_get_size(array) == array->capacity * sizeof(int64_t));
+
+    array_object_set_at(array, 0, INT_VALUE(-5));
+    assert(AS_INT(array_object_get_at(array, 0)) == -5);
+    assert(AS_INT(array_object_pop(array)) == 999);
+    assert(array->length == 1001);
+
+    assert(array_object_reserve(array, 4096));
+    assert(array->capacity == 4096 && array->length == 1001);
+
+    while (array->length > 0) {
+        array_object_pop(array);
+    }
+
+    Object* error_obj = AS_OBJECT(array_object_pop(array));
+    assert(error_obj->type == OBJ_ERROR);
+    object_free(&error_obj);
+
+    object_free(&array_obj);
+
+    Type* stringArrayType = NEW_ARRAY_TYPE(NEW_STRING_TYPE());
+    ARRAY_TYPE_ADD_DIMENSION(stringArrayType, NEW_ARRAY_DIMENSION(0));
+
+    Object* strings_obj = NEW_ARRAY_OBJECT(stringArrayType, safe_malloc(sizeof(Value), NULL), 0);
+    ArrayObject* strings = strings_obj->object;
+    assert(strings->storage == ARRAY_VALUES);
+
+    Object* rose = NEW_STRING_OBJECT("rose");
+    assert(array_object_push(strings, OBJECT_VALUE(rose)));
+    assert(array_object_push(strings, CHAR_VALUE('!')));
+
+    ByteBuffer* bb = byte_buffer_new();
+    array_object_to_string(bb, &strings);
+
+    char* str = byte_buffer_to_string(bb);
+    assert(strcmp(str, "[rose, !]") == 0);
+
+    safe_free((void**) &str);
+    byte_buffer_free(&bb);
+    object_free(&rose);
+    object_free(&strings_obj);
+}
+
+static void test_dense_array_object(void) {
+    Type* matrixType = NEW_ARRAY_TYPE(NEW_INT_TYPE());
+    ARRAY_TYPE_ADD_DIMENSION(matrixType, NEW_ARRAY_DIMENSION(2));
+    ARRAY_TYPE_ADD_DIMENSION(matrixType, NEW_ARRAY_DIMENSION(3));
+
+    Value* values = safe_malloc(4 * sizeof(Value), NULL);
+    for (int i = 0; i < 4; i++) {
+        values[i] = INT_VALUE(i + 1);
+    }
+
+    Object* matrix_obj = NEW_ARRAY_OBJECT(type_intern(matrixType), values, 4);
+    ArrayObject* matrix = matrix_obj->object;
+    assert(matrix->rank == 2 && matrix->storage == ARRAY_INTS);
+    assert(matrix->length == 6 && array_object_get_length(matrix) == 2);
+    assert(matrix->strides[0] == 3 && matrix->strides[1] == 1);
+
+    int64_t cell[] = {1, 0};
+    assert(AS_INT(array_object_get_index(matrix, cell, 2)) == 4);
+    assert(AS_INT(array_object_set_index(matrix, cell, 2, INT_VALUE(40))) == 40);
+    assert(matrix->ints[3] == 40);
+
+    int64_t outside[] = {0, 3};
+    Object* error_obj = AS_OBJECT(array_object_get_index(matrix, outside, 2));
+    assert(error_obj->type == OBJ_ERROR);
+    object_free(&error_obj);
+
+    Object* row_obj = AS_OBJECT(array_object_get_index(matrix, cell, 1));
+    ArrayObject* row = row_obj->object;
+    assert(row->rank == 1 && row->length == 3);
+    assert(row->ints[0] == 40 && row->ints[1] == 0);
+
+    int64_t first[] = {0};
+    array_object_set_index(matrix, first, 1, OBJECT_VALUE(row_obj));
+    assert(matrix->ints[0] == 40 && matrix->ints[2] == 0);
+
+    assert(!array_object_push(matrix, INT_VALUE(1)));
+
+    ByteBuffer* bb = byte_buffer_new();
+    array_object_to_string(bb, &matrix);
+
+    char* str = byte_buffer_to_string(bb);
+    assert(strcmp(str, "[[40, 0, 0], [40, 0, 0]]") == 0);
+
+    safe_free((void**) &str);
+    byte_buffer_free(&bb);
+    object_free(&row_obj);
+    object_free(&matrix_obj);
+}
+
+static void test_map_object(void) {
+    Object* map_obj = NEW_MAP_OBJECT(type_intern(NEW_MAP_TYPE(NEW_STRING_TYPE(), NEW_INT_TYPE())), 0);
+    MapObject* map = map_obj->object;
+
+    Object* first = NEW_STRING_OBJECT("ann");
+    Object* same = NEW_STRING_OBJECT("ann");
+    Object* other = NEW_STRING_OBJECT("bob");
+
+    Value value = NIL_VALUE();
+    assert(!map_object_get(map, OBJECT_VALUE(first), &value));
+    assert(AS_INT(map_object_zero(map)) == 0);
+
+    assert(map_object_set(map, OBJECT_VALUE(first), INT_VALUE(31)));
+    assert(map_object_set(map, OBJECT_VALUE(same), INT_VALUE(32)));
+    assert(map_object_set(map, OBJECT_VALUE(other), INT_VALUE(27)));
+    assert(map_object_get_length(map) == 2);
+
+    assert(map_object_get(map, OBJECT_VALUE(first), &value) && AS_INT(value) == 32);
+    assert(map_object_delete(map, OBJECT_VALUE(same)));
+    assert(!map_object_delete(map, OBJECT_VALUE(first)));
+    assert(map_object_get_length(map) == 1);
+
+    ByteBuffer* bb = byte_buffer_new();
+    map_object_to_string(bb, &map);
+
+    char* str = byte_buffer_to_string(bb);
+    assert(strcmp(str, "{bob: 27}") == 0);
+
+    safe_free((void**) &str);
+    byte_buffer_free(&bb);
+
+    Object* counts_obj = NEW_MAP_OBJECT(type_intern(NEW_MAP_TYPE(NEW_INT_TYPE(), NEW_INT_TYPE())), 0);
+    MapObject* counts = counts_obj->object;
+
+    for (int64_t i = 0; i < 1000; i++) {
+        assert(map_object_set(counts, INT_VALUE(i * 7919), INT_VALUE(i)));
+    }
+
+    assert(map_object_get_length(counts) == 1000);
+    assert(map_object_get_size(counts) >= 1000 * 2 * sizeof(Value));
+    assert(map_object_get(counts, INT_VALUE(999 * 7919), &value) && AS_INT(value) == 999);
+    assert(!map_object_get(counts, INT_VALUE(1), &value));
+
+    object_free(&counts_obj);
+    object_free(&map_obj);
+    object_free(&first);
+    object_free(&same);
+    object_free(&other);
+}
+
+static void test_index_target(void) {
+    Type* rowType = NEW_ARRAY_TYPE(NEW_INT_TYPE());
+    ARRAY_TYPE_ADD_DIMENSION(rowType, NEW_ARRAY_DIMENSION(0));
+    rowType = type_intern(rowType);
+
+    Value* values = safe_malloc(2 * sizeof(Value), NULL);
+    values[0] = INT_VALUE(1);
+    values[1] = INT_VALUE(2);
+
+    Object* row_obj = NEW_ARRAY_OBJECT(rowType, values, 2);
+
+    Object* map_obj = NEW_MAP_OBJECT(type_intern(NEW_MAP_TYPE(NEW_CHAR_TYPE(), type_copy((const Type**) &rowType))), 0);
+    assert(map_object_set(map_obj->object, CHAR_VALUE('a'), OBJECT_VALUE(row_obj)));
+
+    IndexTarget target;
+
+    Value levels[] = { CHAR_VALUE('a'), INT_VALUE(1) };
+    assert(IS_NIL(index_target_resolve(&target, OBJECT_VALUE(map_obj), levels, 2)));
+    assert(target.container == row_obj && target.count == 1 && target.indices[0] == 1);
+
+    assert(IS_NIL(index_target_resolve(&target, OBJECT_VALUE(map_obj), levels, 1)));
+    assert(target.container == map_obj && AS_CHAR(target.key) == 'a');
+
+    Value missing[] = { CHAR_VALUE('b'), INT_VALUE(0) };
+    Value error = index_target_resolve(&target, OBJECT_VALUE(map_obj), missing, 2);
+    assert(IS_OBJECT(error) && AS_OBJECT(error)->type == OBJ_ERROR);
+
+    Object* error_obj = AS_OBJECT(error);
+    object_free(&error_obj);
+    object_free(&map_obj);
+    object_free(&row_obj);
+}
+
 void run_object_tests(void) {
     test_error_object();
     test_integer_object();
@@ -254,6 +450,10 @@ void run_object_tests(void) {
     test_return_object();
     test_break_object();
     test_continue_object();
+    test_array_object();
+    test_dense_array_object();
+    test_map_object();
+    test_index_target();
 
     printf("%s: All tests passed successfully!\n", __FILE__);
 }
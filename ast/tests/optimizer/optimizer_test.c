@@ -0,0 +1,166 @@
+#include "optimizer_test.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../../src/ast.h"
+#include "../../src/list.h"
+#include "../../src/literal-type.h"
+#include "../../src/optimizer.h"
+#include "../../src/token.h"
+
+
+static LiteralExpr* literal_of(Expr* expression) {
+    assert(expression != NULL);
+    assert(expression->type == LITERAL_EXPR);
+
+    return expression->expr;
+}
+
+static int int_of(Expr* expression) {
+    LiteralExpr* literal = literal_of(expression);
+    assert(literal->type == INT_LITERAL);
+
+    return ((IntLiteral*) literal->value)->value;
+}
+
+static Expr* binary(Expr* left, TokenType op, char* literal, Expr* right) {
+    return NEW_BINARY_EXPR(left, NEW_TOKEN(op, literal, 1), right);
+}
+
+static void test_fold_constant_expressions(void) {
+    List* declarations = list_new((void (*)(void**)) decl_free);
+
+    /* let a = (1 + 2) * 3 */
+    Decl* letA = NEW_LET_DECL(NEW_TOKEN(TOKEN_IDENT, "a", 1), NULL, binary(
+        NEW_GROUP_EXPR(binary(NEW_INT_LITERAL(1), TOKEN_ADD, "+", NEW_INT_LITERAL(2))),
+        TOKEN_MUL, "*", NEW_INT_LITERAL(3)));
+    list_insert_last(&declarations, letA);
+
+    /* let b = 7 / 0 has to fail at runtime, so it stays */
+    Decl* letB = NEW_LET_DECL(NEW_TOKEN(TOKEN_IDENT, "b", 1), NULL,
+        binary(NEW_INT_LITERAL(7), TOKEN_QUO, "/", NEW_INT_LITERAL(0)));
+    list_insert_last(&declarations, letB);
+
+    /* let c = 1 < 2.5 */
+    Decl* letC = NEW_LET_DECL(NEW_TOKEN(TOKEN_IDENT, "c", 1), NULL,
+        binary(NEW_INT_LITERAL(1), TOKEN_LSS, "<", NEW_FLOAT_LITERAL(2.5)));
+    list_insert_last(&declarations, letC);
+
+    optimize(declarations, OPTIMIZER_LOCAL);
+
+    assert(int_of(((LetDecl*) letA->decl)->expression) == 9);
+    assert(((LetDecl*) letB->decl)->expression->type == BINARY_EXPR);
+
+    LiteralExpr* c = literal_of(((LetDecl*) letC->decl)->expression);
+    assert(c->type == BOOL_LITERAL);
+    assert(((BoolLiteral*) c->value)->value);
+
+    list_free(&declarations);
+}
+
+static void test_propagate_constants(void) {
+    List* declarations = list_new((void (*)(void**)) decl_free);
+
+    list_insert_last(&declarations, NEW_CONST_DECL(NEW_TOKEN(TOKEN_IDENT, "N", 1), NULL, NEW_INT_LITERAL(4)));
+    list_insert_last(&declarations, NEW_CONST_DECL(NEW_TOKEN(TOKEN_IDENT, "M", 1), NULL, NEW_INT_LITERAL(1)));
+
+    /* let a = N * 2 */
+    Decl* letA = NEW_LET_DECL(NEW_TOKEN(TOKEN_IDENT, "a", 1), NULL,
+        binary(NEW_IDENT_LITERAL("N"), TOKEN_MUL, "*", NEW_INT_LITERAL(2)));
+    list_insert_last(&declarations, letA);
+
+    /* M is written somewhere, so it is never treated as a constant */
+    Decl* letB = NEW_LET_DECL(NEW_TOKEN(TOKEN_IDENT, "b", 1), NULL, NEW_IDENT_LITERAL("M"));
+    list_insert_last(&declarations, letB);
+    list_insert_last(&declarations, NEW_STMT_DECL(
+        NEW_EXPR_STMT(NEW_UPDATE_EXPR(NEW_IDENT_LITERAL("M"), NEW_TOKEN(TOKEN_INC, "++", 1)))
+    ));
+
+    /* func f(N) { return N; } sees its parameter, not the constant */
+    Expr* useN = NEW_IDENT_LITERAL("N");
+    Stmt* body = NEW_BLOCK_STMT();
+    block_stmt_add_declaration((BlockStmt**) &body->stmt, NEW_STMT_DECL(NEW_RETURN_STMT(useN)));
+
+    List* parameters = list_new((void (*)(void**)) decl_free);
+    list_insert_last(&parameters, NEW_FIELD_DECL(NEW_TOKEN(TOKEN_IDENT, "N", 1), NULL));
+    list_insert_last(&declarations, NEW_FUNCTION_DECL_WITH_PARAMS(NEW_TOKEN(TOKEN_IDENT, "f", 1), parameters, body));
+
+    optimize(declarations, OPTIMIZER_LOCAL);
+
+    assert(int_of(((LetDecl*) letA->decl)->expression) == 8);
+    assert(literal_of(((LetDecl*) letB->decl)->expression)->type == IDENT_LITERAL);
+    assert(literal_of(useN)->type == IDENT_LITERAL);
+
+    list_free(&declarations);
+}
+
+static void test_prune_dead_code(void) {
+    List* declarations = list_new((void (*)(void**)) decl_free);
+
+    /* if (false) { a++ } disappears */
+    Stmt* deadBranch = NEW_BLOCK_STMT();
+    block_stmt_add_declaration((BlockStmt**) &deadBranch->stmt, NEW_STMT_DECL(
+        NEW_EXPR_STMT(NEW_UPDATE_EXPR(NEW_IDENT_LITERAL("a"), NEW_TOKEN(TOKEN_INC, "++", 1)))
+    ));
+    list_insert_last(&declarations, NEW_STMT_DECL(NEW_IF_STMT(NEW_BOOL_LITERAL(false), deadBranch, NULL)));
+
+    /* if (1 < 2) { ... } else { ... } becomes its then block */
+    Stmt* thenBranch = NEW_BLOCK_STMT();
+    Stmt* elseBranch = NEW_BLOCK_STMT();
+    Decl* taken = NEW_STMT_DECL(NEW_IF_STMT(
+        binary(NEW_INT_LITERAL(1), TOKEN_LSS, "<", NEW_INT_LITERAL(2)), thenBranch, elseBranch));
+    list_insert_last(&declarations, taken);
+
+    /* func f() { return 1; a++; } */
+    Stmt* body = NEW_BLOCK_STMT();
+    block_stmt_add_declaration((BlockStmt**) &body->stmt, NEW_STMT_DECL(NEW_RETURN_STMT(NEW_INT_LITERAL(1))));
+    block_stmt_add_declaration((BlockStmt**) &body->stmt, NEW_STMT_DECL(
+        NEW_EXPR_STMT(NEW_UPDATE_EXPR(NEW_IDENT_LITERAL("a"), NEW_TOKEN(TOKEN_INC, "++", 1)))
+    ));
+    list_insert_last(&declarations, NEW_FUNCTION_DECL(NEW_TOKEN(TOKEN_IDENT, "f", 1), body));
+
+    optimize(declarations, OPTIMIZER_LOCAL);
+
+    assert(list_size(&declarations) == 2);
+    assert(list_get_at(&declarations, 0) == taken);
+    assert(((StmtDecl*) taken->decl)->stmt == thenBranch);
+    assert(vector_size(&((BlockStmt*) body->stmt)->declarations) == 1);
+
+    list_free(&declarations);
+}
+
+static void test_drop_unreached_functions(void) {
+    List* declarations = list_new((void (*)(void**)) decl_free);
+
+    /* main calls helper, helper calls itself, unused is never named */
+    Stmt* helperBody = NEW_BLOCK_STMT();
+    block_stmt_add_declaration((BlockStmt**) &helperBody->stmt, NEW_STMT_DECL(
+        NEW_RETURN_STMT(NEW_CALL_EXPR(NEW_IDENT_LITERAL("helper")))));
+    Decl* helper = NEW_FUNCTION_DECL(NEW_TOKEN(TOKEN_IDENT, "helper", 1), helperBody);
+
+    Decl* unused = NEW_FUNCTION_DECL(NEW_TOKEN(TOKEN_IDENT, "unused", 1), NEW_BLOCK_STMT());
+
+    list_insert_last(&declarations, unused);
+    list_insert_last(&declarations, helper);
+    list_insert_last(&declarations, NEW_STMT_DECL(NEW_EXPR_STMT(NEW_CALL_EXPR(NEW_IDENT_LITERAL("helper")))));
+
+    optimize(declarations, OPTIMIZER_LOCAL);
+    assert(list_size(&declarations) == 3);
+
+    optimize(declarations, OPTIMIZER_FULL);
+    assert(list_size(&declarations) == 2);
+    assert(list_get_at(&declarations, 0) == helper);
+
+    list_free(&declarations);
+}
+
+void run_optimizer_tests(void) {
+    test_fold_constant_expressions();
+    test_propagate_constants();
+    test_prune_dead_code();
+    test_drop_unreached_functions();
+
+    printf("%s: All tests passed successfully!\n", __FILE__);
+}
@@ -0,0 +1,121 @@
+#include "output_test.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../../src/buffer.h"
+#include "../../src/object.h"
+#include "../../src/output.h"
+#include "../../src/value.h"
+
+
+/* stdout is pointed at a pipe so what reaches the descriptor can be read back */
+static int capture[2];
+static int savedStdout;
+
+static void capture_begin(void) {
+    fflush(stdout);
+    assert(pipe(capture) == 0);
+
+    savedStdout = dup(STDOUT_FILENO);
+    dup2(capture[1], STDOUT_FILENO);
+    close(capture[1]);
+}
+
+static size_t capture_read(char* text, size_t size) {
+    dup2(savedStdout, STDOUT_FILENO);
+    close(savedStdout);
+
+    size_t length = 0;
+    ssize_t got = 0;
+
+    while (length < size - 1 && (got = read(capture[0], text + length, size - 1 - length)) > 0) {
+        length += got;
+    }
+
+    text[length] = '\0';
+    close(capture[0]);
+
+    return length;
+}
+
+static void test_output_fully_buffered(void) {
+    output_configure(16, OUTPUT_FULLY_BUFFERED);
+    capture_begin();
+
+    Value arguments[] = {INT_VALUE(42), CHAR_VALUE(' '), BOOL_VALUE(true)};
+    println_function_run(NULL, NULL, arguments, 3);
+
+    /* nothing is written until the threshold, flush() or the end */
+    assert(strcmp(output_buffer()->bytes, "42 true\n") == 0);
+
+    println_function_run(NULL, NULL, arguments, 3);
+    assert(byte_buffer_size(output_buffer()) == 0);
+
+    print_function_run(NULL, NULL, arguments, 1);
+    flush_function_run(NULL, NULL, NULL, 0);
+    assert(byte_buffer_size(output_buffer()) == 0);
+
+    char text[64];
+    capture_read(text, sizeof(text));
+    assert(strcmp(text, "42 true\n42 true\n42") == 0);
+
+    output_free();
+}
+
+static void test_output_line_buffered(void) {
+    output_configure(1024, OUTPUT_LINE_BUFFERED);
+    capture_begin();
+
+    Value arguments[] = {INT_VALUE(7)};
+    print_function_run(NULL, NULL, arguments, 1);
+    assert(byte_buffer_size(output_buffer()) == 1);
+
+    println_function_run(NULL, NULL, arguments, 1);
+    assert(byte_buffer_size(output_buffer()) == 0);
+
+    char text[64];
+    capture_read(text, sizeof(text));
+    assert(strcmp(text, "77\n") == 0);
+
+    output_configure(OUTPUT_DEFAULT_CAPACITY, OUTPUT_AUTO);
+}
+
+static void test_output_captured(void) {
+    output_configure(1024, OUTPUT_LINE_BUFFERED);
+    capture_begin();
+
+    output_printf("before ");
+
+    ByteBuffer* captured = byte_buffer_new();
+    output_capture(captured);
+
+    Value arguments[] = {INT_VALUE(7)};
+    println_function_run(NULL, NULL, arguments, 1);
+    output_printf("%s: %d\n", "status", 1);
+    flush_function_run(NULL, NULL, NULL, 0);
+
+    /* held for the caller whatever the mode, nothing reached the descriptor */
+    assert(output_buffer() == captured);
+    assert(strcmp(captured->bytes, "7\nstatus: 1\n") == 0);
+
+    output_capture(NULL);
+    output_printf("after\n");
+
+    char text[64];
+    capture_read(text, sizeof(text));
+    assert(strcmp(text, "before after\n") == 0);
+
+    byte_buffer_free(&captured);
+    output_configure(OUTPUT_DEFAULT_CAPACITY, OUTPUT_AUTO);
+}
+
+void run_output_tests(void) {
+    test_output_fully_buffered();
+    test_output_line_buffered();
+    test_output_captured();
+
+    printf("%s: All tests passed successfully!\n", __FILE__);
+}
@@ -0,0 +1,193 @@
+#include "reader_test.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../../src/reader.h"
+#include "../../src/symbol.h"
+#include "../../src/types.h"
+
+
+static void assert_line(Reader* reader, const char* expected) {
+    const char* line = NULL;
+    size_t length = 0;
+
+    assert(reader_has_line(reader));
+    assert(reader_next_line(reader, &line, &length));
+    assert(length == strlen(expected) && memcmp(line, expected, length) == 0);
+}
+
+static char* temporary_file(const char* content) {
+    static char path[] = "/tmp/rose_reader_testXXXXXX";
+    strcpy(path, "/tmp/rose_reader_testXXXXXX");
+
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    assert(write(fd, content, strlen(content)) == (ssize_t) strlen(content));
+    close(fd);
+
+    return path;
+}
+
+static void test_reader_mapped_file(void) {
+    char* path = temporary_file("first\n\nthird\nlast without newline");
+
+    Reader* reader = reader_open(path);
+    assert(reader != NULL && reader->mapped);
+
+    assert_line(reader, "first");
+    assert_line(reader, "");
+    assert_line(reader, "third");
+    assert_line(reader, "last without newline");
+
+    const char* line = NULL;
+    size_t length = 0;
+    assert(!reader_has_line(reader));
+    assert(!reader_next_line(reader, &line, &length));
+
+    reader_free(&reader);
+    assert(reader == NULL);
+
+    reader = reader_open(path);
+    assert_line(reader, "first");
+
+    const char* rest = NULL;
+    assert(reader_rest(reader, &rest, &length));
+    assert(length == strlen("\nthird\nlast without newline"));
+    assert(!reader_has_line(reader));
+
+    reader_free(&reader);
+
+    assert(reader_open("/nonexistent/rose/file") == NULL);
+
+    unlink(path);
+}
+
+/* a line longer than one chunk makes the buffer grow instead of splitting it */
+static void test_reader_stream(void) {
+    size_t longLength = READER_CHUNK_SIZE * 2 + 17;
+
+    int channel[2];
+    assert(pipe(channel) == 0);
+
+    pid_t writer = fork();
+    assert(writer >= 0);
+
+    if (writer == 0) {
+        close(channel[0]);
+
+        char* longLine = malloc(longLength);
+        memset(longLine, 'x', longLength);
+
+        ssize_t ignored = write(channel[1], "one\ntwo\n", 8);
+        ignored = write(channel[1], longLine, longLength);
+        ignored = write(channel[1], "\nend", 4);
+        (void) ignored;
+
+        _exit(0);
+    }
+
+    close(channel[1]);
+
+    int savedStdin = dup(STDIN_FILENO);
+    dup2(channel[0], STDIN_FILENO);
+    close(channel[0]);
+
+    Reader* reader = reader_open(NULL);
+    assert(reader != NULL && !reader->mapped);
+
+    assert_line(reader, "one");
+    assert_line(reader, "two");
+
+    const char* line = NULL;
+    size_t length = 0;
+    assert(reader_next_line(reader, &line, &length));
+    assert(length == longLength && line[0] == 'x' && line[length - 1] == 'x');
+    assert(reader->capacity > READER_CHUNK_SIZE);
+
+    assert_line(reader, "end");
+    assert(!reader_has_line(reader));
+
+    reader_free(&reader);
+
+    dup2(savedStdin, STDIN_FILENO);
+    close(savedStdin);
+
+    waitpid(writer, NULL, 0);
+}
+
+static void test_reader_for_path(void) {
+    char* path = temporary_file("a\nb\n");
+
+    Reader* reader = reader_for(path);
+    assert(reader != NULL && reader_for(path) == reader);
+
+    assert_line(reader, "a");
+
+    /* closing drops the position, the next reader starts over */
+    reader_close(path);
+
+    reader = reader_for(path);
+    assert_line(reader, "a");
+    assert_line(reader, "b");
+
+    reader_close_all();
+
+    unlink(path);
+}
+
+static void assert_source(const char* path, const char* expected, bool mapped) {
+    Source* source = source_open(path);
+    assert(source != NULL);
+    assert((source->reserved > 0) == mapped);
+
+    size_t length = strlen(expected);
+    assert(source->size == length && memcmp(source->text, expected, length) == 0);
+    assert(source->text[length] == '\0' && source->text[length + 1] == '\0');
+
+    /* the lexer writes into the text, never into the file */
+    if (length > 0) {
+        source->text[0] = '\0';
+    }
+
+    source_free(&source);
+    assert(source == NULL);
+}
+
+static void test_source_open(void) {
+    char* path = temporary_file("let x = 1;\n");
+    assert_source(path, "let x = 1;\n", true);
+
+    Source* source = source_open(path);
+    assert(source->text[0] == 'l');
+    source_free(&source);
+    unlink(path);
+
+    /* a file filling its last page exactly still gets its NULs, from the extra page */
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    char* full = malloc(page + 1);
+    memset(full, 'a', page);
+    full[page] = '\0';
+
+    path = temporary_file(full);
+    assert_source(path, full, true);
+    unlink(path);
+    free(full);
+
+    assert_source("/dev/null", "", false);
+    assert(source_open("/nonexistent/rose/file") == NULL);
+}
+
+void run_reader_tests(void) {
+    test_reader_mapped_file();
+    test_reader_stream();
+    test_reader_for_path();
+    test_source_open();
+
+    printf("%s: All tests passed successfully!\n", __FILE__);
+}
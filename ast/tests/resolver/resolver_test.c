@@ -0,0 +1,171 @@
+#include "resolver_test.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../../src/ast.h"
+#include "../../src/list.h"
+#include "../../src/literal-type.h"
+#include "../../src/resolver.h"
+#include "../../src/token.h"
+
+
+static char* builtins[] = {"print", "println"};
+
+static IdentLiteral* ident_of(Expr* expression) {
+    return ((LiteralExpr*) expression->expr)->value;
+}
+
+static void test_resolve_global_and_block_slots(void) {
+    List* declarations = list_new((void (*)(void**)) decl_free);
+
+    Decl* letA = NEW_LET_DECL(NEW_TOKEN(TOKEN_IDENT, "a", 1), NULL, NEW_INT_LITERAL(1));
+    list_insert_last(&declarations, letA);
+
+    Expr* useA = NEW_IDENT_LITERAL("a");
+    Expr* useB = NEW_IDENT_LITERAL("b");
+    Decl* letB = NEW_LET_DECL(NEW_TOKEN(TOKEN_IDENT, "b", 1), NULL, useA);
+
+    Stmt* block = NEW_BLOCK_STMT();
+    block_stmt_add_declaration((BlockStmt**) &block->stmt, letB);
+    block_stmt_add_declaration((BlockStmt**) &block->stmt, NEW_STMT_DECL(
+        NEW_EXPR_STMT(NEW_UPDATE_EXPR(useB, NEW_TOKEN(TOKEN_INC, "++", 1)))
+    ));
+
+    list_insert_last(&declarations, NEW_STMT_DECL(block));
+
+    assert(resolve(declarations, builtins, 2) == RESOLVER_SUCCESS);
+
+    assert(((LetDecl*) letA->decl)->slot == 2);
+    assert(((LetDecl*) letB->decl)->slot == 0);
+
+    assert(ident_of(useA)->depth == 1);
+    assert(ident_of(useA)->slot == 2);
+    assert(ident_of(useB)->depth == 0);
+    assert(ident_of(useB)->slot == 0);
+
+    list_free(&declarations);
+}
+
+static void test_resolve_undefined_ident(void) {
+    List* declarations = list_new((void (*)(void**)) decl_free);
+
+    Expr* useC = NEW_IDENT_LITERAL("c");
+    list_insert_last(&declarations, NEW_STMT_DECL(NEW_EXPR_STMT(useC)));
+
+    assert(resolve(declarations, builtins, 2) == RESOLVER_FAILURE);
+    assert(ident_of(useC)->depth == -1);
+    assert(ident_of(useC)->slot == -1);
+
+    list_free(&declarations);
+}
+
+static void test_resolve_scope_layouts(void) {
+    List* declarations = list_new((void (*)(void**)) decl_free);
+
+    Decl* letA = NEW_LET_DECL(NEW_TOKEN(TOKEN_IDENT, "a", 1), NULL, NEW_INT_LITERAL(1));
+    list_insert_last(&declarations, letA);
+
+    /* { a++ } declares nothing, so it runs in the global scope */
+    Expr* useA = NEW_IDENT_LITERAL("a");
+    Stmt* emptyBlock = NEW_BLOCK_STMT();
+    block_stmt_add_declaration((BlockStmt**) &emptyBlock->stmt, NEW_STMT_DECL(
+        NEW_EXPR_STMT(NEW_UPDATE_EXPR(useA, NEW_TOKEN(TOKEN_INC, "++", 1)))
+    ));
+    list_insert_last(&declarations, NEW_STMT_DECL(emptyBlock));
+
+    /* fn f(x) { let y = x; fn g() { y++ } } */
+    Expr* useX = NEW_IDENT_LITERAL("x");
+    Expr* useY = NEW_IDENT_LITERAL("y");
+
+    Stmt* innerBody = NEW_BLOCK_STMT();
+    block_stmt_add_declaration((BlockStmt**) &innerBody->stmt, NEW_STMT_DECL(
+        NEW_EXPR_STMT(NEW_UPDATE_EXPR(useY, NEW_TOKEN(TOKEN_INC, "++", 1)))
+    ));
+    Decl* g = NEW_FUNCTION_DECL(NEW_TOKEN(TOKEN_IDENT, "g", 1), innerBody);
+
+    Stmt* outerBody = NEW_BLOCK_STMT();
+    block_stmt_add_declaration((BlockStmt**) &outerBody->stmt,
+        NEW_LET_DECL(NEW_TOKEN(TOKEN_IDENT, "y", 1), NULL, useX));
+    block_stmt_add_declaration((BlockStmt**) &outerBody->stmt, g);
+
+    List* parameters = list_new((void (*)(void**)) decl_free);
+    list_insert_last(&parameters, NEW_FIELD_DECL(NEW_TOKEN(TOKEN_IDENT, "x", 1), NULL));
+    Decl* f = NEW_FUNCTION_DECL_WITH_PARAMS(NEW_TOKEN(TOKEN_IDENT, "f", 1), parameters, outerBody);
+    list_insert_last(&declarations, f);
+
+    assert(resolve(declarations, builtins, 2) == RESOLVER_SUCCESS);
+
+    assert(((BlockStmt*) emptyBlock->stmt)->scope.size == 0);
+    assert(ident_of(useA)->depth == 0);
+    assert(ident_of(useA)->slot == 2);
+
+    FunctionDecl* fDecl = f->decl;
+    assert(fDecl->scope.size == 1);
+    assert(fDecl->scope.isCapturable);
+    assert(((BlockStmt*) outerBody->stmt)->scope.size == 2);
+    assert(((BlockStmt*) outerBody->stmt)->scope.isCapturable);
+    assert(ident_of(useX)->depth == 1);
+    assert(ident_of(useX)->slot == 0);
+
+    /* g has no parameters and its body declares nothing */
+    FunctionDecl* gDecl = g->decl;
+    assert(gDecl->scope.size == 0);
+    assert(((BlockStmt*) innerBody->stmt)->scope.size == 0);
+    assert(ident_of(useY)->depth == 0);
+    assert(ident_of(useY)->slot == 0);
+
+    list_free(&declarations);
+}
+
+static void test_resolve_one_declaration_at_a_time(void) {
+    Resolver* resolver = resolver_new(builtins, 2);
+    assert(resolver != NULL);
+
+    /* func f() { a++ } before a exists, then let a = 1; a++ */
+    Expr* early = NEW_IDENT_LITERAL("a");
+    Stmt* body = NEW_BLOCK_STMT();
+    block_stmt_add_declaration((BlockStmt**) &body->stmt, NEW_STMT_DECL(
+        NEW_EXPR_STMT(NEW_UPDATE_EXPR(early, NEW_TOKEN(TOKEN_INC, "++", 1)))
+    ));
+    Decl* f = NEW_FUNCTION_DECL(NEW_TOKEN(TOKEN_IDENT, "f", 1), body);
+
+    assert(resolve_next(resolver, f) == RESOLVER_FAILURE);
+    assert(((FunctionDecl*) f->decl)->slot == 2);
+    assert(ident_of(early)->slot == -1);
+
+    resolver_free(&resolver);
+    assert(resolver == NULL);
+
+    resolver = resolver_new(builtins, 2);
+
+    Decl* letA = NEW_LET_DECL(NEW_TOKEN(TOKEN_IDENT, "a", 1), NULL, NEW_INT_LITERAL(1));
+    Expr* useA = NEW_IDENT_LITERAL("a");
+    Decl* update = NEW_STMT_DECL(NEW_EXPR_STMT(NEW_UPDATE_EXPR(useA, NEW_TOKEN(TOKEN_INC, "++", 1))));
+    Decl* redeclared = NEW_LET_DECL(NEW_TOKEN(TOKEN_IDENT, "a", 2), NULL, NEW_INT_LITERAL(2));
+
+    assert(resolve_next(resolver, letA) == RESOLVER_SUCCESS);
+    assert(resolve_next(resolver, update) == RESOLVER_SUCCESS);
+    assert(resolve_next(resolver, redeclared) == RESOLVER_SUCCESS);
+
+    assert(((LetDecl*) letA->decl)->slot == 2);
+    assert(ident_of(useA)->depth == 0 && ident_of(useA)->slot == 2);
+    assert(((LetDecl*) redeclared->decl)->slot == 2);
+
+    resolver_free(&resolver);
+
+    decl_free(&f);
+    decl_free(&letA);
+    decl_free(&update);
+    decl_free(&redeclared);
+}
+
+void run_resolver_tests(void) {
+    test_resolve_global_and_block_slots();
+    test_resolve_undefined_ident();
+    test_resolve_scope_layouts();
+    test_resolve_one_declaration_at_a_time();
+
+    printf("%s: All tests passed successfully!\n", __FILE__);
+}
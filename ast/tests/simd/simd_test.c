@@ -0,0 +1,128 @@
+#include "simd_test.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "../../src/simd.h"
+
+
+/* not a multiple of any vector width, so every level runs its tail loop */
+#define SIZE 67
+
+static int64_t ints[SIZE];
+static int64_t others[SIZE];
+static double floats[SIZE];
+static double halves[SIZE];
+
+static void fill_inputs(void) {
+    for (size_t i = 0; i < SIZE; i++) {
+        ints[i] = (int64_t) (i * 7919 % 101) - 50;
+        others[i] = (int64_t) (i % 9) - 4;
+        /* halves sum exactly in any order */
+        floats[i] = (double) ((int64_t) (i * 31 % 23) - 11) * 0.5;
+        halves[i] = (double) (i % 5) * 0.5;
+    }
+
+    ints[SIZE - 1] = INT64_MAX;
+    floats[SIZE - 1] = -99.5;
+}
+
+static void test_simd_level(void) {
+    assert(simd_kernels() == simd_kernels_for(simd_level()));
+    assert(simd_kernels_for(SIMD_SCALAR) != NULL);
+}
+
+static void test_simd_reductions_match_scalar(const SimdKernels* kernels) {
+    const SimdKernels* scalar = simd_kernels_for(SIMD_SCALAR);
+
+    for (size_t size = 1; size <= SIZE; size++) {
+        assert(kernels->sum_int(ints, size) == scalar->sum_int(ints, size));
+        assert(kernels->min_int(ints, size) == scalar->min_int(ints, size));
+        assert(kernels->max_int(ints, size) == scalar->max_int(ints, size));
+        assert(kernels->dot_int(ints, others, size) == scalar->dot_int(ints, others, size));
+
+        assert(kernels->sum_float(floats, size) == scalar->sum_float(floats, size));
+        assert(kernels->min_float(floats, size) == scalar->min_float(floats, size));
+        assert(kernels->max_float(floats, size) == scalar->max_float(floats, size));
+        assert(kernels->dot_float(floats, halves, size) == scalar->dot_float(floats, halves, size));
+    }
+
+    assert(kernels->sum_int(ints, 0) == 0);
+    assert(kernels->max_int(ints, SIZE) == INT64_MAX);
+    assert(kernels->min_float(floats, SIZE) == -99.5);
+}
+
+static void test_simd_maps_match_scalar(const SimdKernels* kernels) {
+    const SimdKernels* scalar = simd_kernels_for(SIMD_SCALAR);
+
+    int64_t intResult[SIZE], intExpected[SIZE];
+    double floatResult[SIZE], floatExpected[SIZE];
+
+    kernels->add_int(ints, 3, intResult, SIZE);
+    scalar->add_int(ints, 3, intExpected, SIZE);
+    for (size_t i = 0; i < SIZE; i++) {
+        assert(intResult[i] == intExpected[i]);
+    }
+    /* wraps like the interpreter */
+    assert(intResult[SIZE - 1] == INT64_MIN + 2);
+
+    kernels->mul_int(ints, -3, intResult, SIZE);
+    scalar->mul_int(ints, -3, intExpected, SIZE);
+    for (size_t i = 0; i < SIZE; i++) {
+        assert(intResult[i] == intExpected[i]);
+    }
+
+    kernels->add_float(floats, 0.25, floatResult, SIZE);
+    scalar->add_float(floats, 0.25, floatExpected, SIZE);
+    for (size_t i = 0; i < SIZE; i++) {
+        assert(floatResult[i] == floatExpected[i]);
+    }
+
+    kernels->mul_float(floats, -2.0, floatResult, SIZE);
+    scalar->mul_float(floats, -2.0, floatExpected, SIZE);
+    for (size_t i = 0; i < SIZE; i++) {
+        assert(floatResult[i] == floatExpected[i]);
+    }
+
+    for (size_t i = 0; i < SIZE; i++) {
+        intResult[i] = intExpected[i] = others[i];
+        floatResult[i] = floatExpected[i] = halves[i];
+    }
+
+    kernels->axpy_int(5, ints, intResult, SIZE);
+    scalar->axpy_int(5, ints, intExpected, SIZE);
+    kernels->axpy_float(1.5, floats, floatResult, SIZE);
+    scalar->axpy_float(1.5, floats, floatExpected, SIZE);
+    for (size_t i = 0; i < SIZE; i++) {
+        assert(intResult[i] == intExpected[i]);
+        assert(floatResult[i] == floatExpected[i]);
+    }
+
+    kernels->fill_int(intResult, -7, SIZE);
+    kernels->fill_float(floatResult, 2.5, SIZE - 1);
+    for (size_t i = 0; i < SIZE; i++) {
+        assert(intResult[i] == -7);
+    }
+    for (size_t i = 0; i < SIZE - 1; i++) {
+        assert(floatResult[i] == 2.5);
+    }
+    assert(floatResult[SIZE - 1] == floatExpected[SIZE - 1]);
+}
+
+void run_simd_tests(void) {
+    fill_inputs();
+    test_simd_level();
+
+    /* every level this cpu can run, the scalar one included */
+    for (int level = SIMD_SCALAR; level <= SIMD_AVX2; level++) {
+        const SimdKernels* kernels = simd_kernels_for((SimdLevel) level);
+        if (kernels == NULL)
+            continue;
+
+        test_simd_reductions_match_scalar(kernels);
+        test_simd_maps_match_scalar(kernels);
+    }
+
+    printf("%s: All tests passed successfully!\n", __FILE__);
+}
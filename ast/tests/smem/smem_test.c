@@ -1,6 +1,7 @@
 #include "smem_test.h"
 
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
 
 #include "../../src/smem.h"
@@ -55,11 +56,74 @@ static void test_safe_free(void) {
     safe_free(&ptr2);
 }
 
+static void test_smem_pool(void) {
+    SmemPool* pool = smem_pool_new(24, 4);
+    assert(pool != NULL);
+    assert(pool->objectSize % SMEM_SIZE_CLASS_ALIGN == 0);
+
+    void* objects[10];
+    for (size_t i = 0; i < 10; i++) {
+        objects[i] = smem_pool_alloc(pool);
+        assert(objects[i] != NULL);
+        memset(objects[i], (int) i, 24);
+    }
+
+    assert(pool->liveObjects == 10);
+
+    for (size_t i = 0; i < 10; i++) {
+        unsigned char* bytes = objects[i];
+        assert(bytes[0] == i && bytes[23] == i);
+    }
+
+    void* last = objects[9];
+    smem_pool_free(pool, &objects[9]);
+    assert(objects[9] == NULL);
+    assert(pool->liveObjects == 9);
+
+    void* reused = smem_pool_alloc(pool);
+#ifndef SMEM_NO_POOLS
+    assert(reused == last);
+    assert(pool->slabCount == 3);
+#else
+    (void) last;
+#endif
+
+    smem_pool_free(pool, &reused);
+    for (size_t i = 0; i < 9; i++) {
+        smem_pool_free(pool, &objects[i]);
+    }
+
+    assert(pool->liveObjects == 0);
+
+    smem_pool_destroy(&pool);
+    assert(pool == NULL);
+}
+
+static void test_smem_size_classes(void) {
+    assert(smem_size_class(0) == NULL);
+    assert(smem_size_class(SMEM_MAX_SIZE_CLASS + 1) == NULL);
+    assert(smem_size_class(1) == smem_size_class(SMEM_SIZE_CLASS_ALIGN));
+    assert(smem_size_class(17) != smem_size_class(16));
+
+    void* small = smem_alloc(40);
+    void* large = smem_alloc(SMEM_MAX_SIZE_CLASS * 4);
+    assert(small != NULL && large != NULL);
+
+    memset(small, 0, 40);
+    memset(large, 0, SMEM_MAX_SIZE_CLASS * 4);
+
+    smem_free(&small, 40);
+    smem_free(&large, SMEM_MAX_SIZE_CLASS * 4);
+    assert(small == NULL && large == NULL);
+}
+
 void run_smem_tests(void) {
     test_safe_malloc();
     test_safe_calloc();
     test_safe_realloc();
     test_safe_free();
+    test_smem_pool();
+    test_smem_size_classes();
 
     printf("%s: All tests passed successfully!\n", __FILE__);
 }
@@ -0,0 +1,122 @@
+#include "symbol_test.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../../src/literal-type.h"
+#include "../../src/map.h"
+#include "../../src/symbol.h"
+#include "../../src/token.h"
+#include "../../src/utils.h"
+
+
+static void test_symbol_intern(void) {
+    char buffer[] = "counter";
+
+    char* first = symbol_intern("counter");
+    char* second = symbol_intern(buffer);
+
+    assert(first == second);
+    assert(first != buffer);
+    assert(strcmp(first, "counter") == 0);
+
+    /* the copy does not follow later changes to the source */
+    buffer[0] = 'C';
+    assert(symbol_intern(buffer) != first);
+    assert(symbol_intern("counter") == first);
+
+    assert(symbol_hash(first) == hash_string("counter"));
+    assert(symbol_of(first)->length == strlen("counter"));
+
+    assert(symbol_intern(NULL) == NULL);
+}
+
+static void test_symbol_constructors_intern(void) {
+    Token* token = NEW_TOKEN(TOKEN_IDENT, "total", 1);
+    IdentLiteral* ident = ident_literal_new("total");
+
+    assert(token->literal == ident->value);
+    assert(token->literal == symbol_intern("total"));
+
+    token_free(&token);
+    ident_literal_free(&ident);
+
+    /* freeing the nodes leaves the shared name alone */
+    assert(strcmp(symbol_intern("total"), "total") == 0);
+}
+
+static void test_symbol_map(void) {
+    Map* map = SYMBOL_MAP_NEW(4, NULL);
+
+    char* names[20];
+    for (size_t i = 0; i < 20; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "name%zu", i);
+        names[i] = symbol_intern(name);
+        map_put(map, names[i], names[i]);
+    }
+
+    assert(map_size(map) == 20);
+
+    for (size_t i = 0; i < 20; i++) {
+        assert(map_get(map, symbol_intern(names[i])) == names[i]);
+    }
+
+    map_remove(map, names[3]);
+    assert(!map_contains(map, names[3]));
+    assert(map_get(map, names[4]) == names[4]);
+
+    map_free(&map);
+}
+
+typedef struct Interned {
+    const SymbolTable* builtins;
+    char* counter;
+    char* print;
+} Interned;
+
+static void* intern_on_thread(void* context) {
+    Interned* interned = context;
+    SymbolTable* table = symbol_table_new(interned->builtins);
+
+    interned->counter = symbol_table_intern(table, "counter");
+    interned->print = symbol_table_intern(table, "print");
+    assert(symbol_table_intern(table, "counter") == interned->counter);
+
+    /* print was found in the builtins, only counter was copied */
+    assert(symbol_table_size(table) == 1);
+
+    symbol_table_free(&table);
+    return NULL;
+}
+
+static void test_symbol_tables(void) {
+    SymbolTable* builtins = symbol_table_new(NULL);
+    char* print = symbol_table_intern(builtins, "print");
+    char* name = symbol_intern("counter");
+
+    Interned interned = {.builtins = builtins};
+    pthread_t thread;
+    assert(pthread_create(&thread, NULL, intern_on_thread, &interned) == 0);
+    assert(pthread_join(thread, NULL) == 0);
+
+    /* the other table was freed without touching the active one */
+    assert(interned.counter != NULL && interned.counter != name);
+    assert(interned.print == print);
+    assert(symbol_intern("counter") == name);
+    assert(strcmp(name, "counter") == 0);
+
+    symbol_table_free(&builtins);
+    assert(symbol_table_active() != NULL);
+}
+
+void run_symbol_tests(void) {
+    test_symbol_intern();
+    test_symbol_constructors_intern();
+    test_symbol_map();
+    test_symbol_tables();
+
+    printf("%s: All tests passed successfully!\n", __FILE__);
+}
@@ -92,11 +92,65 @@ static void test_token_is_keyword(void) {
     token_free(&ident_tok3);
 }
 
+static void test_token_new_at(void) {
+    const char* source = "let counter = \"text\";";
+    token_set_source(source);
+
+    Span ident = {4, 7};
+    Token* tok = token_new_at(TOKEN_IDENT, ident, 3);
+
+    assert(tok != NULL);
+    assert(strcmp(tok->literal, "counter") == 0);
+    assert(tok->span.offset == 4 && tok->span.length == 7);
+    assert(tok->line == 3);
+
+    /* the name is interned, the same pointer as any other spelling of it */
+    assert(tok->literal == span_intern(ident));
+
+    Span string = {14, 6};
+    assert(span_text(string) == source + 14);
+    assert(strncmp(span_text(string), "\"text\"", string.length) == 0);
+
+    token_free(&tok);
+    token_set_source(NULL);
+}
+
+static void test_token_stream(void) {
+    /* no source set: the text comes from the lexer's buffer and is copied out */
+    char buffer[] = "let first = second;";
+
+    Span first = span_of(buffer + 4, 5);
+    Span second = span_of(buffer + 12, 6);
+    assert(first.offset == 0 && first.length == 5);
+    assert(second.offset == 5 && second.length == 6);
+
+    /* the lexer refills its buffer, the copies stay */
+    memset(buffer, 'x', sizeof(buffer) - 1);
+    assert(strncmp(span_text(first), "first", first.length) == 0);
+    assert(strcmp(span_intern(second), "second") == 0);
+
+    /* the token scanned last may start the next declaration, so it is kept */
+    token_stream_discard();
+    assert(strncmp(span_text(second), "second", second.length) == 0);
+
+    Span third = span_of("third", 5);
+    assert(third.offset == 11);
+    assert(strncmp(span_text(third), "third", third.length) == 0);
+
+    Token* tok = token_new_at(TOKEN_IDENT, second, 1);
+    assert(strcmp(tok->literal, "second") == 0);
+    token_free(&tok);
+
+    token_stream_free();
+}
+
 void run_token_tests(void) {
     test_token_new();
     test_token_is_literal();
     test_token_is_operator();
     test_token_is_keyword();
+    test_token_new_at();
+    test_token_stream();
 
     printf("%s: All tests passed successfully!\n", __FILE__);
 }
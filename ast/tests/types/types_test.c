@@ -285,6 +285,123 @@ void test_all_copy_functions(void) {
     type_free(&funcType1Copy);
 }
 
+void test_interned_types_are_canonical(void) {
+    assert(NEW_INT_TYPE() == NEW_INT_TYPE());
+    assert(NEW_CUSTOM_TYPE(0, "User") == NEW_CUSTOM_TYPE(0, "User"));
+    assert(NEW_ARRAY_DIMENSION(3) == NEW_ARRAY_DIMENSION(3));
+
+    Type* array1 = NEW_ARRAY_TYPE(NEW_STRING_TYPE());
+    ARRAY_TYPE_ADD_DIMENSIONS(array1,
+        NEW_ARRAY_DIMENSION(3),
+        NEW_ARRAY_DIMENSION(3),
+    );
+
+    Type* array2 = NEW_ARRAY_TYPE(NEW_STRING_TYPE());
+    ARRAY_TYPE_ADD_DIMENSIONS(array2,
+        NEW_ARRAY_DIMENSION(3),
+        NEW_ARRAY_DIMENSION(3),
+    );
+
+    Type* array1Copy = type_copy((const Type**) &array1);
+
+    assert(array1->interned == false);
+    assert(array1Copy->interned == true);
+    assert(type_copy((const Type**) &array1Copy) == array1Copy);
+
+    size_t size = type_table_size(type_table_active());
+
+    array1 = type_intern(array1);
+    array2 = type_intern(array2);
+
+    assert(array1 == array1Copy);
+    assert(array2 == array1Copy);
+    assert(type_table_size(type_table_active()) == size);
+
+    Type* funcType1 = NEW_FUNCTION_TYPE_WITH_RETURN(NEW_VOID_TYPE());
+    FUNCTION_TYPE_ADD_PARAMS(funcType1,
+        NEW_NAMED_TYPE("user", NEW_CUSTOM_TYPE(0, "User"))
+    );
+
+    Type* funcType2 = NEW_FUNCTION_TYPE();
+    FUNCTION_TYPE_ADD_PARAMS(funcType2,
+        NEW_NAMED_TYPE("user", NEW_CUSTOM_TYPE(0, "User"))
+    );
+
+    funcType1 = type_intern(funcType1);
+    funcType2 = type_intern(funcType2);
+
+    assert(funcType1 == funcType2);
+    assert(((FunctionType*) funcType1->type)->returnType == NULL);
+
+    size = type_table_size(type_table_active());
+
+    type_free(&array1);
+    type_free(&array2);
+    type_free(&array1Copy);
+    type_free(&funcType1);
+    type_free(&funcType2);
+
+    assert(array1 == NULL);
+    assert(type_table_size(type_table_active()) == size);
+}
+
+void test_type_table_builtins(void) {
+    TypeTable* previous = type_table_active();
+
+    TypeTable* builtins = type_table_new(NULL);
+    type_table_set_active(builtins);
+    Type* integer = NEW_INT_TYPE();
+
+    TypeTable* table = type_table_new(builtins);
+    type_table_set_active(table);
+
+    /* atomic types and anything else already in the builtins are not interned again */
+    assert(NEW_INT_TYPE() == integer);
+
+    Type* array = type_intern(NEW_ARRAY_TYPE(NEW_INT_TYPE()));
+    assert(((ArrayType*) array->type)->type == integer);
+    assert(type_table_size(table) == 1);
+    assert(type_table_size(builtins) == 1);
+
+    type_table_free(&table);
+    assert(type_table_active() == NULL);
+
+    type_table_free(&builtins);
+    type_table_set_active(previous);
+}
+
+void test_dense_array_types(void) {
+    Type* matrix = NEW_ARRAY_TYPE(NEW_FLOAT_TYPE());
+    ARRAY_TYPE_ADD_DIMENSION(matrix, NEW_ARRAY_DIMENSION(2));
+    ARRAY_TYPE_ADD_DIMENSION(matrix, NEW_ARRAY_DIMENSION(3));
+    matrix = type_intern(matrix);
+
+    assert(array_type_rank(matrix) == 2);
+    assert(array_type_extent(matrix, 0) == 2 && array_type_extent(matrix, 1) == 3);
+    assert(array_type_is_dense(matrix));
+
+    Type* row = array_type_slice(matrix, 1);
+    assert(array_type_rank(row) == 1 && array_type_extent(row, 0) == 3);
+    assert(!array_type_is_dense(row));
+    assert(array_type_slice(matrix, 2)->typeId == FLOAT_TYPE);
+
+    Type* jagged = NEW_ARRAY_TYPE(NEW_FLOAT_TYPE());
+    ARRAY_TYPE_ADD_DIMENSION(jagged, NEW_ARRAY_UNDEFINED_DIMENSION());
+    ARRAY_TYPE_ADD_DIMENSION(jagged, NEW_ARRAY_DIMENSION(3));
+    jagged = type_intern(jagged);
+
+    assert(!array_type_is_dense(jagged));
+    assert(array_type_slice(jagged, 1) == row);
+
+    Type* strings = NEW_ARRAY_TYPE(NEW_STRING_TYPE());
+    ARRAY_TYPE_ADD_DIMENSION(strings, NEW_ARRAY_DIMENSION(2));
+    ARRAY_TYPE_ADD_DIMENSION(strings, NEW_ARRAY_DIMENSION(2));
+
+    assert(!array_type_is_dense(strings));
+
+    type_free(&strings);
+}
+
 void run_type_tests(void) {
     test_atomic_type_equals();
     test_custom_type_equals();
@@ -294,6 +411,9 @@ void run_type_tests(void) {
     test_array_type_equals();
     test_function_type_equals();
     test_all_copy_functions();
+    test_interned_types_are_canonical();
+    test_type_table_builtins();
+    test_dense_array_types();
 
     printf("%s: All tests passed successfully!\n", __FILE__);
 }
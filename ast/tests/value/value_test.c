@@ -0,0 +1,141 @@
+#include "value_test.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../src/buffer.h"
+#include "../../src/gc.h"
+#include "../../src/object.h"
+#include "../../src/smem.h"
+#include "../../src/token.h"
+#include "../../src/value.h"
+
+
+static void test_value_round_trip(void) {
+    Value integer = INT_VALUE(-42);
+    assert(IS_INT(integer) && !IS_FLOAT(integer) && !IS_OBJECT(integer));
+    assert(AS_INT(integer) == -42);
+
+    /* the last ints that fit the payload, and the first ones that need a box */
+    Value small = INT_VALUE(((int64_t) 1 << 47) - 1);
+    Value big = INT_VALUE((int64_t) 1 << 47);
+    assert(IS_INT(small) && !IS_BIG_INT(small) && AS_INT(small) == ((int64_t) 1 << 47) - 1);
+    assert(IS_INT(big) && IS_BIG_INT(big) && !IS_OBJECT(big) && AS_INT(big) == (int64_t) 1 << 47);
+    assert(!IS_BIG_INT(INT_VALUE(-((int64_t) 1 << 47))) && AS_INT(INT_VALUE(-((int64_t) 1 << 47))) == -((int64_t) 1 << 47));
+
+    Value max = INT_VALUE(INT64_MAX);
+    Value min = INT_VALUE(INT64_MIN);
+    assert(AS_INT(max) == INT64_MAX && AS_INT(min) == INT64_MIN);
+    assert(value_type(max) == VAL_INT);
+
+    /* two boxes of one int are the same key */
+    Value other = INT_VALUE(INT64_MAX);
+    assert(value_equals(max, other) && value_hash(max) == value_hash(other));
+
+    value_release(big);
+    value_release(max);
+    value_release(min);
+    value_release(other);
+
+    Value number = FLOAT_VALUE(3.5);
+    assert(IS_FLOAT(number) && !IS_INT(number));
+    assert(AS_FLOAT(number) == 3.5);
+
+    Value character = CHAR_VALUE('x');
+    assert(IS_CHAR(character) && AS_CHAR(character) == 'x');
+
+    assert(IS_BOOL(BOOL_VALUE(true)) && AS_BOOL(BOOL_VALUE(true)));
+    assert(!AS_BOOL(BOOL_VALUE(false)));
+
+    assert(IS_NIL(NIL_VALUE()) && !IS_FLOAT(NIL_VALUE()));
+    assert(IS_UNDEFINED(UNDEFINED_VALUE()) && !IS_NIL(UNDEFINED_VALUE()));
+
+    Value nan = FLOAT_VALUE(NAN);
+    assert(IS_FLOAT(nan) && !IS_INT(nan) && !IS_NIL(nan));
+
+    Object* string = NEW_STRING_OBJECT("rose");
+    Value object = OBJECT_VALUE(string);
+    assert(IS_OBJECT(object) && !IS_FLOAT(object));
+    assert(AS_OBJECT(object) == string);
+
+    object_free(&string);
+}
+
+static void test_value_equals_and_truthiness(void) {
+    assert(value_equals(INT_VALUE(2), FLOAT_VALUE(2.0)));
+    assert(!value_equals(INT_VALUE(2), CHAR_VALUE(2)));
+
+    Object* left = NEW_STRING_OBJECT("abc");
+    Object* right = NEW_STRING_OBJECT("abc");
+    assert(value_equals(OBJECT_VALUE(left), OBJECT_VALUE(right)));
+
+    assert(!value_is_truthy(NIL_VALUE()));
+    assert(!value_is_truthy(INT_VALUE(0)));
+    assert(value_is_truthy(FLOAT_VALUE(0.5)));
+    assert(value_is_truthy(OBJECT_VALUE(left)));
+
+    object_free(&left);
+    object_free(&right);
+}
+
+static void test_value_binary_op(void) {
+    /* the big ints below are boxed on this heap */
+    GC* gc = gc_new(1 << 20);
+    gc_set_active(gc);
+
+    Value result = UNDEFINED_VALUE();
+
+    assert(value_binary_op(TOKEN_ADD, INT_VALUE(INT64_MAX), INT_VALUE(1), &result) == VALUE_OP_OK);
+    assert(IS_INT(result) && AS_INT(result) == INT64_MIN);
+
+    assert(value_binary_op(TOKEN_QUO, INT_VALUE(INT64_MIN), INT_VALUE(-1), &result) == VALUE_OP_OK);
+    assert(AS_INT(result) == INT64_MIN);
+
+    assert(value_binary_op(TOKEN_MUL_ASSIGN, INT_VALUE(3), FLOAT_VALUE(0.5), &result) == VALUE_OP_OK);
+    assert(IS_FLOAT(result) && AS_FLOAT(result) == 1.5);
+
+    /* ints compare exactly, past what a double holds */
+    assert(value_binary_op(TOKEN_GTR, INT_VALUE(INT64_MAX), INT_VALUE(INT64_MAX - 1), &result) == VALUE_OP_OK);
+    assert(AS_BOOL(result));
+
+    assert(value_binary_op(TOKEN_EQL, INT_VALUE(1), FLOAT_VALUE(1.0), &result) == VALUE_OP_OK);
+    assert(AS_BOOL(result));
+
+    assert(value_binary_op(TOKEN_NEQ, BOOL_VALUE(true), BOOL_VALUE(true), &result) == VALUE_OP_OK);
+    assert(IS_BOOL(result) && !AS_BOOL(result));
+
+    assert(value_binary_op(TOKEN_REM, INT_VALUE(1), INT_VALUE(0), &result) == VALUE_OP_DIVISION_BY_ZERO);
+    assert(value_binary_op(TOKEN_QUO, FLOAT_VALUE(1.0), INT_VALUE(0), &result) == VALUE_OP_DIVISION_BY_ZERO);
+    assert(value_binary_op(TOKEN_SHL, FLOAT_VALUE(1.0), INT_VALUE(2), &result) == VALUE_OP_INVALID);
+    assert(value_binary_op(TOKEN_LSS, BOOL_VALUE(false), BOOL_VALUE(true), &result) == VALUE_OP_INVALID);
+
+    gc_free(&gc);
+}
+
+static void test_value_to_string(void) {
+    ByteBuffer* bb = byte_buffer_new();
+
+    value_to_string(bb, INT_VALUE(7));
+    value_to_string(bb, CHAR_VALUE(' '));
+    value_to_string(bb, FLOAT_VALUE(1.5));
+    value_to_string(bb, BOOL_VALUE(false));
+
+    char* str = byte_buffer_to_string(bb);
+    assert(strcmp(str, "7 1.500000false") == 0);
+
+    safe_free((void**) &str);
+    byte_buffer_free(&bb);
+}
+
+void run_value_tests(void) {
+    test_value_round_trip();
+    test_value_equals_and_truthiness();
+    test_value_binary_op();
+    test_value_to_string();
+
+    printf("%s: All tests passed successfully!\n", __FILE__);
+}
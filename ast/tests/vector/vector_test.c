@@ -0,0 +1,125 @@
+#include "vector_test.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "../../src/arena.h"
+#include "../../src/smem.h"
+#include "../../src/vector.h"
+
+
+static size_t released;
+
+static void count_release(void** value) {
+    released += 1;
+    safe_free(value);
+}
+
+static int* number(int value) {
+    int* boxed = safe_malloc(sizeof(int), NULL);
+    *boxed = value;
+    return boxed;
+}
+
+static void test_vector_push_and_remove(void) {
+    released = 0;
+
+    Vector* vector = vector_new(count_release);
+    assert(vector != NULL && vector->items != NULL);
+    assert(vector_is_empty(&vector));
+    assert(vector_last(&vector) == NULL);
+
+    size_t visited = 0;
+    vector_foreach(item, vector) {
+        visited += 1;
+    }
+    assert(visited == 0);
+
+    for (int i = 0; i < 1000; i++) {
+        vector_push(&vector, number(i));
+    }
+    assert(vector_size(&vector) == 1000 && vector->capacity >= 1000);
+    assert(*(int*) vector_get_at(&vector, 999) == 999);
+    assert(*(int*) vector_last(&vector) == 999);
+    assert(vector_get_at(&vector, 1000) == NULL);
+
+    int expected = 0;
+    vector_foreach(item, vector) {
+        assert(**(int**) item == expected++);
+    }
+
+    vector_replace_at(&vector, 0, number(-1));
+    assert(released == 1 && *(int*) vector_get_at(&vector, 0) == -1);
+
+    int* kept = NULL;
+    vector_remove_at(&vector, 1, (void**) &kept);
+    assert(*kept == 1 && released == 1);
+    assert(vector_size(&vector) == 999 && *(int*) vector_get_at(&vector, 1) == 2);
+    safe_free((void**) &kept);
+
+    vector_remove_at(&vector, 0, NULL);
+    assert(released == 2 && *(int*) vector_get_at(&vector, 0) == 2);
+
+    assert(vector_reserve(&vector, 4096) && vector->capacity == 4096);
+
+    vector_free(&vector);
+    assert(vector == NULL && released == 2 + 998);
+}
+
+static void test_vector_truncate(void) {
+    Vector* vector = vector_new(NULL);
+
+    static int values[] = {1, 2, 3, 4, 5};
+    for (size_t i = 0; i < 5; i++) {
+        vector_push(&vector, &values[i]);
+    }
+
+    /* compacts the odd values to the front, as the optimizer does with dead statements */
+    size_t kept = 0;
+    vector_foreach(item, vector) {
+        if (**(int**) item % 2 != 0) {
+            vector->items[kept++] = *item;
+        }
+    }
+    vector_truncate(&vector, kept);
+
+    assert(vector_size(&vector) == 3);
+    assert(*(int*) vector_last(&vector) == 5);
+
+    vector_clear(&vector);
+    assert(vector_is_empty(&vector));
+
+    vector_free(&vector);
+}
+
+static void test_vector_in_arena(void) {
+    Arena* arena = arena_new(0);
+    arena_set_active(arena);
+
+    Vector* vector = vector_new(NULL);
+    assert(vector->arena == arena);
+
+    for (uintptr_t i = 1; i <= 100; i++) {
+        vector_push(&vector, (void*) i);
+    }
+
+    arena_set_active(NULL);
+
+    assert(vector_size(&vector) == 100);
+    assert((uintptr_t) vector_get_at(&vector, 0) == 1);
+    assert((uintptr_t) vector_last(&vector) == 100);
+
+    vector_free(&vector);
+    assert(vector == NULL);
+
+    arena_free(&arena);
+}
+
+void run_vector_tests(void) {
+    test_vector_push_and_remove();
+    test_vector_truncate();
+    test_vector_in_arena();
+
+    printf("%s: All tests passed successfully!\n", __FILE__);
+}
@@ -0,0 +1,270 @@
+#include "vm_test.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../../src/ast.h"
+#include "../../src/buffer.h"
+#include "../../src/interpreter.h"
+#include "../../src/list.h"
+#include "../../src/optimizer.h"
+#include "../../src/output.h"
+#include "../../src/smem.h"
+#include "../../src/token.h"
+#include "../../src/types.h"
+#include "../../src/vm.h"
+
+
+static Expr* binary(Expr* left, TokenType op, char* literal, Expr* right) {
+    return NEW_BINARY_EXPR(left, NEW_TOKEN(op, literal, 1), right);
+}
+
+static Decl* println_of(Expr* argument) {
+    Expr* call = NEW_CALL_EXPR(NEW_IDENT_LITERAL("println"));
+    CALL_EXPR_ADD_ARG(call, argument);
+
+    return NEW_STMT_DECL(NEW_EXPR_STMT(call));
+}
+
+static Expr* call_of(char* name, Expr* first, Expr* second) {
+    Expr* call = NEW_CALL_EXPR(NEW_IDENT_LITERAL(name));
+    CALL_EXPR_ADD_ARG(call, first);
+
+    if (second != NULL) {
+        CALL_EXPR_ADD_ARG(call, second);
+    }
+
+    return call;
+}
+
+/*
+ * func rec(n: int): int { if (n == 0) { return 0; } return rec(n - 1) + 1; }
+ * println(rec(1000));
+ */
+static List* deep_recursion(void) {
+    List* declarations = list_new((void (*)(void**)) decl_free);
+
+    Stmt* base = NEW_BLOCK_STMT();
+    BLOCK_STMT_ADD_DECL(base, NEW_STMT_DECL(NEW_RETURN_STMT(NEW_INT_LITERAL(0))));
+
+    Stmt* body = NEW_BLOCK_STMT();
+    BLOCK_STMT_ADD_DECL(body, NEW_STMT_DECL(NEW_IF_STMT(
+        binary(NEW_IDENT_LITERAL("n"), TOKEN_EQL, "==", NEW_INT_LITERAL(0)), base, NULL)));
+    BLOCK_STMT_ADD_DECL(body, NEW_STMT_DECL(NEW_RETURN_STMT(binary(
+        call_of("rec", binary(NEW_IDENT_LITERAL("n"), TOKEN_SUB, "-", NEW_INT_LITERAL(1)), NULL),
+        TOKEN_ADD, "+", NEW_INT_LITERAL(1)))));
+
+    Decl* rec = NEW_FUNCTION_DECL_WITH_RETURN(NEW_TOKEN(TOKEN_IDENT, "rec", 1), NEW_INT_TYPE(), body);
+    FUNCTION_ADD_PARAM(rec, NEW_FIELD_DECL(NEW_TOKEN(TOKEN_IDENT, "n", 1), NEW_INT_TYPE()));
+
+    list_insert_last(&declarations, rec);
+    list_insert_last(&declarations, println_of(call_of("rec", NEW_INT_LITERAL(1000), NULL)));
+
+    return declarations;
+}
+
+/*
+ * func quotient(a: int, b: int): int { return a / b; }
+ * println(quotient(1, 0));
+ * println("after");
+ * let i = 0;
+ * while (i < 3) { i = i + 1; println(quotient(6, i - 2)); }
+ * println("end");
+ */
+static List* runtime_errors(void) {
+    List* declarations = list_new((void (*)(void**)) decl_free);
+
+    Stmt* body = NEW_BLOCK_STMT();
+    BLOCK_STMT_ADD_DECL(body, NEW_STMT_DECL(NEW_RETURN_STMT(
+        binary(NEW_IDENT_LITERAL("a"), TOKEN_QUO, "/", NEW_IDENT_LITERAL("b")))));
+
+    Decl* quotient = NEW_FUNCTION_DECL_WITH_RETURN(NEW_TOKEN(TOKEN_IDENT, "quotient", 1), NEW_INT_TYPE(), body);
+    FUNCTION_ADD_PARAMS(quotient,
+        NEW_FIELD_DECL(NEW_TOKEN(TOKEN_IDENT, "a", 1), NEW_INT_TYPE()),
+        NEW_FIELD_DECL(NEW_TOKEN(TOKEN_IDENT, "b", 1), NEW_INT_TYPE())
+    );
+
+    Stmt* loop = NEW_BLOCK_STMT();
+    BLOCK_STMT_ADD_DECL(loop, NEW_STMT_DECL(NEW_EXPR_STMT(NEW_ASSIGN_EXPR(
+        NEW_IDENT_LITERAL("i"), NEW_TOKEN(TOKEN_ASSIGN, "=", 1),
+        binary(NEW_IDENT_LITERAL("i"), TOKEN_ADD, "+", NEW_INT_LITERAL(1))))));
+    BLOCK_STMT_ADD_DECL(loop, println_of(call_of("quotient", NEW_INT_LITERAL(6),
+        binary(NEW_IDENT_LITERAL("i"), TOKEN_SUB, "-", NEW_INT_LITERAL(2)))));
+
+    list_insert_last(&declarations, quotient);
+    list_insert_last(&declarations, println_of(call_of("quotient", NEW_INT_LITERAL(1), NEW_INT_LITERAL(0))));
+    list_insert_last(&declarations, println_of(NEW_STRING_LITERAL("after")));
+    list_insert_last(&declarations, NEW_LET_DECL(NEW_TOKEN(TOKEN_IDENT, "i", 1), NULL, NEW_INT_LITERAL(0)));
+    list_insert_last(&declarations, NEW_STMT_DECL(NEW_WHILE_STMT(
+        binary(NEW_IDENT_LITERAL("i"), TOKEN_LSS, "<", NEW_INT_LITERAL(3)), loop)));
+    list_insert_last(&declarations, println_of(NEW_STRING_LITERAL("end")));
+
+    return declarations;
+}
+
+/*
+ * func keeper(s: string): func(): string { let kept = s + "!"; return func(): string { return kept; }; }
+ * let held = keeper("held");
+ * let text = "";
+ * let i = 0;
+ * while (i < 20) { i = i + 1; text = text + "x"; let junk = keeper("junk"); }
+ * println(held());
+ * println(text);
+ */
+static List* garbage(void) {
+    List* declarations = list_new((void (*)(void**)) decl_free);
+
+    Stmt* inner = NEW_BLOCK_STMT();
+    BLOCK_STMT_ADD_DECL(inner, NEW_STMT_DECL(NEW_RETURN_STMT(NEW_IDENT_LITERAL("kept"))));
+
+    Stmt* body = NEW_BLOCK_STMT();
+    BLOCK_STMT_ADD_DECL(body, NEW_LET_DECL(NEW_TOKEN(TOKEN_IDENT, "kept", 1), NULL,
+        binary(NEW_IDENT_LITERAL("s"), TOKEN_ADD, "+", NEW_STRING_LITERAL("!"))));
+    BLOCK_STMT_ADD_DECL(body, NEW_STMT_DECL(NEW_RETURN_STMT(
+        NEW_FUNCTION_EXPR_WITH_RETURN(NEW_STRING_TYPE(), inner))));
+
+    Decl* keeper = NEW_FUNCTION_DECL_WITH_RETURN(NEW_TOKEN(TOKEN_IDENT, "keeper", 1),
+        NEW_FUNCTION_TYPE_WITH_RETURN(NEW_STRING_TYPE()), body);
+    FUNCTION_ADD_PARAM(keeper, NEW_FIELD_DECL(NEW_TOKEN(TOKEN_IDENT, "s", 1), NEW_STRING_TYPE()));
+
+    Stmt* loop = NEW_BLOCK_STMT();
+    BLOCK_STMT_ADD_DECL(loop, NEW_STMT_DECL(NEW_EXPR_STMT(NEW_ASSIGN_EXPR(
+        NEW_IDENT_LITERAL("i"), NEW_TOKEN(TOKEN_ASSIGN, "=", 1),
+        binary(NEW_IDENT_LITERAL("i"), TOKEN_ADD, "+", NEW_INT_LITERAL(1))))));
+    BLOCK_STMT_ADD_DECL(loop, NEW_STMT_DECL(NEW_EXPR_STMT(NEW_ASSIGN_EXPR(
+        NEW_IDENT_LITERAL("text"), NEW_TOKEN(TOKEN_ASSIGN, "=", 1),
+        binary(NEW_IDENT_LITERAL("text"), TOKEN_ADD, "+", NEW_STRING_LITERAL("x"))))));
+    BLOCK_STMT_ADD_DECL(loop, NEW_LET_DECL(NEW_TOKEN(TOKEN_IDENT, "junk", 1), NULL,
+        call_of("keeper", NEW_STRING_LITERAL("junk"), NULL)));
+
+    list_insert_last(&declarations, keeper);
+    list_insert_last(&declarations, NEW_LET_DECL(NEW_TOKEN(TOKEN_IDENT, "held", 1), NULL,
+        call_of("keeper", NEW_STRING_LITERAL("held"), NULL)));
+    list_insert_last(&declarations, NEW_LET_DECL(NEW_TOKEN(TOKEN_IDENT, "text", 1), NULL, NEW_STRING_LITERAL("")));
+    list_insert_last(&declarations, NEW_LET_DECL(NEW_TOKEN(TOKEN_IDENT, "i", 1), NULL, NEW_INT_LITERAL(0)));
+    list_insert_last(&declarations, NEW_STMT_DECL(NEW_WHILE_STMT(
+        binary(NEW_IDENT_LITERAL("i"), TOKEN_LSS, "<", NEW_INT_LITERAL(20)), loop)));
+    list_insert_last(&declarations, println_of(NEW_CALL_EXPR(NEW_IDENT_LITERAL("held"))));
+    list_insert_last(&declarations, println_of(NEW_IDENT_LITERAL("text")));
+
+    return declarations;
+}
+
+static Expr* element_of(char* name, int64_t index) {
+    Expr* element = NEW_ARRAY_MEMBER_EXPR(NEW_IDENT_LITERAL(name));
+    ARRAY_MEMBER_EXPR_ACCESS_INDEX(element, NEW_INT_LITERAL(index));
+
+    return element;
+}
+
+/*
+ * let xs = []int{1, 2};
+ * xs[0]++;
+ * println(xs[1]--);
+ * println(xs);
+ */
+static List* element_updates(void) {
+    List* declarations = list_new((void (*)(void**)) decl_free);
+
+    Type* arrayType = NEW_ARRAY_TYPE(NEW_INT_TYPE());
+    ARRAY_TYPE_ADD_DIMENSION(arrayType, NEW_ARRAY_UNDEFINED_DIMENSION());
+    Expr* array = NEW_ARRAY_INIT_EXPR(arrayType);
+    ARRAY_INIT_EXPR_ADD_ELEMENTS(array, NEW_INT_LITERAL(1), NEW_INT_LITERAL(2));
+
+    list_insert_last(&declarations, NEW_LET_DECL(NEW_TOKEN(TOKEN_IDENT, "xs", 1), NULL, array));
+    list_insert_last(&declarations, NEW_STMT_DECL(NEW_EXPR_STMT(
+        NEW_UPDATE_EXPR(element_of("xs", 0), NEW_TOKEN(TOKEN_INC, "++", 1)))));
+    list_insert_last(&declarations, println_of(
+        NEW_UPDATE_EXPR(element_of("xs", 1), NEW_TOKEN(TOKEN_DEC, "--", 1))));
+    list_insert_last(&declarations, println_of(NEW_IDENT_LITERAL("xs")));
+
+    return declarations;
+}
+
+/*
+ * println(1 == 1.0);
+ * println(true != false);
+ * println(7 % 2.5);
+ */
+static List* mixed_operands(void) {
+    List* declarations = list_new((void (*)(void**)) decl_free);
+
+    list_insert_last(&declarations, println_of(binary(NEW_INT_LITERAL(1), TOKEN_EQL, "==", NEW_FLOAT_LITERAL(1.0))));
+    list_insert_last(&declarations, println_of(binary(NEW_BOOL_LITERAL(true), TOKEN_NEQ, "!=", NEW_BOOL_LITERAL(false))));
+    list_insert_last(&declarations, println_of(binary(NEW_INT_LITERAL(7), TOKEN_REM, "%", NEW_FLOAT_LITERAL(2.5))));
+
+    return declarations;
+}
+
+/* what the program printed, each engine runs its own copy of the tree */
+static char* run_on(List* (*program)(void), bool useVM, InterpreterOptions options, InterpreterStatus* status) {
+    List* declarations = program();
+
+    ByteBuffer* text = byte_buffer_new();
+    output_capture(text);
+    *status = useVM ? vm_eval_with_options(declarations, options) : eval_with_options(declarations, options);
+    output_capture(NULL);
+
+    char* printed = byte_buffer_to_string(text);
+
+    byte_buffer_free(&text);
+    list_free(&declarations);
+
+    return printed;
+}
+
+static void assert_same_on_both_engines(List* (*program)(void), InterpreterOptions options, const char* expected, InterpreterStatus expectedStatus) {
+    InterpreterStatus treeStatus;
+    InterpreterStatus vmStatus;
+
+    char* tree = run_on(program, false, options, &treeStatus);
+    char* vm = run_on(program, true, options, &vmStatus);
+
+    assert(strcmp(tree, expected) == 0);
+    assert(strcmp(vm, tree) == 0);
+    assert(treeStatus == expectedStatus);
+    assert(vmStatus == treeStatus);
+
+    safe_free((void**) &tree);
+    safe_free((void**) &vm);
+}
+
+static void test_deep_recursion(void) {
+    assert_same_on_both_engines(deep_recursion, (InterpreterOptions) {0}, "1000\n", INTERPRETER_SUCCESS);
+}
+
+static void test_runtime_errors_continue(void) {
+    assert_same_on_both_engines(runtime_errors, (InterpreterOptions) {0}, "after\n-6\n6\nend\n", INTERPRETER_FAILURE);
+}
+
+/* collecting before every allocation must keep what globals and closures still hold */
+static void test_collects_garbage(void) {
+    InterpreterOptions options = { .gcThreshold = 1 };
+
+    assert_same_on_both_engines(garbage, options, "held!\nxxxxxxxxxxxxxxxxxxxx\n", INTERPRETER_SUCCESS);
+}
+
+/* an element update leaves the old element, like one on a variable */
+static void test_element_updates(void) {
+    assert_same_on_both_engines(element_updates, (InterpreterOptions) {0}, "2\n[2, 1]\n", INTERPRETER_SUCCESS);
+}
+
+/* both engines, with and without folding, share one set of operators */
+static void test_mixed_operands(void) {
+    assert_same_on_both_engines(mixed_operands, (InterpreterOptions) {0}, "true\ntrue\n2.000000\n", INTERPRETER_SUCCESS);
+    assert_same_on_both_engines(mixed_operands, (InterpreterOptions) { .optimizationLevel = OPTIMIZER_LOCAL },
+        "true\ntrue\n2.000000\n", INTERPRETER_SUCCESS);
+}
+
+void run_vm_tests(void) {
+    test_deep_recursion();
+    test_runtime_errors_continue();
+    test_collects_garbage();
+    test_element_updates();
+    test_mixed_operands();
+
+    printf("%s: All tests passed successfully!\n", __FILE__);
+}